@@ -0,0 +1,289 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_AttachVolume.c
+ *
+ * Description :
+ *  Attach/detach the device of a volume to/from EduBfM.
+ *  EduBfM accesses an attached volume directly (e.g. to write runs of
+ *  adjacent pages at once by the bulk flush), instead of through RDsM
+ *  which transfers one train at a time. A volume must consist of a single
+ *  device, in which page p is stored at the offset p * PAGESIZE.
+ *  If edubfm_cfgParams.useDirectIO is set, the device is opened with
+ *  O_DIRECT and all pages/trains of the volume are read and written by
+ *  EduBfM directly, so that they are not cached by the OS a second time.
+ *  If edubfm_cfgParams.useMmap is set, the device is mapped into memory,
+ *  and its pages/trains are fixed in place (see edubfm_MappedVolume.c).
+ *  EduBfM_AttachMemoryVolume() attaches a copy of the device in memory
+ *  instead, with an injected latency and bandwidth (see edubfm_MemoryVolume.c).
+ *
+ * Exports:
+ *  Four EduBfM_AttachVolume(VolNo, char *)
+ *  Four EduBfM_AttachMemoryVolume(VolNo, char *)
+ *  Four EduBfM_DetachVolume(VolNo)
+ *  Four edubfm_VolumeFd(VolNo)
+ *  Four edubfm_DirectVolumeFd(VolNo)
+ */
+
+
+#define _GNU_SOURCE /* for O_DIRECT */
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+/* attached volumes */
+VolumeDevice edubfm_volumes[MAX_ATTACHED_VOLUMES];
+Four         edubfm_nVolumes = 0;
+
+
+
+/*@================================
+ * EduBfM_AttachVolume()
+ *================================*/
+/*
+ * Function: Four EduBfM_AttachVolume(VolNo, char *)
+ *
+ * Description :
+ *  Open the device of the mounted volume for the direct accesses of EduBfM.
+ *  If edubfm_cfgParams.useDirectIO is set, the device is opened with
+ *  O_DIRECT, which requires the buffer pools to be page aligned; so
+ *  EduBfM_Init() must have been called with the same parameter. If the file
+ *  system of the device does not support O_DIRECT, it is opened as usual.
+ *  If edubfm_cfgParams.useMmap is set, the device is also mapped into memory.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - The volume is already attached, or too many volumes are attached.
+ *    eVOLUMEIOERR_EDUBFM - The device cannot be opened or mapped.
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ *
+ * 설명:
+ *  Volume의 device file을 열어, EduBfM이 RDsM을 거치지 않고 직접 접근할 수 있도록 함
+ */
+Four EduBfM_AttachVolume(
+    VolNo               volNo,                  /* IN volume number */
+    char                *devName)               /* IN device name of the volume */
+{
+    Four                e;                      /* error code */
+    Four                fd = -1;                /* file descriptor */
+    Boolean             direct = FALSE;         /* TRUE if opened with O_DIRECT */
+    VolumeDevice        *vol;                   /* attached volume */
+
+    if (devName == NULL || edubfm_VolumeFd(volNo) != NIL) ERR(eBADPARAMETER_EDUBFM);
+    if (edubfm_nVolumes == MAX_ATTACHED_VOLUMES) ERR(eBADPARAMETER_EDUBFM);
+
+    // O_DIRECT를 지원하지 않는 file system (EINVAL) 이면 일반적인 방법으로 엶
+    if (edubfm_cfgParams.useDirectIO) {
+        fd = open(devName, O_RDWR | O_DIRECT);
+        if (fd >= 0) direct = TRUE;
+        else if (errno != EINVAL) ERR(eVOLUMEIOERR_EDUBFM);
+    }
+    if (fd < 0) fd = open(devName, O_RDWR);
+    if (fd < 0) ERR(eVOLUMEIOERR_EDUBFM);
+
+    vol = &edubfm_volumes[edubfm_nVolumes];
+    vol->volNo = volNo;
+    vol->fd = fd;
+    vol->direct = direct;
+    vol->memory = FALSE;
+    vol->map = NULL;
+
+    // Volume의 device를 memory에 mapping 하여, 그 page/train들을 bufferPool에 복사하지 않고 fix 함
+    if (edubfm_cfgParams.useMmap) {
+        e = edubfm_MapVolume(vol);
+        if (e < 0) {
+            close(fd);
+            ERR(e);
+        }
+    }
+
+    edubfm_nVolumes++;
+
+    return(eNOERROR);
+
+}  /* EduBfM_AttachVolume() */
+
+
+
+/*@================================
+ * EduBfM_AttachMemoryVolume()
+ *================================*/
+/*
+ * Function: Four EduBfM_AttachMemoryVolume(VolNo, char *)
+ *
+ * Description :
+ *  Attach a copy of the device of the mounted volume in memory, which
+ *  EduBfM reads and writes instead of the device, delaying each I/O by
+ *  edubfm_cfgParams.memVolumeLatency and memVolumeBandwidth. The pages of
+ *  the volume are neither read nor written by RDsM while it is attached,
+ *  so the measurements of the layers above are not disturbed by the disk.
+ *  The copy is dropped when the volume is detached, leaving the device as
+ *  it was; the pages written by the storage system meanwhile are not seen
+ *  by EduBfM. If edubfm_cfgParams.useMmap is set, the copy is mapped.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - The volume is already attached, too many volumes are attached,
+ *                           or the latency or the bandwidth is negative.
+ *    eVOLUMEIOERR_EDUBFM - The device cannot be read, or the copy cannot be created or mapped.
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ *
+ * 설명:
+ *  Volume의 device를 memory에 복사하여 attach 하고, disk 대신 주어진 지연 시간과 bandwidth로 읽고 씀
+ */
+Four EduBfM_AttachMemoryVolume(
+    VolNo               volNo,                  /* IN volume number */
+    char                *devName)               /* IN device name of the volume */
+{
+    Four                e;                      /* error code */
+    VolumeDevice        *vol;                   /* attached volume */
+
+    if (devName == NULL || edubfm_VolumeFd(volNo) != NIL) ERR(eBADPARAMETER_EDUBFM);
+    if (edubfm_nVolumes == MAX_ATTACHED_VOLUMES) ERR(eBADPARAMETER_EDUBFM);
+
+    vol = &edubfm_volumes[edubfm_nVolumes];
+    vol->volNo = volNo;
+    vol->map = NULL;
+
+    e = edubfm_LoadMemoryVolume(vol, devName);
+    if (e < 0) ERR(e);
+
+    if (edubfm_cfgParams.useMmap) {
+        e = edubfm_MapVolume(vol);
+        if (e < 0) {
+            close(vol->fd);
+            ERR(e);
+        }
+    }
+
+    edubfm_nVolumes++;
+    edubfm_nMemoryVolumes++;
+
+    return(eNOERROR);
+
+}  /* EduBfM_AttachMemoryVolume() */
+
+
+
+/*@================================
+ * EduBfM_DetachVolume()
+ *================================*/
+/*
+ * Function: Four EduBfM_DetachVolume(VolNo)
+ *
+ * Description :
+ *  Close the device of the volume opened by EduBfM_AttachVolume().
+ *  The dirty pages/trains of the volume should be flushed first; the
+ *  modifications of the pages/trains of a mapped volume are lost otherwise.
+ *  The copy of a memory volume is dropped.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - The volume is not attached.
+ *    eFLUSHFIXEDBUF_BFM - A page/train of the mapped volume is still fixed.
+ *
+ * 설명:
+ *  EduBfM_AttachVolume()으로 연 volume의 device file을 닫음
+ */
+Four EduBfM_DetachVolume(
+    VolNo               volNo)                  /* IN volume number */
+{
+    Four                i;
+
+    for (i = 0; i < edubfm_nVolumes; i++) {
+        if (edubfm_volumes[i].volNo == volNo) {
+            if (edubfm_volumes[i].map != NULL) {
+                if (edubfm_volumes[i].nFixed > 0) ERR(eFLUSHFIXEDBUF_BFM);
+                edubfm_UnmapVolume(&edubfm_volumes[i]);
+            }
+            if (edubfm_volumes[i].memory) edubfm_nMemoryVolumes--;
+            close(edubfm_volumes[i].fd);
+            edubfm_volumes[i] = edubfm_volumes[--edubfm_nVolumes];
+            return(eNOERROR);
+        }
+    }
+
+    ERR(eBADPARAMETER_EDUBFM);
+
+}  /* EduBfM_DetachVolume() */
+
+
+
+/*@================================
+ * edubfm_VolumeFd()
+ *================================*/
+/*
+ * Function: Four edubfm_VolumeFd(VolNo)
+ *
+ * Description :
+ *  Return the file descriptor of the device of the attached volume.
+ *
+ * Returns:
+ *  file descriptor (NIL : The volume is not attached.)
+ */
+Four edubfm_VolumeFd(
+    VolNo               volNo)                  /* IN volume number */
+{
+    Four                i;
+
+    for (i = 0; i < edubfm_nVolumes; i++)
+        if (edubfm_volumes[i].volNo == volNo) return(edubfm_volumes[i].fd);
+
+    return(NIL);
+
+}  /* edubfm_VolumeFd() */
+
+
+
+/*@================================
+ * edubfm_DirectVolumeFd()
+ *================================*/
+/*
+ * Function: Four edubfm_DirectVolumeFd(VolNo)
+ *
+ * Description :
+ *  Return the file descriptor of the device of the attached volume if it
+ *  is opened with O_DIRECT. The pages/trains of such a volume are also
+ *  written directly instead of by RDsM, which goes through the page cache.
+ *  So are the pages/trains of a memory volume.
+ *
+ * Returns:
+ *  file descriptor (NIL : The volume is neither attached with O_DIRECT nor in memory.)
+ */
+Four edubfm_DirectVolumeFd(
+    VolNo               volNo)                  /* IN volume number */
+{
+    Four                i;
+
+    for (i = 0; i < edubfm_nVolumes; i++)
+        if (edubfm_volumes[i].volNo == volNo) return(edubfm_volumes[i].direct ? edubfm_volumes[i].fd : NIL);
+
+    return(NIL);
+
+}  /* edubfm_DirectVolumeFd() */
@@ -0,0 +1,4490 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_Bench.c
+ *
+ * Description : 
+ *  Benchmarks of EduBfM.
+ *  Each benchmark drives the interface functions of EduBfM on the trains
+ *  allocated in the benchmark volume and prints its measurements.
+ *
+ * Exports:
+ *  Four EduBfM_Bench(Four, Four, char **)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <pthread.h>
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+#include "EduBfM_TestModule.h"
+#include "EduBfM_BenchModule.h"
+
+
+/* trains of the LOT_LEAF_BUF size accessed by the benchmarks */
+static PageID benchTrains[BENCH_NTRAINS];
+
+/* first extents of the segments allocated by edubfm_bench_AllocTrains(), dropped when each benchmark finishes */
+static Four benchSegments[BENCH_MAX_SEGMENTS];
+static Four nBenchSegments = 0;
+
+/* table of the benchmarks */
+typedef struct {
+    char    *name;                      /* name of the benchmark */
+    Four    (*func)(Four, Four, char *);    /* IN volume id, IN # of operations per thread, IN argument */
+} BenchEntry;
+
+static BenchEntry benchTable[] = {
+    { "mtfix",      edubfm_bench_MultiThreadedFix },
+    { "policy",     edubfm_bench_PolicyHitRatio },
+    { "pagetable",  edubfm_bench_PageTableLookUp },
+    { "bgwriter",   edubfm_bench_BgWriter },
+    { "bulkflush",  edubfm_bench_BulkFlush },
+    { "readahead",  edubfm_bench_ReadAhead },
+    { "prefetch",   edubfm_bench_Prefetch },
+    { "ring",       edubfm_bench_Ring },
+    { "resize",     edubfm_bench_Resize },
+    { "stats",      edubfm_bench_Stats },
+    { "directio",   edubfm_bench_DirectIO },
+    { "mmap",       edubfm_bench_Mmap },
+    { "ccache",     edubfm_bench_CompressedCache },
+    { "warmup",     edubfm_bench_Warmup },
+    { "optfix",     edubfm_bench_OptimisticFix },
+    { "numa",       edubfm_bench_Numa },
+    { "vartrain",   edubfm_bench_VarTrain },
+    { "cleanfirst", edubfm_bench_CleanFirst },
+    { "suite",      edubfm_bench_Suite },
+    { "asyncio",    edubfm_bench_AsyncIO },
+    { "memvol",     edubfm_bench_MemoryVolume },
+    { "replay",     edubfm_bench_Replay },
+    { "checkpoint", edubfm_bench_Checkpoint },
+    { "readsize",   edubfm_bench_ReadSize },
+    { NULL,         NULL }
+};
+
+
+
+/*@================================
+ * EduBfM_Bench()
+ *================================*/
+/*
+ * Function: EduBfM_Bench(Four, Four, char **)
+ *
+ * Description : 
+ *  Run the benchmark named by argv[1] (all benchmarks if omitted) with
+ *  argv[2] operations per thread (BENCH_NOPS if omitted). argv[3], if any,
+ *  is passed to the benchmark.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four EduBfM_Bench(
+    Four        volId,                  /* IN volume id */
+    Four        argc,                   /* IN # of arguments */
+    char        **argv)                 /* IN arguments */
+{
+    Four        e;                      /* for errors */
+    Four        nOps;                   /* # of operations per thread */
+    char        *arg;                   /* argument of the benchmark */
+    BenchEntry  *b;                     /* a benchmark */
+    Four        nShared;                /* # of segments of benchTrains, kept for all benchmarks */
+
+
+    nOps = (argc > 2) ? atoi(argv[2]) : BENCH_NOPS;
+    arg = (argc > 3) ? argv[3] : NULL;
+
+    e = edubfm_bench_AllocTrains(volId, BENCH_NTRAINS, BI_BUFSIZE(LOT_LEAF_BUF), benchTrains);
+    if (e < eNOERROR) ERR(e);
+    nShared = nBenchSegments;
+
+    for (b = benchTable; b->name != NULL; b++) {
+        if (argc > 1 && strcmp(argv[1], "all") != 0 && strcmp(argv[1], b->name) != 0) continue;
+
+        printf("\n*Benchmark %s\n", b->name);
+        e = b->func(volId, nOps, arg);
+        if (e < eNOERROR) ERR(e);
+
+        // 다음 benchmark들이 volume을 다시 사용할 수 있도록, 이 benchmark가 할당한 segment들을 반환함
+        e = edubfm_bench_DropSegments(volId, nShared);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* EduBfM_Bench() */
+
+
+
+/*@================================
+ * edubfm_bench_AllocTrains()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_AllocTrains(Four, Four, Two, PageID *)
+ *
+ * Description:
+ *  Allocate 'nTrains' trains of 'trainSize' pages in a new segment.
+ *  The segment is dropped by edubfm_bench_DropSegments() when the
+ *  benchmark finishes.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - BENCH_MAX_SEGMENTS segments are allocated already.
+ *    some errors caused by function calls
+ */
+Four edubfm_bench_AllocTrains(
+    Four        volId,                  /* IN volume id */
+    Four        nTrains,                /* IN # of trains to allocate */
+    Two         trainSize,              /* IN size of a train (unit: # of pages) */
+    PageID      *trains)                /* OUT allocated trains */
+{
+    Four        e;                      /* for errors */
+    Four        i;                      /* loop index */
+    Four        firstExtNo;             /* first extent number */
+    PageID      nearPid;                /* near pageID */
+
+    if (nBenchSegments == BENCH_MAX_SEGMENTS) ERR(eBADPARAMETER_EDUBFM);
+
+    e = RDsM_CreateSegment(volId, &firstExtNo);
+    if (e < eNOERROR) ERR(e);
+    benchSegments[nBenchSegments++] = firstExtNo;
+
+    e = RDsM_ExtNoToPageId(volId, firstExtNo, &nearPid);
+    if (e < eNOERROR) ERR(e);
+
+    for (i = 0; i < nTrains; i++) {
+        e = RDsM_AllocTrains(volId, firstExtNo, &nearPid, 100, 1, trainSize, &trains[i]);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* edubfm_bench_AllocTrains() */
+
+
+
+/*@================================
+ * edubfm_bench_DropSegments()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_DropSegments(Four, Four)
+ *
+ * Description:
+ *  Drop the segments allocated by edubfm_bench_AllocTrains() except the
+ *  first 'nKept' ones, so that the benchmarks run one after another do not
+ *  run out of the pages of the volume. The buffer pools are flushed and
+ *  emptied first, so that no page of the dropped segments is left in them.
+ *  It must be called while EduBfM is finalized.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_DropSegments(
+    Four        volId,                  /* IN volume id */
+    Four        nKept)                  /* IN # of segments kept */
+{
+    Four        e;                      /* for errors */
+
+    e = EduBfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+    e = EduBfM_DiscardAll();
+    if (e < eNOERROR) ERR(e);
+
+    while (nBenchSegments > nKept) {
+        e = RDsM_DropSegment(volId, benchSegments[--nBenchSegments]);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* edubfm_bench_DropSegments() */
+
+
+
+/*@================================
+ * edubfm_bench_Now()
+ *================================*/
+/*
+ * Function: double edubfm_bench_Now(void)
+ *
+ * Description:
+ *  Return the current time of the monotonic clock in seconds.
+ */
+double edubfm_bench_Now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return((double)ts.tv_sec + (double)ts.tv_nsec / 1e9);
+
+} /* edubfm_bench_Now() */
+
+
+
+/*
+ * Benchmark "mtfix" : multi-threaded fix/unfix throughput
+ */
+
+/* # of partitions compared with the single partition;
+ * odd so that the trains, which are BI_BUFSIZE(LOT_LEAF_BUF) pages apart, spread over all partitions */
+#define MTFIX_NPARTITIONS   61
+
+typedef struct {
+    pthread_t   thread;
+    UFour       seed;                   /* seed of the random number generator */
+    Four        nOps;                   /* # of fix/unfix pairs to perform */
+    Four        e;                      /* error of this thread */
+} MtFixWorker;
+
+static void *edubfm_bench_MtFixWorker(
+    void        *arg)                   /* IN MtFixWorker */
+{
+    MtFixWorker *w = (MtFixWorker *)arg;
+    Four        i;
+    PageID      *pid;
+    char        *buf;
+    volatile char sum = 0;
+
+    for (i = 0; i < w->nOps; i++) {
+        pid = &benchTrains[rand_r(&w->seed) % BENCH_NTRAINS];
+
+        w->e = EduBfM_GetTrain(pid, &buf, LOT_LEAF_BUF);
+        if (w->e < eNOERROR) break;
+
+        sum += buf[0];
+
+        w->e = EduBfM_FreeTrain(pid, LOT_LEAF_BUF);
+        if (w->e < eNOERROR) break;
+    }
+
+    return(NULL);
+}
+
+/*@================================
+ * edubfm_bench_MultiThreadedFix()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_MultiThreadedFix(Four, Four, char *)
+ *
+ * Description:
+ *  Measure the fixes per second of 1, 2, 4, ... threads which fix and
+ *  unfix trains resident in the LOT_LEAF_BUF pool, once with one latched
+ *  partition (a global latch) and once with MTFIX_NPARTITIONS partitions,
+ *  each with the latch taken by every fix and with the trains fixed
+ *  without the latch (edubfm_cfgParams.useOptimisticFix).
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_MultiThreadedFix(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of operations per thread */
+    char        *arg)                   /* IN not used */
+{
+    Four        e;                      /* for errors */
+    Four        i, t;                   /* loop index */
+    Four        nThreads;               /* # of threads */
+    Four        nParts;                 /* # of partitions */
+    Four        c;                      /* configuration */
+    double      start, elapsed;         /* time */
+    char        *buf;
+    MtFixWorker workers[BENCH_MAX_THREADS];
+
+    printf("%12s %10s %10s %16s\n", "partitions", "latch", "threads", "fixes/sec");
+
+    for (c = 0; c < 4; c++) {
+
+        nParts = (c % 2 == 0) ? 1 : MTFIX_NPARTITIONS;
+        edubfm_cfgParams.nPartitions = nParts;
+        edubfm_cfgParams.useOptimisticFix = (c >= 2);
+        e = EduBfM_Init();
+        if (e < eNOERROR) ERR(e);
+
+        /* warm up the buffer pool */
+        for (i = 0; i < BENCH_NTRAINS; i++) {
+            e = EduBfM_GetTrain(&benchTrains[i], &buf, LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+            e = EduBfM_FreeTrain(&benchTrains[i], LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        for (nThreads = 1; nThreads <= 8; nThreads *= 2) {
+            start = edubfm_bench_Now();
+
+            for (t = 0; t < nThreads; t++) {
+                workers[t].seed = t + 1;
+                workers[t].nOps = nOps;
+                workers[t].e = eNOERROR;
+                pthread_create(&workers[t].thread, NULL, edubfm_bench_MtFixWorker, &workers[t]);
+            }
+            for (t = 0; t < nThreads; t++) {
+                pthread_join(workers[t].thread, NULL);
+                if (workers[t].e < eNOERROR) ERR(workers[t].e);
+            }
+
+            elapsed = edubfm_bench_Now() - start;
+            printf("%12d %10s %10d %16.0f\n", nParts, (c >= 2) ? "no" : "yes", nThreads, (double)nOps * nThreads / elapsed);
+        }
+
+        e = EduBfM_Final();
+        if (e < eNOERROR) ERR(e);
+    }
+
+    edubfm_cfgParams.nPartitions = 0;
+    edubfm_cfgParams.useOptimisticFix = FALSE;
+
+    return(eNOERROR);
+
+} /* edubfm_bench_MultiThreadedFix() */
+
+
+
+/*
+ * Benchmark "policy" : hit ratio of the replacement policies on a trace
+ */
+
+/* synthetic trace : skewed probes of a hot set mixed with scans of a cold set larger than the buffer pool */
+#define POLICY_HOT_TRAINS   2000
+#define POLICY_COLD_TRAINS  8000
+#define POLICY_HOT_PERCENT  70
+
+typedef struct {
+    Four        type;                   /* buffer type */
+    Four        key;                    /* train number in the trace, then index of benchTrains of the type */
+} TraceEntry;
+
+/* compare two keys for qsort() and bsearch() */
+static int edubfm_bench_CompareKeys(
+    const void  *a,
+    const void  *b)
+{
+    Four        x = *(const Four *)a, y = *(const Four *)b;
+
+    return((x > y) - (x < y));
+}
+
+/* compare the pages of two TracePage entries for qsort() */
+typedef struct {
+    PageID      pid;                    /* page/train of a fix */
+    Four        pos;                    /* its entry of the trace */
+} TracePage;
+
+static int edubfm_bench_ComparePages(
+    const void  *a,
+    const void  *b)
+{
+    const PageID *x = &((const TracePage *)a)->pid, *y = &((const TracePage *)b)->pid;
+
+    if (x->volNo != y->volNo) return((x->volNo > y->volNo) - (x->volNo < y->volNo));
+    return((x->pageNo > y->pageNo) - (x->pageNo < y->pageNo));
+}
+
+/*@================================
+ * edubfm_bench_LoadBinaryTrace()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_LoadBinaryTrace(FILE *, TraceEntry **, Four *)
+ *
+ * Description:
+ *  Read the fixes (hits and misses) of a trace file written by EduBfM
+ *  (edubfm_cfgParams.traceFile), whose header has been checked by the
+ *  caller. The distinct pages/trains are numbered from 0 in the order of
+ *  their volumes and page numbers.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ *    eBADPARAMETER_EDUBFM - A record has an invalid buffer type.
+ */
+static Four edubfm_bench_LoadBinaryTrace(
+    FILE        *fp,                    /* IN trace file, positioned after the header */
+    TraceEntry  **trace,                /* OUT trace */
+    Four        *nEntries)              /* OUT # of entries of the trace */
+{
+    Four        i, n, max, nRead;       /* # of entries, allocated entries, # of records read */
+    Four        key;
+    TraceEntry  *t;
+    TracePage   *pages;                 /* page/train of each entry */
+    EduBfM_TraceRecord records[TRACE_BUFFER_SIZE];
+
+    n = 0;
+    max = 1024;
+    t = (TraceEntry *)malloc(sizeof(TraceEntry) * max);
+    pages = (TracePage *)malloc(sizeof(TracePage) * max);
+
+    while (t != NULL && pages != NULL &&
+           (nRead = fread(records, sizeof(EduBfM_TraceRecord), TRACE_BUFFER_SIZE, fp)) > 0) {
+        for (i = 0; i < nRead; i++) {
+            if (records[i].op != BFM_TRACE_FIXHIT && records[i].op != BFM_TRACE_FIXMISS) continue;
+
+            if (IS_BAD_BUFFERTYPE(records[i].type)) {
+                free(t);
+                free(pages);
+                ERR(eBADPARAMETER_EDUBFM);
+            }
+
+            if (n == max) {
+                max *= 2;
+                t = (TraceEntry *)realloc(t, sizeof(TraceEntry) * max);
+                pages = (TracePage *)realloc(pages, sizeof(TracePage) * max);
+                if (t == NULL || pages == NULL) break;
+            }
+            t[n].type = records[i].type;
+            pages[n].pid.volNo = records[i].volNo;
+            pages[n].pid.pageNo = records[i].pageNo;
+            pages[n].pos = n;
+            n++;
+        }
+    }
+
+    if (t == NULL || pages == NULL) {
+        free(t);
+        free(pages);
+        ERR(eMEMALLOCERR_EDUBFM);
+    }
+
+    // 같은 page/train의 fix들이 같은 번호를 갖도록, 정렬한 순서로 번호를 붙임
+    qsort(pages, n, sizeof(TracePage), edubfm_bench_ComparePages);
+    for (key = -1, i = 0; i < n; i++) {
+        if (i == 0 || edubfm_bench_ComparePages(&pages[i - 1], &pages[i]) != 0) key++;
+        t[pages[i].pos].key = key;
+    }
+    free(pages);
+
+    *trace = t;
+    *nEntries = n;
+
+    return(eNOERROR);
+
+} /* edubfm_bench_LoadBinaryTrace() */
+
+/*@================================
+ * edubfm_bench_LoadTrace()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_LoadTrace(char *, Four, TraceEntry **, Four *)
+ *
+ * Description:
+ *  Read the trace file, each line of which is "<buffer type> <train number>"
+ *  or "<train number>" (LOT_LEAF_BUF), or which is a binary trace written
+ *  by EduBfM (see edubfm_bench_LoadBinaryTrace()). If 'fileName' is NULL, a synthetic
+ *  trace of 'nOps' accesses to LOT_LEAF_BUF is generated instead: each
+ *  access probes the hot set with a skewed distribution with the
+ *  probability POLICY_HOT_PERCENT, and reads the next train of a scan
+ *  over the cold set otherwise.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ *    eBADPARAMETER_EDUBFM - The trace file cannot be read.
+ */
+static Four edubfm_bench_LoadTrace(
+    char        *fileName,              /* IN trace file (NULL : synthetic trace) */
+    Four        nOps,                   /* IN # of accesses of the synthetic trace */
+    TraceEntry  **trace,                /* OUT trace */
+    Four        *nEntries)              /* OUT # of entries of the trace */
+{
+    Four        e;                      /* for errors */
+    FILE        *fp;
+    Four        n, max;                 /* # of entries, allocated entries */
+    Four        a, b;                   /* fields of a line */
+    char        line[256];
+    EduBfM_TraceHeader header;          /* header of a binary trace */
+    UFour       seed = 1;               /* seed of the random number generator */
+    Four        scan = 0;               /* position of the scan over the cold set */
+    double      u;
+    TraceEntry  *t;
+
+    if (fileName == NULL) {
+        t = (TraceEntry *)malloc(sizeof(TraceEntry) * MAX(nOps, 1));
+        if (t == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+        for (n = 0; n < nOps; n++) {
+            t[n].type = LOT_LEAF_BUF;
+            if (rand_r(&seed) % 100 < POLICY_HOT_PERCENT) {
+                u = (double)rand_r(&seed) / ((double)RAND_MAX + 1);
+                t[n].key = (Four)(u * u * POLICY_HOT_TRAINS);
+            }
+            else {
+                t[n].key = POLICY_HOT_TRAINS + scan;
+                scan = (scan + 1) % POLICY_COLD_TRAINS;
+            }
+        }
+
+        *trace = t;
+        *nEntries = nOps;
+        return(eNOERROR);
+    }
+
+    fp = fopen(fileName, "r");
+    if (fp == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    // EduBfM이 기록한 binary trace인 경우, 그 fix들을 읽음
+    if (fread(&header, sizeof(header), 1, fp) == 1 && memcmp(header.magic, BFM_TRACE_MAGIC, sizeof(header.magic)) == 0) {
+        if (header.pageSize != PAGESIZE || header.nTypes != NUM_BUF_TYPES) {
+            fclose(fp);
+            ERR(eBADPARAMETER_EDUBFM);
+        }
+        e = edubfm_bench_LoadBinaryTrace(fp, trace, nEntries);
+        fclose(fp);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
+    rewind(fp);
+
+    n = 0;
+    max = 1024;
+    t = (TraceEntry *)malloc(sizeof(TraceEntry) * max);
+
+    while (t != NULL && fgets(line, sizeof(line), fp) != NULL) {
+        switch (sscanf(line, "%d %d", &a, &b)) {
+          case 1:
+            b = a;
+            a = LOT_LEAF_BUF;
+            break;
+          case 2:
+            break;
+          default:
+            continue;           /* empty line or comment */
+        }
+
+        if (IS_BAD_BUFFERTYPE(a) || b < 0) {
+            fclose(fp);
+            free(t);
+            ERR(eBADPARAMETER_EDUBFM);
+        }
+
+        if (n == max) {
+            max *= 2;
+            t = (TraceEntry *)realloc(t, sizeof(TraceEntry) * max);
+            if (t == NULL) break;
+        }
+        t[n].type = a;
+        t[n].key = b;
+        n++;
+    }
+    fclose(fp);
+
+    if (t == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    *trace = t;
+    *nEntries = n;
+
+    return(eNOERROR);
+
+} /* edubfm_bench_LoadTrace() */
+
+/*@================================
+ * edubfm_bench_PrepareTrace()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_PrepareTrace(Four, TraceEntry *, Four, Four *, PageID **)
+ *
+ * Description:
+ *  Number the distinct train numbers of each buffer type of the trace from
+ *  0 in ascending order, replacing the train numbers of the entries by
+ *  them, and map them to as many trains allocated in the benchmark volume.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ *    eBADPARAMETER_EDUBFM - The trace has too many distinct trains.
+ */
+static Four edubfm_bench_PrepareTrace(
+    Four        volId,                  /* IN volume id */
+    TraceEntry  *trace,                 /* INOUT trace */
+    Four        nEntries,               /* IN # of entries of the trace */
+    Four        *nKeys,                 /* OUT # of distinct train numbers of each type */
+    PageID      **trains)               /* OUT trains mapped to the train numbers of each type */
+{
+    Four        e;                      /* for errors */
+    Four        i, type;
+    Four        *keys;                  /* distinct train numbers of a type, sorted */
+
+    keys = (Four *)malloc(sizeof(Four) * MAX(nEntries, 1));
+    if (keys == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        nKeys[type] = 0;
+        for (i = 0; i < nEntries; i++)
+            if (trace[i].type == type) keys[nKeys[type]++] = trace[i].key;
+
+        qsort(keys, nKeys[type], sizeof(Four), edubfm_bench_CompareKeys);
+        for (i = 1, e = MIN(nKeys[type], 1); i < nKeys[type]; i++)
+            if (keys[i] != keys[e-1]) keys[e++] = keys[i];
+        nKeys[type] = e;
+
+        for (i = 0; i < nEntries; i++)
+            if (trace[i].type == type)
+                trace[i].key = (Four *)bsearch(&trace[i].key, keys, nKeys[type], sizeof(Four), edubfm_bench_CompareKeys) - keys;
+
+        if (nKeys[type] > BENCH_MAX_TRACETRAINS) {
+            free(keys);
+            ERR(eBADPARAMETER_EDUBFM);
+        }
+
+        trains[type] = (PageID *)malloc(sizeof(PageID) * MAX(nKeys[type], 1));
+        if (trains[type] == NULL) {
+            free(keys);
+            ERR(eMEMALLOCERR_EDUBFM);
+        }
+
+        if (nKeys[type] > 0) {
+            e = edubfm_bench_AllocTrains(volId, nKeys[type], BI_BUFSIZE(type), trains[type]);
+            if (e < eNOERROR) {
+                free(keys);
+                ERR(e);
+            }
+        }
+    }
+
+    free(keys);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_PrepareTrace() */
+
+/*@================================
+ * edubfm_bench_PolicyHitRatio()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_PolicyHitRatio(Four, Four, char *)
+ *
+ * Description:
+ *  Replay a trace (the file 'arg', which may be a binary trace written by
+ *  EduBfM, or the synthetic trace of 'nOps' accesses) with each replacement
+ *  policy, starting from an empty buffer pool, and print the hit ratio of
+ *  each buffer type. The distinct train numbers of the trace are mapped to
+ *  trains allocated in the benchmark volume; each access fixes and unfixes
+ *  the train.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - The trace has too many distinct trains.
+ */
+Four edubfm_bench_PolicyHitRatio(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of accesses of the synthetic trace */
+    char        *arg)                   /* IN trace file (NULL : synthetic trace) */
+{
+    Four        e;                      /* for errors */
+    Four        i, type, policy;
+    TraceEntry  *trace;                 /* trace */
+    Four        nEntries;               /* # of entries of the trace */
+    Four        nKeys[NUM_BUF_TYPES];   /* # of distinct train numbers of each type */
+    PageID      *trains[NUM_BUF_TYPES]; /* trains mapped to the train numbers */
+    Four        nAccesses[NUM_BUF_TYPES];
+    Four        nHits[NUM_BUF_TYPES];
+    char        *buf;
+    double      start, elapsed;         /* time */
+
+    e = edubfm_bench_LoadTrace(arg, nOps, &trace, &nEntries);
+    if (e < eNOERROR) ERR(e);
+
+    /* map the train numbers of each type to the trains of the benchmark volume */
+    e = edubfm_bench_PrepareTrace(volId, trace, nEntries, nKeys, trains);
+    if (e < eNOERROR) ERR(e);
+
+    printf("%d accesses, %d distinct pages, %d distinct trains\n", nEntries, nKeys[PAGE_BUF], nKeys[LOT_LEAF_BUF]);
+    printf("%8s %14s %14s %12s\n", "policy", "PAGE_BUF hit", "LOT_LEAF hit", "accesses/sec");
+
+    for (policy = 0; policy < NUM_BFM_POLICIES; policy++) {
+
+        /* start from an empty buffer pool */
+        e = EduBfM_FlushAll();
+        if (e < eNOERROR) ERR(e);
+        e = EduBfM_DiscardAll();
+        if (e < eNOERROR) ERR(e);
+
+        for (type = 0; type < NUM_BUF_TYPES; type++) {
+            edubfm_cfgParams.replacementPolicy[type] = policy;
+            nAccesses[type] = nHits[type] = 0;
+        }
+        e = EduBfM_Init();
+        if (e < eNOERROR) ERR(e);
+
+        start = edubfm_bench_Now();
+
+        for (i = 0; i < nEntries; i++) {
+            type = trace[i].type;
+
+            nAccesses[type]++;
+            if (edubfm_LookUp((BfMHashKey *)&trains[type][trace[i].key], type) != NOTFOUND_IN_HTABLE) nHits[type]++;
+
+            e = EduBfM_GetTrain(&trains[type][trace[i].key], &buf, type);
+            if (e < eNOERROR) ERR(e);
+            e = EduBfM_FreeTrain(&trains[type][trace[i].key], type);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        elapsed = edubfm_bench_Now() - start;
+
+        printf("%8s %13.2f%% %13.2f%% %12.0f\n", edubfm_policies[policy].name,
+               100.0 * nHits[PAGE_BUF] / MAX(nAccesses[PAGE_BUF], 1),
+               100.0 * nHits[LOT_LEAF_BUF] / MAX(nAccesses[LOT_LEAF_BUF], 1),
+               nEntries / elapsed);
+
+        e = EduBfM_Final();
+        if (e < eNOERROR) ERR(e);
+    }
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        edubfm_cfgParams.replacementPolicy[type] = BFM_CLOCK;
+        free(trains[type]);
+    }
+    free(trace);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_PolicyHitRatio() */
+
+
+
+/*
+ * Benchmark "pagetable" : look-up speed of the chained hash table and the open addressing page table
+ */
+
+/* key patterns of the resident pages/trains */
+#define PT_SEQUENTIAL       0       /* consecutive trains of one volume */
+#define PT_MULTIVOLUME      1       /* the same page range on PT_NVOLUMES volumes */
+#define PT_NVOLUMES         8
+
+/*@================================
+ * edubfm_bench_PageTableLookUp()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_PageTableLookUp(Four, Four, char *)
+ *
+ * Description:
+ *  Fill the bufTable of the LOT_LEAF_BUF pool with synthetic keys (without
+ *  reading any train) of each key pattern, and measure the look-ups per
+ *  second of resident keys (hit) and of absent keys next to them (miss),
+ *  once with each page table. The buffer pool is emptied afterwards.
+ *
+ * Returns:
+ *  error code
+ *    eNOTFOUND_BFM - A page table lost a key.
+ */
+Four edubfm_bench_PageTableLookUp(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of look-ups of each kind */
+    char        *arg)                   /* IN not used */
+{
+    Four        e;                      /* for errors */
+    Four        i, n, pattern, table, miss;
+    Four        nBufs;                  /* # of buffers */
+    BfMHashKey  key;
+    UFour       seed;                   /* seed of the random number generator */
+    Four        found;                  /* # of keys found */
+    double      start, rate[2];         /* look-ups per second of hits and misses */
+    static char *tableNames[] = { "chained", "open" };
+    static char *patternNames[] = { "sequential", "multi-volume" };
+
+    nBufs = BI_NBUFS(LOT_LEAF_BUF);
+
+    printf("%14s %8s %16s %16s\n", "keys", "table", "hit/sec", "miss/sec");
+
+    for (pattern = PT_SEQUENTIAL; pattern <= PT_MULTIVOLUME; pattern++) {
+        for (table = BFM_CHAINED_TABLE; table <= BFM_OPEN_TABLE; table++) {
+
+            e = EduBfM_FlushAll();
+            if (e < eNOERROR) ERR(e);
+            e = EduBfM_DiscardAll();
+            if (e < eNOERROR) ERR(e);
+
+            edubfm_cfgParams.pageTable = table;
+            e = EduBfM_Init();
+            if (e < eNOERROR) ERR(e);
+
+            /* store the synthetic keys in the bufTable (the i-th key in the i-th buffer) */
+            for (i = 0; i < nBufs; i++) {
+                if (pattern == PT_SEQUENTIAL) {
+                    BI_KEY(LOT_LEAF_BUF, i).volNo = volId;
+                    BI_KEY(LOT_LEAF_BUF, i).pageNo = i * BI_BUFSIZE(LOT_LEAF_BUF);
+                }
+                else {
+                    BI_KEY(LOT_LEAF_BUF, i).volNo = volId + i % PT_NVOLUMES;
+                    BI_KEY(LOT_LEAF_BUF, i).pageNo = (i / PT_NVOLUMES) * BI_BUFSIZE(LOT_LEAF_BUF);
+                }
+                BI_NEXTHASHENTRY(LOT_LEAF_BUF, i) = NIL;
+
+                e = edubfm_Insert(&BI_KEY(LOT_LEAF_BUF, i), i, LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+            }
+
+            for (miss = 0; miss <= 1; miss++) {
+                seed = 1;
+                found = 0;
+                start = edubfm_bench_Now();
+
+                for (n = 0; n < nOps; n++) {
+                    key = BI_KEY(LOT_LEAF_BUF, rand_r(&seed) % nBufs);
+                    key.pageNo += miss;
+
+                    if (edubfm_LookUp(&key, LOT_LEAF_BUF) != NOTFOUND_IN_HTABLE) found++;
+                }
+
+                rate[miss] = nOps / (edubfm_bench_Now() - start);
+                if (found != (miss ? 0 : nOps)) ERR(eNOTFOUND_BFM);
+            }
+
+            printf("%14s %8s %16.0f %16.0f\n", patternNames[pattern], tableNames[table], rate[0], rate[1]);
+
+            /* remove the synthetic keys */
+            for (i = 0; i < nBufs; i++) {
+                e = edubfm_Delete(&BI_KEY(LOT_LEAF_BUF, i), LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+                SET_NILBFMHASHKEY(BI_KEY(LOT_LEAF_BUF, i));
+            }
+
+            e = EduBfM_Final();
+            if (e < eNOERROR) ERR(e);
+        }
+    }
+
+    edubfm_cfgParams.pageTable = BFM_CHAINED_TABLE;
+
+    return(eNOERROR);
+
+} /* edubfm_bench_PageTableLookUp() */
+
+
+
+/*
+ * Benchmark "bgwriter" : synchronous writes of the replaced dirty trains with and without the background writer
+ */
+
+/* # of trains updated, relative to the # of buffers */
+#define BGW_TRAINS_PER_BUFFER   2
+/* % of the fixes which modify the train */
+#define BGW_DIRTY_PERCENT       50
+
+/*@================================
+ * edubfm_bench_BgWriter()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_BgWriter(Four, Four, char *)
+ *
+ * Description:
+ *  Fix random trains from a set twice as large as the LOT_LEAF_BUF pool,
+ *  modifying BGW_DIRTY_PERCENT % of them, with one latched partition and
+ *  the background writer keeping 0 (off), 50 and 90 % of the unfixed
+ *  buffers clean every msec. The fixes per second and the writer counters are printed.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_BgWriter(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of fixes */
+    char        *arg)                   /* IN not used */
+{
+    Four        e;                      /* for errors */
+    Four        i, n, round;
+    Four        nTrains;                /* # of trains */
+    PageID      *trains;
+    BfMFrameHandle handle;
+    UFour       seed;                   /* seed of the random number generator */
+    char        *buf;
+    double      start, elapsed;         /* time */
+    EduBfM_WriterStats stats;
+    static Four cleanPercents[] = { 0, 50, 90 };
+
+    nTrains = BI_NBUFS(LOT_LEAF_BUF) * BGW_TRAINS_PER_BUFFER;
+    trains = (PageID *)malloc(sizeof(PageID) * nTrains);
+    if (trains == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    e = edubfm_bench_AllocTrains(volId, nTrains, BI_BUFSIZE(LOT_LEAF_BUF), trains);
+    if (e < eNOERROR) ERR(e);
+
+    printf("%8s %12s %12s %12s %12s\n", "clean %", "fixes/sec", "evictions", "sync writes", "bg writes");
+
+    for (round = 0; round < sizeof(cleanPercents) / sizeof(Four); round++) {
+
+        e = EduBfM_FlushAll();
+        if (e < eNOERROR) ERR(e);
+        e = EduBfM_DiscardAll();
+        if (e < eNOERROR) ERR(e);
+
+        edubfm_cfgParams.nPartitions = 1;
+        edubfm_cfgParams.bgWriterCleanPercent = cleanPercents[round];
+        edubfm_cfgParams.bgWriterInterval = 1;
+        e = EduBfM_Init();
+        if (e < eNOERROR) ERR(e);
+
+        seed = 1;
+        start = edubfm_bench_Now();
+
+        for (n = 0; n < nOps; n++) {
+            i = rand_r(&seed) % nTrains;
+
+            e = EduBfM_GetFrame(&trains[i], &buf, LOT_LEAF_BUF, &handle);
+            if (e < eNOERROR) ERR(e);
+
+            if (rand_r(&seed) % 100 < BGW_DIRTY_PERCENT) {
+                buf[PAGESIZE - 1]++;
+                e = EduBfM_SetDirtyFrame(&handle);
+                if (e < eNOERROR) ERR(e);
+            }
+
+            e = EduBfM_FreeFrame(&handle);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        elapsed = edubfm_bench_Now() - start;
+
+        e = EduBfM_GetWriterStats(&stats);
+        if (e < eNOERROR) ERR(e);
+
+        printf("%8d %12.0f %12u %12u %12u\n", cleanPercents[round], nOps / elapsed,
+               stats.nEvictions, stats.nSyncWrites, stats.nBgWrites);
+
+        e = EduBfM_Final();
+        if (e < eNOERROR) ERR(e);
+    }
+
+    edubfm_cfgParams.nPartitions = 0;
+    edubfm_cfgParams.bgWriterCleanPercent = 0;
+    edubfm_cfgParams.bgWriterInterval = 0;
+    free(trains);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_BgWriter() */
+
+
+
+/*
+ * Benchmark "bulkflush" : EduBfM_FlushAll() of a buffer pool full of dirty trains with and without the bulk flush
+ */
+
+extern CfgParams_T sm_cfgParams;
+
+/*@================================
+ * edubfm_bench_BulkFlush()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_BulkFlush(Four, Four, char *)
+ *
+ * Description:
+ *  Modify as many trains as the LOT_LEAF_BUF pool holds, in a random order,
+ *  and time EduBfM_FlushAll() without and with sm_cfgParams.useBulkFlush
+ *  (the benchmark volume is attached). The trains are read back after each
+ *  flush to check that they were written to their places.
+ *  The elapsed time, the # of trains written and the # of write requests are printed.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_BulkFlush(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN not used */
+    char        *arg)                   /* IN not used */
+{
+    Four        e;                      /* for errors */
+    Four        i, j, tmp, round;
+    Four        nTrains;                /* # of trains */
+    PageID      *trains;
+    Four        *order;                 /* order of the modification */
+    UFour       seed;                   /* seed of the random number generator */
+    char        *buf;
+    double      start, elapsed;         /* time */
+    EduBfM_WriterStats before, after;
+    Boolean     savedUseBulkFlush = sm_cfgParams.useBulkFlush;
+
+    nTrains = BI_NBUFS(LOT_LEAF_BUF);
+    trains = (PageID *)malloc(sizeof(PageID) * nTrains);
+    order = (Four *)malloc(sizeof(Four) * nTrains);
+    if (trains == NULL || order == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    e = edubfm_bench_AllocTrains(volId, nTrains, BI_BUFSIZE(LOT_LEAF_BUF), trains);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_AttachVolume(volId, BENCH_VOLUME_NAME);
+    if (e < eNOERROR) ERR(e);
+
+    printf("%10s %12s %12s %12s\n", "bulk flush", "msec", "trains", "writes");
+
+    for (round = 0; round < 2; round++) {
+
+        e = EduBfM_FlushAll();
+        if (e < eNOERROR) ERR(e);
+        e = EduBfM_DiscardAll();
+        if (e < eNOERROR) ERR(e);
+
+        // 모든 train을 임의의 순서로 수정함
+        for (i = 0; i < nTrains; i++) order[i] = i;
+        for (seed = 1, i = nTrains - 1; i > 0; i--) {
+            j = rand_r(&seed) % (i + 1);
+            tmp = order[i]; order[i] = order[j]; order[j] = tmp;
+        }
+
+        for (i = 0; i < nTrains; i++) {
+            e = EduBfM_GetTrain(&trains[order[i]], &buf, LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+
+            memset(buf, round + 1, PAGESIZE * BI_BUFSIZE(LOT_LEAF_BUF));
+            memcpy(buf, &order[i], sizeof(Four));
+
+            e = EduBfM_SetDirty(&trains[order[i]], LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+            e = EduBfM_FreeTrain(&trains[order[i]], LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        e = EduBfM_GetWriterStats(&before);
+        if (e < eNOERROR) ERR(e);
+
+        sm_cfgParams.useBulkFlush = (round == 1);
+        start = edubfm_bench_Now();
+
+        e = EduBfM_FlushAll();
+
+        elapsed = edubfm_bench_Now() - start;
+        sm_cfgParams.useBulkFlush = savedUseBulkFlush;
+        if (e < eNOERROR) ERR(e);
+
+        e = EduBfM_GetWriterStats(&after);
+        if (e < eNOERROR) ERR(e);
+
+        printf("%10s %12.2f %12u %12u\n", (round == 1) ? "on" : "off", elapsed * 1000,
+               after.nFlushedTrains - before.nFlushedTrains, after.nFlushWrites - before.nFlushWrites);
+
+        // 기록된 train들을 disk로부터 다시 읽어 확인함
+        e = EduBfM_DiscardAll();
+        if (e < eNOERROR) ERR(e);
+
+        for (i = 0; i < nTrains; i++) {
+            e = EduBfM_GetTrain(&trains[i], &buf, LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+
+            memcpy(&tmp, buf, sizeof(Four));
+            if (tmp != i || buf[PAGESIZE * BI_BUFSIZE(LOT_LEAF_BUF) - 1] != round + 1) {
+                printf("train {%d, %d} was not written correctly\n", trains[i].volNo, trains[i].pageNo);
+                ERR(eVOLUMEIOERR_EDUBFM);
+            }
+
+            e = EduBfM_FreeTrain(&trains[i], LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+        }
+    }
+
+    e = EduBfM_DetachVolume(volId);
+    if (e < eNOERROR) ERR(e);
+
+    free(order);
+    free(trains);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_BulkFlush() */
+
+
+
+/*
+ * Benchmark "readahead" : sequential, strided and random scans with and without the read-ahead
+ */
+
+/* # of trains scanned, relative to the # of buffers */
+#define RA_TRAINS_PER_BUFFER    2
+/* max. read-ahead window compared with no read-ahead */
+#define RA_MAX_WINDOW           32
+
+/*@================================
+ * edubfm_bench_ReadAhead()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_ReadAhead(Four, Four, char *)
+ *
+ * Description:
+ *  Fix and free nOps trains (at least one pass) from a set twice as large as
+ *  the LOT_LEAF_BUF pool, sequentially, every other train and randomly, with
+ *  the read-ahead off and with the window up to RA_MAX_WINDOW trains
+ *  ('arg' if given). The fixes per second and the read-ahead counters are printed.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_ReadAhead(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of fixes */
+    char        *arg)                   /* IN max. read-ahead window */
+{
+    Four        e;                      /* for errors */
+    Four        i, n, pattern, round;
+    Four        nTrains;                /* # of trains */
+    PageID      *trains;
+    UFour       seed;                   /* seed of the random number generator */
+    char        *buf;
+    double      start, elapsed;         /* time */
+    EduBfM_ReadAheadStats stats;
+    Four        windows[2];
+    static char *patterns[] = { "sequential", "strided", "random" };
+
+    windows[0] = 0;
+    windows[1] = (arg != NULL) ? atoi(arg) : RA_MAX_WINDOW;
+
+    nTrains = BI_NBUFS(LOT_LEAF_BUF) * RA_TRAINS_PER_BUFFER;
+    trains = (PageID *)malloc(sizeof(PageID) * nTrains);
+    if (trains == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    e = edubfm_bench_AllocTrains(volId, nTrains, BI_BUFSIZE(LOT_LEAF_BUF), trains);
+    if (e < eNOERROR) ERR(e);
+
+    nOps = MAX(nOps, nTrains);
+
+    printf("%12s %8s %12s %12s %12s %12s\n", "pattern", "window", "fixes/sec", "read-aheads", "hits", "wasted");
+
+    for (pattern = 0; pattern < sizeof(patterns) / sizeof(char *); pattern++) {
+        for (round = 0; round < 2; round++) {
+
+            e = EduBfM_FlushAll();
+            if (e < eNOERROR) ERR(e);
+            e = EduBfM_DiscardAll();
+            if (e < eNOERROR) ERR(e);
+
+            edubfm_cfgParams.readAheadMaxWindow = windows[round];
+            e = EduBfM_Init();
+            if (e < eNOERROR) ERR(e);
+
+            seed = 1;
+            start = edubfm_bench_Now();
+
+            for (n = 0; n < nOps; n++) {
+                if (pattern == 0) i = n % nTrains;
+                else if (pattern == 1) i = (n * 2) % nTrains + (n * 2 / nTrains) % 2;
+                else i = rand_r(&seed) % nTrains;
+
+                e = EduBfM_GetTrain(&trains[i], &buf, LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+
+                e = EduBfM_FreeTrain(&trains[i], LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+            }
+
+            elapsed = edubfm_bench_Now() - start;
+
+            e = EduBfM_GetReadAheadStats(&stats);
+            if (e < eNOERROR) ERR(e);
+            if (windows[round] == 0) stats.nReadAheads = stats.nReadAheadHits = stats.nReadAheadWasted = 0;
+
+            printf("%12s %8d %12.0f %12u %12u %12u\n", patterns[pattern], windows[round], nOps / elapsed,
+                   stats.nReadAheads, stats.nReadAheadHits, stats.nReadAheadWasted);
+
+            e = EduBfM_Final();
+            if (e < eNOERROR) ERR(e);
+        }
+    }
+
+    edubfm_cfgParams.readAheadMaxWindow = 0;
+    free(trains);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_ReadAhead() */
+
+
+
+/*
+ * Benchmark "prefetch" : batches of random trains fixed one by one and by EduBfM_GetTrains()
+ */
+
+/* # of trains fixed together */
+#define PF_BATCH                16
+/* # of trains accessed, relative to the # of buffers */
+#define PF_TRAINS_PER_BUFFER    4
+
+/*@================================
+ * edubfm_bench_Prefetch()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_Prefetch(Four, Four, char *)
+ *
+ * Description:
+ *  Fix and free batches of PF_BATCH random trains from a set four times as
+ *  large as the LOT_LEAF_BUF pool, nOps trains in total, with EduBfM_GetTrain()
+ *  per train and with EduBfM_GetTrains() using 1 and 'arg' (default 4)
+ *  I/O threads. The benchmark volume is attached, so the I/O threads read
+ *  its device concurrently. The fixes per second and the read-ahead counters are printed.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_Prefetch(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of fixes */
+    char        *arg)                   /* IN # of I/O threads */
+{
+    Four        e;                      /* for errors */
+    Four        i, n, round;
+    Four        nTrains;                /* # of trains */
+    PageID      *trains;
+    PageID      batch[PF_BATCH];
+    char        *bufs[PF_BATCH];
+    UFour       seed;                   /* seed of the random number generator */
+    double      start, elapsed;         /* time */
+    EduBfM_ReadAheadStats stats;
+    Four        nThreads[3];
+
+    nThreads[0] = 0;
+    nThreads[1] = 1;
+    nThreads[2] = (arg != NULL) ? atoi(arg) : 4;
+
+    nTrains = BI_NBUFS(LOT_LEAF_BUF) * PF_TRAINS_PER_BUFFER;
+    trains = (PageID *)malloc(sizeof(PageID) * nTrains);
+    if (trains == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    e = edubfm_bench_AllocTrains(volId, nTrains, BI_BUFSIZE(LOT_LEAF_BUF), trains);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_AttachVolume(volId, BENCH_VOLUME_NAME);
+    if (e < eNOERROR) ERR(e);
+
+    printf("%12s %12s %12s %12s\n", "I/O threads", "fixes/sec", "prefetches", "hits");
+
+    for (round = 0; round < 3; round++) {
+
+        e = EduBfM_FlushAll();
+        if (e < eNOERROR) ERR(e);
+        e = EduBfM_DiscardAll();
+        if (e < eNOERROR) ERR(e);
+
+        edubfm_cfgParams.nIOThreads = nThreads[round];
+        edubfm_cfgParams.nPartitions = 1;
+        e = EduBfM_Init();
+        if (e < eNOERROR) ERR(e);
+
+        seed = 1;
+        start = edubfm_bench_Now();
+
+        for (n = 0; n < nOps; n += PF_BATCH) {
+            for (i = 0; i < PF_BATCH; i++) batch[i] = trains[rand_r(&seed) % nTrains];
+
+            if (nThreads[round] == 0) {
+                for (i = 0; i < PF_BATCH; i++) {
+                    e = EduBfM_GetTrain(&batch[i], &bufs[i], LOT_LEAF_BUF);
+                    if (e < eNOERROR) ERR(e);
+                }
+            }
+            else {
+                e = EduBfM_GetTrains(batch, bufs, PF_BATCH, LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+            }
+
+            for (i = 0; i < PF_BATCH; i++) {
+                e = EduBfM_FreeTrain(&batch[i], LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+            }
+        }
+
+        elapsed = edubfm_bench_Now() - start;
+
+        e = EduBfM_GetReadAheadStats(&stats);
+        if (e < eNOERROR) ERR(e);
+        if (nThreads[round] == 0) stats.nReadAheads = stats.nReadAheadHits = 0;
+
+        printf("%12d %12.0f %12u %12u\n", nThreads[round], n / elapsed, stats.nReadAheads, stats.nReadAheadHits);
+
+        e = EduBfM_Final();
+        if (e < eNOERROR) ERR(e);
+    }
+
+    edubfm_cfgParams.nIOThreads = 0;
+    edubfm_cfgParams.nPartitions = 0;
+
+    e = EduBfM_DetachVolume(volId);
+    if (e < eNOERROR) ERR(e);
+
+    free(trains);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_Prefetch() */
+
+
+
+/*
+ * Benchmark "ring" : a large scan with and without the sequential scan ring
+ */
+
+/* # of hot trains, relative to the # of buffers */
+#define RING_HOT_PERCENT        25
+/* # of trains scanned, relative to the # of buffers */
+#define RING_SCAN_PER_BUFFER    2
+
+/*@================================
+ * edubfm_bench_Ring()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_Ring(Four, Four, char *)
+ *
+ * Description:
+ *  Fix a hot set of trains (RING_HOT_PERCENT % of the LOT_LEAF_BUF pool)
+ *  so that it is in the buffer pool, scan twice as many other trains as
+ *  the pool holds with BFM_ACCESS_NORMAL and BFM_ACCESS_SEQSCAN, and count
+ *  how many hot trains are still in the buffer pool after the scan.
+ *  Each hot train is fixed nOps / (# of hot trains) times (at least once)
+ *  before the scan. The LOT_LEAF_BUF pool uses the replacement policy
+ *  numbered 'arg' (BFM_CLOCK if omitted). The scan rate is printed, too.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_Ring(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of fixes of the hot trains */
+    char        *arg)                   /* IN replacement policy */
+{
+    Four        e;                      /* for errors */
+    Four        i, n, round;
+    Four        policy;                 /* replacement policy */
+    Four        nHot, nScan;            /* # of hot trains and # of trains scanned */
+    Four        nResident;              /* # of hot trains in the buffer pool after the scan */
+    PageID      *trains;
+    char        *buf;
+    double      start, elapsed;         /* time */
+    BfMAccessStrategy strategy;
+    static Four hints[] = { BFM_ACCESS_NORMAL, BFM_ACCESS_SEQSCAN };
+    static char *hintNames[] = { "normal", "seqscan" };
+
+    nHot = BI_NBUFS(LOT_LEAF_BUF) * RING_HOT_PERCENT / 100;
+    nScan = BI_NBUFS(LOT_LEAF_BUF) * RING_SCAN_PER_BUFFER;
+    trains = (PageID *)malloc(sizeof(PageID) * (nHot + nScan));
+    if (trains == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    e = edubfm_bench_AllocTrains(volId, nHot + nScan, BI_BUFSIZE(LOT_LEAF_BUF), trains);
+    if (e < eNOERROR) ERR(e);
+
+    policy = (arg != NULL) ? atoi(arg) : BFM_CLOCK;
+
+    printf("%10s %10s %12s %12s %12s\n", "policy", "scan hint", "scans/sec", "hot trains", "hot resident");
+
+    for (round = 0; round < 2; round++) {
+
+        e = EduBfM_FlushAll();
+        if (e < eNOERROR) ERR(e);
+        e = EduBfM_DiscardAll();
+        if (e < eNOERROR) ERR(e);
+
+        edubfm_cfgParams.replacementPolicy[LOT_LEAF_BUF] = policy;
+        e = EduBfM_Init();
+        if (e < eNOERROR) ERR(e);
+
+        for (n = 0; n < MAX(nOps / nHot, 1); n++) {
+            for (i = 0; i < nHot; i++) {
+                e = EduBfM_GetTrain(&trains[i], &buf, LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+                e = EduBfM_FreeTrain(&trains[i], LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+            }
+        }
+
+        e = EduBfM_InitAccessStrategy(&strategy, hints[round]);
+        if (e < eNOERROR) ERR(e);
+
+        start = edubfm_bench_Now();
+
+        for (i = nHot; i < nHot + nScan; i++) {
+            e = EduBfM_GetTrainWithStrategy(&trains[i], &buf, LOT_LEAF_BUF, &strategy);
+            if (e < eNOERROR) ERR(e);
+            e = EduBfM_FreeTrain(&trains[i], LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        elapsed = edubfm_bench_Now() - start;
+
+        for (nResident = 0, i = 0; i < nHot; i++)
+            if (edubfm_LookUp((BfMHashKey *)&trains[i], LOT_LEAF_BUF) != NOTFOUND_IN_HTABLE) nResident++;
+
+        printf("%10s %10s %12.0f %12d %12d\n", PI_POLICY(LOT_LEAF_BUF)->name, hintNames[round],
+               nScan / elapsed, nHot, nResident);
+
+        e = EduBfM_Final();
+        if (e < eNOERROR) ERR(e);
+    }
+
+    edubfm_cfgParams.replacementPolicy[LOT_LEAF_BUF] = BFM_CLOCK;
+    free(trains);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_Ring() */
+
+
+
+/*
+ * Benchmark "resize" : growing and shrinking the buffer pool while it is used
+ */
+
+/* # of trains accessed, relative to the initial # of buffers */
+#define RESIZE_TRAINS_PER_BUFFER    2
+/* % of the fixes which set the dirty bit */
+#define RESIZE_DIRTY_PERCENT        25
+/* default # of partitions */
+#define RESIZE_NPARTITIONS          4
+
+/*@================================
+ * edubfm_bench_Resize()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_Resize(Four, Four, char *)
+ *
+ * Description:
+ *  Make the LOT_LEAF_BUF pool resizable up to twice its size, split into
+ *  'arg' partitions (RESIZE_NPARTITIONS if omitted), and resize it to 1x,
+ *  2x, 0.5x and 1x of its initial size in turn. After each resize, nOps
+ *  trains chosen uniformly among twice as many trains as the initial pool
+ *  holds are fixed (RESIZE_DIRTY_PERCENT % of them are set dirty).
+ *  The time taken by the resize, the # of dirty trains it wrote, the hit
+ *  ratio of the fixes and the resident memory of the process are printed.
+ *  One train stays fixed all the while, and its buffer is checked to be
+ *  neither moved nor changed at the end.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_Resize(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of fixes after each resize */
+    char        *arg)                   /* IN # of partitions */
+{
+    Four        e;                      /* for errors */
+    Four        i, phase;
+    Four        nBufs;                  /* initial # of buffers */
+    Four        nTrains;                /* # of trains */
+    Four        resized;                /* # of buffers after resizing */
+    Four        nHits;
+    PageID      *trains;
+    PageID      *pid;
+    UFour       seed;                   /* seed of the random number generator */
+    char        *buf;
+    char        *pinnedBuf;             /* buffer of the train fixed all the while */
+    char        *pinnedBuf2;
+    double      start, elapsed;         /* time */
+    long        vmSize, rssPages;       /* from /proc/self/statm */
+    FILE        *fp;
+    UFour       nWrites;                /* # of dirty trains written before the resize */
+    EduBfM_WriterStats stats;
+    static Four sizes[] = { 100, 200, 50, 100 };    /* size of each phase, relative to the initial # of buffers (%) */
+
+    nBufs = BI_NBUFS(LOT_LEAF_BUF);
+    nTrains = nBufs * RESIZE_TRAINS_PER_BUFFER;
+    trains = (PageID *)malloc(sizeof(PageID) * nTrains);
+    if (trains == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    e = edubfm_bench_AllocTrains(volId, nTrains, BI_BUFSIZE(LOT_LEAF_BUF), trains);
+    if (e < eNOERROR) ERR(e);
+
+    edubfm_cfgParams.nPartitions = (arg != NULL) ? atoi(arg) : RESIZE_NPARTITIONS;
+    edubfm_cfgParams.maxBufs[LOT_LEAF_BUF] = nBufs * 2;
+    e = EduBfM_Init();
+    if (e < eNOERROR) ERR(e);
+
+    // 마지막 train을 끝까지 fix 해 두고, 그 buffer가 옮겨지거나 바뀌지 않는지 확인함
+    e = EduBfM_GetTrain(&trains[nTrains - 1], &pinnedBuf, LOT_LEAF_BUF);
+    if (e < eNOERROR) ERR(e);
+    memset(pinnedBuf, 0x5a, PAGESIZE * BI_BUFSIZE(LOT_LEAF_BUF));
+
+    printf("%10s %10s %12s %12s %10s %12s\n", "requested", "resized", "resize msec", "writes", "hit %", "RSS (MB)");
+
+    seed = 1;
+    for (phase = 0; phase < sizeof(sizes) / sizeof(sizes[0]); phase++) {
+
+        e = EduBfM_GetWriterStats(&stats);
+        if (e < eNOERROR) ERR(e);
+        nWrites = stats.nSyncWrites;
+
+        start = edubfm_bench_Now();
+
+        e = EduBfM_ResizeBuffer(LOT_LEAF_BUF, nBufs * sizes[phase] / 100, &resized);
+        if (e < eNOERROR) ERR(e);
+
+        elapsed = edubfm_bench_Now() - start;
+
+        e = EduBfM_GetWriterStats(&stats);
+        if (e < eNOERROR) ERR(e);
+        nWrites = stats.nSyncWrites - nWrites;
+
+        for (nHits = 0, i = 0; i < nOps; i++) {
+            pid = &trains[rand_r(&seed) % (nTrains - 1)];
+            if (edubfm_LookUp((BfMHashKey *)pid, LOT_LEAF_BUF) != NOTFOUND_IN_HTABLE) nHits++;
+
+            e = EduBfM_GetTrain(pid, &buf, LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+            if (rand_r(&seed) % 100 < RESIZE_DIRTY_PERCENT) {
+                e = EduBfM_SetDirty(pid, LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+            }
+            e = EduBfM_FreeTrain(pid, LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        vmSize = rssPages = 0;
+        fp = fopen("/proc/self/statm", "r");
+        if (fp != NULL) {
+            if (fscanf(fp, "%ld %ld", &vmSize, &rssPages) != 2) rssPages = 0;
+            fclose(fp);
+        }
+
+        printf("%10d %10d %12.2f %12u %10.1f %12.1f\n", nBufs * sizes[phase] / 100, resized, elapsed * 1000, nWrites,
+               100.0 * nHits / MAX(nOps, 1), rssPages * (double)sysconf(_SC_PAGESIZE) / (1024 * 1024));
+    }
+
+    e = EduBfM_GetTrain(&trains[nTrains - 1], &pinnedBuf2, LOT_LEAF_BUF);
+    if (e < eNOERROR) ERR(e);
+    for (i = 0; i < PAGESIZE * BI_BUFSIZE(LOT_LEAF_BUF) && pinnedBuf[i] == 0x5a; i++);
+    printf("fixed train kept in place: %s\n",
+           (pinnedBuf2 == pinnedBuf && i == PAGESIZE * BI_BUFSIZE(LOT_LEAF_BUF)) ? "yes" : "NO");
+
+    for (i = 0; i < 2; i++) {
+        e = EduBfM_FreeTrain(&trains[nTrains - 1], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    e = EduBfM_Final();
+    if (e < eNOERROR) ERR(e);
+
+    printf("after EduBfM_Final(): %d buffers\n", BI_NBUFS(LOT_LEAF_BUF));
+
+    edubfm_cfgParams.nPartitions = 0;
+    edubfm_cfgParams.maxBufs[LOT_LEAF_BUF] = 0;
+    free(trains);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_Resize() */
+
+
+
+/*
+ * Benchmark "stats" : the statistics of a skewed workload and the cost of collecting them
+ */
+
+/* # of trains accessed, relative to the # of buffers */
+#define STATS_TRAINS_PER_BUFFER     2
+/* % of the fixes which access the hot trains (the first 1/10 of the trains) */
+#define STATS_HOT_PERCENT           80
+/* % of the fixes which set the dirty bit */
+#define STATS_DIRTY_PERCENT         10
+
+/*@================================
+ * edubfm_bench_Stats()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_Stats(Four, Four, char *)
+ *
+ * Description:
+ *  Fix nOps trains of the LOT_LEAF_BUF pool chosen among twice as many
+ *  trains as the pool holds, STATS_HOT_PERCENT % of them among the hot
+ *  tenth of the trains (STATS_DIRTY_PERCENT % of them are set dirty),
+ *  once to warm up the buffer pool and once after EduBfM_ResetStats().
+ *  The fix rate of the second run is printed, and then the statistics by
+ *  EduBfM_DumpStats(); comparing the fix rate with that of EduBfM compiled
+ *  with 'make STATS=' shows the cost of collecting them.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_Stats(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of fixes of each run */
+    char        *arg)                   /* IN not used */
+{
+    Four        e;                      /* for errors */
+    Four        i, run;
+    Four        nTrains, nHot;          /* # of trains and # of hot trains */
+    PageID      *trains;
+    PageID      *pid;
+    UFour       seed;                   /* seed of the random number generator */
+    char        *buf;
+    double      start, elapsed;         /* time */
+
+    nTrains = BI_NBUFS(LOT_LEAF_BUF) * STATS_TRAINS_PER_BUFFER;
+    nHot = MAX(nTrains / 10, 1);
+    trains = (PageID *)malloc(sizeof(PageID) * nTrains);
+    if (trains == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    e = edubfm_bench_AllocTrains(volId, nTrains, BI_BUFSIZE(LOT_LEAF_BUF), trains);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_Init();
+    if (e < eNOERROR) ERR(e);
+
+    seed = 1;
+    for (run = 0; run < 2; run++) {
+
+        // 두 번째 실행 전에 warm-up 동안의 통계를 지움 (통계를 수집하지 않는 경우 무시함)
+        if (run == 1) {
+            e = EduBfM_ResetStats();
+            if (e < eNOERROR && e != eNOTSUPPORTED_EDUBFM) ERR(e);
+        }
+
+        start = edubfm_bench_Now();
+
+        for (i = 0; i < nOps; i++) {
+            if (rand_r(&seed) % 100 < STATS_HOT_PERCENT) pid = &trains[rand_r(&seed) % nHot];
+            else pid = &trains[nHot + rand_r(&seed) % (nTrains - nHot)];
+
+            e = EduBfM_GetTrain(pid, &buf, LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+            if (rand_r(&seed) % 100 < STATS_DIRTY_PERCENT) {
+                e = EduBfM_SetDirty(pid, LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+            }
+            e = EduBfM_FreeTrain(pid, LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        elapsed = edubfm_bench_Now() - start;
+    }
+
+    printf("%d fixes of %d trains (%d%% hot): %.0f fixes/sec\n", nOps, nTrains, STATS_HOT_PERCENT, nOps / elapsed);
+
+    e = EduBfM_DumpStats(stdout);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_Final();
+    if (e < eNOERROR) ERR(e);
+
+    free(trains);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_Stats() */
+
+
+
+/*
+ * Benchmark "directio" : huge pages and O_DIRECT against the page cache of the OS
+ */
+
+/* # of trains accessed, relative to the # of buffers */
+#define DIO_TRAINS_PER_BUFFER   2
+/* % of the fixes which modify the train */
+#define DIO_DIRTY_PERCENT       25
+
+/*@================================
+ * edubfm_bench_CountCached()
+ *================================*/
+/*
+ * Function: static Four edubfm_bench_CountCached(Four, Four)
+ *
+ * Description:
+ *  Return the # of pages [firstPage, firstPage + nPages) of the benchmark
+ *  volume which are cached by the OS.
+ *
+ * Returns:
+ *  # of pages (-1 : unknown)
+ */
+static Four edubfm_bench_CountCached(
+    Four        firstPage,              /* IN first page */
+    Four        nPages)                 /* IN # of pages */
+{
+    Four        fd;
+    Four        i, n;
+    char        *addr;
+    unsigned char *vec;
+
+    fd = open(BENCH_VOLUME_NAME, O_RDONLY);
+    if (fd < 0) return(-1);
+
+    addr = mmap(NULL, (size_t)nPages * PAGESIZE, PROT_READ, MAP_SHARED, fd, (off_t)firstPage * PAGESIZE);
+    vec = (unsigned char *)malloc(nPages * (PAGESIZE / sysconf(_SC_PAGESIZE)));
+    n = -1;
+    if (addr != MAP_FAILED && vec != NULL && mincore(addr, (size_t)nPages * PAGESIZE, vec) == 0) {
+        for (n = 0, i = 0; i < nPages * (PAGESIZE / sysconf(_SC_PAGESIZE)); i++) n += vec[i] & 1;
+        n /= PAGESIZE / sysconf(_SC_PAGESIZE);
+    }
+
+    if (addr != MAP_FAILED) munmap(addr, (size_t)nPages * PAGESIZE);
+    free(vec);
+    close(fd);
+
+    return(n);
+
+} /* edubfm_bench_CountCached() */
+
+/*@================================
+ * edubfm_bench_AnonHugePages()
+ *================================*/
+/*
+ * Function: static long edubfm_bench_AnonHugePages(void)
+ *
+ * Description:
+ *  Return the size of the anonymous memory of the process backed by huge pages.
+ *
+ * Returns:
+ *  size (unit: KB, -1 : unknown)
+ */
+static long edubfm_bench_AnonHugePages(void)
+{
+    FILE        *fp;
+    char        line[256];
+    long        kb = -1;
+
+    fp = fopen("/proc/self/smaps_rollup", "r");
+    if (fp == NULL) return(-1);
+
+    while (fgets(line, sizeof(line), fp) != NULL)
+        if (sscanf(line, "AnonHugePages: %ld kB", &kb) == 1) break;
+
+    fclose(fp);
+
+    return(kb);
+
+} /* edubfm_bench_AnonHugePages() */
+
+/*@================================
+ * edubfm_bench_DirectIO()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_DirectIO(Four, Four, char *)
+ *
+ * Description:
+ *  With the benchmark volume attached, fix nOps trains of the LOT_LEAF_BUF
+ *  pool chosen uniformly among twice as many trains as the pool holds
+ *  (DIO_DIRTY_PERCENT % of them are modified) and flush them, with the
+ *  default buffer pools and then with edubfm_cfgParams.useHugePages and
+ *  edubfm_cfgParams.useDirectIO. The page cache of the OS is emptied
+ *  first. The fix rate, the # of pages of the trains left in the page
+ *  cache, and the memory backed by huge pages are printed, and the trains
+ *  are read back to check that they were written correctly.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_DirectIO(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of fixes of each round */
+    char        *arg)                   /* IN not used */
+{
+    Four        e;                      /* for errors */
+    Four        i, t, round;
+    Four        fd;
+    Four        nTrains;                /* # of trains */
+    Four        firstPage, nPages;      /* pages of the trains */
+    Four        *stamps;                /* value written last to each train */
+    PageID      *trains;
+    UFour       seed;                   /* seed of the random number generator */
+    char        *buf;
+    double      start, elapsed;         /* time */
+    long        hugeKB;                 /* memory backed by huge pages */
+
+    nTrains = BI_NBUFS(LOT_LEAF_BUF) * DIO_TRAINS_PER_BUFFER;
+    trains = (PageID *)malloc(sizeof(PageID) * nTrains);
+    stamps = (Four *)calloc(nTrains, sizeof(Four));
+    if (trains == NULL || stamps == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    e = edubfm_bench_AllocTrains(volId, nTrains, BI_BUFSIZE(LOT_LEAF_BUF), trains);
+    if (e < eNOERROR) ERR(e);
+
+    for (firstPage = trains[0].pageNo, nPages = 0, i = 0; i < nTrains; i++) {
+        firstPage = MIN(firstPage, trains[i].pageNo);
+        nPages = MAX(nPages, trains[i].pageNo + BI_BUFSIZE(LOT_LEAF_BUF));
+    }
+    nPages -= firstPage;
+
+    printf("%10s %12s %12s %14s %12s\n", "direct", "fixes/sec", "flush msec", "cached pages", "huge (MB)");
+
+    for (round = 0; round < 2; round++) {
+
+        e = EduBfM_FlushAll();
+        if (e < eNOERROR) ERR(e);
+        e = EduBfM_DiscardAll();
+        if (e < eNOERROR) ERR(e);
+
+        edubfm_cfgParams.useHugePages = edubfm_cfgParams.useDirectIO = (round == 1);
+        e = EduBfM_Init();
+        if (e < eNOERROR) ERR(e);
+
+        e = EduBfM_AttachVolume(volId, BENCH_VOLUME_NAME);
+        if (e < eNOERROR) ERR(e);
+
+        // 운영체제의 page cache를 비움
+        fd = open(BENCH_VOLUME_NAME, O_RDONLY);
+        if (fd >= 0) {
+            fdatasync(fd);
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+        }
+
+        seed = round + 1;
+        start = edubfm_bench_Now();
+
+        for (i = 0; i < nOps; i++) {
+            t = rand_r(&seed) % nTrains;
+
+            e = EduBfM_GetTrain(&trains[t], &buf, LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+            if (rand_r(&seed) % 100 < DIO_DIRTY_PERCENT) {
+                stamps[t] = round * nOps + i + 1;
+                memcpy(buf, &stamps[t], sizeof(Four));
+                e = EduBfM_SetDirty(&trains[t], LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+            }
+            e = EduBfM_FreeTrain(&trains[t], LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        elapsed = edubfm_bench_Now() - start;
+        start = edubfm_bench_Now();
+
+        e = EduBfM_FlushAll();
+        if (e < eNOERROR) ERR(e);
+
+        printf("%10s %12.0f %12.2f %14d %12.1f\n", (round == 1) ? "on" : "off", nOps / elapsed,
+               (edubfm_bench_Now() - start) * 1000, edubfm_bench_CountCached(firstPage, nPages),
+               (hugeKB = edubfm_bench_AnonHugePages()) < 0 ? -1.0 : hugeKB / 1024.0);
+
+        // 기록된 train들을 disk로부터 다시 읽어 확인함
+        e = EduBfM_DiscardAll();
+        if (e < eNOERROR) ERR(e);
+
+        for (i = 0; i < nTrains; i++) {
+            if (stamps[i] == 0) continue;
+
+            e = EduBfM_GetTrain(&trains[i], &buf, LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+
+            memcpy(&t, buf, sizeof(Four));
+            if (t != stamps[i]) {
+                printf("train {%d, %d} was not written correctly\n", trains[i].volNo, trains[i].pageNo);
+                ERR(eVOLUMEIOERR_EDUBFM);
+            }
+
+            e = EduBfM_FreeTrain(&trains[i], LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        e = EduBfM_DetachVolume(volId);
+        if (e < eNOERROR) ERR(e);
+
+        e = EduBfM_Final();
+        if (e < eNOERROR) ERR(e);
+    }
+
+    edubfm_cfgParams.useHugePages = edubfm_cfgParams.useDirectIO = FALSE;
+    free(stamps);
+    free(trains);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_DirectIO() */
+
+
+
+/*
+ * Benchmark "mmap" : fixing the trains of a mapped volume in place against reading them into the buffer pool
+ */
+
+/* # of trains accessed, relative to the # of buffers */
+#define MMAP_TRAINS_PER_BUFFER  2
+/* # of trains modified to check the write-back of a mapped volume */
+#define MMAP_NMODIFIED          100
+
+/*@================================
+ * edubfm_bench_DropCache()
+ *================================*/
+/*
+ * Function: static Four edubfm_bench_DropCache(Four)
+ *
+ * Description:
+ *  Empty the buffer pools and the page cache of the OS, detaching the
+ *  benchmark volume meanwhile so that its mapping is dropped, too.
+ *
+ * Returns:
+ *  error code
+ */
+static Four edubfm_bench_DropCache(
+    Four        volId)                  /* IN volume id */
+{
+    Four        e;                      /* for errors */
+    Four        fd;
+
+    e = EduBfM_DiscardAll();
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_DetachVolume(volId);
+    if (e < eNOERROR) ERR(e);
+
+    fd = open(BENCH_VOLUME_NAME, O_RDONLY);
+    if (fd >= 0) {
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+
+    e = EduBfM_AttachVolume(volId, BENCH_VOLUME_NAME);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_DropCache() */
+
+/*@================================
+ * edubfm_bench_Mmap()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_Mmap(Four, Four, char *)
+ *
+ * Description:
+ *  Stamp twice as many trains as the LOT_LEAF_BUF pool holds with their
+ *  numbers, and fix nOps of them sequentially and uniformly at random,
+ *  reading the stamps, with the benchmark volume attached as usual and
+ *  then with edubfm_cfgParams.useMmap. Each access pattern is run once
+ *  with the buffer pools and the page cache of the OS emptied (cold) and
+ *  once again (warm); the fix rates and the # of wrong stamps are printed.
+ *  Finally MMAP_NMODIFIED trains are modified in the mapped volume and
+ *  flushed, and read back through the buffer pool to check them.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_Mmap(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of fixes of each run */
+    char        *arg)                   /* IN not used */
+{
+    Four        e;                      /* for errors */
+    Four        i, t, mode, pattern, pass;
+    Four        nTrains;                /* # of trains */
+    Four        nWrong;                 /* # of wrong stamps */
+    Four        stamp;
+    PageID      *trains;
+    UFour       seed;                   /* seed of the random number generator */
+    char        *buf;
+    double      start, rate[2];         /* fix rates of the cold and the warm runs */
+    static char *modeNames[] = { "copy", "mmap" };
+    static char *patternNames[] = { "sequential", "random" };
+
+    nTrains = BI_NBUFS(LOT_LEAF_BUF) * MMAP_TRAINS_PER_BUFFER;
+    trains = (PageID *)malloc(sizeof(PageID) * nTrains);
+    if (trains == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    e = edubfm_bench_AllocTrains(volId, nTrains, BI_BUFSIZE(LOT_LEAF_BUF), trains);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_Init();
+    if (e < eNOERROR) ERR(e);
+
+    // 각 train에 train 번호를 기록함
+    for (i = 0; i < nTrains; i++) {
+        e = EduBfM_GetTrain(&trains[i], &buf, LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        memcpy(buf, &i, sizeof(Four));
+        e = EduBfM_SetDirty(&trains[i], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        e = EduBfM_FreeTrain(&trains[i], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    e = EduBfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+
+    printf("%6s %12s %14s %14s %8s\n", "mode", "pattern", "cold fixes/s", "warm fixes/s", "wrong");
+
+    for (mode = 0; mode < 2; mode++) {
+
+        edubfm_cfgParams.useMmap = (mode == 1);
+        e = EduBfM_AttachVolume(volId, BENCH_VOLUME_NAME);
+        if (e < eNOERROR) ERR(e);
+
+        for (pattern = 0; pattern < 2; pattern++) {
+            nWrong = 0;
+
+            for (pass = 0; pass < 2; pass++) {
+                if (pass == 0) {
+                    e = edubfm_bench_DropCache(volId);
+                    if (e < eNOERROR) ERR(e);
+                }
+
+                seed = 1;
+                start = edubfm_bench_Now();
+
+                for (i = 0; i < nOps; i++) {
+                    t = (pattern == 0) ? i % nTrains : rand_r(&seed) % nTrains;
+
+                    e = EduBfM_GetTrain(&trains[t], &buf, LOT_LEAF_BUF);
+                    if (e < eNOERROR) ERR(e);
+                    memcpy(&stamp, buf, sizeof(Four));
+                    if (stamp != t) nWrong++;
+                    e = EduBfM_FreeTrain(&trains[t], LOT_LEAF_BUF);
+                    if (e < eNOERROR) ERR(e);
+                }
+
+                rate[pass] = nOps / (edubfm_bench_Now() - start);
+            }
+
+            printf("%6s %12s %14.0f %14.0f %8d\n", modeNames[mode], patternNames[pattern], rate[0], rate[1], nWrong);
+        }
+
+        // Mapping 된 volume의 train들을 수정하여 flush 함
+        if (mode == 1) {
+            for (i = 0; i < MMAP_NMODIFIED; i++) {
+                e = EduBfM_GetTrain(&trains[i * 7 % nTrains], &buf, LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+                stamp = -(i * 7 % nTrains) - 1;
+                memcpy(buf, &stamp, sizeof(Four));
+                e = EduBfM_SetDirty(&trains[i * 7 % nTrains], LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+                e = EduBfM_FreeTrain(&trains[i * 7 % nTrains], LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+            }
+
+            e = EduBfM_FlushAll();
+            if (e < eNOERROR) ERR(e);
+        }
+
+        e = EduBfM_DetachVolume(volId);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    edubfm_cfgParams.useMmap = FALSE;
+
+    // 수정된 train들을 bufferPool을 통해 다시 읽어 확인함
+    e = EduBfM_DiscardAll();
+    if (e < eNOERROR) ERR(e);
+
+    for (nWrong = 0, i = 0; i < MMAP_NMODIFIED; i++) {
+        e = EduBfM_GetTrain(&trains[i * 7 % nTrains], &buf, LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        memcpy(&stamp, buf, sizeof(Four));
+        if (stamp != -(i * 7 % nTrains) - 1) nWrong++;
+        e = EduBfM_FreeTrain(&trains[i * 7 % nTrains], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    printf("trains modified in the mapping and flushed: %d, read back wrong: %d\n", MMAP_NMODIFIED, nWrong);
+
+    e = EduBfM_Final();
+    if (e < eNOERROR) ERR(e);
+
+    free(trains);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_Mmap() */
+
+
+
+/*
+ * Benchmark "ccache" : hit ratios of the buffer pool and of the compressed cache under it
+ */
+
+/* # of trains accessed, relative to the # of buffers */
+#define CC_TRAINS_PER_BUFFER    4
+/* # of sizes of the compressed cache compared */
+#define CC_NSIZES               3
+
+/*@================================
+ * edubfm_bench_FillRecords()
+ *================================*/
+/*
+ * Function: static void edubfm_bench_FillRecords(char *, Four, Four)
+ *
+ * Description:
+ *  Fill a train like a data page: its number followed by text records of
+ *  a few fields with random values, which compress about as well as the
+ *  records of a table.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_bench_FillRecords(
+    char        *buf,                   /* OUT train */
+    Four        nBytes,                 /* IN size of the train */
+    Four        t)                      /* IN train number */
+{
+    Four        off, n;
+    UFour       seed = t + 1;
+    char        record[128];
+    static char *cities[] = { "Seoul", "Daejeon", "Busan", "Incheon", "Gwangju", "Daegu", "Ulsan", "Suwon" };
+
+    memcpy(buf, &t, sizeof(Four));
+    for (off = sizeof(Four); off < nBytes; off += n) {
+        n = snprintf(record, sizeof(record), "id=%08d|name=customer%06d|city=%s|balance=%010d|status=%s;",
+                     rand_r(&seed) % 100000000, rand_r(&seed) % 1000000, cities[rand_r(&seed) % 8],
+                     rand_r(&seed) % 1000000, (rand_r(&seed) % 4 == 0) ? "inactive" : "active");
+        n = MIN(n, nBytes - off);
+        memcpy(buf + off, record, n);
+    }
+
+} /* edubfm_bench_FillRecords() */
+
+/*@================================
+ * edubfm_bench_CompressedCache()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_CompressedCache(Four, Four, char *)
+ *
+ * Description:
+ *  Fill CC_TRAINS_PER_BUFFER times as many trains as the LOT_LEAF_BUF pool
+ *  holds with records, attach the benchmark volume with O_DIRECT so that
+ *  every read goes to disk, and fix nOps trains chosen uniformly at random
+ *  (after as many fixes to warm up), without the compressed cache and with
+ *  a compressed cache of half and of the whole size of the buffer pool.
+ *  The fix rate, the hit ratios of the buffer pool and of the compressed
+ *  cache (among the misses of the buffer pool), the # of reads from disk
+ *  per fix and the compression ratio are printed. The number of each train
+ *  is checked.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_CompressedCache(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of fixes of each run */
+    char        *arg)                   /* IN not used */
+{
+    Four        e;                      /* for errors */
+    Four        i, t, s, run, stamp;
+    Four        nTrains;                /* # of trains */
+    Four        nWrong;                 /* # of trains with a wrong number */
+    Four        poolBytes;              /* size of the LOT_LEAF_BUF pool */
+    PageID      *trains;
+    UFour       seed;                   /* seed of the random number generator */
+    char        *buf;
+    double      start, elapsed;         /* time */
+    EduBfM_CompressedCacheStats before, after;  /* counters of the compressed cache */
+    UFour       nMisses, nHits;
+
+    nTrains = BI_NBUFS(LOT_LEAF_BUF) * CC_TRAINS_PER_BUFFER;
+    poolBytes = BI_NBUFS(LOT_LEAF_BUF) * BI_BUFSIZE(LOT_LEAF_BUF) * PAGESIZE;
+    trains = (PageID *)malloc(sizeof(PageID) * nTrains);
+    if (trains == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    e = edubfm_bench_AllocTrains(volId, nTrains, BI_BUFSIZE(LOT_LEAF_BUF), trains);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_Init();
+    if (e < eNOERROR) ERR(e);
+
+    for (t = 0; t < nTrains; t++) {
+        e = EduBfM_GetTrain(&trains[t], &buf, LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        edubfm_bench_FillRecords(buf, BI_BUFSIZE(LOT_LEAF_BUF) * PAGESIZE, t);
+        e = EduBfM_SetDirty(&trains[t], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        e = EduBfM_FreeTrain(&trains[t], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    e = EduBfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_Final();
+    if (e < eNOERROR) ERR(e);
+
+    printf("%10s %12s %10s %10s %10s %12s %8s %8s\n",
+           "ccache MB", "fixes/sec", "pool hit", "cc hit", "total hit", "reads/fix", "ratio", "wrong");
+
+    for (s = 0; s < CC_NSIZES; s++) {
+
+        edubfm_cfgParams.useDirectIO = TRUE;
+        edubfm_cfgParams.compressedCacheSize = poolBytes / 2 * s;
+        e = EduBfM_Init();
+        if (e < eNOERROR) ERR(e);
+
+        e = EduBfM_AttachVolume(volId, BENCH_VOLUME_NAME);
+        if (e < eNOERROR) ERR(e);
+
+        seed = 1;
+        nWrong = 0;
+
+        for (run = 0; run < 2; run++) {
+            EduBfM_GetCompressedCacheStats(&before);
+            start = edubfm_bench_Now();
+
+            for (i = 0; i < nOps; i++) {
+                t = rand_r(&seed) % nTrains;
+
+                e = EduBfM_GetTrain(&trains[t], &buf, LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+                memcpy(&stamp, buf, sizeof(Four));
+                if (stamp != t) nWrong++;
+                e = EduBfM_FreeTrain(&trains[t], LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+            }
+
+            elapsed = edubfm_bench_Now() - start;
+            EduBfM_GetCompressedCacheStats(&after);
+        }
+
+        // 모든 miss는 compressed cache를 먼저 찾으므로, 그 look-up 수가 bufferPool의 miss 수임
+        // (compressed cache가 없으면 look-up을 세지 않으므로 miss 수를 알 수 없어 모두 disk read로 봄)
+        nMisses = after.nLookUps - before.nLookUps;
+        nHits = after.nHits - before.nHits;
+
+        if (s == 0) printf("%10.1f %12.0f %10s %10s %10s %12s %8s %8d\n", 0.0, nOps / elapsed, "-", "-", "-", "-", "-", nWrong);
+        else printf("%10.1f %12.0f %9.1f%% %9.1f%% %9.1f%% %12.3f %8.2f %8d\n",
+                    edubfm_cfgParams.compressedCacheSize / (1024.0 * 1024.0), nOps / elapsed,
+                    100.0 * (nOps - nMisses) / nOps, nMisses == 0 ? 0.0 : 100.0 * nHits / nMisses,
+                    100.0 * (nOps - nMisses + nHits) / nOps, (double)(nMisses - nHits) / nOps,
+                    after.nBytesStored == 0 ? 0.0 : (double)after.nBytesIn / after.nBytesStored, nWrong);
+
+        e = EduBfM_DetachVolume(volId);
+        if (e < eNOERROR) ERR(e);
+
+        e = EduBfM_Final();
+        if (e < eNOERROR) ERR(e);
+    }
+
+    edubfm_cfgParams.useDirectIO = FALSE;
+    edubfm_cfgParams.compressedCacheSize = 0;
+    free(trains);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_CompressedCache() */
+
+/*
+ * Benchmark "warmup" : restarting with the resident set reloaded against restarting cold
+ */
+
+/* # of trains, relative to the # of buffers; the first buffer-pool-full of them are hot */
+#define WARMUP_TRAINS_PER_BUFFER    4
+/* percentage of the fixes going to the hot trains */
+#define WARMUP_HOT_PERCENT          90
+/* resident set file written and read by the benchmark */
+#define WARMUP_FILE                 "bench.rs"
+/* # of restarts compared */
+#define WARMUP_NMODES               3
+
+/*@================================
+ * edubfm_bench_Warmup()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_Warmup(Four, Four, char *)
+ *
+ * Description:
+ *  Stamp WARMUP_TRAINS_PER_BUFFER times as many trains as the LOT_LEAF_BUF
+ *  pool holds with their numbers, and fix nOps of them at random
+ *  (WARMUP_HOT_PERCENT % of them among the hot trains, which fill the pool),
+ *  so that EduBfM_Final() saves the resident set to WARMUP_FILE. Then
+ *  EduBfM is restarted with the buffer pools and the page cache of the OS
+ *  emptied and latched as one partition, cold (without
+ *  edubfm_cfgParams.residentSetFile), and with the saved resident set
+ *  reloaded by the calling thread and by arg I/O threads (4 if omitted),
+ *  and nOps fixes are made again. The time EduBfM_Init()
+ *  took, the # of trains resident after it, the hit ratio of the first
+ *  buffer-pool-full of the fixes and of all of them, the time until all fixes are
+ *  done (including EduBfM_Init()) and the # of wrong stamps are printed.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_Warmup(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of fixes of each run */
+    char        *arg)                   /* IN # of I/O threads reloading the resident set */
+{
+    Four        e;                      /* for errors */
+    Four        i, t, mode, stamp, fd;
+    Four        nTrains;                /* # of trains */
+    Four        nHot;                   /* # of hot trains */
+    Four        nWrong;                 /* # of wrong stamps */
+    Four        nResident;              /* # of trains in the buffer pool after EduBfM_Init() */
+    Four        nThreads;               /* # of I/O threads */
+    PageID      *trains;
+    UFour       seed;                   /* seed of the random number generator */
+    char        *buf;
+    double      start, initTime, totalTime;
+    EduBfM_Stats firstStats, stats;     /* statistics after the first buffer-pool-full and all of the fixes */
+    static char *modeNames[] = { "cold", "reload", "reload+io" };
+
+    nThreads = (arg != NULL) ? atoi(arg) : 4;
+    if (nThreads < 1 || nThreads > MAX_IO_THREADS) ERR(eBADPARAMETER_EDUBFM);
+
+    nHot = BI_NBUFS(LOT_LEAF_BUF);
+    nTrains = nHot * WARMUP_TRAINS_PER_BUFFER;
+    trains = (PageID *)malloc(sizeof(PageID) * nTrains);
+    if (trains == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    e = edubfm_bench_AllocTrains(volId, nTrains, BI_BUFSIZE(LOT_LEAF_BUF), trains);
+    if (e < eNOERROR) ERR(e);
+
+    unlink(WARMUP_FILE);
+    edubfm_cfgParams.residentSetFile = WARMUP_FILE;
+
+    e = EduBfM_Init();
+    if (e < eNOERROR) ERR(e);
+
+    for (t = 0; t < nTrains; t++) {
+        e = EduBfM_GetTrain(&trains[t], &buf, LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        memcpy(buf, &t, sizeof(Four));
+        e = EduBfM_SetDirty(&trains[t], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        e = EduBfM_FreeTrain(&trains[t], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    seed = 1;
+    for (i = 0; i < nOps; i++) {
+        t = (rand_r(&seed) % 100 < WARMUP_HOT_PERCENT) ? rand_r(&seed) % nHot : nHot + rand_r(&seed) % (nTrains - nHot);
+        e = EduBfM_GetTrain(&trains[t], &buf, LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        e = EduBfM_FreeTrain(&trains[t], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    e = EduBfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+
+    // EduBfM_Final()이 resident set을 기록함
+    e = EduBfM_Final();
+    if (e < eNOERROR) ERR(e);
+
+    printf("%10s %10s %10s %12s %10s %12s %8s\n",
+           "restart", "init ms", "resident", "first hit", "hit", "total ms", "wrong");
+
+    for (mode = 0; mode < WARMUP_NMODES; mode++) {
+
+        // bufferPool과 OS의 page cache를 비움
+        e = EduBfM_DiscardAll();
+        if (e < eNOERROR) ERR(e);
+
+        fd = open(BENCH_VOLUME_NAME, O_RDONLY);
+        if (fd >= 0) {
+            fdatasync(fd);
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+        }
+
+        // 같은 조건에서 비교하도록 모든 재시작에서 bufferPool을 하나의 partition으로 latch 함
+        edubfm_cfgParams.residentSetFile = (mode == 0) ? NULL : WARMUP_FILE;
+        edubfm_cfgParams.nIOThreads = (mode == 2) ? nThreads : 0;
+        edubfm_cfgParams.nPartitions = 1;
+
+        start = edubfm_bench_Now();
+
+        e = EduBfM_Init();
+        if (e < eNOERROR) ERR(e);
+
+        initTime = edubfm_bench_Now() - start;
+
+        // 다음 재시작들도 같은 resident set을 읽도록, EduBfM_Final()이 다시 기록하지 않게 함
+        edubfm_cfgParams.residentSetFile = NULL;
+
+        for (nResident = 0, i = 0; i < BI_NBUFS(LOT_LEAF_BUF); i++)
+            if (!IS_NILBFMHASHKEY(BI_KEY(LOT_LEAF_BUF, i))) nResident++;
+
+        memset(&firstStats, 0, sizeof(EduBfM_Stats));
+        memset(&stats, 0, sizeof(EduBfM_Stats));
+
+        seed = 2;
+        nWrong = 0;
+
+        for (i = 0; i < nOps; i++) {
+            if (i == nHot) EduBfM_GetStats(LOT_LEAF_BUF, &firstStats);
+
+            t = (rand_r(&seed) % 100 < WARMUP_HOT_PERCENT) ? rand_r(&seed) % nHot : nHot + rand_r(&seed) % (nTrains - nHot);
+            e = EduBfM_GetTrain(&trains[t], &buf, LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+            memcpy(&stamp, buf, sizeof(Four));
+            if (stamp != t) nWrong++;
+            e = EduBfM_FreeTrain(&trains[t], LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        totalTime = edubfm_bench_Now() - start;
+        EduBfM_GetStats(LOT_LEAF_BUF, &stats);
+
+        // 통계를 수집하지 않도록 compile 된 경우에는 hit ratio를 출력하지 않음
+        if (stats.nFixes == 0)
+            printf("%10s %10.1f %10d %12s %10s %12.1f %8d\n", modeNames[mode], initTime * 1000, nResident,
+                   "-", "-", totalTime * 1000, nWrong);
+        else
+            printf("%10s %10.1f %10d %11.1f%% %9.1f%% %12.1f %8d\n", modeNames[mode], initTime * 1000, nResident,
+                   100.0 * firstStats.nHits / MAX(firstStats.nFixes, 1), 100.0 * stats.nHits / stats.nFixes,
+                   totalTime * 1000, nWrong);
+
+        e = EduBfM_Final();
+        if (e < eNOERROR) ERR(e);
+    }
+
+    edubfm_cfgParams.nIOThreads = 0;
+    edubfm_cfgParams.nPartitions = 0;
+    unlink(WARMUP_FILE);
+    free(trains);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_Warmup() */
+
+/*
+ * Benchmark "optfix" : fixing without the latch while pages/trains are replaced
+ */
+
+/* # of trains, relative to the # of buffers; the first half of a buffer-pool-full of them are hot */
+#define OPTFIX_TRAINS_PER_BUFFER    2
+/* percentage of the fixes going to the hot trains */
+#define OPTFIX_HOT_PERCENT          90
+
+typedef struct {
+    pthread_t   thread;
+    UFour       seed;                   /* seed of the random number generator */
+    Four        nOps;                   /* # of fix/unfix pairs to perform */
+    Four        nTrains;                /* # of trains */
+    Four        nHot;                   /* # of hot trains */
+    PageID      *trains;
+    Four        nWrong;                 /* # of wrong stamps read */
+    Four        e;                      /* error of this thread */
+} OptFixWorker;
+
+static void *edubfm_bench_OptFixWorker(
+    void        *arg)                   /* IN OptFixWorker */
+{
+    OptFixWorker *w = (OptFixWorker *)arg;
+    Four        i, t, stamp;
+    char        *buf;
+
+    for (i = 0; i < w->nOps; i++) {
+        t = (rand_r(&w->seed) % 100 < OPTFIX_HOT_PERCENT) ? rand_r(&w->seed) % w->nHot : rand_r(&w->seed) % w->nTrains;
+
+        w->e = EduBfM_GetTrain(&w->trains[t], &buf, LOT_LEAF_BUF);
+        if (w->e < eNOERROR) break;
+
+        memcpy(&stamp, buf, sizeof(Four));
+        if (stamp != t) w->nWrong++;
+
+        w->e = EduBfM_FreeTrain(&w->trains[t], LOT_LEAF_BUF);
+        if (w->e < eNOERROR) break;
+    }
+
+    return(NULL);
+}
+
+/*@================================
+ * edubfm_bench_OptimisticFix()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_OptimisticFix(Four, Four, char *)
+ *
+ * Description:
+ *  Stamp OPTFIX_TRAINS_PER_BUFFER times as many trains as the LOT_LEAF_BUF
+ *  pool holds with their numbers, and let arg threads (4 if omitted) fix
+ *  nOps of them each (OPTFIX_HOT_PERCENT % among the hot trains), so that
+ *  the fixes race with the replacements, with MTFIX_NPARTITIONS partitions
+ *  latched by every fix and with edubfm_cfgParams.useOptimisticFix. The
+ *  fix rate, the hit ratio, the share of the hits fixed without the latch,
+ *  the # of wrong stamps and the sum of the fix counts left (which must
+ *  be 0) are printed.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_OptimisticFix(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of fixes per thread */
+    char        *arg)                   /* IN # of threads */
+{
+    Four        e;                      /* for errors */
+    Four        i, t, mode;
+    Four        nThreads;               /* # of threads */
+    Four        nTrains;                /* # of trains */
+    Four        nWrong;                 /* # of wrong stamps */
+    Four        nFixed;                 /* sum of the fix counts left */
+    PageID      *trains;
+    char        *buf;
+    double      start, elapsed;         /* time */
+    EduBfM_Stats stats;                 /* statistics of the LOT_LEAF_BUF pool */
+    OptFixWorker workers[BENCH_MAX_THREADS];
+
+    nThreads = (arg != NULL) ? atoi(arg) : 4;
+    if (nThreads < 1 || nThreads > BENCH_MAX_THREADS) ERR(eBADPARAMETER_EDUBFM);
+
+    nTrains = BI_NBUFS(LOT_LEAF_BUF) * OPTFIX_TRAINS_PER_BUFFER;
+    trains = (PageID *)malloc(sizeof(PageID) * nTrains);
+    if (trains == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    e = edubfm_bench_AllocTrains(volId, nTrains, BI_BUFSIZE(LOT_LEAF_BUF), trains);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_Init();
+    if (e < eNOERROR) ERR(e);
+
+    for (t = 0; t < nTrains; t++) {
+        e = EduBfM_GetTrain(&trains[t], &buf, LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        memcpy(buf, &t, sizeof(Four));
+        e = EduBfM_SetDirty(&trains[t], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        e = EduBfM_FreeTrain(&trains[t], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    e = EduBfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_Final();
+    if (e < eNOERROR) ERR(e);
+
+    printf("%10s %10s %12s %10s %12s %8s %8s\n", "latch", "threads", "fixes/sec", "hit", "latch-free", "wrong", "fixed");
+
+    for (mode = 0; mode < 2; mode++) {
+
+        edubfm_cfgParams.nPartitions = MTFIX_NPARTITIONS;
+        edubfm_cfgParams.useOptimisticFix = (mode == 1);
+        e = EduBfM_Init();
+        if (e < eNOERROR) ERR(e);
+
+        start = edubfm_bench_Now();
+
+        for (t = 0; t < nThreads; t++) {
+            workers[t].seed = t + 1;
+            workers[t].nOps = nOps;
+            workers[t].nTrains = nTrains;
+            workers[t].nHot = BI_NBUFS(LOT_LEAF_BUF) / 2;
+            workers[t].trains = trains;
+            workers[t].nWrong = 0;
+            workers[t].e = eNOERROR;
+            pthread_create(&workers[t].thread, NULL, edubfm_bench_OptFixWorker, &workers[t]);
+        }
+
+        nWrong = 0;
+        for (t = 0; t < nThreads; t++) {
+            pthread_join(workers[t].thread, NULL);
+            if (workers[t].e < eNOERROR) ERR(workers[t].e);
+            nWrong += workers[t].nWrong;
+        }
+
+        elapsed = edubfm_bench_Now() - start;
+
+        for (nFixed = 0, i = 0; i < BI_NBUFS(LOT_LEAF_BUF); i++) nFixed += BI_FIXED(LOT_LEAF_BUF, i);
+
+        memset(&stats, 0, sizeof(EduBfM_Stats));
+        EduBfM_GetStats(LOT_LEAF_BUF, &stats);
+
+        printf("%10s %10d %12.0f %9.1f%% %11.1f%% %8d %8d\n", (mode == 1) ? "no" : "yes", nThreads,
+               (double)nOps * nThreads / elapsed, stats.nFixes == 0 ? 0.0 : 100.0 * stats.nHits / stats.nFixes,
+               stats.nHits == 0 ? 0.0 : 100.0 * stats.nOptimisticFixes / stats.nHits, nWrong, nFixed);
+
+        e = EduBfM_Final();
+        if (e < eNOERROR) ERR(e);
+    }
+
+    edubfm_cfgParams.nPartitions = 0;
+    edubfm_cfgParams.useOptimisticFix = FALSE;
+    free(trains);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_OptimisticFix() */
+
+
+/*
+ * Benchmark "numa" : placement of the partitions on (simulated) NUMA nodes
+ */
+
+/* default # of simulated NUMA nodes, and # of threads on each node */
+#define NUMA_DEFAULT_NODES      2
+#define NUMA_THREADS_PER_NODE   2
+
+typedef struct {
+    pthread_t   thread;
+    UFour       seed;                   /* seed of the random number generator */
+    Four        nOps;                   /* # of fix/unfix pairs to perform */
+    Four        node;                   /* NUMA node of this thread (NIL : not set) */
+    Four        e;                      /* error of this thread */
+} NumaWorker;
+
+static void *edubfm_bench_NumaWorker(
+    void        *arg)                   /* IN NumaWorker */
+{
+    NumaWorker  *w = (NumaWorker *)arg;
+    Four        i;
+    PageID      *pid;
+    char        *buf;
+    volatile char sum = 0;
+
+    if (w->node != NIL) {
+        w->e = EduBfM_SetThreadNode(w->node);
+        if (w->e < eNOERROR) return(NULL);
+    }
+
+    for (i = 0; i < w->nOps; i++) {
+        pid = &benchTrains[rand_r(&w->seed) % BENCH_NTRAINS];
+
+        w->e = EduBfM_GetTrain(pid, &buf, LOT_LEAF_BUF);
+        if (w->e < eNOERROR) break;
+
+        sum += buf[0];
+
+        w->e = EduBfM_FreeTrain(pid, LOT_LEAF_BUF);
+        if (w->e < eNOERROR) break;
+    }
+
+    return(NULL);
+}
+
+/*@================================
+ * edubfm_bench_Numa()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_Numa(Four, Four, char *)
+ *
+ * Description:
+ *  Spread MTFIX_NPARTITIONS partitions over arg NUMA nodes
+ *  (NUMA_DEFAULT_NODES if omitted, the nodes of the machine if 0; more
+ *  nodes than the machine has are simulated), and print the partitions and
+ *  the buffer elements of each node and the nodes of the machine holding
+ *  them. Then NUMA_THREADS_PER_NODE threads on each node fix nOps trains
+ *  resident in the LOT_LEAF_BUF pool each, and the fix rate and the share
+ *  of the fixes from another node are printed, compared with the same
+ *  threads and partitions not placed on any node.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_Numa(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of fixes per thread */
+    char        *arg)                   /* IN # of NUMA nodes */
+{
+    Four        e;                      /* for errors */
+    Four        i, t, p, n, mode;
+    Four        nNodes;                 /* # of NUMA nodes */
+    Four        nThreads;               /* # of threads */
+    Four        nParts, nBufs;          /* # of partitions and buffer elements of a node */
+    Four        m, mFirst, mLast;       /* nodes of the machine holding the buffer elements of a node */
+    BufferPartition *part;
+    char        *buf;
+    double      start, elapsed;         /* time */
+    EduBfM_Stats stats;                 /* statistics of the LOT_LEAF_BUF pool */
+    NumaWorker  workers[BENCH_MAX_THREADS];
+
+    n = (arg != NULL) ? atoi(arg) : NUMA_DEFAULT_NODES;
+    if (n < 0 || n > BFM_MAX_NUMA_NODES) ERR(eBADPARAMETER_EDUBFM);
+
+    for (mode = 0; mode < 2; mode++) {
+
+        edubfm_cfgParams.nPartitions = MTFIX_NPARTITIONS;
+        edubfm_cfgParams.numaNodes = (mode == 1) ? 0 : (n == 0 ? BFM_NUMA_MACHINE : n);
+        e = EduBfM_Init();
+        if (e < eNOERROR) ERR(e);
+
+        /* the same threads run without the placement */
+        nNodes = edubfm_nNumaNodes;
+        if (mode == 0) nThreads = MIN(nNodes * NUMA_THREADS_PER_NODE, BENCH_MAX_THREADS);
+
+        /* warm up the buffer pool */
+        for (i = 0; i < BENCH_NTRAINS; i++) {
+            e = EduBfM_GetTrain(&benchTrains[i], &buf, LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+            e = EduBfM_FreeTrain(&benchTrains[i], LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        if (mode == 0) {
+            printf("%10s %12s %10s %14s\n", "node", "partitions", "buffers", "machine node");
+
+            for (i = 0; i < nNodes; i++) {
+                nParts = nBufs = 0;
+                mFirst = mLast = NIL;
+
+                for (p = 0; p < PI_NPARTS(LOT_LEAF_BUF); p++) {
+                    part = PI_PART(LOT_LEAF_BUF, p);
+                    if (part->node != i) continue;
+
+                    nParts++;
+                    nBufs += part->nBufs;
+
+                    /* touch the first buffer element of the partition and see where it is */
+                    *(volatile char *)BI_BUFFER(LOT_LEAF_BUF, part->firstBuf) += 0;
+                    m = edubfm_MemoryNode(BI_BUFFER(LOT_LEAF_BUF, part->firstBuf));
+                    if (mFirst == NIL) mFirst = m;
+                    mLast = m;
+                }
+
+                if (mFirst == mLast) printf("%10d %12d %10d %14d\n", i, nParts, nBufs, mFirst);
+                else printf("%10d %12d %10d %9d - %2d\n", i, nParts, nBufs, mFirst, mLast);
+            }
+        }
+
+        EduBfM_ResetStats();
+
+        start = edubfm_bench_Now();
+
+        for (t = 0; t < nThreads; t++) {
+            workers[t].seed = t + 1;
+            workers[t].nOps = nOps;
+            workers[t].node = (nNodes > 0) ? t % nNodes : NIL;
+            workers[t].e = eNOERROR;
+            pthread_create(&workers[t].thread, NULL, edubfm_bench_NumaWorker, &workers[t]);
+        }
+        for (t = 0; t < nThreads; t++) {
+            pthread_join(workers[t].thread, NULL);
+            if (workers[t].e < eNOERROR) ERR(workers[t].e);
+        }
+
+        elapsed = edubfm_bench_Now() - start;
+
+        memset(&stats, 0, sizeof(EduBfM_Stats));
+        EduBfM_GetStats(LOT_LEAF_BUF, &stats);
+
+        printf("%-12s nodes %2d, threads %2d, fixes/sec %10.0f, fixes from another node %5.1f%%\n",
+               (mode == 1) ? "not placed" : "placed", nNodes, nThreads, (double)nOps * nThreads / elapsed,
+               stats.nFixes == 0 ? 0.0 : 100.0 * stats.nRemoteFixes / stats.nFixes);
+
+        e = EduBfM_Final();
+        if (e < eNOERROR) ERR(e);
+    }
+
+    edubfm_cfgParams.nPartitions = 0;
+    edubfm_cfgParams.numaNodes = 0;
+
+    return(eNOERROR);
+
+} /* edubfm_bench_Numa() */
+
+
+/*
+ * Benchmark "vartrain" : trains of several sizes in buffer elements of the largest size and in the pool of the variable-size trains
+ */
+
+/* # of trains, relative to the # of buffers of the LOT_LEAF_BUF pool; the first half of them are hot */
+#define VT_TRAINS_PER_BUFFER    3
+/* percentage of the fixes going to the hot trains */
+#define VT_HOT_PERCENT          90
+/* percentage of the fixes which modify the train */
+#define VT_DIRTY_PERCENT        10
+
+/* # of pages of the train t (half of them single pages, and a quarter not a power of 2) */
+#define VT_TRAIN_PAGES(t)       ((t) % 4 < 2 ? 1 : ((t) % 4 == 2 ? 3 : 4))
+
+/*@================================
+ * edubfm_bench_VarTrain()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_VarTrain(Four, Four, char *)
+ *
+ * Description:
+ *  Stamp each page of VT_TRAINS_PER_BUFFER times as many trains as the
+ *  LOT_LEAF_BUF pool holds, which consist of 1, 3 or 4 pages
+ *  (VT_TRAIN_PAGES()), and fix nOps of them (VT_HOT_PERCENT % among the
+ *  hot half, VT_DIRTY_PERCENT % modified), once in the LOT_LEAF_BUF pool,
+ *  where every train occupies a buffer element of BI_BUFSIZE(LOT_LEAF_BUF)
+ *  pages, and once in a pool of the variable-size trains of the same # of
+ *  pages. The hit ratio, the fix rate, the # of trains held at the end,
+ *  the pages lost to the rounding and the # of wrong stamps read (also
+ *  after the trains are written back and read again) are printed.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_VarTrain(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of fixes */
+    char        *arg)                   /* IN not used */
+{
+    Four        e;                      /* for errors */
+    Four        i, j, t, mode;
+    Four        nTrains;                /* # of trains */
+    Four        nHot;                   /* # of hot trains */
+    Four        nPages;                 /* # of pages of a train */
+    Four        poolPages;              /* # of pages of the LOT_LEAF_BUF pool */
+    Four        stamp;                  /* stamp of a page */
+    Four        nWrong;                 /* # of wrong stamps */
+    Four        nHeld;                  /* # of trains held at the end */
+    UFour       seed;                   /* seed of the random number generator */
+    PageID      *trains;
+    char        *buf;
+    double      start, elapsed;         /* time */
+    double      hitRatio, lost;         /* hit ratio and % of the pages used lost to the rounding */
+    EduBfM_Stats stats;                 /* statistics of the LOT_LEAF_BUF pool */
+    EduBfM_VarTrainStats vtStats;       /* counters of the pool of the variable-size trains */
+
+    nTrains = BI_NBUFS(LOT_LEAF_BUF) * VT_TRAINS_PER_BUFFER;
+    nHot = nTrains / 2;
+    poolPages = BI_NBUFS(LOT_LEAF_BUF) * BI_BUFSIZE(LOT_LEAF_BUF);
+
+    trains = (PageID *)malloc(sizeof(PageID) * nTrains);
+    if (trains == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    e = edubfm_bench_AllocTrains(volId, nTrains, BI_BUFSIZE(LOT_LEAF_BUF), trains);
+    if (e < eNOERROR) ERR(e);
+
+    /* stamp page j of train t with t * BI_BUFSIZE + j */
+    e = EduBfM_Init();
+    if (e < eNOERROR) ERR(e);
+
+    for (t = 0; t < nTrains; t++) {
+        e = EduBfM_GetTrain(&trains[t], &buf, LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        for (j = 0; j < BI_BUFSIZE(LOT_LEAF_BUF); j++) {
+            stamp = t * BI_BUFSIZE(LOT_LEAF_BUF) + j;
+            memcpy(buf + j * PAGESIZE, &stamp, sizeof(Four));
+        }
+        e = EduBfM_SetDirty(&trains[t], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        e = EduBfM_FreeTrain(&trains[t], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    e = EduBfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_DiscardAll();
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_Final();
+    if (e < eNOERROR) ERR(e);
+
+    printf("%12s %8s %10s %12s %10s %12s %8s\n", "pool", "pages", "hit", "fixes/sec", "held", "lost pages", "wrong");
+
+    for (mode = 0; mode < 2; mode++) {
+
+        edubfm_cfgParams.varTrainPoolPages = (mode == 1) ? poolPages : 0;
+        e = EduBfM_Init();
+        if (e < eNOERROR) ERR(e);
+
+        EduBfM_ResetStats();
+
+        seed = 1;
+        nWrong = 0;
+        start = edubfm_bench_Now();
+
+        for (i = 0; i < nOps; i++) {
+            t = (rand_r(&seed) % 100 < VT_HOT_PERCENT) ? rand_r(&seed) % nHot : rand_r(&seed) % nTrains;
+            nPages = VT_TRAIN_PAGES(t);
+
+            if (mode == 0) e = EduBfM_GetTrain(&trains[t], &buf, LOT_LEAF_BUF);
+            else e = EduBfM_GetVarTrain(&trains[t], &buf, nPages);
+            if (e < eNOERROR) ERR(e);
+
+            for (j = 0; j < nPages; j++) {
+                memcpy(&stamp, buf + j * PAGESIZE, sizeof(Four));
+                if (stamp != t * BI_BUFSIZE(LOT_LEAF_BUF) + j) nWrong++;
+            }
+
+            /* rewrite the stamp of the last page */
+            if (rand_r(&seed) % 100 < VT_DIRTY_PERCENT) {
+                stamp = t * BI_BUFSIZE(LOT_LEAF_BUF) + nPages - 1;
+                memcpy(buf + (nPages - 1) * PAGESIZE, &stamp, sizeof(Four));
+
+                if (mode == 0) e = EduBfM_SetDirty(&trains[t], LOT_LEAF_BUF);
+                else e = EduBfM_SetDirtyVarTrain(&trains[t]);
+                if (e < eNOERROR) ERR(e);
+            }
+
+            if (mode == 0) e = EduBfM_FreeTrain(&trains[t], LOT_LEAF_BUF);
+            else e = EduBfM_FreeVarTrain(&trains[t]);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        elapsed = edubfm_bench_Now() - start;
+
+        if (mode == 0) {
+            memset(&stats, 0, sizeof(EduBfM_Stats));
+            EduBfM_GetStats(LOT_LEAF_BUF, &stats);
+            hitRatio = stats.nFixes == 0 ? 0.0 : 100.0 * stats.nHits / stats.nFixes;
+
+            /* every train held occupies BI_BUFSIZE(LOT_LEAF_BUF) pages */
+            nHeld = 0;
+            lost = 0;
+            for (t = 0; t < nTrains; t++) {
+                if (edubfm_LookUp((BfMHashKey *)&trains[t], LOT_LEAF_BUF) == NIL) continue;
+                nHeld++;
+                lost += BI_BUFSIZE(LOT_LEAF_BUF) - VT_TRAIN_PAGES(t);
+            }
+            lost = nHeld == 0 ? 0.0 : 100.0 * lost / (nHeld * BI_BUFSIZE(LOT_LEAF_BUF));
+        }
+        else {
+            EduBfM_GetVarTrainStats(&vtStats);
+            hitRatio = vtStats.nFixes == 0 ? 0.0 : 100.0 * vtStats.nHits / vtStats.nFixes;
+            nHeld = vtStats.nTrains;
+            lost = vtStats.nPagesUsed == 0 ? 0.0 : 100.0 * (vtStats.nPagesUsed - vtStats.nPagesRequested) / vtStats.nPagesUsed;
+
+            /* write the trains back, and read all of them again */
+            e = EduBfM_FlushAll();
+            if (e < eNOERROR) ERR(e);
+
+            e = EduBfM_DiscardAll();
+            if (e < eNOERROR) ERR(e);
+
+            for (t = 0; t < nTrains; t++) {
+                nPages = VT_TRAIN_PAGES(t);
+                e = EduBfM_GetVarTrain(&trains[t], &buf, nPages);
+                if (e < eNOERROR) ERR(e);
+                for (j = 0; j < nPages; j++) {
+                    memcpy(&stamp, buf + j * PAGESIZE, sizeof(Four));
+                    if (stamp != t * BI_BUFSIZE(LOT_LEAF_BUF) + j) nWrong++;
+                }
+                e = EduBfM_FreeVarTrain(&trains[t]);
+                if (e < eNOERROR) ERR(e);
+            }
+        }
+
+        printf("%12s %8d %9.1f%% %12.0f %10d %11.1f%% %8d\n", (mode == 0) ? "LOT_LEAF_BUF" : "var-size", poolPages,
+               hitRatio, (double)nOps / elapsed, nHeld, lost, nWrong);
+
+        e = EduBfM_Final();
+        if (e < eNOERROR) ERR(e);
+    }
+
+    edubfm_cfgParams.varTrainPoolPages = 0;
+    free(trains);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_VarTrain() */
+
+
+/*
+ * Benchmark "cleanfirst" : tail latency of EduBfM_GetTrain() with and without the clean-first victim selection
+ */
+
+/* # of trains updated, relative to the # of buffers */
+#define CF_TRAINS_PER_BUFFER    2
+/* % of the fixes which modify the train */
+#define CF_DIRTY_PERCENT        50
+/* default budget, relative to the # of buffers (1/CF_BUDGET_FRACTION of them) */
+#define CF_BUDGET_FRACTION      4
+
+/*@================================
+ * edubfm_bench_CompareLatencies()
+ *================================*/
+/*
+ * Function: static int edubfm_bench_CompareLatencies(const void *, const void *)
+ *
+ * Description:
+ *  Compare two latencies for qsort().
+ *
+ * Returns:
+ *  negative, 0 or positive as the first latency is shorter, equal or longer
+ */
+static int edubfm_bench_CompareLatencies(
+    const void  *a,                     /* IN latency */
+    const void  *b)                     /* IN latency */
+{
+    double      x = *(const double *)a;
+    double      y = *(const double *)b;
+
+    return((x > y) - (x < y));
+
+} /* edubfm_bench_CompareLatencies() */
+
+/*@================================
+ * edubfm_bench_CleanFirst()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_CleanFirst(Four, Four, char *)
+ *
+ * Description:
+ *  Fix random trains from a set twice as large as the LOT_LEAF_BUF pool,
+ *  modifying CF_DIRTY_PERCENT % of them, and time every EduBfM_GetTrain(),
+ *  with the clean-first budget 0 (the plain clock) and arg (default: 1/4
+ *  of the buffers), each without and with the background writer keeping
+ *  50 % of the unfixed buffers clean. The fixes are timed after a warm-up
+ *  of as many fixes as the trains. The percentiles of the latency, the
+ *  synchronous writes and the dirty buffers passed over are printed.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_CleanFirst(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of timed fixes */
+    char        *arg)                   /* IN budget (# of dirty buffers) */
+{
+    Four        e;                      /* for errors */
+    Four        i, n, round;
+    Four        nTrains;                /* # of trains */
+    Four        budgets[2];             /* clean-first budgets compared */
+    PageID      *trains;
+    UFour       seed;                   /* seed of the random number generator */
+    char        *buf;
+    double      *latencies;             /* latency of each timed fix (unit: usec) */
+    double      start, elapsed;         /* time */
+    EduBfM_WriterStats before, after;   /* writer counters before and after the timed fixes */
+    EduBfM_Stats stats;
+
+    nTrains = BI_NBUFS(LOT_LEAF_BUF) * CF_TRAINS_PER_BUFFER;
+    budgets[0] = 0;
+    budgets[1] = (arg != NULL) ? atoi(arg) : BI_NBUFS(LOT_LEAF_BUF) / CF_BUDGET_FRACTION;
+
+    trains = (PageID *)malloc(sizeof(PageID) * nTrains);
+    latencies = (double *)malloc(sizeof(double) * nOps);
+    if (trains == NULL || latencies == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    e = edubfm_bench_AllocTrains(volId, nTrains, BI_BUFSIZE(LOT_LEAF_BUF), trains);
+    if (e < eNOERROR) ERR(e);
+
+    printf("%8s %8s %12s %10s %10s %10s %10s %12s %12s\n", "clean %", "budget", "fixes/sec",
+           "p50 usec", "p99", "p99.9", "max", "sync writes", "dirty skips");
+
+    for (round = 0; round < 4; round++) {
+
+        e = EduBfM_FlushAll();
+        if (e < eNOERROR) ERR(e);
+        e = EduBfM_DiscardAll();
+        if (e < eNOERROR) ERR(e);
+
+        edubfm_cfgParams.nPartitions = 1;
+        edubfm_cfgParams.bgWriterCleanPercent = (round / 2) * 50;
+        edubfm_cfgParams.bgWriterInterval = 1;
+        edubfm_cfgParams.cleanFirstBudget = budgets[round % 2];
+        e = EduBfM_Init();
+        if (e < eNOERROR) ERR(e);
+
+        // 측정 전에 bufferPool을 수정된 train들로 채움
+        seed = 1;
+        for (n = -nTrains; n < nOps; n++) {
+            i = rand_r(&seed) % nTrains;
+
+            if (n == 0) {
+                e = EduBfM_GetWriterStats(&before);
+                if (e < eNOERROR) ERR(e);
+                BFM_STATS( EduBfM_ResetStats() );
+                start = edubfm_bench_Now();
+            }
+
+            elapsed = edubfm_bench_Now();
+            e = EduBfM_GetTrain(&trains[i], &buf, LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+            if (n >= 0) latencies[n] = (edubfm_bench_Now() - elapsed) * 1e6;
+
+            if (rand_r(&seed) % 100 < CF_DIRTY_PERCENT) {
+                buf[PAGESIZE - 1]++;
+                e = EduBfM_SetDirty(&trains[i], LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+            }
+
+            e = EduBfM_FreeTrain(&trains[i], LOT_LEAF_BUF);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        elapsed = edubfm_bench_Now() - start;
+
+        e = EduBfM_GetWriterStats(&after);
+        if (e < eNOERROR) ERR(e);
+
+        memset(&stats, 0, sizeof(EduBfM_Stats));
+        BFM_STATS( EduBfM_GetStats(LOT_LEAF_BUF, &stats) );
+
+        qsort(latencies, nOps, sizeof(double), edubfm_bench_CompareLatencies);
+
+        printf("%8d %8d %12.0f %10.1f %10.1f %10.1f %10.1f %12u %12llu\n",
+               edubfm_cfgParams.bgWriterCleanPercent, edubfm_cfgParams.cleanFirstBudget, nOps / elapsed,
+               latencies[nOps / 2], latencies[(Four)(nOps * 0.99)], latencies[(Four)(nOps * 0.999)], latencies[nOps - 1],
+               after.nSyncWrites - before.nSyncWrites, stats.nDirtySkips);
+
+        e = EduBfM_Final();
+        if (e < eNOERROR) ERR(e);
+    }
+
+    edubfm_cfgParams.nPartitions = 0;
+    edubfm_cfgParams.bgWriterCleanPercent = 0;
+    edubfm_cfgParams.bgWriterInterval = 0;
+    edubfm_cfgParams.cleanFirstBudget = 0;
+    free(latencies);
+    free(trains);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_CleanFirst() */
+
+
+/*
+ * Benchmark "suite" : ns/op, hit ratio and I/Os of each policy under synthetic access distributions, in CSV
+ */
+
+/* access distributions */
+#define SUITE_UNIFORM           0       /* uniform over all trains */
+#define SUITE_ZIPF              1       /* Zipfian over all trains (exponent SUITE_ZIPF_THETA) */
+#define SUITE_SEQUENTIAL        2       /* consecutive trains, wrapping around all trains */
+#define SUITE_LOOP              3       /* consecutive trains, wrapping around a loop 1/4 larger than the pool */
+#define SUITE_SCANPOINT         4       /* a scan over the cold trains interleaved with uniform points on the hot trains */
+#define SUITE_NDISTS            5
+
+/* # of trains, relative to the # of buffers of the LOT_LEAF_BUF pool */
+#define SUITE_TRAINS_PER_BUFFER 2
+/* exponent of the Zipfian distribution */
+#define SUITE_ZIPF_THETA        0.99
+/* fraction of the trains which are hot in SUITE_SCANPOINT (1/SUITE_HOT_FRACTION) */
+#define SUITE_HOT_FRACTION      8
+/* # of timed fixes of each configuration, relative to nOps (1/SUITE_OPS_DIVISOR) */
+#define SUITE_OPS_DIVISOR       20
+
+static char *suiteDistNames[SUITE_NDISTS] = { "uniform", "zipf", "sequential", "loop", "scan+point" };
+
+/*@================================
+ * edubfm_bench_SuiteNext()
+ *================================*/
+/*
+ * Function: static Four edubfm_bench_SuiteNext(Four, Four, Four, Four, double *, UFour *)
+ *
+ * Description:
+ *  Return the index of the train accessed by the n-th fix of the given
+ *  distribution.
+ *
+ * Returns:
+ *  index of the train
+ */
+static Four edubfm_bench_SuiteNext(
+    Four        dist,                   /* IN access distribution */
+    Four        n,                      /* IN # of fixes done before */
+    Four        nTrains,                /* IN # of trains */
+    Four        poolBufs,               /* IN # of buffers of the pool */
+    double      *zipfCdf,               /* IN cumulative probability of each rank of the Zipfian distribution */
+    UFour       *seed)                  /* INOUT seed of the random number generator */
+{
+    Four        lo, hi, mid;
+    Four        nHot;                   /* # of hot trains */
+    double      u;
+
+    switch (dist) {
+      case SUITE_UNIFORM:
+        return(rand_r(seed) % nTrains);
+
+      case SUITE_ZIPF:
+        // 누적 확률이 u 이상인 첫 번째 rank를 이진 탐색함
+        u = (double)rand_r(seed) / ((double)RAND_MAX + 1);
+        for (lo = 0, hi = nTrains - 1; lo < hi; ) {
+            mid = (lo + hi) / 2;
+            if (zipfCdf[mid] < u) lo = mid + 1;
+            else hi = mid;
+        }
+        return(lo);
+
+      case SUITE_SEQUENTIAL:
+        return(n % nTrains);
+
+      case SUITE_LOOP:
+        return(n % MIN(poolBufs + poolBufs / 4, nTrains));
+
+      default:
+        nHot = nTrains / SUITE_HOT_FRACTION;
+        if (n % 2 == 0) return(rand_r(seed) % nHot);
+        return(nHot + (n / 2) % (nTrains - nHot));
+    }
+
+} /* edubfm_bench_SuiteNext() */
+
+/*@================================
+ * edubfm_bench_Suite()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_Suite(Four, Four, char *)
+ *
+ * Description:
+ *  For every replacement policy, access distribution (SUITE_UNIFORM ..
+ *  SUITE_SCANPOINT), size of the LOT_LEAF_BUF pool (1/4, 1/2 and all of
+ *  its buffers, set by EduBfM_ResizeBuffer()) and dirty ratio (0 and 50 %
+ *  of the fixes set the dirty bit), fix trains out of twice as many as
+ *  the whole pool holds. The pool is first filled with the last trains
+ *  and warmed up by twice as many fixes as its buffers; then
+ *  nOps/SUITE_OPS_DIVISOR GetTrain/SetDirty/FreeTrain sequences are
+ *  timed with a fixed seed, so that the runs can be compared.
+ *  A CSV row with the ns/op, the hit ratio, the # of trains read and
+ *  written (the last two need EDUBFM_STATS) is written for each
+ *  configuration to the file 'arg' (stdout if omitted).
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_Suite(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of fixes, SUITE_OPS_DIVISOR times the # of fixes of each configuration */
+    char        *arg)                   /* IN CSV file */
+{
+    Four        e;                      /* for errors */
+    Four        i, n, t;
+    Four        policy, dist, size, dirty;
+    Four        nBufs;                  /* # of buffers of the whole pool */
+    Four        poolBufs;               /* # of buffers after resizing */
+    Four        nTrains;                /* # of trains */
+    Four        nWarmUp;                /* # of fixes before the timed ones */
+    Four        nTimed;                 /* # of timed fixes */
+    PageID      *trains;
+    double      *zipfCdf;               /* cumulative probability of each rank of the Zipfian distribution */
+    UFour       seed;                   /* seed of the random number generator */
+    char        *buf;
+    double      start, elapsed;         /* time */
+    FILE        *fp;                    /* CSV file */
+    EduBfM_Stats stats;
+    static Four poolPercents[] = { 25, 50, 100 };
+    static Four dirtyPercents[] = { 0, 50 };
+
+    nBufs = BI_NBUFS(LOT_LEAF_BUF);
+    nTrains = nBufs * SUITE_TRAINS_PER_BUFFER;
+    nTimed = MAX(nOps / SUITE_OPS_DIVISOR, 1);
+
+    trains = (PageID *)malloc(sizeof(PageID) * nTrains);
+    zipfCdf = (double *)malloc(sizeof(double) * nTrains);
+    if (trains == NULL || zipfCdf == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    e = edubfm_bench_AllocTrains(volId, nTrains, BI_BUFSIZE(LOT_LEAF_BUF), trains);
+    if (e < eNOERROR) ERR(e);
+
+    for (zipfCdf[0] = 1.0, t = 1; t < nTrains; t++) zipfCdf[t] = zipfCdf[t - 1] + 1.0 / pow(t + 1, SUITE_ZIPF_THETA);
+    for (t = 0; t < nTrains; t++) zipfCdf[t] /= zipfCdf[nTrains - 1];
+
+    fp = (arg != NULL) ? fopen(arg, "w") : stdout;
+    if (fp == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    fprintf(fp, "policy,distribution,pool_buffers,trains,dirty_percent,ops,ns_per_op,hit_ratio,reads,writes\n");
+
+    for (policy = 0; policy < NUM_BFM_POLICIES; policy++) {
+        for (dist = 0; dist < SUITE_NDISTS; dist++) {
+            for (size = 0; size < sizeof(poolPercents) / sizeof(Four); size++) {
+                for (dirty = 0; dirty < sizeof(dirtyPercents) / sizeof(Four); dirty++) {
+
+                    e = EduBfM_FlushAll();
+                    if (e < eNOERROR) ERR(e);
+                    e = EduBfM_DiscardAll();
+                    if (e < eNOERROR) ERR(e);
+
+                    edubfm_cfgParams.replacementPolicy[LOT_LEAF_BUF] = policy;
+                    edubfm_cfgParams.maxBufs[LOT_LEAF_BUF] = nBufs;
+                    e = EduBfM_Init();
+                    if (e < eNOERROR) ERR(e);
+
+                    e = EduBfM_ResizeBuffer(LOT_LEAF_BUF, nBufs * poolPercents[size] / 100, &poolBufs);
+                    if (e < eNOERROR) ERR(e);
+
+                    // 측정 전에 bufferPool을 서로 다른 train들로 채움
+                    for (t = nTrains - poolBufs; t < nTrains; t++) {
+                        e = EduBfM_GetTrain(&trains[t], &buf, LOT_LEAF_BUF);
+                        if (e < eNOERROR) ERR(e);
+                        e = EduBfM_FreeTrain(&trains[t], LOT_LEAF_BUF);
+                        if (e < eNOERROR) ERR(e);
+                    }
+
+                    nWarmUp = poolBufs * 2;
+                    seed = 1;
+
+                    for (n = 0; n < nWarmUp + nTimed; n++) {
+                        if (n == nWarmUp) {
+                            BFM_STATS( EduBfM_ResetStats() );
+                            start = edubfm_bench_Now();
+                        }
+
+                        i = edubfm_bench_SuiteNext(dist, n, nTrains, poolBufs, zipfCdf, &seed);
+
+                        e = EduBfM_GetTrain(&trains[i], &buf, LOT_LEAF_BUF);
+                        if (e < eNOERROR) ERR(e);
+                        if (rand_r(&seed) % 100 < dirtyPercents[dirty]) {
+                            buf[PAGESIZE - 1]++;
+                            e = EduBfM_SetDirty(&trains[i], LOT_LEAF_BUF);
+                            if (e < eNOERROR) ERR(e);
+                        }
+                        e = EduBfM_FreeTrain(&trains[i], LOT_LEAF_BUF);
+                        if (e < eNOERROR) ERR(e);
+                    }
+
+                    elapsed = edubfm_bench_Now() - start;
+
+                    memset(&stats, 0, sizeof(EduBfM_Stats));
+                    BFM_STATS( EduBfM_GetStats(LOT_LEAF_BUF, &stats) );
+
+                    fprintf(fp, "%s,%s,%d,%d,%d,%d,%.1f,%.4f,%llu,%llu\n", edubfm_policies[policy].name, suiteDistNames[dist],
+                            poolBufs, nTrains, dirtyPercents[dirty], nTimed, elapsed * 1e9 / nTimed,
+                            stats.nFixes == 0 ? 0.0 : (double)stats.nHits / stats.nFixes, stats.nMisses, stats.nWriteBacks);
+
+                    // EduBfM_Final()은 resizable buffer pool을 사용 중인 크기로 줄이므로, 원래 크기로 되돌림
+                    e = EduBfM_ResizeBuffer(LOT_LEAF_BUF, nBufs, &poolBufs);
+                    if (e < eNOERROR) ERR(e);
+
+                    e = EduBfM_Final();
+                    if (e < eNOERROR) ERR(e);
+                }
+            }
+        }
+    }
+
+    if (fp != stdout) fclose(fp);
+    else fflush(fp);
+
+    edubfm_cfgParams.replacementPolicy[LOT_LEAF_BUF] = BFM_CLOCK;
+    edubfm_cfgParams.maxBufs[LOT_LEAF_BUF] = 0;
+    free(zipfCdf);
+    free(trains);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_Suite() */
+
+
+
+/*
+ * Benchmark "asyncio" : misses, batched fixes and flushes with the synchronous and the asynchronous I/O
+ */
+
+/* # of trains accessed, relative to the # of buffers */
+#define AIO_TRAINS_PER_BUFFER   4
+/* percentage of the fixes modifying the train */
+#define AIO_DIRTY_PERCENT       10
+/* default # of requests in flight */
+#define AIO_DEFAULT_DEPTH       32
+/* # of threads fixing the trains */
+#define AIO_NTHREADS            4
+/* # of cold trains fixed by all threads in the same order */
+#define AIO_HOT_TRAINS          64
+#define AIO_NMODES              3
+
+typedef struct {
+    pthread_t   thread;
+    UFour       seed;                   /* seed of the random number generator */
+    Four        nOps;                   /* # of fix/unfix pairs to perform */
+    Four        nTrains;                /* # of trains */
+    Boolean     inOrder;                /* TRUE if the trains are fixed in order, FALSE if at random */
+    PageID      *trains;
+    Four        nWrong;                 /* # of wrong stamps read */
+    Four        e;                      /* error of this thread */
+} AsyncIOWorker;
+
+static void *edubfm_bench_AsyncIOWorker(
+    void        *arg)                   /* IN AsyncIOWorker */
+{
+    AsyncIOWorker *w = (AsyncIOWorker *)arg;
+    Four        i, t, stamp;
+    char        *buf;
+
+    for (i = 0; i < w->nOps; i++) {
+        t = (w->inOrder) ? i % w->nTrains : rand_r(&w->seed) % w->nTrains;
+
+        w->e = EduBfM_GetTrain(&w->trains[t], &buf, LOT_LEAF_BUF);
+        if (w->e < eNOERROR) break;
+
+        memcpy(&stamp, buf, sizeof(Four));
+        if (stamp != t) w->nWrong++;
+
+        // train을 같은 stamp로 다시 기록하여 write-back을 일으킴
+        if (!w->inOrder && rand_r(&w->seed) % 100 < AIO_DIRTY_PERCENT) {
+            memcpy(buf, &t, sizeof(Four));
+            w->e = EduBfM_SetDirty(&w->trains[t], LOT_LEAF_BUF);
+            if (w->e < eNOERROR) break;
+        }
+
+        w->e = EduBfM_FreeTrain(&w->trains[t], LOT_LEAF_BUF);
+        if (w->e < eNOERROR) break;
+    }
+
+    return(NULL);
+}
+
+/*@================================
+ * edubfm_bench_AsyncIOThreads()
+ *================================*/
+/*
+ * Function: static Four edubfm_bench_AsyncIOThreads(Four, Four, Boolean, PageID *, Four *)
+ *
+ * Description:
+ *  Let AIO_NTHREADS threads fix nOps of the given trains each, at random
+ *  or all in the same order, and check the stamps they read.
+ *
+ * Returns:
+ *  error code
+ */
+static Four edubfm_bench_AsyncIOThreads(
+    Four        nOps,                   /* IN # of fixes per thread */
+    Four        nTrains,                /* IN # of trains */
+    Boolean     inOrder,                /* IN fix the trains in order */
+    PageID      *trains,                /* IN trains stamped with their numbers */
+    Four        *nWrong)                /* OUT # of wrong stamps read */
+{
+    Four        t;
+    AsyncIOWorker workers[AIO_NTHREADS];
+
+    for (t = 0; t < AIO_NTHREADS; t++) {
+        workers[t].seed = t + 1;
+        workers[t].nOps = nOps;
+        workers[t].nTrains = nTrains;
+        workers[t].inOrder = inOrder;
+        workers[t].trains = trains;
+        workers[t].nWrong = 0;
+        workers[t].e = eNOERROR;
+        pthread_create(&workers[t].thread, NULL, edubfm_bench_AsyncIOWorker, &workers[t]);
+    }
+
+    *nWrong = 0;
+    for (t = 0; t < AIO_NTHREADS; t++) pthread_join(workers[t].thread, NULL);
+    for (t = 0; t < AIO_NTHREADS; t++) {
+        if (workers[t].e < eNOERROR) ERR(workers[t].e);
+        *nWrong += workers[t].nWrong;
+    }
+
+    return(eNOERROR);
+
+} /* edubfm_bench_AsyncIOThreads() */
+
+/*@================================
+ * edubfm_bench_AsyncIO()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_AsyncIO(Four, Four, char *)
+ *
+ * Description:
+ *  Stamp AIO_TRAINS_PER_BUFFER times as many trains as the LOT_LEAF_BUF
+ *  pool holds with their numbers, and access them through the attached
+ *  benchmark volume with edubfm_cfgParams.useDirectIO, with the synchronous
+ *  I/O, with io_uring and with the pool of I/O threads (both with 'arg'
+ *  requests in flight, AIO_DEFAULT_DEPTH if omitted):
+ *   - AIO_NTHREADS threads fix nOps random trains each, modifying some
+ *   - batches of PF_BATCH random trains are fixed by EduBfM_GetTrains()
+ *   - the buffer pool is dirtied and flushed with sm_cfgParams.useBulkFlush
+ *   - AIO_NTHREADS threads fix the same AIO_HOT_TRAINS cold trains in order
+ *  The fix rates, the flush time, the # of wrong stamps, the # of reads of
+ *  the hot trains beyond the first one and the asynchronous I/O counters
+ *  are printed.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_AsyncIO(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of fixes per thread */
+    char        *arg)                   /* IN # of requests in flight */
+{
+    Four        e;                      /* for errors */
+    Four        i, n, t, mode;
+    Four        fd;
+    Four        depth;                  /* # of requests in flight */
+    Four        nTrains;                /* # of trains */
+    Four        nWrong, nHotWrong;      /* # of wrong stamps */
+    Four        nDupReads;              /* # of reads of the hot trains beyond the first one */
+    Boolean     saveBulkFlush;
+    PageID      *trains;
+    PageID      batch[PF_BATCH];
+    char        *bufs[PF_BATCH];
+    char        *buf;
+    UFour       seed;                   /* seed of the random number generator */
+    double      start, fixRate, batchRate, flushMsec;
+    EduBfM_AsyncIOStats stats, before;
+
+    saveBulkFlush = sm_cfgParams.useBulkFlush;
+    depth = (arg != NULL) ? atoi(arg) : AIO_DEFAULT_DEPTH;
+    if (depth < 1 || depth > AIO_MAX_DEPTH) ERR(eBADPARAMETER_EDUBFM);
+
+    nTrains = BI_NBUFS(LOT_LEAF_BUF) * AIO_TRAINS_PER_BUFFER;
+    trains = (PageID *)malloc(sizeof(PageID) * nTrains);
+    if (trains == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    e = edubfm_bench_AllocTrains(volId, nTrains, BI_BUFSIZE(LOT_LEAF_BUF), trains);
+    if (e < eNOERROR) goto error;
+
+    e = EduBfM_Init();
+    if (e < eNOERROR) goto error;
+
+    for (t = 0; t < nTrains; t++) {
+        e = EduBfM_GetTrain(&trains[t], &buf, LOT_LEAF_BUF);
+        if (e < eNOERROR) goto error;
+        memcpy(buf, &t, sizeof(Four));
+        e = EduBfM_SetDirty(&trains[t], LOT_LEAF_BUF);
+        if (e < eNOERROR) goto error;
+        e = EduBfM_FreeTrain(&trains[t], LOT_LEAF_BUF);
+        if (e < eNOERROR) goto error;
+    }
+
+    e = EduBfM_FlushAll();
+    if (e < eNOERROR) goto error;
+    e = EduBfM_DiscardAll();
+    if (e < eNOERROR) goto error;
+
+    e = EduBfM_Final();
+    if (e < eNOERROR) goto error;
+
+    sm_cfgParams.useBulkFlush = TRUE;
+
+    printf("%10s %6s %12s %12s %10s %6s %8s %8s %8s %8s %8s\n", "I/O", "depth", "fixes/sec", "batch/sec",
+           "flush msec", "wrong", "reads", "writes", "inflight", "waits", "dupreads");
+
+    for (mode = 0; mode < AIO_NMODES; mode++) {
+
+        edubfm_cfgParams.useDirectIO = TRUE;
+        edubfm_cfgParams.ioQueueDepth = (mode == 0) ? 0 : depth;
+        edubfm_cfgParams.useIOThreadPool = (mode == 2);
+        edubfm_cfgParams.nPartitions = MTFIX_NPARTITIONS;
+        e = EduBfM_Init();
+        if (e < eNOERROR) goto error;
+
+        e = EduBfM_AttachVolume(volId, BENCH_VOLUME_NAME);
+        if (e < eNOERROR) goto error;
+
+        // 운영체제의 page cache를 비움
+        fd = open(BENCH_VOLUME_NAME, O_RDONLY);
+        if (fd >= 0) {
+            fdatasync(fd);
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+        }
+
+        // 여러 thread가 임의의 train들을 fix함
+        start = edubfm_bench_Now();
+        e = edubfm_bench_AsyncIOThreads(nOps, nTrains, FALSE, trains, &nWrong);
+        if (e < eNOERROR) goto error;
+        fixRate = (double)nOps * AIO_NTHREADS / (edubfm_bench_Now() - start);
+
+        // 임의의 train들을 PF_BATCH 개씩 함께 fix함
+        seed = 1;
+        start = edubfm_bench_Now();
+        for (n = 0; n < nOps; n += PF_BATCH) {
+            for (i = 0; i < PF_BATCH; i++) batch[i] = trains[rand_r(&seed) % nTrains];
+
+            e = EduBfM_GetTrains(batch, bufs, PF_BATCH, LOT_LEAF_BUF);
+            if (e < eNOERROR) goto error;
+
+            for (i = 0; i < PF_BATCH; i++) {
+                e = EduBfM_FreeTrain(&batch[i], LOT_LEAF_BUF);
+                if (e < eNOERROR) goto error;
+            }
+        }
+        batchRate = n / (edubfm_bench_Now() - start);
+
+        // buffer pool을 모두 dirty로 만든 후 flush함
+        for (t = 0; t < BI_NBUFS(LOT_LEAF_BUF); t++) {
+            e = EduBfM_GetTrain(&trains[t], &buf, LOT_LEAF_BUF);
+            if (e < eNOERROR) goto error;
+            e = EduBfM_SetDirty(&trains[t], LOT_LEAF_BUF);
+            if (e < eNOERROR) goto error;
+            e = EduBfM_FreeTrain(&trains[t], LOT_LEAF_BUF);
+            if (e < eNOERROR) goto error;
+        }
+
+        start = edubfm_bench_Now();
+        e = EduBfM_FlushAll();
+        if (e < eNOERROR) goto error;
+        flushMsec = (edubfm_bench_Now() - start) * 1000;
+
+        // 모든 thread가 같은 cold train들을 같은 순서로 fix함
+        e = EduBfM_DiscardAll();
+        if (e < eNOERROR) goto error;
+
+        memset(&before, 0, sizeof(EduBfM_AsyncIOStats));
+        EduBfM_GetAsyncIOStats(&before);
+
+        e = edubfm_bench_AsyncIOThreads(AIO_HOT_TRAINS, AIO_HOT_TRAINS, TRUE, trains, &nHotWrong);
+        if (e < eNOERROR) goto error;
+        nWrong += nHotWrong;
+
+        memset(&stats, 0, sizeof(EduBfM_AsyncIOStats));
+        EduBfM_GetAsyncIOStats(&stats);
+        nDupReads = (Four)(stats.nReads - before.nReads) - AIO_HOT_TRAINS;
+
+        if (mode == 0)
+            printf("%10s %6d %12.0f %12.0f %10.1f %6d %8s %8s %8s %8s %8s\n", "sync", 0,
+                   fixRate, batchRate, flushMsec, nWrong, "-", "-", "-", "-", "-");
+        else
+            printf("%10s %6d %12.0f %12.0f %10.1f %6d %8u %8u %8u %8u %8d\n",
+                   stats.usingIoUring ? "io_uring" : "threads", depth, fixRate, batchRate, flushMsec, nWrong,
+                   stats.nReads, stats.nWrites, stats.maxInFlight, stats.nFrameWaits, nDupReads);
+
+        e = EduBfM_DetachVolume(volId);
+        if (e < eNOERROR) goto error;
+
+        e = EduBfM_Final();
+        if (e < eNOERROR) goto error;
+    }
+
+    e = eNOERROR;
+
+error:
+    // 오류가 발생한 경우에도 설정을 되돌리고 train 목록을 해제함
+    edubfm_cfgParams.useDirectIO = edubfm_cfgParams.useIOThreadPool = FALSE;
+    edubfm_cfgParams.ioQueueDepth = 0;
+    edubfm_cfgParams.nPartitions = 0;
+    sm_cfgParams.useBulkFlush = saveBulkFlush;
+    free(trains);
+
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_AsyncIO() */
+
+
+
+/*
+ * Benchmark "memvol" : the variance of the fix rate with the device and with a copy of it in memory
+ */
+
+/* # of trains accessed, relative to the # of buffers */
+#define MEMVOL_TRAINS_PER_BUFFER    4
+/* percentage of the fixes modifying the train */
+#define MEMVOL_DIRTY_PERCENT        10
+/* # of repetitions of each configuration */
+#define MEMVOL_NREPS                5
+/* default latency injected into the I/Os of the memory volume (unit: usec) */
+#define MEMVOL_DEFAULT_LATENCY      100
+/* bandwidth of the memory volume with the latency (unit: MB/s) */
+#define MEMVOL_BANDWIDTH            400
+#define MEMVOL_NMODES               3
+
+/*@================================
+ * edubfm_bench_MemoryVolume()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_MemoryVolume(Four, Four, char *)
+ *
+ * Description:
+ *  Stamp MEMVOL_TRAINS_PER_BUFFER times as many trains as the LOT_LEAF_BUF
+ *  pool holds with their numbers, and fix nOps random trains (modifying
+ *  MEMVOL_DIRTY_PERCENT % of them) MEMVOL_NREPS times with the benchmark
+ *  volume attached by EduBfM_AttachVolume() (the page cache of the OS is
+ *  emptied before each repetition), and by EduBfM_AttachMemoryVolume()
+ *  without a delay and with 'arg' usec of latency (MEMVOL_DEFAULT_LATENCY
+ *  if omitted) and MEMVOL_BANDWIDTH MB/s. The mean and the coefficient of
+ *  variation of the fix rate over the repetitions and the # of wrong
+ *  stamps are printed.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_MemoryVolume(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of fixes of each repetition */
+    char        *arg)                   /* IN latency of the memory volume (unit: usec) */
+{
+    Four        e;                      /* for errors */
+    Four        i, t, rep, mode;
+    Four        fd;
+    Four        latency;                /* latency of the memory volume */
+    Four        nTrains;                /* # of trains */
+    Four        nWrong;                 /* # of wrong stamps */
+    Four        stamp;
+    PageID      *trains;
+    char        *buf;
+    UFour       seed;                   /* seed of the random number generator */
+    double      start, rate, sum, sumSq, mean;
+    static char *modeNames[MEMVOL_NMODES] = { "device", "memory", "memory+delay" };
+
+    latency = (arg != NULL) ? atoi(arg) : MEMVOL_DEFAULT_LATENCY;
+    if (latency < 0) ERR(eBADPARAMETER_EDUBFM);
+
+    nTrains = BI_NBUFS(LOT_LEAF_BUF) * MEMVOL_TRAINS_PER_BUFFER;
+    trains = (PageID *)malloc(sizeof(PageID) * nTrains);
+    if (trains == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    e = edubfm_bench_AllocTrains(volId, nTrains, BI_BUFSIZE(LOT_LEAF_BUF), trains);
+    if (e < eNOERROR) ERR(e);
+
+    // 각 train에 그 번호를 기록하여 device에 저장함 (memory volume은 attach 될 때 이를 복사함)
+    e = EduBfM_Init();
+    if (e < eNOERROR) ERR(e);
+
+    for (t = 0; t < nTrains; t++) {
+        e = EduBfM_GetTrain(&trains[t], &buf, LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        memcpy(buf, &t, sizeof(Four));
+        e = EduBfM_SetDirty(&trains[t], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        e = EduBfM_FreeTrain(&trains[t], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    e = EduBfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+    e = EduBfM_DiscardAll();
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_Final();
+    if (e < eNOERROR) ERR(e);
+
+    printf("%14s %8s %12s %8s %8s\n", "volume", "latency", "fixes/sec", "cv", "wrong");
+
+    for (mode = 0; mode < MEMVOL_NMODES; mode++) {
+
+        edubfm_cfgParams.memVolumeLatency = (mode == 2) ? latency : 0;
+        edubfm_cfgParams.memVolumeBandwidth = (mode == 2) ? MEMVOL_BANDWIDTH : 0;
+        e = EduBfM_Init();
+        if (e < eNOERROR) ERR(e);
+
+        if (mode == 0) e = EduBfM_AttachVolume(volId, BENCH_VOLUME_NAME);
+        else e = EduBfM_AttachMemoryVolume(volId, BENCH_VOLUME_NAME);
+        if (e < eNOERROR) ERR(e);
+
+        sum = sumSq = 0.0;
+        nWrong = 0;
+
+        for (rep = 0; rep < MEMVOL_NREPS; rep++) {
+
+            e = EduBfM_DiscardAll();
+            if (e < eNOERROR) ERR(e);
+
+            // 운영체제의 page cache를 비움
+            if (mode == 0) {
+                fd = open(BENCH_VOLUME_NAME, O_RDONLY);
+                if (fd >= 0) {
+                    fdatasync(fd);
+                    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+                    close(fd);
+                }
+            }
+
+            seed = rep + 1;
+            start = edubfm_bench_Now();
+
+            for (i = 0; i < nOps; i++) {
+                t = rand_r(&seed) % nTrains;
+
+                e = EduBfM_GetTrain(&trains[t], &buf, LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+
+                memcpy(&stamp, buf, sizeof(Four));
+                if (stamp != t) nWrong++;
+
+                if (rand_r(&seed) % 100 < MEMVOL_DIRTY_PERCENT) {
+                    e = EduBfM_SetDirty(&trains[t], LOT_LEAF_BUF);
+                    if (e < eNOERROR) ERR(e);
+                }
+
+                e = EduBfM_FreeTrain(&trains[t], LOT_LEAF_BUF);
+                if (e < eNOERROR) ERR(e);
+            }
+
+            e = EduBfM_FlushAll();
+            if (e < eNOERROR) ERR(e);
+
+            rate = nOps / (edubfm_bench_Now() - start);
+            sum += rate;
+            sumSq += rate * rate;
+        }
+
+        mean = sum / MEMVOL_NREPS;
+        printf("%14s %8d %12.0f %7.1f%% %8d\n", modeNames[mode], edubfm_cfgParams.memVolumeLatency, mean,
+               100.0 * sqrt(MAX(sumSq / MEMVOL_NREPS - mean * mean, 0.0)) / mean, nWrong);
+
+        e = EduBfM_DetachVolume(volId);
+        if (e < eNOERROR) ERR(e);
+
+        e = EduBfM_Final();
+        if (e < eNOERROR) ERR(e);
+    }
+
+    edubfm_cfgParams.memVolumeLatency = edubfm_cfgParams.memVolumeBandwidth = 0;
+    free(trains);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_MemoryVolume() */
+
+
+
+/*
+ * Benchmark "replay" : working set, reuse distances and miss ratio curves of a trace
+ */
+
+/* trace file recorded when no trace is given */
+#define REPLAY_FILE             "bench.trace"
+/* percentage of the fixes of the recorded trace modifying the train */
+#define REPLAY_DIRTY_PERCENT    10
+/* # of sizes of the buffer pools of the miss ratio curves, and # of the smallest ones replayed by EduBfM */
+#define REPLAY_NSIZES           7
+#define REPLAY_NREPLAYED        4
+/* # of windows of the working set */
+#define REPLAY_NWINDOWS         3
+
+/* sizes of the buffer pools (% of their # of buffers) and windows of the working set (% of the # of buffers) */
+static Four replaySizes[REPLAY_NSIZES] = { 10, 25, 50, 100, 200, 400, 800 };
+static Four replayWindows[REPLAY_NWINDOWS] = { 100, 400, 1600 };
+
+/*@================================
+ * edubfm_bench_RecordTrace()
+ *================================*/
+/*
+ * Function: static Four edubfm_bench_RecordTrace(Four, Four)
+ *
+ * Description:
+ *  Record the synthetic trace of the "policy" benchmark ('nOps' accesses,
+ *  REPLAY_DIRTY_PERCENT % of them modifying the train) into REPLAY_FILE
+ *  with edubfm_cfgParams.traceFile.
+ *
+ * Returns:
+ *  error code
+ */
+static Four edubfm_bench_RecordTrace(
+    Four        volId,                  /* IN volume id */
+    Four        nOps)                   /* IN # of accesses */
+{
+    Four        e;                      /* for errors */
+    Four        i, type;
+    TraceEntry  *trace;                 /* trace */
+    Four        nEntries;               /* # of entries of the trace */
+    Four        nKeys[NUM_BUF_TYPES];   /* # of distinct train numbers of each type */
+    PageID      *trains[NUM_BUF_TYPES]; /* trains mapped to the train numbers */
+    PageID      *pid;
+    UFour       seed = 1;               /* seed of the random number generator */
+    char        *buf;
+
+    e = edubfm_bench_LoadTrace(NULL, nOps, &trace, &nEntries);
+    if (e < eNOERROR) ERR(e);
+
+    e = edubfm_bench_PrepareTrace(volId, trace, nEntries, nKeys, trains);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+    e = EduBfM_DiscardAll();
+    if (e < eNOERROR) ERR(e);
+
+    edubfm_cfgParams.traceFile = REPLAY_FILE;
+    e = EduBfM_Init();
+    if (e < eNOERROR) ERR(e);
+
+    for (i = 0; i < nEntries; i++) {
+        type = trace[i].type;
+        pid = &trains[type][trace[i].key];
+
+        e = EduBfM_GetTrain(pid, &buf, type);
+        if (e < eNOERROR) ERR(e);
+        if (rand_r(&seed) % 100 < REPLAY_DIRTY_PERCENT) {
+            e = EduBfM_SetDirty(pid, type);
+            if (e < eNOERROR) ERR(e);
+        }
+        e = EduBfM_FreeTrain(pid, type);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    e = EduBfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_Final();
+    edubfm_cfgParams.traceFile = NULL;
+    if (e < eNOERROR) ERR(e);
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) free(trains[type]);
+    free(trace);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_RecordTrace() */
+
+/*@================================
+ * edubfm_bench_ReuseDistances()
+ *================================*/
+/*
+ * Function: static Four edubfm_bench_ReuseDistances(TraceEntry *, Four, Four, Four, Four *, Four *)
+ *
+ * Description:
+ *  Compute the reuse (LRU stack) distance of each access of the type in
+ *  the trace, i.e. the # of distinct trains accessed since the last access
+ *  to the same train, and count the accesses of each distance; an LRU
+ *  buffer pool of c buffers misses the accesses of distance >= c and the
+ *  first accesses. The distances are counted by a Fenwick tree over the
+ *  accesses, marking the last access to each train.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ */
+static Four edubfm_bench_ReuseDistances(
+    TraceEntry  *trace,                 /* IN trace, numbered by edubfm_bench_PrepareTrace() */
+    Four        nEntries,               /* IN # of entries of the trace */
+    Four        type,                   /* IN buffer type */
+    Four        nKeys,                  /* IN # of distinct trains of the type */
+    Four        *count,                 /* OUT # of accesses of each distance (nKeys entries) */
+    Four        *nFirst)                /* OUT # of first accesses to the trains */
+{
+    Four        i, j, n, d;
+    Four        *last;                  /* position of the last access to each train (-1 : none) */
+    Four        *tree;                  /* Fenwick tree of the marks of the last accesses */
+
+    last = (Four *)malloc(sizeof(Four) * MAX(nKeys, 1));
+    tree = (Four *)calloc(nEntries + 1, sizeof(Four));
+    if (last == NULL || tree == NULL) {
+        free(last);
+        free(tree);
+        ERR(eMEMALLOCERR_EDUBFM);
+    }
+
+    for (i = 0; i < nKeys; i++) {
+        last[i] = -1;
+        count[i] = 0;
+    }
+    *nFirst = 0;
+
+    for (n = 0, i = 0; i < nEntries; i++) {
+        if (trace[i].type != type) continue;
+
+        // 마지막 접근 이후에 접근된 서로 다른 train의 수 (그 사이에 마지막 접근 표시가 있는 train들) 를 셈
+        if (last[trace[i].key] < 0) (*nFirst)++;
+        else {
+            for (d = 0, j = n; j > 0; j -= j & -j) d += tree[j];
+            for (j = last[trace[i].key] + 1; j > 0; j -= j & -j) d -= tree[j];
+            count[d]++;
+
+            for (j = last[trace[i].key] + 1; j <= nEntries; j += j & -j) tree[j]--;
+        }
+
+        for (j = n + 1; j <= nEntries; j += j & -j) tree[j]++;
+        last[trace[i].key] = n++;
+    }
+
+    free(last);
+    free(tree);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_ReuseDistances() */
+
+/*@================================
+ * edubfm_bench_Replay()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_Replay(Four, Four, char *)
+ *
+ * Description:
+ *  Analyze the fixes of a trace, the file 'arg' (a binary trace written by
+ *  EduBfM with edubfm_cfgParams.traceFile, or a text trace of the "policy"
+ *  benchmark), or a trace of 'nOps' synthetic accesses recorded into
+ *  REPLAY_FILE if omitted. For each buffer type, it prints:
+ *   - the average working set, i.e. the # of distinct trains in windows of
+ *     1, 4 and 16 times as many accesses as the buffer pool has buffers
+ *   - the histogram of the reuse distances
+ *   - the miss ratio curve of LRU, from 10 % to 8 times the buffer pool,
+ *     computed from the reuse distances, and the miss ratios of the trace
+ *     replayed by EduBfM with each replacement policy, with the buffer pool
+ *     resized to the sizes up to its own (starting empty)
+ *  so that the # of buffers of a deployment can be chosen from its trace.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_Replay(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of accesses of the synthetic trace */
+    char        *arg)                   /* IN trace file (NULL : record a synthetic trace) */
+{
+    Four        e;                      /* for errors */
+    Four        i, b, w, type, policy, size;
+    TraceEntry  *trace;                 /* trace */
+    Four        nEntries;               /* # of entries of the trace */
+    Four        nKeys[NUM_BUF_TYPES];   /* # of distinct trains of each type */
+    PageID      *trains[NUM_BUF_TYPES]; /* trains mapped to the train numbers */
+    Four        nAccesses[NUM_BUF_TYPES];
+    Four        nBufs[NUM_BUF_TYPES];   /* # of buffers of each buffer pool */
+    Four        resized;                /* # of buffers after resizing */
+    Four        *count;                 /* # of accesses of each reuse distance */
+    Four        nFirst;                 /* # of first accesses */
+    Four        *seen;                  /* window in which each train was accessed last */
+    Four        window, nWindows, nDistinct;
+    Four        hist[BFM_STATS_NBUCKETS];   /* histogram of the reuse distances */
+    Four        misses[NUM_BFM_POLICIES][REPLAY_NREPLAYED][NUM_BUF_TYPES];
+    double      lruMisses, cum;
+    char        *buf;
+    static char *typeNames[] = { "PAGE_BUF", "LOT_LEAF_BUF" };
+
+    if (arg == NULL) {
+        e = edubfm_bench_RecordTrace(volId, nOps);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    e = edubfm_bench_LoadTrace((arg != NULL) ? arg : REPLAY_FILE, nOps, &trace, &nEntries);
+    if (e < eNOERROR) ERR(e);
+    if (arg == NULL) unlink(REPLAY_FILE);
+
+    e = edubfm_bench_PrepareTrace(volId, trace, nEntries, nKeys, trains);
+    if (e < eNOERROR) ERR(e);
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        nBufs[type] = BI_NBUFS(type);
+        for (nAccesses[type] = 0, i = 0; i < nEntries; i++) if (trace[i].type == type) nAccesses[type]++;
+    }
+
+    // 각 replacement policy로, 각 크기로 줄인 빈 bufferPool에서 trace를 재현함
+    for (policy = 0; policy < NUM_BFM_POLICIES; policy++) {
+        for (size = 0; size < REPLAY_NREPLAYED; size++) {
+
+            e = EduBfM_FlushAll();
+            if (e < eNOERROR) ERR(e);
+            e = EduBfM_DiscardAll();
+            if (e < eNOERROR) ERR(e);
+
+            for (type = 0; type < NUM_BUF_TYPES; type++) {
+                edubfm_cfgParams.replacementPolicy[type] = policy;
+                edubfm_cfgParams.maxBufs[type] = (nAccesses[type] > 0) ? nBufs[type] : 0;
+                misses[policy][size][type] = 0;
+            }
+            e = EduBfM_Init();
+            if (e < eNOERROR) ERR(e);
+
+            for (type = 0; type < NUM_BUF_TYPES; type++) {
+                if (nAccesses[type] == 0) continue;
+                e = EduBfM_ResizeBuffer(type, MAX(nBufs[type] * replaySizes[size] / 100, 1), &resized);
+                if (e < eNOERROR) ERR(e);
+            }
+
+            for (i = 0; i < nEntries; i++) {
+                type = trace[i].type;
+
+                if (edubfm_LookUp((BfMHashKey *)&trains[type][trace[i].key], type) == NOTFOUND_IN_HTABLE) misses[policy][size][type]++;
+
+                e = EduBfM_GetTrain(&trains[type][trace[i].key], &buf, type);
+                if (e < eNOERROR) ERR(e);
+                e = EduBfM_FreeTrain(&trains[type][trace[i].key], type);
+                if (e < eNOERROR) ERR(e);
+            }
+
+            // EduBfM_Final()은 resizable buffer pool을 사용 중인 크기로 줄이므로, 원래 크기로 되돌림
+            for (type = 0; type < NUM_BUF_TYPES; type++) {
+                if (nAccesses[type] == 0) continue;
+                e = EduBfM_ResizeBuffer(type, nBufs[type], &resized);
+                if (e < eNOERROR) ERR(e);
+            }
+
+            e = EduBfM_Final();
+            if (e < eNOERROR) ERR(e);
+        }
+    }
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        edubfm_cfgParams.replacementPolicy[type] = BFM_CLOCK;
+        edubfm_cfgParams.maxBufs[type] = 0;
+    }
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        if (nAccesses[type] == 0) continue;
+
+        count = (Four *)malloc(sizeof(Four) * nKeys[type]);
+        seen = (Four *)malloc(sizeof(Four) * nKeys[type]);
+        if (count == NULL || seen == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+        e = edubfm_bench_ReuseDistances(trace, nEntries, type, nKeys[type], count, &nFirst);
+        if (e < eNOERROR) ERR(e);
+
+        printf("%s: %d accesses, %d distinct trains, %d buffers\n", typeNames[type], nAccesses[type], nKeys[type], nBufs[type]);
+
+        // 연속된 window들의 서로 다른 train 수의 평균 (working set)
+        printf("%12s %14s\n", "window", "working set");
+        for (w = 0; w < REPLAY_NWINDOWS; w++) {
+            window = MAX(nBufs[type] * replayWindows[w] / 100, 1);
+            for (i = 0; i < nKeys[type]; i++) seen[i] = -1;
+
+            for (nWindows = 0, nDistinct = 0, b = 0, i = 0; i < nEntries; i++) {
+                if (trace[i].type != type) continue;
+                if (seen[trace[i].key] != b / window) {
+                    seen[trace[i].key] = b / window;
+                    nDistinct++;
+                }
+                b++;
+            }
+            nWindows = (b + window - 1) / window;
+
+            printf("%12d %14.1f\n", window, (double)nDistinct / nWindows);
+        }
+
+        // Reuse distance의 histogram
+        for (b = 0; b < BFM_STATS_NBUCKETS; b++) hist[b] = 0;
+        for (i = 0; i < nKeys[type]; i++) hist[BFM_STATS_BUCKET(i)] += count[i];
+
+        printf("%12s %10s %10s\n", "distance <", "accesses", "cum.");
+        for (cum = 0.0, b = 0; b < BFM_STATS_NBUCKETS; b++) {
+            if (hist[b] == 0) continue;
+            cum += hist[b];
+            printf("%12lld %9.2f%% %9.2f%%\n", 1LL << b, 100.0 * hist[b] / nAccesses[type], 100.0 * cum / nAccesses[type]);
+        }
+        printf("%12s %9.2f%%\n", "first", 100.0 * nFirst / nAccesses[type]);
+
+        // Miss ratio curve (LRU는 reuse distance로부터 계산하고, 각 replacement policy는 재현한 결과)
+        printf("%12s %10s", "buffers", "LRU(dist)");
+        for (policy = 0; policy < NUM_BFM_POLICIES; policy++) printf(" %9s", edubfm_policies[policy].name);
+        printf("\n");
+
+        for (size = 0; size < REPLAY_NSIZES; size++) {
+            window = MAX(nBufs[type] * replaySizes[size] / 100, 1);
+            for (lruMisses = nFirst, i = MIN(window, nKeys[type]); i < nKeys[type]; i++) lruMisses += count[i];
+
+            printf("%12d %9.2f%%", window, 100.0 * lruMisses / nAccesses[type]);
+            for (policy = 0; policy < NUM_BFM_POLICIES; policy++) {
+                if (size < REPLAY_NREPLAYED) printf(" %8.2f%%", 100.0 * misses[policy][size][type] / nAccesses[type]);
+                else printf(" %9s", "-");
+            }
+            printf("\n");
+        }
+
+        free(count);
+        free(seen);
+    }
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) free(trains[type]);
+    free(trace);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_Replay() */
+
+
+
+/*
+ * Benchmark "checkpoint" : latency of the fixes during periodic EduBfM_FlushAll() and fuzzy checkpoints
+ */
+
+/* # of trains accessed, relative to the # of buffers */
+#define CKPT_TRAINS_PER_BUFFER  2
+/* percentage of the fixes modifying the train */
+#define CKPT_DIRTY_PERCENT      20
+/* # of threads fixing the trains */
+#define CKPT_NTHREADS           4
+/* # of partitions of the buffer pools */
+#define CKPT_NPARTITIONS        4
+/* default interval between the flushes or the checkpoints (unit: msec) */
+#define CKPT_DEFAULT_INTERVAL   200
+/* latency (unit: usec) and bandwidth (unit: MB/s) of the memory volume */
+#define CKPT_LATENCY            50
+#define CKPT_BANDWIDTH          200
+#define CKPT_NMODES             3
+
+typedef struct {
+    pthread_t   thread;
+    UFour       seed;                   /* seed of the random number generator */
+    Four        nOps;                   /* # of fix/unfix pairs to perform */
+    Four        nTrains;                /* # of trains */
+    PageID      *trains;
+    double      *latencies;             /* latency of each fix/unfix pair (unit: usec) */
+    Four        nWrong;                 /* # of wrong stamps read */
+    Four        e;                      /* error of this thread */
+} CheckpointWorker;
+
+typedef struct {
+    pthread_t   thread;
+    Four        interval;               /* interval between the flushes (unit: msec) */
+    volatile Boolean stop;              /* TRUE if the thread is requested to stop */
+    Four        nFlushes;               /* # of flushes */
+    Four        e;                      /* error of this thread */
+} CheckpointFlusher;
+
+static void *edubfm_bench_CheckpointWorker(
+    void        *arg)                   /* IN CheckpointWorker */
+{
+    CheckpointWorker *w = (CheckpointWorker *)arg;
+    Four        i, t, stamp;
+    double      start;
+    char        *buf;
+
+    for (i = 0; i < w->nOps; i++) {
+        t = rand_r(&w->seed) % w->nTrains;
+        start = edubfm_bench_Now();
+
+        w->e = EduBfM_GetTrain(&w->trains[t], &buf, LOT_LEAF_BUF);
+        if (w->e < eNOERROR) break;
+
+        memcpy(&stamp, buf, sizeof(Four));
+        if (stamp != t) w->nWrong++;
+
+        // train을 같은 stamp로 다시 기록하여 flush 할 page/train을 만듦
+        if (rand_r(&w->seed) % 100 < CKPT_DIRTY_PERCENT) {
+            memcpy(buf, &t, sizeof(Four));
+            w->e = EduBfM_SetDirty(&w->trains[t], LOT_LEAF_BUF);
+            if (w->e < eNOERROR) break;
+        }
+
+        w->e = EduBfM_FreeTrain(&w->trains[t], LOT_LEAF_BUF);
+        if (w->e < eNOERROR) break;
+
+        w->latencies[i] = (edubfm_bench_Now() - start) * 1e6;
+    }
+
+    return(NULL);
+}
+
+static void *edubfm_bench_CheckpointFlusher(
+    void        *arg)                   /* IN CheckpointFlusher */
+{
+    CheckpointFlusher *f = (CheckpointFlusher *)arg;
+
+    while (!f->stop) {
+        usleep(f->interval * 1000);
+        if (f->stop) break;
+
+        f->e = EduBfM_FlushAll();
+        if (f->e < eNOERROR) break;
+        f->nFlushes++;
+    }
+
+    return(NULL);
+}
+
+/*@================================
+ * edubfm_bench_Checkpoint()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_Checkpoint(Four, Four, char *)
+ *
+ * Description:
+ *  Stamp CKPT_TRAINS_PER_BUFFER times as many trains as the LOT_LEAF_BUF
+ *  pool holds with their numbers, attach the benchmark volume by
+ *  EduBfM_AttachMemoryVolume() with CKPT_LATENCY usec of latency and
+ *  CKPT_BANDWIDTH MB/s, and let CKPT_NTHREADS threads fix nOps random
+ *  trains each (modifying CKPT_DIRTY_PERCENT % of them) and time each
+ *  fix/unfix pair:
+ *   - without any flush
+ *   - while another thread calls EduBfM_FlushAll() every 'arg' msec
+ *     (CKPT_DEFAULT_INTERVAL if omitted)
+ *   - with the checkpointer taking a fuzzy checkpoint spread over every
+ *     'arg' msec (edubfm_cfgParams.checkpointInterval)
+ *  The fix rate, the percentiles of the latency, the # of flushes or
+ *  checkpoints completed, the # of pages/trains they wrote, the # of
+ *  synchronous writes of the replaced pages/trains, the # of writes of the
+ *  checkpoints delayed for the reads, and the # of wrong stamps are printed.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_Checkpoint(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of fixes per thread */
+    char        *arg)                   /* IN interval between the flushes or the checkpoints (unit: msec) */
+{
+    Four        e;                      /* for errors */
+    Four        t, mode;
+    Four        interval;               /* interval between the flushes or the checkpoints */
+    Four        nTrains;                /* # of trains */
+    Four        nWrong;                 /* # of wrong stamps */
+    Four        nLatencies;             /* # of latencies */
+    Four        nDone, nWritten;        /* # of flushes or checkpoints completed, and # of pages/trains they wrote */
+    PageID      *trains;
+    char        *buf;
+    double      *latencies;             /* latencies of all threads (unit: usec) */
+    double      start, elapsed;
+    CheckpointWorker workers[CKPT_NTHREADS];
+    CheckpointFlusher flusher;
+    EduBfM_WriterStats writerStats;
+    EduBfM_CheckpointStats ckptStats;
+    static char *modeNames[CKPT_NMODES] = { "none", "flushall", "checkpoint" };
+
+    interval = (arg != NULL) ? atoi(arg) : CKPT_DEFAULT_INTERVAL;
+    if (interval <= 0) ERR(eBADPARAMETER_EDUBFM);
+
+    nTrains = BI_NBUFS(LOT_LEAF_BUF) * CKPT_TRAINS_PER_BUFFER;
+    nLatencies = nOps * CKPT_NTHREADS;
+    trains = (PageID *)malloc(sizeof(PageID) * nTrains);
+    latencies = (double *)malloc(sizeof(double) * MAX(nLatencies, 1));
+    if (trains == NULL || latencies == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    e = edubfm_bench_AllocTrains(volId, nTrains, BI_BUFSIZE(LOT_LEAF_BUF), trains);
+    if (e < eNOERROR) ERR(e);
+
+    // 각 train에 그 번호를 기록하여 device에 저장함 (memory volume은 attach 될 때 이를 복사함)
+    e = EduBfM_Init();
+    if (e < eNOERROR) ERR(e);
+
+    for (t = 0; t < nTrains; t++) {
+        e = EduBfM_GetTrain(&trains[t], &buf, LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        memcpy(buf, &t, sizeof(Four));
+        e = EduBfM_SetDirty(&trains[t], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+        e = EduBfM_FreeTrain(&trains[t], LOT_LEAF_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    e = EduBfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+    e = EduBfM_DiscardAll();
+    if (e < eNOERROR) ERR(e);
+
+    e = EduBfM_Final();
+    if (e < eNOERROR) ERR(e);
+
+    printf("%10s %12s %10s %10s %10s %10s %8s %10s %12s %10s %8s\n", "flush", "fixes/sec", "p50 usec", "p99", "p99.9", "max",
+           "done", "written", "sync writes", "throttled", "wrong");
+
+    for (mode = 0; mode < CKPT_NMODES; mode++) {
+
+        edubfm_cfgParams.nPartitions = CKPT_NPARTITIONS;
+        edubfm_cfgParams.memVolumeLatency = CKPT_LATENCY;
+        edubfm_cfgParams.memVolumeBandwidth = CKPT_BANDWIDTH;
+        edubfm_cfgParams.checkpointInterval = (mode == 2) ? interval : 0;
+        e = EduBfM_Init();
+        if (e < eNOERROR) ERR(e);
+
+        e = EduBfM_AttachMemoryVolume(volId, BENCH_VOLUME_NAME);
+        if (e < eNOERROR) ERR(e);
+
+        flusher.interval = interval;
+        flusher.stop = FALSE;
+        flusher.nFlushes = 0;
+        flusher.e = eNOERROR;
+        if (mode == 1) pthread_create(&flusher.thread, NULL, edubfm_bench_CheckpointFlusher, &flusher);
+
+        start = edubfm_bench_Now();
+
+        for (t = 0; t < CKPT_NTHREADS; t++) {
+            workers[t].seed = t + 1;
+            workers[t].nOps = nOps;
+            workers[t].nTrains = nTrains;
+            workers[t].trains = trains;
+            workers[t].latencies = latencies + (size_t)nOps * t;
+            workers[t].nWrong = 0;
+            workers[t].e = eNOERROR;
+            pthread_create(&workers[t].thread, NULL, edubfm_bench_CheckpointWorker, &workers[t]);
+        }
+
+        nWrong = 0;
+        for (t = 0; t < CKPT_NTHREADS; t++) pthread_join(workers[t].thread, NULL);
+
+        elapsed = edubfm_bench_Now() - start;
+
+        if (mode == 1) {
+            flusher.stop = TRUE;
+            pthread_join(flusher.thread, NULL);
+            if (flusher.e < eNOERROR) ERR(flusher.e);
+        }
+
+        for (t = 0; t < CKPT_NTHREADS; t++) {
+            if (workers[t].e < eNOERROR) ERR(workers[t].e);
+            nWrong += workers[t].nWrong;
+        }
+
+        e = EduBfM_GetWriterStats(&writerStats);
+        if (e < eNOERROR) ERR(e);
+        e = EduBfM_GetCheckpointStats(&ckptStats);
+        if (e < eNOERROR) ERR(e);
+
+        nDone = (mode == 1) ? flusher.nFlushes : ckptStats.nCheckpoints;
+        nWritten = (mode == 1) ? writerStats.nFlushedTrains : writerStats.nCheckpointWrites;
+
+        qsort(latencies, nLatencies, sizeof(double), edubfm_bench_CompareLatencies);
+
+        printf("%10s %12.0f %10.1f %10.1f %10.1f %10.1f %8d %10d %12u %10u %8d\n", modeNames[mode], nLatencies / elapsed,
+               latencies[nLatencies / 2], latencies[(Four)(nLatencies * 0.99)], latencies[(Four)(nLatencies * 0.999)],
+               latencies[nLatencies - 1], nDone, nWritten, writerStats.nSyncWrites, ckptStats.nThrottled, nWrong);
+
+        // 남은 수정된 train들을 기록함 (checkpoint를 사용하는 경우, 기다리지 않는 checkpoint로 기록함)
+        e = (mode == 2) ? EduBfM_Checkpoint(0) : EduBfM_FlushAll();
+        if (e < eNOERROR) ERR(e);
+
+        e = EduBfM_DetachVolume(volId);
+        if (e < eNOERROR) ERR(e);
+
+        e = EduBfM_Final();
+        if (e < eNOERROR) ERR(e);
+    }
+
+    edubfm_cfgParams.nPartitions = 0;
+    edubfm_cfgParams.memVolumeLatency = edubfm_cfgParams.memVolumeBandwidth = 0;
+    edubfm_cfgParams.checkpointInterval = 0;
+    free(latencies);
+    free(trains);
+
+    return(eNOERROR);
+
+} /* edubfm_bench_Checkpoint() */
+
+
+
+/*
+ * Benchmark "readsize" : scan throughput of the variable-size trains of 1 to 16 pages
+ */
+
+/* # of train sizes (1, 2, 4, ... pages) */
+#define RS_NSIZES               5
+/* # of pages of the pool of the variable-size trains */
+#define RS_POOL_PAGES           1024
+/* default latency (unit: usec) and bandwidth (unit: MB/s) of the memory volume */
+#define RS_DEFAULT_LATENCY      100
+#define RS_BANDWIDTH            400
+
+/*@================================
+ * edubfm_bench_ReadSize()
+ *================================*/
+/*
+ * Function: Four edubfm_bench_ReadSize(Four, Four, char *)
+ *
+ * Description:
+ *  For variable-size trains of 1, 2, 4, 8 and 16 pages, scan the first
+ *  nOps pages of the benchmark volume attached by
+ *  EduBfM_AttachMemoryVolume() with 'arg' usec of latency
+ *  (RS_DEFAULT_LATENCY if omitted) and RS_BANDWIDTH MB/s, fixing
+ *  consecutive trains of that size in an empty pool of RS_POOL_PAGES
+ *  pages, and print the # of reads and the throughput.
+ *  This measures how the read size of EduBfM_GetVarTrain() amortizes the
+ *  per-read latency; the page size stays PAGESIZE in every run.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_bench_ReadSize(
+    Four        volId,                  /* IN volume id */
+    Four        nOps,                   /* IN # of pages scanned */
+    char        *arg)                   /* IN latency of the memory volume (unit: usec) */
+{
+    Four        e;                      /* for errors */
+    Four        s, nPages;
+    Four        latency;                /* latency of the memory volume */
+    PageID      pid;
+    char        *buf;
+    double      start, elapsed;
+    EduBfM_VarTrainStats stats;
+
+    latency = (arg != NULL) ? atoi(arg) : RS_DEFAULT_LATENCY;
+    if (latency < 0) ERR(eBADPARAMETER_EDUBFM);
+    nOps = MIN(nOps, BENCH_VOLUME_NPAGES);
+
+    printf("%12s %10s %10s %12s\n", "train pages", "read KB", "reads", "MB/sec");
+
+    for (s = 0; s < RS_NSIZES; s++) {
+        nPages = 1 << s;
+
+        edubfm_cfgParams.varTrainPoolPages = RS_POOL_PAGES;
+        edubfm_cfgParams.memVolumeLatency = latency;
+        edubfm_cfgParams.memVolumeBandwidth = RS_BANDWIDTH;
+        e = EduBfM_Init();
+        if (e < eNOERROR) ERR(e);
+
+        e = EduBfM_AttachMemoryVolume(volId, BENCH_VOLUME_NAME);
+        if (e < eNOERROR) ERR(e);
+
+        // 연속된 train들을 차례로 fix 하여 volume의 앞부분을 scan 함
+        pid.volNo = volId;
+        start = edubfm_bench_Now();
+
+        for (pid.pageNo = 0; pid.pageNo + nPages <= nOps; pid.pageNo += nPages) {
+            e = EduBfM_GetVarTrain((TrainID *)&pid, &buf, nPages);
+            if (e < eNOERROR) ERR(e);
+            e = EduBfM_FreeVarTrain((TrainID *)&pid);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        elapsed = edubfm_bench_Now() - start;
+
+        e = EduBfM_GetVarTrainStats(&stats);
+        if (e < eNOERROR) ERR(e);
+
+        printf("%12d %10d %10u %12.1f\n", nPages, PAGESIZE * nPages / 1024, stats.nFixes - stats.nHits,
+               (double)pid.pageNo * PAGESIZE / (1024 * 1024) / elapsed);
+
+        e = EduBfM_DetachVolume(volId);
+        if (e < eNOERROR) ERR(e);
+
+        e = EduBfM_Final();
+        if (e < eNOERROR) ERR(e);
+    }
+
+    edubfm_cfgParams.varTrainPoolPages = 0;
+    edubfm_cfgParams.memVolumeLatency = edubfm_cfgParams.memVolumeBandwidth = 0;
+
+    return(eNOERROR);
+
+} /* edubfm_bench_ReadSize() */
@@ -0,0 +1,114 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_Checkpoint.c
+ *
+ * Description :
+ *  Take a fuzzy checkpoint spread over a window of time, and return the
+ *  progress of the checkpoints.
+ *
+ * Exports:
+ *  Four EduBfM_Checkpoint(Four)
+ *  Four EduBfM_GetCheckpointStats(EduBfM_CheckpointStats *)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_Checkpoint()
+ *================================*/
+/*
+ * Function: Four EduBfM_Checkpoint(Four)
+ *
+ * Description :
+ *  Write the pages/trains which are dirty when it is called, spreading the
+ *  writes over 'duration' msec (0 : as fast as possible), and return when
+ *  they are written. Unlike EduBfM_FlushAll(), it holds the latch of one
+ *  partition at a time during each write only, so the other threads keep
+ *  fixing pages/trains meanwhile, and it slows down while they read pages/
+ *  trains (see edubfm_Checkpoint.c). The pages/trains dirtied after it is
+ *  called may or may not be written.
+ *  The buffer pools must be partitioned if other threads use them.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - 'duration' is negative.
+ *    some errors caused by function calls
+ *
+ * 설명:
+ *  호출 시점에 수정되어 있던 page/train들을 주어진 시간에 걸쳐 나누어 disk에 기록함
+ *
+ * 관련 함수:
+ *  1. edubfm_Checkpoint()
+ */
+Four EduBfM_Checkpoint(
+    Four                duration)               /* IN time over which the writes are spread (unit: msec) */
+{
+    Four                e;                      /* error */
+
+    e = edubfm_Checkpoint(duration);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+}  /* EduBfM_Checkpoint() */
+
+
+
+/*@================================
+ * EduBfM_GetCheckpointStats()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetCheckpointStats(EduBfM_CheckpointStats *)
+ *
+ * Description :
+ *  Return the progress of the checkpoints taken by EduBfM_Checkpoint() and
+ *  the checkpointer since EduBfM_Init(): how many completed or were
+ *  aborted, how many of their writes were delayed for the reads of the
+ *  other threads, whether one is in progress, and how many pages/trains the
+ *  current (or last) one found dirty, wrote and skipped, in how much time.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - stats is NULL.
+ *
+ * 설명:
+ *  Checkpoint의 진행 상황 (기록할 page/train 수, 기록된 수 등) 을 반환함
+ */
+Four EduBfM_GetCheckpointStats(
+    EduBfM_CheckpointStats  *stats)             /* OUT progress */
+{
+    if (stats == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    edubfm_GetCheckpointStats(stats);
+
+    return(eNOERROR);
+
+}  /* EduBfM_GetCheckpointStats() */
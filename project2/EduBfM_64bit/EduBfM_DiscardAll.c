@@ -49,6 +49,8 @@
  *  For ODYSSEUS/EduCOSMOS EduBfM, refer to the EduBfM project manual.)
  *
  *  Discard all buffers.
+ *  The compressed cache and the pool of the variable-size trains (if any)
+ *  are emptied, too.
  *
  * Returns:
  *  error code
@@ -64,19 +66,51 @@ Four EduBfM_DiscardAll(void)
     Four 	e;			/* error */
     Two 	i;			/* index */
     Four 	type;			/* buffer type */
+    Four    p;              /* partition number */
+    BufferPartition *part;  /* partition */
+    Four    nLatched;       /* # of latched partitions */
+
+    // Partition된 경우, 모든 partition의 latch를 획득함 (실패하면 획득한 latch들은 해제됨)
+    e = edubfm_LatchAll();
+    if (e < 0) ERR(e);
 
     // 각 bufTable의 모든 element들을 초기화함
     for (type = 0; type < NUM_BUF_TYPES; type++) {
         for (i = 0; i < BI_NBUFS(type); i++) {
+            FRAME_WRITE_BEGIN(type, i);
             BI_FIXED(type, i) = 0;
             BI_BITS(type, i) = ALL_0;
             SET_NILBFMHASHKEY( BI_KEY(type, i) );
+            FRAME_WRITE_END(type, i);
+            BFM_STATS( edubfm_StatsDiscard(type, i) );
         }
     }
 
+    // Mapping 된 volume들의 수정된 page들을 버림
+    if (edubfm_nMappedVolumes > 0) edubfm_DiscardMappedVolumes();
+
+    // Compressed cache와 variable-size train pool에 저장된 page/train들도 삭제함
+    edubfm_CompressedCacheClear();
+    edubfm_DiscardVarTrains();
+
     // 각 hashTable에 저장된 모든 entry (즉, array index) 들을 삭제함
     e = edubfm_DeleteAll();
-    if (e < 0) ERR(e);
+    if (e < 0) {
+        for (nLatched = 0, type = 0; type < NUM_BUF_TYPES; type++) nLatched += PI_NLOOP(type);
+        edubfm_UnlatchAll(nLatched);
+        ERR(e);
+    }
+
+    // 각 partition의 replacement policy가 유지하던 정보를 초기화하고, latch를 해제함
+    for (type = 0; type < NUM_BUF_TYPES; type++)
+        for (p = 0; p < PI_NLOOP(type); p++) {
+            part = PI_PART(type, p);
+            if (IS_PARTITIONED(type)) part->nextVictim = 0;
+            PI_POLICY(type)->reset(type, part);
+
+            e = edubfm_UnlatchPartition(part);
+            if (e < 0) ERR(e);
+        }
 
     return(eNOERROR);
 
@@ -37,6 +37,9 @@
 #include "EduBfM_Internal.h"
 
 
+extern CfgParams_T sm_cfgParams;
+
+
 
 /*@================================
  * EduBfM_FlushAll()
@@ -50,6 +53,9 @@
  *
  *  Flush dirty buffers holding trains.
  *  A dirty buffer is one with the dirty bit set.
+ *  If sm_cfgParams.useBulkFlush is set, the dirty buffers are written in
+ *  the order of their disk addresses, and adjacent ones are written together.
+ *  The dirty trains of the pool of the variable-size trains are written, too.
  *
  * Returns:
  *  error code
@@ -59,21 +65,57 @@
  * 
  * 관련 함수:
  *  1. edubfm_FlushTrain()
+ *  2. edubfm_BulkFlush()
  */
 Four EduBfM_FlushAll(void)
 {
     Four        e;                      /* error */
     Two         i;                      /* index */
     Four        type;                   /* buffer type */
+    Four        p;                      /* partition number */
+    BufferPartition *part;              /* partition */
+
+    // Mapping 된 volume들의 수정된 page들을 disk에 기록함
+    if (edubfm_nMappedVolumes > 0) {
+        e = edubfm_FlushMappedVolumes();
+        if (e < 0) ERR(e);
+    }
+
+    // Variable-size train pool의 수정된 train들을 disk에 기록함
+    e = edubfm_FlushVarTrains();
+    if (e < 0) ERR(e);
+
+    // Bulk flush를 사용하는 경우, 수정된 page/train들을 disk 상의 위치 순으로 모아서 기록함
+    if (sm_cfgParams.useBulkFlush) {
+        e = edubfm_BulkFlush();
+        if (e < 0) ERR(e);
+
+        return( eNOERROR );
+    }
 
     // DIRTY bit가 1로 set 된 buffer element들에 저장된 각 page/train에 대해, 
     // edubfm_FlushTrain()을 호출하여 해당 page/train을 disk에 기록함
+    // Partition된 경우, 각 partition의 latch를 차례로 획득하여 해당 partition의 buffer element들을 flush 함
     for (type = 0; type < NUM_BUF_TYPES; type++){
-        for (i = 0; i < BI_NBUFS(type); i++) {
-            if (BI_BITS(type, i) & DIRTY) {
-                e = edubfm_FlushTrain(&BI_KEY(type, i), type);
-                if (e < 0) ERR(e);
+        for (p = 0; p < PI_NLOOP(type); p++) {
+            part = PI_PART(type, p);
+
+            e = edubfm_LatchPartition(part);
+            if (e < 0) ERR(e);
+
+            for (i = part->firstBuf; i < part->firstBuf + part->nBufs; i++) {
+                if (BI_BITS(type, i) & DIRTY) {
+                    e = edubfm_FlushTrain(&BI_KEY(type, i), type);
+                    if (e < 0) ERR_UNLATCH(e, part);
+
+                    part->writerStats.nFlushedTrains++;
+                    part->writerStats.nFlushWrites++;
+                    BFM_STATS( part->stats.nWriteBacks++ );
+                }
             }
+
+            e = edubfm_UnlatchPartition(part);
+            if (e < 0) ERR(e);
         }
     }
     
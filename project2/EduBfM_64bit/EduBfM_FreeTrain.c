@@ -30,13 +30,18 @@
  *
  * Exports:
  *  Four EduBfM_FreeTrain(TrainID *, Four)
+ *  Four EduBfM_FreeFrame(BfMFrameHandle *)
  */
 
 
 #include "EduBfM_common.h"
+#include "EduBfM.h"
 #include "EduBfM_Internal.h"
 
 
+/* internal function prototypes */
+static void edubfm_UnpinFrame(Four, BufferPartition *, Four, TrainID *);
+
 
 /*@================================
  * EduBfM_FreeTrain()
@@ -50,10 +55,15 @@
  *
  *  Free(or unfix) a buffer.
  *  This function simply frees a buffer by decrementing the fix count by 1.
+ *  The buffer is looked up and freed under one acquisition of the latch of
+ *  its partition. A train of a mapped volume, or of a buffer pool whose
+ *  trains are fixed without the latch, is looked up by edubfm_FindFrame()
+ *  and freed by EduBfM_FreeFrame() instead.
  *
  * Returns :
  *  error code
  *    eBADBUFFERTYPE_BFM - bad buffer type
+ *    eBADHASHKEY_BFM - The train isn't in the buffer pool.
  *    some errors caused by fuction calls
  * 
  * 설명 :
@@ -61,34 +71,141 @@
  * 
  * 관련 함수 :
  *  1. edubfm_LookUp()
+ *  2. edubfm_FindFrame()
+ *  3. EduBfM_FreeFrame()
  */
 Four EduBfM_FreeTrain( 
     TrainID             *trainId,       /* IN train to be freed */
     Four                type)           /* IN buffer type */
 {
-    Four                index;          /* index on buffer holding the train */
     Four 		        e;		        /* error code */
+    Four                index;          /* index on buffer holding the train */
+    BufferPartition     *part;          /* partition of the train */
+    BfMFrameHandle      handle;         /* handle of the buffer holding the train */
 
     /*@ check if the parameter is valid. */
     if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);	
 
-    // Unfix 할 page/train의 hash key value를 이용하여, 
-    // 해당 page/train이 저장된 buffer element의 array index를 hashTable에서 검색함
+    // Mapping 된 volume이나 latch 없이 fix 하는 bufferPool의 page/train은 handle을 구하여 unfix 함
+    if (IS_MAPPED_VOLUME(trainId->volNo) || PI_OPTIMISTIC(type)) {
+        e = edubfm_FindFrame(trainId, type, &handle);
+        if (e < 0) ERR(e);
+
+        e = EduBfM_FreeFrame(&handle);
+        if (e < 0) ERR(e);
+
+        return( eNOERROR );
+    }
+
+    BFM_TRACE(BFM_TRACE_FREE, trainId, type);
+
+    // 한 번 획득한 latch 아래에서, unfix 할 page/train이 저장된 buffer element를 hashTable에서 검색하여 unfix 함
+    part = edubfm_GetPartition((BfMHashKey *)trainId, type);
+    e = edubfm_LatchPartition(part);
+    if (e < 0) ERR(e);
+
     index = edubfm_LookUp((BfMHashKey *)trainId, type);
+    if (index < 0) ERR_UNLATCH(eBADHASHKEY_BFM, part);
+
+    edubfm_UnpinFrame(type, part, index, trainId);
+
+    e = edubfm_UnlatchPartition(part);
+    if (e < 0) ERR(e);
+    
+    return( eNOERROR );
+    
+} /* EduBfM_FreeTrain() */
+
+
+
+/*@================================
+ * EduBfM_FreeFrame()
+ *================================*/
+/*
+ * Function: Four EduBfM_FreeFrame(BfMFrameHandle*)
+ *
+ * Description :
+ *  Free(or unfix) the buffer given by the handle which EduBfM_GetFrame()
+ *  returned, by decrementing the fix count by 1, without looking it up.
+ *  If the trains of the buffer pool are fixed without the latch, the fix
+ *  count is decremented without the latch, too.
+ *
+ * Returns :
+ *  error code
+ *    eBADBUFFER_BFM - bad handle
+ *    eBADBUFINDEX_BFM - bad index in the handle
+ *    eBADHASHKEY_BFM - The buffer doesn't hold the train of the handle.
+ *    some errors caused by fuction calls
+ * 
+ * 설명 :
+ *  Handle이 가리키는 buffer element에 저장된 page/train을 bufferPool에서 unfix 함
+ */
+Four EduBfM_FreeFrame( 
+    BfMFrameHandle      *handle)        /* IN handle of the buffer to be freed */
+{
+    Four 		        e;		        /* error code */
+    Four                type;           /* buffer type */
+    Four                index;          /* index on buffer holding the train */
+    BufferPartition     *part;          /* partition of the train */
+
+    // Mapping 된 volume의 page/train인 경우, 해당 volume의 fix 횟수를 감소시킴
+    if (handle != NULL && handle->index == BFM_MAPPED_FRAME && !IS_BAD_BUFFERTYPE(handle->type))
+        return( edubfm_FreeMappedFrame(handle) );
+
+    /*@ check if the parameter is valid. */
+    CHECK_FRAMEHANDLE(handle);
+
+    type = handle->type;
+    index = handle->index;
+    BFM_TRACE(BFM_TRACE_FREE, &handle->trainId, type);
+
+    // Latch 없이 fix 하는 bufferPool에서는 latch 없이 fixed 변수 값을 감소시킴
+    // (fix 되어 있으므로 key는 바뀌지 않으며, fix 된 시간을 재는 경우에는 latch를 획득함)
+    if (PI_OPTIMISTIC(type) && EQUALKEY(&BI_KEY(type, index), &handle->trainId) &&
+        !BFM_STATS_PIN_TIMED(type, index) && edubfm_OptimisticUnfix(type, index)) return( eNOERROR );
+
+    part = edubfm_GetPartition((BfMHashKey *)&handle->trainId, type);
+    e = edubfm_LatchPartition(part);
+    if (e < 0) ERR(e);
+
+    if (!EQUALKEY(&BI_KEY(type, index), &handle->trainId)) ERR_UNLATCH(eBADHASHKEY_BFM, part);
+
+    edubfm_UnpinFrame(type, part, index, &handle->trainId);
+
+    e = edubfm_UnlatchPartition(part);
+    if (e < 0) ERR(e);
+    
+    return( eNOERROR );
+    
+} /* EduBfM_FreeFrame() */
 
+
+
+/*@================================
+ * edubfm_UnpinFrame()
+ *================================*/
+/*
+ * Function: static void edubfm_UnpinFrame(Four, BufferPartition *, Four, TrainID *)
+ *
+ * Description :
+ *  Decrement the fix count of the buffer element holding the train.
+ *  The caller must hold the latch of the partition.
+ */
+static void edubfm_UnpinFrame(
+    Four                type,           /* IN buffer type */
+    BufferPartition     *part,          /* IN partition latched by the caller */
+    Four                index,          /* IN index on buffer holding the train */
+    TrainID             *trainId)       /* IN train to be freed */
+{
     // 해당 buffer element에 대한 fixed 변수 값을 1 감소시킴
     // fixed 변수의 값은 0 미만이 될 수 없음
-    if (index == NOTFOUND_IN_HTABLE) {
-        ERR(eBADHASHKEY_BFM);
-    }
-    else if (BI_FIXED(type, index) > 0) {
-        BI_FIXED(type, index) -= 1;
+    if (BI_FIXED(type, index) > 0) {
+        BI_UNPIN(type, index);
+        BFM_STATS( edubfm_StatsUnfix(type, part, index) );
     }
     else {
         printf("fixed counter is less than 0!!!\n");
         printf("trainId = {%d,  %d}\n", trainId->volNo, trainId->pageNo);
     }
-    
-    return( eNOERROR );
-    
-} /* EduBfM_FreeTrain() */
+
+} /* edubfm_UnpinFrame() */
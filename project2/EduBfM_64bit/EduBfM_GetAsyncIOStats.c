@@ -0,0 +1,73 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_GetAsyncIOStats.c
+ *
+ * Description :
+ *  Return the counters of the asynchronous I/O.
+ *
+ * Exports:
+ *  Four EduBfM_GetAsyncIOStats(EduBfM_AsyncIOStats *)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_GetAsyncIOStats()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetAsyncIOStats(EduBfM_AsyncIOStats *)
+ *
+ * Description :
+ *  Return the counters of the asynchronous I/O since it was started by
+ *  EduBfM_Init(): whether io_uring serves the requests, how many reads and
+ *  writes were submitted, how many were in flight at most, how many waited
+ *  for an overlapping write, and how many fixes waited for a read of the
+ *  same page/train in progress instead of reading it again.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - stats is NULL.
+ *
+ * 설명:
+ *  비동기 I/O로 제출된 read/write의 수와, 동시에 진행된 최대 request 수 등을 반환함
+ */
+Four EduBfM_GetAsyncIOStats(
+    EduBfM_AsyncIOStats     *stats)             /* OUT counters */
+{
+    if (stats == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    pthread_mutex_lock(&edubfm_aioMutex);
+    *stats = edubfm_aioStats;
+    pthread_mutex_unlock(&edubfm_aioMutex);
+
+    return(eNOERROR);
+
+}  /* EduBfM_GetAsyncIOStats() */
@@ -0,0 +1,73 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_GetCompressedCacheStats.c
+ *
+ * Description :
+ *  Return the counters of the compressed cache.
+ *
+ * Exports:
+ *  Four EduBfM_GetCompressedCacheStats(EduBfM_CompressedCacheStats *)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_GetCompressedCacheStats()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetCompressedCacheStats(EduBfM_CompressedCacheStats *)
+ *
+ * Description :
+ *  Return the counters of the compressed cache since it was allocated by
+ *  EduBfM_Init(): how many pages/trains to be read were looked up in it and
+ *  how many of them were found, how many replaced pages/trains were stored
+ *  or rejected, and how many were dropped to make room. The hits of the
+ *  buffer pools themselves are returned by EduBfM_GetStats().
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - stats is NULL.
+ *
+ * 설명:
+ *  Compressed cache에서 찾은 page/train의 수와, 저장하거나 제거한 page/train의 수를 반환함
+ */
+Four EduBfM_GetCompressedCacheStats(
+    EduBfM_CompressedCacheStats *stats)         /* OUT counters */
+{
+    if (stats == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    pthread_mutex_lock(&edubfm_ccMutex);
+    *stats = edubfm_ccStats;
+    pthread_mutex_unlock(&edubfm_ccMutex);
+
+    return(eNOERROR);
+
+}  /* EduBfM_GetCompressedCacheStats() */
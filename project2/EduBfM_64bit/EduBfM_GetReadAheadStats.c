@@ -0,0 +1,71 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_GetReadAheadStats.c
+ *
+ * Description :
+ *  Return the counters of the read-ahead.
+ *
+ * Exports:
+ *  Four EduBfM_GetReadAheadStats(EduBfM_ReadAheadStats *)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_GetReadAheadStats()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetReadAheadStats(EduBfM_ReadAheadStats *)
+ *
+ * Description :
+ *  Return the counters of the read-ahead since it was started by
+ *  EduBfM_Init(): how many pages/trains were read ahead, how many of them
+ *  were fixed afterwards, and how many were replaced without being fixed.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - stats is NULL.
+ *
+ * 설명:
+ *  Read-ahead로 읽은 page/train의 수와, 그 중 fix 된 것과 fix 되지 않고 교체된 것의 수를 반환함
+ */
+Four EduBfM_GetReadAheadStats(
+    EduBfM_ReadAheadStats   *stats)             /* OUT counters */
+{
+    if (stats == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    pthread_mutex_lock(&edubfm_raMutex);
+    *stats = edubfm_raStats;
+    pthread_mutex_unlock(&edubfm_raMutex);
+
+    return(eNOERROR);
+
+}  /* EduBfM_GetReadAheadStats() */
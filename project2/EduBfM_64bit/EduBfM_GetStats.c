@@ -0,0 +1,274 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_GetStats.c
+ *
+ * Description :
+ *  Return, reset and print the statistics of the buffer pools, which are
+ *  collected only if EduBfM is compiled with EDUBFM_STATS (see Makefile).
+ *
+ * Exports:
+ *  Four EduBfM_GetStats(Four, EduBfM_Stats *)
+ *  Four EduBfM_ResetStats(void)
+ *  Four EduBfM_DumpStats(FILE *)
+ */
+
+
+#include <string.h> /* for memset */
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+/* names of the buffer types printed by EduBfM_DumpStats() */
+static char *edubfm_bufTypeNames[NUM_BUF_TYPES] = { "PAGE_BUF", "LOT_LEAF_BUF" };
+
+
+
+/*@================================
+ * EduBfM_GetStats()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetStats(Four, EduBfM_Stats *)
+ *
+ * Description :
+ *  Return the sums of the statistics of all partitions of the buffer pool
+ *  'type' since EduBfM_Init() or EduBfM_ResetStats(): how many pages/trains
+ *  were fixed (how many of them from another NUMA node than the partition)
+ *  and found in the buffer pool (how many of them without the latch) or
+ *  read from disk, how many were evicted or written back, how many buffer
+ *  elements the replacement policy visited to select the victims, how many
+ *  hash chain entries edubfm_LookUp() compared, and the histograms of them,
+ *  of the fix counts of the evicted pages/trains and of the pin times.
+ *  The counters are read without the latches of the partitions, so they
+ *  may be slightly inconsistent while other threads use the buffer pool.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFERTYPE_BFM - bad buffer type
+ *    eBADPARAMETER_EDUBFM - stats is NULL.
+ *    eNOTSUPPORTED_EDUBFM - EduBfM is compiled without EDUBFM_STATS.
+ *
+ * 설명:
+ *  해당 bufferPool의 각 partition의 통계를 합하여 반환함
+ */
+Four EduBfM_GetStats(
+    Four                type,                   /* IN buffer type */
+    EduBfM_Stats        *stats)                 /* OUT statistics */
+{
+#ifdef EDUBFM_STATS
+    Four                p;                      /* partition number */
+    Four                b;                      /* bucket number */
+    EduBfM_Stats        *s;                     /* statistics of a partition */
+
+
+    if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
+    if (stats == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    memset(stats, 0, sizeof(EduBfM_Stats));
+
+    for (p = 0; p < PI_NLOOP(type); p++) {
+        s = &PI_PART(type, p)->stats;
+
+        stats->nFixes += s->nFixes + s->nOptimisticFixes;
+        stats->nHits += s->nHits + s->nOptimisticFixes;
+        stats->nMisses += s->nMisses;
+        stats->nEvictions += s->nEvictions;
+        stats->nWriteBacks += s->nWriteBacks;
+        stats->nVictimSearches += s->nVictimSearches;
+        stats->nVictimSteps += s->nVictimSteps;
+        stats->maxVictimSteps = MAX(stats->maxVictimSteps, s->maxVictimSteps);
+        stats->nLookUps += s->nLookUps;
+        stats->nChainSteps += s->nChainSteps;
+        stats->maxChainSteps = MAX(stats->maxChainSteps, s->maxChainSteps);
+        stats->nOptimisticFixes += s->nOptimisticFixes;
+        stats->nRemoteFixes += s->nRemoteFixes;
+        stats->nDirtySkips += s->nDirtySkips;
+
+        for (b = 0; b < BFM_STATS_NBUCKETS; b++) {
+            stats->victimStepsHist[b] += s->victimStepsHist[b];
+            stats->chainStepsHist[b] += s->chainStepsHist[b];
+            stats->fixCountHist[b] += s->fixCountHist[b];
+            stats->pinTimeHist[b] += s->pinTimeHist[b];
+        }
+    }
+
+    return(eNOERROR);
+#else
+    ERR(eNOTSUPPORTED_EDUBFM);
+#endif
+
+}  /* EduBfM_GetStats() */
+
+
+
+/*@================================
+ * EduBfM_ResetStats()
+ *================================*/
+/*
+ * Function: Four EduBfM_ResetStats(void)
+ *
+ * Description :
+ *  Reset the statistics of all partitions of all buffer pools, e.g. after
+ *  the buffer pools have been warmed up.
+ *
+ * Returns:
+ *  error code
+ *    eNOTSUPPORTED_EDUBFM - EduBfM is compiled without EDUBFM_STATS.
+ *    some errors caused by function calls
+ */
+Four EduBfM_ResetStats(void)
+{
+#ifdef EDUBFM_STATS
+    Four                e;                      /* error code */
+    Four                type;                   /* buffer type */
+    Four                p;                      /* partition number */
+    BufferPartition     *part;                  /* a partition */
+
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        for (p = 0; p < PI_NLOOP(type); p++) {
+            part = PI_PART(type, p);
+
+            e = edubfm_LatchPartition(part);
+            if (e < 0) ERR(e);
+
+            memset(&part->stats, 0, sizeof(EduBfM_Stats));
+
+            e = edubfm_UnlatchPartition(part);
+            if (e < 0) ERR(e);
+        }
+    }
+
+    return(eNOERROR);
+#else
+    ERR(eNOTSUPPORTED_EDUBFM);
+#endif
+
+}  /* EduBfM_ResetStats() */
+
+
+
+/*@================================
+ * EduBfM_DumpStats()
+ *================================*/
+/*
+ * Function: Four EduBfM_DumpStats(FILE *)
+ *
+ * Description :
+ *  Print the statistics of each buffer pool returned by EduBfM_GetStats()
+ *  to 'fp' in a human-readable form. Only the non-empty buckets of the
+ *  histograms are printed, as "[low, high) count". The counters of the
+ *  compressed cache (the second tier) follow if it has been used.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - fp is NULL.
+ *    some errors caused by function calls
+ */
+Four EduBfM_DumpStats(
+    FILE                *fp)                    /* IN output stream */
+{
+#ifdef EDUBFM_STATS
+    Four                e;                      /* error code */
+    Four                type;                   /* buffer type */
+    Four                h;                      /* histogram number */
+    Four                b;                      /* bucket number */
+    EduBfM_Stats        stats;                  /* statistics of a buffer pool */
+    EduBfM_CompressedCacheStats ccStats;        /* counters of the compressed cache */
+    UEight              *hist[4];               /* histograms */
+    static char         *histNames[4] = { "victim search length", "hash chain length",
+                                          "fix count at eviction", "pin time (usec)" };
+
+
+    if (fp == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        e = EduBfM_GetStats(type, &stats);
+        if (e < 0) ERR(e);
+
+        fprintf(fp, "%s (%ld buffers, %ld partitions)\n", edubfm_bufTypeNames[type], (long)BI_NBUFS(type), (long)PI_NLOOP(type));
+        fprintf(fp, "  fixes %llu, hits %llu, misses %llu, hit ratio %.2f%%\n",
+                stats.nFixes, stats.nHits, stats.nMisses,
+                stats.nFixes == 0 ? 0.0 : 100.0 * stats.nHits / stats.nFixes);
+        if (stats.nOptimisticFixes > 0)
+            fprintf(fp, "  fixed without the latch %llu (%.2f%% of the hits)\n",
+                    stats.nOptimisticFixes, 100.0 * stats.nOptimisticFixes / stats.nHits);
+        if (stats.nRemoteFixes > 0)
+            fprintf(fp, "  fixed from another NUMA node %llu (%.2f%% of the fixes)\n",
+                    stats.nRemoteFixes, 100.0 * stats.nRemoteFixes / stats.nFixes);
+        fprintf(fp, "  evictions %llu, write-backs %llu\n", stats.nEvictions, stats.nWriteBacks);
+        if (stats.nDirtySkips > 0)
+            fprintf(fp, "  dirty buffers passed over for a clean victim %llu\n", stats.nDirtySkips);
+        fprintf(fp, "  victim searches %llu, avg. length %.2f, max. length %llu\n",
+                stats.nVictimSearches,
+                stats.nVictimSearches == 0 ? 0.0 : (double)stats.nVictimSteps / stats.nVictimSearches,
+                stats.maxVictimSteps);
+        fprintf(fp, "  look-ups %llu, avg. chain length %.2f, max. chain length %llu\n",
+                stats.nLookUps,
+                stats.nLookUps == 0 ? 0.0 : (double)stats.nChainSteps / stats.nLookUps,
+                stats.maxChainSteps);
+
+        hist[0] = stats.victimStepsHist;
+        hist[1] = stats.chainStepsHist;
+        hist[2] = stats.fixCountHist;
+        hist[3] = stats.pinTimeHist;
+
+        for (h = 0; h < 4; h++) {
+            fprintf(fp, "  %s:", histNames[h]);
+            for (b = 0; b < BFM_STATS_NBUCKETS; b++) {
+                if (hist[h][b] == 0) continue;
+                if (b == 0) fprintf(fp, " [0] %llu", hist[h][b]);
+                else if (b == BFM_STATS_NBUCKETS - 1) fprintf(fp, " [%llu,) %llu", 1ULL << (b - 1), hist[h][b]);
+                else fprintf(fp, " [%llu,%llu) %llu", 1ULL << (b - 1), 1ULL << b, hist[h][b]);
+            }
+            fprintf(fp, "\n");
+        }
+    }
+
+    // Compressed cache가 사용된 경우, 두 번째 tier의 hit ratio도 출력함
+    e = EduBfM_GetCompressedCacheStats(&ccStats);
+    if (e < 0) ERR(e);
+
+    if (ccStats.nLookUps > 0 || ccStats.nInserts > 0) {
+        fprintf(fp, "compressed cache (%lu pages/trains, %lu bytes)\n", (unsigned long)ccStats.nEntries, (unsigned long)ccStats.nBytesUsed);
+        fprintf(fp, "  look-ups %lu, hits %lu, hit ratio %.2f%%\n",
+                (unsigned long)ccStats.nLookUps, (unsigned long)ccStats.nHits,
+                ccStats.nLookUps == 0 ? 0.0 : 100.0 * ccStats.nHits / ccStats.nLookUps);
+        fprintf(fp, "  inserts %lu, rejected %lu, evictions %lu, compression ratio %.2f\n",
+                (unsigned long)ccStats.nInserts, (unsigned long)ccStats.nRejected, (unsigned long)ccStats.nEvictions,
+                ccStats.nBytesStored == 0 ? 0.0 : (double)ccStats.nBytesIn / ccStats.nBytesStored);
+    }
+
+    return(eNOERROR);
+#else
+    if (fp == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    fprintf(fp, "EduBfM statistics are not collected (compile with EDUBFM_STATS)\n");
+
+    return(eNOERROR);
+#endif
+
+}  /* EduBfM_DumpStats() */
@@ -30,13 +30,21 @@
  *
  * Exports:
  *  Four EduBfM_GetTrain(TrainID *, char **, Four)
+ *  Four EduBfM_GetFrame(TrainID *, char **, Four, BfMFrameHandle *)
+ *  Four EduBfM_GetTrains(TrainID *, char **, Four, Four)
+ *  Four EduBfM_GetTrainWithStrategy(TrainID *, char **, Four, BfMAccessStrategy *)
  */
 
 
 #include "EduBfM_common.h"
+#include "EduBfM.h"
 #include "EduBfM_Internal.h"
 
 
+/* internal function prototypes */
+static Four edubfm_GetFrame(TrainID *, char **, Four, BfMFrameHandle *, BfMAccessStrategy *);
+
+
 
 /*@================================
  * EduBfM_GetTrain()
@@ -45,6 +53,45 @@
  * Function: EduBfM_GetTrain(TrainID*, char**, Four)
  *
  * Description : 
+ *  Return a buffer which has the disk content indicated by `trainId'.
+ *  Same as EduBfM_GetFrame() except that the handle is not returned.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) parameter retBuf
+ *     pointer to buffer holding the disk train indicated by `trainId'
+ *
+ * 설명:
+ *  Page/train을 bufferPool에 fix 하고, page/train이 저장된 buffer element에 대한 포인터를 반환함
+ */
+Four EduBfM_GetTrain(
+    TrainID             *trainId,               /* IN train to be used */
+    char                **retBuf,               /* OUT pointer to the returned buffer */
+    Four                type )                  /* IN buffer type */
+{
+    Four                e;                      /* for error */
+    BfMFrameHandle      handle;                 /* handle of the buffer element (not used) */
+
+
+    e = EduBfM_GetFrame(trainId, retBuf, type, &handle);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);   /* No error */
+
+}  /* EduBfM_GetTrain() */
+
+
+
+/*@================================
+ * EduBfM_GetFrame()
+ *================================*/
+/*
+ * Function: EduBfM_GetFrame(TrainID*, char**, Four, BfMFrameHandle*)
+ *
+ * Description : 
  * (Following description is for original ODYSSEUS/COSMOS BfM.
  *  For ODYSSEUS/EduCOSMOS EduBfM, refer to the EduBfM project manual.)
  *
@@ -56,6 +103,18 @@
  *  pool, allocate a buffer (a buffer selected as victim may be forced out
  *  by the buffer replacement algorithm), read a disk train into the 
  *  selected buffer train, and return it.
+ *  The handle of the buffer element is also returned, with which the
+ *  caller can free the train or set it dirty without looking it up again.
+ *  If the read-ahead is running, the fix is reported to it, and a train
+ *  being read ahead or prefetched is waited for.
+ *  If the asynchronous I/O is running (edubfm_cfgParams.ioQueueDepth > 0),
+ *  a train which is not in the buffer pool is read after the latch of the
+ *  partition is released, and the other fixes of the train wait for that
+ *  read instead of reading it again.
+ *  A train of a volume attached with edubfm_cfgParams.useMmap is not read
+ *  into the buffer pool; the pointer to it in the mapping is returned.
+ *  With edubfm_cfgParams.useOptimisticFix, a train found in the buffer pool
+ *  is fixed without the latch by edubfm_OptimisticFix() if possible.
  *
  * Returns:
  *  error code
@@ -66,9 +125,12 @@
  * Side effects:
  *  1) parameter retBuf
  *     pointer to buffer holding the disk train indicated by `trainId'
+ *  2) parameter handle
+ *     handle of the buffer element holding the train
  * 
  * 설명:
- *  Page/train을 bufferPool에 fix 하고, page/train이 저장된 buffer element에 대한 포인터를 반환함
+ *  Page/train을 bufferPool에 fix 하고, page/train이 저장된 buffer element에 대한 포인터와 handle을 반환함
+ *  bufferPool이 partition된 경우, page/train이 속하는 partition의 latch를 획득한 상태에서 수행함
  * 
  * 관련 함수:
  *  1. edubfm_AllocTrain() - bufferPool에서 page/train을 저장하기 위한 buffer element를 한 개 할당 받고, 
@@ -79,56 +141,309 @@
  *  4. edubfm_ReadTrain() - Page/train을 disk로부터 읽어와서 buffer element에 저장하고, 
  *                          해당 buffer element에 대한 포인터를 반환함
  */
-Four EduBfM_GetTrain(
+Four EduBfM_GetFrame(
     TrainID             *trainId,               /* IN train to be used */
     char                **retBuf,               /* OUT pointer to the returned buffer */
-    Four                type )                  /* IN buffer type */
+    Four                type,                   /* IN buffer type */
+    BfMFrameHandle      *handle)                /* OUT handle of the buffer element */
 {
     Four                e;                      /* for error */
+
+
+    e = edubfm_GetFrame(trainId, retBuf, type, handle, NULL);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);   /* No error */
+
+}  /* EduBfM_GetFrame() */
+
+
+
+/*@================================
+ * EduBfM_GetTrainWithStrategy()
+ *================================*/
+/*
+ * Function: EduBfM_GetTrainWithStrategy(TrainID*, char**, Four, BfMAccessStrategy*)
+ *
+ * Description : 
+ *  Same as EduBfM_GetTrain() except that a train which is not in the
+ *  buffer pool is read into a buffer chosen by the access strategy
+ *  initialized by EduBfM_InitAccessStrategy(). With BFM_ACCESS_SEQSCAN or
+ *  BFM_ACCESS_BULKWRITE, the trains are read into a small ring of buffers
+ *  reused over and over, so that a large scan or bulk write does not flush
+ *  the other trains out of the buffer pool. A train already in the buffer
+ *  pool is fixed as usual. The same strategy should be used for one buffer type.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - strategy is NULL.
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) parameter retBuf
+ *     pointer to buffer holding the disk train indicated by `trainId'
+ *
+ * 설명:
+ *  Access strategy를 사용하여 page/train을 bufferPool에 fix 하고, page/train이 저장된 buffer element에 대한 포인터를 반환함
+ *
+ * 관련 함수:
+ *  1. edubfm_AllocRingTrain()
+ */
+Four EduBfM_GetTrainWithStrategy(
+    TrainID             *trainId,               /* IN train to be used */
+    char                **retBuf,               /* OUT pointer to the returned buffer */
+    Four                type,                   /* IN buffer type */
+    BfMAccessStrategy   *strategy)              /* INOUT access strategy */
+{
+    Four                e;                      /* for error */
+    BfMFrameHandle      handle;                 /* handle of the buffer element (not used) */
+
+
+    if (strategy == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    e = edubfm_GetFrame(trainId, retBuf, type, &handle, strategy);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);   /* No error */
+
+}  /* EduBfM_GetTrainWithStrategy() */
+
+
+
+/*
+ * Function: static Four edubfm_GetFrame(TrainID*, char**, Four, BfMFrameHandle*, BfMAccessStrategy*)
+ *
+ * Description : 
+ *  Fix the train as described in EduBfM_GetFrame(). If 'strategy' is not
+ *  NULL and its hint is not BFM_ACCESS_NORMAL, a train which is not in the
+ *  buffer pool is read into a buffer of its ring.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFER_BFM - Invalid Buffer
+ *    eBADBUFFERTYPE_BFM - Invalid Buffer type
+ *    some errors caused by function calls
+ */
+static Four edubfm_GetFrame(
+    TrainID             *trainId,               /* IN train to be used */
+    char                **retBuf,               /* OUT pointer to the returned buffer */
+    Four                type,                   /* IN buffer type */
+    BfMFrameHandle      *handle,                /* OUT handle of the buffer element */
+    BfMAccessStrategy   *strategy)              /* INOUT access strategy (NULL : normal access) */
+{
+    Four                e, e2;                  /* for error */
     Four                index;                  /* index of the buffer pool */
+    BufferPartition     *part;                  /* partition of the train */
+    Boolean             loaded;                 /* TRUE if the train read without the latch is still in its buffer element */
+    Boolean             prefetched = FALSE;     /* TRUE if the train had been read ahead */
 
 
     /*@ Check the validity of given parameters */
     /* Some restrictions may be added         */
-    if(retBuf == NULL) ERR(eBADBUFFER_BFM);
+    if(retBuf == NULL || handle == NULL) ERR(eBADBUFFER_BFM);
 
     /* Is the buffer type valid? */
     if(IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);	
 
+    // Mapping 된 volume의 page/train인 경우, bufferPool에 복사하지 않고 mapping 안의 위치를 반환함
+    if (IS_MAPPED_VOLUME(trainId->volNo))
+        return( edubfm_GetMappedFrame(trainId, retBuf, type, handle) );
+
+    part = edubfm_GetPartition((BfMHashKey *)trainId, type);
+
+    // bufferPool에 존재하는 page/train은 가능하면 latch 없이 fix 함
+    if (PI_OPTIMISTIC(type)) {
+        index = edubfm_OptimisticFix((BfMHashKey *)trainId, type);
+        if (index != NOTFOUND_IN_HTABLE) {
+            BFM_STATS( edubfm_StatsOptimisticFix(type, part, index) );
+            BFM_TRACE(BFM_TRACE_FIXHIT, trainId, type);
+
+            *retBuf = BI_BUFFER(type, index);
+            handle->trainId = *trainId;
+            handle->type = type;
+            handle->index = index;
+
+            edubfm_ReadAheadNotify(trainId, type, FALSE);
+
+            return(eNOERROR);
+        }
+    }
+
+    // Fix 할 page/train이 속하는 partition의 latch를 획득함
+    e = edubfm_LatchPartition(part);
+    if (e < 0) ERR(e);
+
     // Fix 할 page/train의 hash key value를 이용하여, 
     // 해당 page/train이 저장된 buffer element의 array index를 hashTable에서 검색함
     index = edubfm_LookUp((BfMHashKey *)trainId, type);
+
+    // 다른 thread가 해당 page/train을 읽고 있는 경우, 다시 읽지 않고 읽기가 끝날 때까지 기다린 후 다시 검색함
+    while (index != NOTFOUND_IN_HTABLE && (BI_BITS(type, index) & READING)) {
+        e = edubfm_WaitFrameIO(type, index, part);
+        if (e < 0) ERR(e);
+
+        e = edubfm_LatchPartition(part);
+        if (e < 0) ERR(e);
+
+        index = edubfm_LookUp((BfMHashKey *)trainId, type);
+    }
     
     // Fix 할 page/train이 bufferPool에 존재하지 않는 경우,
     if (index == NOTFOUND_IN_HTABLE) {
         // bufferPool에서 page/train을 저장할 buffer element 한 개를 할당 받음
-        index = edubfm_AllocTrain(type);
-        if (index < 0) ERR(index);
-        
-        // Page/train을 disk로부터 읽어와서 할당 받은 buffer element에 저장함
-        e = edubfm_ReadTrain(trainId, BI_BUFFER(type, index), type);
-        if (e < 0) ERR(e);
+        // (access strategy가 주어진 경우, 해당 ring의 buffer element를 재사용함)
+        if (strategy != NULL && strategy->hint != BFM_ACCESS_NORMAL)
+            index = edubfm_AllocRingTrain((BfMHashKey *)trainId, type, strategy);
+        else
+            index = edubfm_AllocTrain((BfMHashKey *)trainId, type);
+        if (index < 0) ERR_UNLATCH(index, part);
 
-        // 할당 받은 buffer element에 대응하는 bufTable element를 갱신함
-        BI_BITS(type, index) = REFER;
-        BI_FIXED(type, index) = 1;
-        BI_KEY(type, index).pageNo = trainId->pageNo;
-        BI_KEY(type, index).volNo = trainId->volNo;
-        BI_NEXTHASHENTRY(type, index) = NIL;
+        // 비동기 I/O를 사용하는 경우, partition의 latch를 해제한 상태에서 읽어 다른 page/train들의 fix를 막지 않음
+        // (같은 page/train을 fix 하는 transaction들은 READING 표시를 보고 읽기가 끝날 때까지 기다림)
+        if (AIO_RUNNING() && part->useLatch) {
+            e = edubfm_BeginFrameRead(trainId, type, index);
+            if (e < 0) ERR_UNLATCH(e, part);
 
-        // 할당 받은 buffer element의 array index를 hashTable에 삽입함
-        e = edubfm_Insert(&BI_KEY(type, index), index, type);
-        if (e < 0) ERR(e);
+            e = edubfm_UnlatchPartition(part);
+            if (e < 0) ERR(e);
+
+            e2 = edubfm_ReadTrain(trainId, BI_BUFFER(type, index), type);
+
+            e = edubfm_LatchPartition(part);
+            if (e < 0) ERR(e);
+
+            loaded = edubfm_EndFrameRead(trainId, type, part, index, e2, REFER, TRUE);
+            if (e2 < 0) ERR_UNLATCH(e2, part);
+
+            // EduBfM_DiscardAll() 등에 의해 buffer element가 그동안 비워진 경우, 처음부터 다시 fix 함
+            if (!loaded) {
+                e = edubfm_UnlatchPartition(part);
+                if (e < 0) ERR(e);
+
+                return( edubfm_GetFrame(trainId, retBuf, type, handle, strategy) );
+            }
+
+            BFM_STATS( edubfm_StatsFix(type, part, index, FALSE) );
+            BFM_TRACE(BFM_TRACE_FIXMISS, trainId, type);
+        }
+        else {
+            // Page/train을 disk로부터 읽어와서 할당 받은 buffer element에 저장함
+            e = edubfm_ReadTrain(trainId, BI_BUFFER(type, index), type);
+            if (e < 0) ERR_UNLATCH(e, part);
+
+            // 할당 받은 buffer element에 대응하는 bufTable element를 갱신함
+            // (latch 없이 fix 하는 thread가 바뀌는 중인 key를 보지 않도록 version을 홀수로 만든 상태에서 갱신함)
+            FRAME_WRITE_BEGIN(type, index);
+            BI_BITS(type, index) = REFER;
+            BI_PIN(type, index);
+            BI_KEY(type, index).pageNo = trainId->pageNo;
+            BI_KEY(type, index).volNo = trainId->volNo;
+            BI_NEXTHASHENTRY(type, index) = NIL;
+            FRAME_WRITE_END(type, index);
+
+            // 할당 받은 buffer element의 array index를 hashTable에 삽입함
+            e = edubfm_Insert(&BI_KEY(type, index), index, type);
+            if (e < 0) ERR_UNLATCH(e, part);
+
+            // Replacement policy에 page/train이 새로 저장되었음을 알림
+            PI_POLICY(type)->fix(type, part, index, FALSE);
+            BFM_STATS( edubfm_StatsFix(type, part, index, FALSE) );
+            BFM_TRACE(BFM_TRACE_FIXMISS, trainId, type);
+        }
     }
     // Fix 할 page/train이 bufferPool에 존재하는 경우,
     else {
         // 해당 page/train이 저장된 buffer element에 대응하는 bufTable element를 갱신함
-        BI_FIXED(type, index) += 1;
+        BI_PIN(type, index);
+
+        // Read-ahead로 읽힌 후 처음 fix 되는 경우, 새로 읽혀 들어온 것과 같이 REFER bit를 set 함
+        if (BI_BITS(type, index) & PREFETCHED) {
+            prefetched = TRUE;
+            BI_BITS(type, index) = (BI_BITS(type, index) & ~PREFETCHED) | REFER;
+        }
+
+        // Replacement policy에 page/train이 다시 참조되었음을 알림
+        PI_POLICY(type)->fix(type, part, index, TRUE);
+        BFM_STATS( edubfm_StatsFix(type, part, index, TRUE) );
+        BFM_TRACE(BFM_TRACE_FIXHIT, trainId, type);
     }
 
-    // 할당 받은 buffer element에 대한 포인터를 반환함
+    // 할당 받은 buffer element에 대한 포인터와 handle을 반환함
     *retBuf = BI_BUFFER(type, index);
+    handle->trainId = *trainId;
+    handle->type = type;
+    handle->index = index;
+
+    e = edubfm_UnlatchPartition(part);
+    if (e < 0) ERR(e);
+
+    // Read-ahead가 sequential/strided access를 감지할 수 있도록 fix 된 page/train을 알림
+    edubfm_ReadAheadNotify(trainId, type, prefetched);
 
     return(eNOERROR);   /* No error */
 
-}  /* EduBfM_GetTrain() */
+}  /* edubfm_GetFrame() */
+
+
+
+/*@================================
+ * EduBfM_GetTrains()
+ *================================*/
+/*
+ * Function: EduBfM_GetTrains(TrainID*, char**, Four, Four)
+ *
+ * Description : 
+ *  Fix the 'count' trains given by 'trainIds' and return their buffers in
+ *  'retBufs'. If the I/O threads or the asynchronous I/O are running, the
+ *  missing trains are prefetched together first, so that their reads
+ *  overlap, and each train is then fixed as by EduBfM_GetTrain() in the
+ *  given order.
+ *  Either all trains are fixed, or none of them is fixed on an error.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFER_BFM - Invalid Buffer
+ *    eBADPARAMETER_EDUBFM - Invalid count
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) parameter retBufs
+ *     pointers to the buffers holding the trains
+ *
+ * 설명:
+ *  여러 page/train을 bufferPool에 한꺼번에 fix 하고, 각 page/train이 저장된 buffer element에 대한 포인터를 반환함
+ *  bufferPool에 존재하지 않는 page/train들은 I/O thread들이 동시에 읽도록 먼저 요청함
+ *
+ * 관련 함수:
+ *  1. EduBfM_Prefetch()
+ *  2. EduBfM_GetTrain()
+ */
+Four EduBfM_GetTrains(
+    TrainID             *trainIds,              /* IN trains to be used */
+    char                **retBufs,              /* OUT pointers to the returned buffers */
+    Four                count,                  /* IN # of trains */
+    Four                type )                  /* IN buffer type */
+{
+    Four                e;                      /* for error */
+    Four                i;                      /* index */
+
+
+    if (trainIds == NULL || retBufs == NULL) ERR(eBADBUFFER_BFM);
+    if (count < 0) ERR(eBADPARAMETER_EDUBFM);
+
+    // bufferPool에 존재하지 않는 page/train들을 I/O thread들이 동시에 읽도록 요청함
+    e = EduBfM_Prefetch(trainIds, count, type);
+    if (e < 0) ERR(e);
+
+    // 주어진 순서대로 각 page/train을 fix 하고, 에러가 발생하면 이미 fix 한 page/train들을 unfix 함
+    for (i = 0; i < count; i++) {
+        e = EduBfM_GetTrain(&trainIds[i], &retBufs[i], type);
+        if (e < 0) {
+            while (--i >= 0) EduBfM_FreeTrain(&trainIds[i], type);
+            ERR(e);
+        }
+    }
+
+    return(eNOERROR);   /* No error */
+
+}  /* EduBfM_GetTrains() */
@@ -0,0 +1,90 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_GetWriterStats.c
+ *
+ * Description :
+ *  Return the counters of the evictions and the writes of dirty pages/trains.
+ *
+ * Exports:
+ *  Four EduBfM_GetWriterStats(EduBfM_WriterStats *)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_GetWriterStats()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetWriterStats(EduBfM_WriterStats *)
+ *
+ * Description :
+ *  Return the sums of the counters of all partitions of all buffer pools
+ *  since EduBfM_Init(): how many pages/trains were replaced, how many of
+ *  them had to be written synchronously by the replacing EduBfM_GetTrain(),
+ *  how many pages/trains were written by the background writer, and how
+ *  many pages/trains were written by EduBfM_FlushAll() with how many write
+ *  requests, and how many pages/trains were written by the checkpoints.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - stats is NULL.
+ *
+ * 설명:
+ *  각 partition의 eviction 및 write 횟수를 합하여 반환함
+ */
+Four EduBfM_GetWriterStats(
+    EduBfM_WriterStats  *stats)                 /* OUT counters */
+{
+    Four                type;                   /* buffer type */
+    Four                p;                      /* partition number */
+    BufferPartition     *part;                  /* a partition */
+
+
+    if (stats == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    stats->nEvictions = stats->nSyncWrites = stats->nBgWrites = 0;
+    stats->nFlushedTrains = stats->nFlushWrites = stats->nCheckpointWrites = 0;
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        for (p = 0; p < PI_NLOOP(type); p++) {
+            part = PI_PART(type, p);
+            stats->nEvictions += part->writerStats.nEvictions;
+            stats->nSyncWrites += part->writerStats.nSyncWrites;
+            stats->nBgWrites += part->writerStats.nBgWrites;
+            stats->nFlushedTrains += part->writerStats.nFlushedTrains;
+            stats->nFlushWrites += part->writerStats.nFlushWrites;
+            stats->nCheckpointWrites += part->writerStats.nCheckpointWrites;
+        }
+    }
+
+    return(eNOERROR);
+
+}  /* EduBfM_GetWriterStats() */
@@ -0,0 +1,634 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_Init.c
+ *
+ * Description :
+ *  Initialize/finalize the data structures which EduBfM keeps in addition
+ *  to the buffer pools set up by the storage system (bufInfo[]).
+ *
+ * Exports:
+ *  Four EduBfM_Init(void)
+ *  Four EduBfM_Final(void)
+ */
+
+
+#include <stdlib.h> /* for malloc & free */
+#include <string.h> /* for memset */
+#include <unistd.h> /* for access */
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+/* configuration parameters of EduBfM */
+EduBfM_CfgParams_T edubfm_cfgParams;
+
+
+/* internal function prototypes */
+static Four edubfm_init_LoadResidentSet(void);
+static void edubfm_init_UndoPartitions(Four, Four, Four);
+
+
+
+/*@================================
+ * EduBfM_Init()
+ *================================*/
+/*
+ * Function: Four EduBfM_Init(void)
+ *
+ * Description :
+ *  Initialize EduBfM according to edubfm_cfgParams.
+ *  It must be called after the storage system has set up the buffer pools
+ *  and while no page/train is fixed.
+ *  If edubfm_cfgParams.nPartitions > 0, each buffer pool is split into
+ *  that many partitions (at most one per buffer element). The buffer pools
+ *  are flushed and emptied first so that every page/train resides in a
+ *  buffer element of its own partition.
+ *  edubfm_cfgParams.replacementPolicy[type] selects the replacement policy
+ *  of each buffer pool (BFM_CLOCK, BFM_LRUK, BFM_2Q or BFM_ARC), whose state
+ *  is kept per partition.
+ *  If edubfm_cfgParams.pageTable is BFM_OPEN_TABLE, each partition gets an
+ *  open addressing page table which replaces the chained hash table.
+ *  If edubfm_cfgParams.bgWriterCleanPercent > 0, the background writer is
+ *  started; since it runs concurrently, the buffer pools are then latched
+ *  as one partition even if nPartitions is 0.
+ *  If edubfm_cfgParams.readAheadMaxWindow > 0 or edubfm_cfgParams.nIOThreads > 0,
+ *  the I/O threads serving the read-ahead and EduBfM_Prefetch() are
+ *  started, and the buffer pools are latched likewise.
+ *  If edubfm_cfgParams.maxBufs[type] > 0, the buffer pool can be resized
+ *  by EduBfM_ResizeBuffer() up to that many buffer elements, and is latched
+ *  likewise. The arrays of the buffer pool are reallocated for the maximum
+ *  size, and each partition reserves an equal share of them.
+ *  If edubfm_cfgParams.useHugePages or edubfm_cfgParams.useDirectIO is set,
+ *  the buffer pools are reallocated likewise, aligned to BFM_HUGEPAGE_SIZE
+ *  and backed by huge pages, or page aligned so that the volumes attached
+ *  with O_DIRECT can be read into and written from them.
+ *  If edubfm_cfgParams.compressedCacheSize > 0, a compressed cache of that
+ *  many bytes (at least CCACHE_MIN_SIZE) keeps the replaced pages/trains.
+ *  If edubfm_cfgParams.useOptimisticFix is set, the pages/trains found in
+ *  a partitioned buffer pool using BFM_CLOCK and BFM_CHAINED_TABLE are
+ *  fixed and unfixed without the latch (see edubfm_OptimisticFix.c).
+ *  If edubfm_cfgParams.residentSetFile is set, the pages/trains listed in
+ *  the file by the last EduBfM_Final() are read back into the buffer pools
+ *  before it returns (a missing or invalid file is ignored). If
+ *  edubfm_cfgParams.residentSetInterval > 0, the file is also rewritten
+ *  every that many seconds by a thread, and the buffer pools are latched
+ *  likewise.
+ *  If edubfm_cfgParams.varTrainPoolPages > 0, a pool of that many pages
+ *  caches the variable-size trains fixed by EduBfM_GetVarTrain().
+ *  If edubfm_cfgParams.numaNodes != 0, the partitions (at least one per
+ *  node) are spread over that many NUMA nodes, and the buffer elements and
+ *  the state of each partition are put on its node (see edubfm_Numa.c).
+ *  If edubfm_cfgParams.cleanFirstBudget > 0, BFM_CLOCK passes over up to
+ *  that many unreferenced dirty buffer elements to select a clean victim,
+ *  so that fewer misses wait for the write of the replaced page/train.
+ *  If edubfm_cfgParams.ioQueueDepth > 0, up to that many reads and writes
+ *  of the attached volumes are kept in flight by io_uring (or by a pool of
+ *  threads if it is not available or edubfm_cfgParams.useIOThreadPool is
+ *  set), a miss reads its page/train without the latch of the partition,
+ *  and the buffer pools are latched likewise (see edubfm_AsyncIO.c).
+ *  If edubfm_cfgParams.traceFile is set, the fixes, unfixes and I/Os are
+ *  recorded in the file until EduBfM_Final() (see edubfm_Trace.c).
+ *  If edubfm_cfgParams.checkpointInterval > 0, a thread takes a fuzzy
+ *  checkpoint spread over every that many msec, and the buffer pools are
+ *  latched likewise (see edubfm_Checkpoint.c).
+ *  If an error occurs, whatever has been started is stopped and freed in
+ *  the reverse order, so that EduBfM is left as after EduBfM_Final() (the
+ *  buffer pools reallocated for huge pages, O_DIRECT or NUMA are kept).
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - Invalid configuration parameter
+ *    eFLUSHFIXEDBUF_BFM - A page/train is still fixed.
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ *    eMUTEXINITFAILED_BFM - A latch cannot be initialized.
+ *    some errors caused by function calls
+ *
+ * 설명:
+ *  bufferPool을 partition들로 나누고, 각 partition의 latch, clock hand와 replacement policy의 상태를 초기화함
+ */
+Four EduBfM_Init(void)
+{
+    Four                e;                      /* error */
+    Two                 i;                      /* index */
+    Four                p;                      /* partition number */
+    Four                type;                   /* buffer type */
+    Four                nParts;                 /* # of partitions */
+    BufferPartition     *part;                  /* a partition */
+    Four                nPartsCfg;              /* # of partitions to be made */
+    Boolean             useClock = TRUE;        /* TRUE if every buffer pool uses BFM_CLOCK */
+    Boolean             useResize = FALSE;      /* TRUE if any buffer pool is resizable */
+    Four                nBufs;                  /* # of buffer elements in use */
+    Four                maxBufs;                /* # of buffer elements reserved for each partition */
+    Four                nNodes;                 /* # of NUMA nodes */
+    Four                nLatches[NUM_BUF_TYPES];    /* # of latches initialized for each buffer pool */
+    Four                nBufsBefore[NUM_BUF_TYPES]; /* # of buffer elements of each buffer pool before reallocated */
+
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        if (edubfm_cfgParams.replacementPolicy[type] < 0 ||
+            edubfm_cfgParams.replacementPolicy[type] >= NUM_BFM_POLICIES) ERR(eBADPARAMETER_EDUBFM);
+        if (edubfm_cfgParams.replacementPolicy[type] != BFM_CLOCK) useClock = FALSE;
+    }
+
+    if (edubfm_cfgParams.pageTable != BFM_CHAINED_TABLE &&
+        edubfm_cfgParams.pageTable != BFM_OPEN_TABLE) ERR(eBADPARAMETER_EDUBFM);
+
+    if (edubfm_cfgParams.bgWriterCleanPercent < 0 ||
+        edubfm_cfgParams.bgWriterCleanPercent > 100) ERR(eBADPARAMETER_EDUBFM);
+
+    if (edubfm_cfgParams.readAheadMaxWindow < 0 ||
+        edubfm_cfgParams.nIOThreads < 0 || edubfm_cfgParams.nIOThreads > MAX_IO_THREADS) ERR(eBADPARAMETER_EDUBFM);
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        if (edubfm_cfgParams.maxBufs[type] < 0 || edubfm_cfgParams.maxBufs[type] > MAX_RESIZABLE_NBUFS) ERR(eBADPARAMETER_EDUBFM);
+        if (edubfm_cfgParams.maxBufs[type] > 0) {
+            if (edubfm_cfgParams.maxBufs[type] < BI_NBUFS(type)) ERR(eBADPARAMETER_EDUBFM);
+            useResize = TRUE;
+        }
+    }
+
+    if (edubfm_cfgParams.numaNodes < BFM_NUMA_MACHINE ||
+        edubfm_cfgParams.numaNodes > BFM_MAX_NUMA_NODES) ERR(eBADPARAMETER_EDUBFM);
+
+    if (edubfm_cfgParams.varTrainPoolPages < 0) ERR(eBADPARAMETER_EDUBFM);
+
+    if (edubfm_cfgParams.cleanFirstBudget < 0) ERR(eBADPARAMETER_EDUBFM);
+
+    if (edubfm_cfgParams.checkpointInterval < 0) ERR(eBADPARAMETER_EDUBFM);
+
+    if (edubfm_cfgParams.ioQueueDepth < 0 || edubfm_cfgParams.ioQueueDepth > AIO_MAX_DEPTH) ERR(eBADPARAMETER_EDUBFM);
+
+    if (edubfm_cfgParams.compressedCacheSize < 0 ||
+        (edubfm_cfgParams.compressedCacheSize > 0 && edubfm_cfgParams.compressedCacheSize < CCACHE_MIN_SIZE)) ERR(eBADPARAMETER_EDUBFM);
+
+    // Clock은 partition의 상태를 갖지 않으므로, partition되지 않은 bufferPool에도 budget을 적용함
+    for (type = 0; type < NUM_BUF_TYPES; type++)
+        PI_CLEANFIRSTBUDGET(type) = edubfm_cfgParams.cleanFirstBudget;
+
+    // Compressed cache는 자신의 mutex를 사용하므로 bufferPool의 partition과 관계없이 할당함
+    edubfm_StopCompressedCache();
+    if (edubfm_cfgParams.compressedCacheSize > 0) {
+        e = edubfm_StartCompressedCache(edubfm_cfgParams.compressedCacheSize);
+        if (e < 0) ERR(e);
+    }
+
+    // Variable-size train pool도 자신의 mutex를 사용하므로 bufferPool의 partition과 관계없이 할당함
+    // (이전에 할당된 pool의 수정된 train들은 disk에 기록함)
+    e = edubfm_StopVarTrainPool();
+    if (e < 0) goto undo_ccache;
+    if (edubfm_cfgParams.varTrainPoolPages > 0) {
+        e = edubfm_StartVarTrainPool(edubfm_cfgParams.varTrainPoolPages);
+        if (e < 0) goto undo_ccache;
+    }
+
+    // Trace도 자신의 mutex를 사용하므로 bufferPool의 partition과 관계없이, 아래에서 시작되는 thread들보다 먼저 시작함
+    // (이전에 시작된 trace는 끝냄)
+    e = edubfm_StopTrace();
+    if (e < 0) goto undo_vartrain;
+    if (edubfm_cfgParams.traceFile != NULL) {
+        e = edubfm_StartTrace(edubfm_cfgParams.traceFile);
+        if (e < 0) goto undo_vartrain;
+    }
+
+    edubfm_ResetCheckpointStats();
+
+    // Background writer, checkpointer와 I/O thread들은 다른 thread에서 수행되고 EduBfM_ResizeBuffer()도 다른 thread에서
+    // 호출될 수 있으므로, latch를 사용하는 partition이 최소 한 개 필요함
+    nPartsCfg = edubfm_cfgParams.nPartitions;
+    if (nPartsCfg <= 0 && (edubfm_cfgParams.bgWriterCleanPercent > 0 || edubfm_cfgParams.checkpointInterval > 0 ||
+                           useResize || edubfm_cfgParams.ioQueueDepth > 0 ||
+                           edubfm_cfgParams.readAheadMaxWindow > 0 || edubfm_cfgParams.nIOThreads > 0 ||
+                           (edubfm_cfgParams.residentSetFile != NULL && edubfm_cfgParams.residentSetInterval > 0))) nPartsCfg = 1;
+
+    // 각 NUMA node가 최소 한 개의 partition을 갖도록 함
+    nNodes = edubfm_StartNuma(edubfm_cfgParams.numaNodes);
+    nPartsCfg = MAX(nPartsCfg, nNodes);
+
+    if (nPartsCfg <= 0 && useClock && edubfm_cfgParams.pageTable == BFM_CHAINED_TABLE &&
+        !edubfm_cfgParams.useHugePages && !edubfm_cfgParams.useDirectIO) {
+        e = edubfm_init_LoadResidentSet();
+        if (e < 0) goto undo_numa;
+
+        return(eNOERROR);
+    }
+
+    /* Is any page/train fixed? */
+    e = eNOERROR;
+    for (type = 0; type < NUM_BUF_TYPES; type++)
+        for (i = 0; i < BI_NBUFS(type); i++)
+            if (BI_FIXED(type, i) > 0) e = eFLUSHFIXEDBUF_BFM;
+    if (e < 0) goto undo_numa;
+
+    // 각 page/train이 자신의 partition에 속하는 buffer element에 저장되도록 bufferPool을 비움
+    e = EduBfM_FlushAll();
+    if (e < 0) goto undo_numa;
+
+    e = EduBfM_DiscardAll();
+    if (e < 0) goto undo_numa;
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        nLatches[type] = 0;
+        nBufsBefore[type] = BI_NBUFS(type);
+    }
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+
+        // Huge page를 사용하거나 O_DIRECT로 읽고 쓰는 경우, 정렬된 bufferPool을 다시 할당함
+        // NUMA node에 배치하는 경우에도, 각 partition의 buffer element들이 처음 사용될 때 자신의 node에 할당되도록 다시 할당함
+        // (resizable buffer pool은 아래에서 최대 크기로 다시 할당함)
+        if (edubfm_cfgParams.maxBufs[type] == 0 && (edubfm_cfgParams.useHugePages || edubfm_cfgParams.useDirectIO || nNodes > 0)) {
+            e = edubfm_ReserveBufferPool(type, BI_NBUFS(type));
+            if (e < 0) goto undo_partitions;
+        }
+
+        if (nPartsCfg > 0) {
+            nParts = MIN(nPartsCfg, BI_NBUFS(type));
+            nParts = MIN(nParts, HASHTABLESIZE(type));
+            nBufs = BI_NBUFS(type);
+            maxBufs = 0;
+
+            // Resizable buffer pool이면 각 partition이 같은 크기의 영역을 예약하도록, 최대 크기로 bufferPool을 다시 할당함
+            // (bufferPool이 비어 있으므로 옮길 page/train은 없음)
+            if (edubfm_cfgParams.maxBufs[type] > 0) {
+                maxBufs = (edubfm_cfgParams.maxBufs[type] + nParts - 1) / nParts;
+                maxBufs = MIN(maxBufs, MAX_RESIZABLE_NBUFS / nParts);
+                if (maxBufs * nParts < nBufs) {
+                    e = eBADPARAMETER_EDUBFM;
+                    goto undo_partitions;
+                }
+
+                e = edubfm_ReserveBufferPool(type, maxBufs * nParts);
+                if (e < 0) goto undo_partitions;
+
+                PI_RESIZABLE(type) = TRUE;
+            }
+
+            // (실패한 경우 해제할 수 있도록, open addressing page table들을 비워 둠)
+            partInfo[type].parts = (BufferPartition *)calloc(nParts, sizeof(BufferPartition));
+            if (partInfo[type].parts == NULL) {
+                e = eMEMALLOCERR_EDUBFM;
+                goto undo_partitions;
+            }
+
+            // Partition p는 buffer element [p*nBufs/nParts, (p+1)*nBufs/nParts) 를 소유함
+            // (resizable buffer pool이면 [p*maxBufs, p*maxBufs + nBufs/nParts) 를 사용함)
+            // NUMA node n은 연속된 partition [n*nParts/nNodes, (n+1)*nParts/nNodes) 를 가짐
+            for (p = 0; p < nParts; p++) {
+                part = &partInfo[type].parts[p];
+                part->firstBuf = (Two)((p * nBufs) / nParts);
+                part->nBufs = (Two)(((p + 1) * nBufs) / nParts) - part->firstBuf;
+                part->maxBufs = part->nBufs;
+                if (PI_RESIZABLE(type)) {
+                    part->firstBuf = (Two)(p * maxBufs);
+                    part->maxBufs = (Two)maxBufs;
+                }
+                part->nextVictim = 0;
+                part->node = (nNodes > 0) ? (Two)((p * nNodes) / nParts) : NIL;
+                part->useLatch = TRUE;
+                part->policyState = NULL;
+                memset(&part->writerStats, 0, sizeof(EduBfM_WriterStats));
+                BFM_STATS( memset(&part->stats, 0, sizeof(EduBfM_Stats)) );
+
+                if (pthread_mutex_init(&part->latch, NULL) != 0) {
+                    e = eMUTEXINITFAILED_BFM;
+                    goto undo_partitions;
+                }
+                nLatches[type]++;
+            }
+
+            PI_NPARTS(type) = nParts;
+        }
+        else {
+            memset(&partInfo[type].whole.writerStats, 0, sizeof(EduBfM_WriterStats));
+            BFM_STATS( memset(&partInfo[type].whole.stats, 0, sizeof(EduBfM_Stats)) );
+        }
+
+        // 각 partition (partition되지 않은 경우 bufferPool 전체) 에 대해 replacement policy의 상태를 생성함
+        partInfo[type].policy = &edubfm_policies[edubfm_cfgParams.replacementPolicy[type]];
+
+        // NUMA node에 배치하는 경우, 각 partition의 상태는 그 partition의 node에 할당함
+        for (p = 0; p < PI_NLOOP(type); p++) {
+            if (nNodes > 0) edubfm_SetMemoryNode(PI_PART(type, p)->node);
+            e = PI_POLICY(type)->init(type, PI_PART(type, p));
+            if (nNodes > 0) edubfm_SetMemoryNode(NIL);
+            if (e < 0) goto undo_partitions;
+        }
+
+        // 각 partition의 open addressing page table을 생성함 (bufferPool이 비어 있으므로 빈 table로 시작함)
+        if (edubfm_cfgParams.pageTable == BFM_OPEN_TABLE) {
+            for (p = 0; p < PI_NLOOP(type); p++) {
+                if (nNodes > 0) edubfm_SetMemoryNode(PI_PART(type, p)->node);
+                e = edubfm_opt_Init(&PI_PART(type, p)->pageTable, PI_PART(type, p)->maxBufs);
+                if (nNodes > 0) edubfm_SetMemoryNode(NIL);
+                if (e < 0) goto undo_partitions;
+            }
+            PI_USEOPENTABLE(type) = TRUE;
+        }
+
+        // bufferPool에 존재하는 page/train을 latch 없이 fix 하도록, 각 buffer element의 version을 할당함
+        if (edubfm_cfgParams.useOptimisticFix) {
+            e = edubfm_StartOptimisticFix(type);
+            if (e < 0) goto undo_partitions;
+        }
+
+        // 각 partition의 buffer element들과 bufTable entry들을 그 partition의 NUMA node에 배치함
+        if (nNodes > 0)
+            for (p = 0; p < PI_NPARTS(type); p++) edubfm_PlacePartition(type, PI_PART(type, p));
+    }
+
+    // Background writer가 batch를 만들 수 있도록 비동기 I/O를 먼저 시작함
+    if (edubfm_cfgParams.ioQueueDepth > 0) {
+        e = edubfm_StartAsyncIO(edubfm_cfgParams.ioQueueDepth, edubfm_cfgParams.useIOThreadPool);
+        if (e < 0) goto undo_partitions;
+    }
+
+    if (edubfm_cfgParams.bgWriterCleanPercent > 0) {
+        e = edubfm_StartBgWriter();
+        if (e < 0) goto undo_asyncio;
+    }
+
+    if (edubfm_cfgParams.checkpointInterval > 0) {
+        e = edubfm_StartCheckpointer();
+        if (e < 0) goto undo_bgwriter;
+    }
+
+    if (edubfm_cfgParams.readAheadMaxWindow > 0 || edubfm_cfgParams.nIOThreads > 0) {
+        e = edubfm_StartReadAhead();
+        if (e < 0) goto undo_checkpointer;
+    }
+
+    if (edubfm_cfgParams.residentSetFile != NULL && edubfm_cfgParams.residentSetInterval > 0) {
+        e = edubfm_StartResidentSetWriter();
+        if (e < 0) goto undo_readahead;
+    }
+
+    e = edubfm_init_LoadResidentSet();
+    if (e < 0) goto undo_residentset;
+
+    return(eNOERROR);
+
+    // 오류가 발생한 경우, 그때까지 시작한 것들을 역순으로 중지하고 해제함
+undo_residentset:
+    // Resizable bufferPool을 줄일 수 있도록, 다시 읽어 들인 page/train들을 제거함
+    if (useResize) {
+        EduBfM_FlushAll();
+        EduBfM_DiscardAll();
+    }
+    edubfm_StopResidentSetWriter();
+undo_readahead:
+    edubfm_StopReadAhead();
+undo_checkpointer:
+    edubfm_StopCheckpointer();
+undo_bgwriter:
+    edubfm_StopBgWriter();
+undo_asyncio:
+    edubfm_StopAsyncIO();
+undo_partitions:
+    for (type = NUM_BUF_TYPES - 1; type >= 0; type--)
+        edubfm_init_UndoPartitions(type, nLatches[type], nBufsBefore[type]);
+undo_numa:
+    edubfm_StopNuma();
+    edubfm_StopTrace();
+undo_vartrain:
+    edubfm_StopVarTrainPool();
+undo_ccache:
+    edubfm_StopCompressedCache();
+
+    ERR(e);
+
+}  /* EduBfM_Init() */
+
+
+
+/*
+ * Function: static Four edubfm_init_LoadResidentSet(void)
+ *
+ * Description:
+ *  Read the pages/trains listed in edubfm_cfgParams.residentSetFile (if
+ *  any) back into the buffer pools. A missing or invalid file is ignored,
+ *  so that EduBfM starts cold instead of failing.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four edubfm_init_LoadResidentSet(void)
+{
+    Four                e;                      /* error */
+
+    if (edubfm_cfgParams.residentSetFile == NULL || access(edubfm_cfgParams.residentSetFile, F_OK) != 0) return(eNOERROR);
+
+    e = EduBfM_LoadResidentSet(edubfm_cfgParams.residentSetFile);
+    if (e < 0 && e != eFILEIOERR_EDUBFM) ERR(e);
+
+    return(eNOERROR);
+
+}  /* edubfm_init_LoadResidentSet */
+
+
+
+/*
+ * Function: static void edubfm_init_UndoPartitions(Four, Four, Four)
+ *
+ * Description:
+ *  Undo what EduBfM_Init() has done to the buffer pool before it failed:
+ *  stop the optimistic fix, free the open addressing page tables and the
+ *  states of the replacement policy, destroy the latches initialized and
+ *  free the partitions. A resizable buffer pool, which is still empty, is
+ *  shrunk back to the number of buffer elements it had.
+ */
+static void edubfm_init_UndoPartitions(
+    Four                type,                   /* IN buffer type */
+    Four                nLatches,               /* IN # of latches of the partitions initialized */
+    Four                nBufs)                  /* IN # of buffer elements before EduBfM_Init() */
+{
+    Four                p;                      /* partition number */
+
+    if (PI_OPTIMISTIC(type)) edubfm_StopOptimisticFix(type);
+
+    // PI_NPARTS(type)는 모든 partition의 latch가 초기화된 후에 설정되므로, 그 전에는 bufferPool 전체만 해제함
+    for (p = 0; p < PI_NLOOP(type); p++) {
+        edubfm_opt_Final(&PI_PART(type, p)->pageTable);
+        if (partInfo[type].policy != NULL) partInfo[type].policy->final(type, PI_PART(type, p));
+    }
+    PI_USEOPENTABLE(type) = FALSE;
+    partInfo[type].policy = NULL;
+
+    if (partInfo[type].parts != NULL) {
+        for (p = 0; p < nLatches; p++) pthread_mutex_destroy(&partInfo[type].parts[p].latch);
+
+        free(partInfo[type].parts);
+        partInfo[type].parts = NULL;
+    }
+    PI_NPARTS(type) = 0;
+
+    if (PI_RESIZABLE(type)) {
+        PI_RESIZABLE(type) = FALSE;
+        edubfm_CompactBufferPool(type, nBufs);
+    }
+
+}  /* edubfm_init_UndoPartitions */
+
+
+
+/*@================================
+ * EduBfM_Final()
+ *================================*/
+/*
+ * Function: Four EduBfM_Final(void)
+ *
+ * Description :
+ *  Finalize EduBfM. The buffer pools are merged back into one partition
+ *  after the checkpointer (aborting its checkpoint in progress), the
+ *  background writer, the I/O threads and the asynchronous I/O (if any)
+ *  are stopped, so that the storage system can use them again
+ *  without latches, and the replacement policies are reset to BFM_CLOCK.
+ *  If the open addressing page tables were used, the chained hash tables
+ *  are rebuilt from them.
+ *  The buffer pools themselves are left as they are, except that a
+ *  resizable buffer pool is flushed, emptied and shrunk to the number of
+ *  buffer elements in use, unless a page/train is still fixed in it
+ *  (then all the buffer elements reserved for it are kept).
+ *  The compressed cache (if any) is freed, and so is the pool of the
+ *  variable-size trains (if any) after its dirty trains are written.
+ *  If edubfm_cfgParams.residentSetFile is set, the pages/trains in the
+ *  buffer pools are listed in the file first, so that the next
+ *  EduBfM_Init() reads them back (a failure to write it is only reported).
+ *  The trace file (if any) is completed and closed last.
+ *
+ * Returns:
+ *  error code
+ *    eMUTEXDESTROYUNKNOWN_BFM - A latch cannot be destroyed.
+ *    some errors caused by function calls
+ *
+ * 설명:
+ *  각 partition의 latch와 replacement policy의 상태를 제거하고, partition 정보를 해제함
+ */
+Four EduBfM_Final(void)
+{
+    Four                e;                      /* error */
+    Two                 i;                      /* index */
+    Four                p;                      /* partition number */
+    Four                type;                   /* buffer type */
+    Four                nBufs[NUM_BUF_TYPES];   /* # of buffer elements in use of each resizable buffer pool */
+    Boolean             compact = FALSE;        /* TRUE if any resizable buffer pool is to be shrunk */
+
+
+    e = edubfm_StopResidentSetWriter();
+    if (e < 0) ERR(e);
+
+    e = edubfm_StopCheckpointer();
+    if (e < 0) ERR(e);
+
+    e = edubfm_StopBgWriter();
+    if (e < 0) ERR(e);
+
+    e = edubfm_StopReadAhead();
+    if (e < 0) ERR(e);
+
+    edubfm_StopAsyncIO();
+
+    // 다음 EduBfM_Init()이 다시 읽어 들이도록, bufferPool에 저장된 page/train들의 목록을 기록함
+    if (edubfm_cfgParams.residentSetFile != NULL) {
+        e = EduBfM_SaveResidentSet(edubfm_cfgParams.residentSetFile);
+        if (e < 0) PRTERR(e);
+    }
+
+    edubfm_StopCompressedCache();
+
+    // Storage system은 variable-size train pool을 알지 못하므로, 수정된 train들을 기록한 후 pool을 해제함
+    e = edubfm_StopVarTrainPool();
+    if (e < 0) ERR(e);
+
+    edubfm_StopNuma();
+
+    // Resizable buffer pool은 storage system이 사용 중인 buffer element들만 보도록, 비운 후 그 크기로 줄임
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        nBufs[type] = NIL;
+        if (!PI_RESIZABLE(type)) continue;
+
+        for (i = 0; i < BI_NBUFS(type); i++)
+            if (BI_FIXED(type, i) > 0) break;
+        if (i < BI_NBUFS(type)) continue;
+
+        nBufs[type] = 0;
+        for (p = 0; p < PI_NPARTS(type); p++) nBufs[type] += PI_PART(type, p)->nBufs;
+        compact = TRUE;
+    }
+
+    if (compact) {
+        e = EduBfM_FlushAll();
+        if (e < 0) ERR(e);
+
+        e = EduBfM_DiscardAll();
+        if (e < 0) ERR(e);
+    }
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        if (PI_OPTIMISTIC(type)) edubfm_StopOptimisticFix(type);
+        PI_CLEANFIRSTBUDGET(type) = 0;
+
+        // Read-ahead로 읽힌 page/train들의 표시를 지움
+        for (i = 0; i < BI_NBUFS(type); i++) BI_BITS(type, i) &= ~PREFETCHED;
+
+        // Storage system이 page/train들을 다시 찾을 수 있도록 hashTable을 재구성함
+        if (PI_USEOPENTABLE(type)) {
+            PI_USEOPENTABLE(type) = FALSE;
+            for (p = 0; p < PI_NLOOP(type); p++) edubfm_opt_Final(&PI_PART(type, p)->pageTable);
+
+            e = edubfm_RebuildHashTable(type);
+            if (e < 0) ERR(e);
+        }
+
+        if (partInfo[type].policy != NULL) {
+            for (p = 0; p < PI_NLOOP(type); p++)
+                partInfo[type].policy->final(type, PI_PART(type, p));
+            partInfo[type].policy = NULL;
+        }
+
+        if (!IS_PARTITIONED(type)) continue;
+
+        for (p = 0; p < PI_NPARTS(type); p++)
+            if (pthread_mutex_destroy(&PI_PART(type, p)->latch) != 0) ERR(eMUTEXDESTROYUNKNOWN_BFM);
+
+        free(partInfo[type].parts);
+        partInfo[type].parts = NULL;
+        PI_NPARTS(type) = 0;
+
+        if (PI_RESIZABLE(type)) {
+            PI_RESIZABLE(type) = FALSE;
+            if (nBufs[type] != NIL) edubfm_CompactBufferPool(type, nBufs[type]);
+        }
+    }
+
+    // 아직 기록되지 않은 trace record들을 기록하고 trace file을 닫음
+    e = edubfm_StopTrace();
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+}  /* EduBfM_Final() */
@@ -0,0 +1,81 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_InitAccessStrategy.c
+ *
+ * Description :
+ *  Initialize an access strategy for EduBfM_GetTrainWithStrategy().
+ *
+ * Exports:
+ *  Four EduBfM_InitAccessStrategy(BfMAccessStrategy *, Four)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_InitAccessStrategy()
+ *================================*/
+/*
+ * Function: Four EduBfM_InitAccessStrategy(BfMAccessStrategy *, Four)
+ *
+ * Description :
+ *  Initialize the access strategy with the access hint, BFM_ACCESS_NORMAL,
+ *  BFM_ACCESS_SEQSCAN or BFM_ACCESS_BULKWRITE. The ring is empty, and its
+ *  size is decided when the first train is read into it.
+ *  The strategy should be initialized again for each scan or bulk write,
+ *  and no resource has to be released after it.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - strategy is NULL, or invalid hint
+ *
+ * 설명:
+ *  Scan이나 bulk write가 사용할 access strategy를 초기화함
+ */
+Four EduBfM_InitAccessStrategy(
+    BfMAccessStrategy   *strategy,              /* OUT access strategy */
+    Four                hint)                   /* IN access hint */
+{
+    Four                i;                      /* index */
+
+
+    if (strategy == NULL) ERR(eBADPARAMETER_EDUBFM);
+    if (hint != BFM_ACCESS_NORMAL && hint != BFM_ACCESS_SEQSCAN && hint != BFM_ACCESS_BULKWRITE) ERR(eBADPARAMETER_EDUBFM);
+
+    strategy->hint = hint;
+    strategy->type = NIL;
+    strategy->nFrames = 0;
+    strategy->current = NIL;
+
+    for (i = 0; i < BFM_MAX_RING_SIZE; i++) strategy->frames[i] = NIL;
+
+    return(eNOERROR);
+
+}  /* EduBfM_InitAccessStrategy() */
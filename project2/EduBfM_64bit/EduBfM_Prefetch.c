@@ -0,0 +1,108 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_Prefetch.c
+ *
+ * Description :
+ *  Hint that the given trains will be fixed soon.
+ *
+ * Exports:
+ *  Four EduBfM_Prefetch(TrainID *, Four, Four)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_Prefetch()
+ *================================*/
+/*
+ * Function: Four EduBfM_Prefetch(TrainID *, Four, Four)
+ *
+ * Description :
+ *  Request the I/O threads to read the 'count' trains given by 'trainIds'
+ *  into the buffer pool, and return without waiting. The trains already in
+ *  the buffer pool are skipped, and a train being read is waited for when it
+ *  is fixed. It is only a hint: nothing is done if no I/O thread is running
+ *  (see EduBfM_Init()), and the requests beyond READAHEAD_QUEUE_SIZE pending
+ *  ones are dropped. If no I/O thread is running but the asynchronous I/O
+ *  is, the trains are read by the calling thread with their reads in
+ *  flight together, and it returns when they have been read. The trains
+ *  of the mapped volumes are read ahead by the OS instead.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFER_BFM - trainIds is NULL.
+ *    eBADBUFFERTYPE_BFM - Invalid Buffer type
+ *    eBADHASHKEY_BFM - Invalid train ID
+ *    eBADPARAMETER_EDUBFM - Invalid count
+ *
+ * 설명:
+ *  곧 fix 될 page/train들을 I/O thread들이 미리 읽어 bufferPool에 저장하도록 요청함
+ *
+ * 관련 함수:
+ *  1. edubfm_ReadAheadQueue()
+ *  2. edubfm_ReadFrames()
+ */
+Four EduBfM_Prefetch(
+    TrainID             *trainIds,              /* IN trains to be read */
+    Four                count,                  /* IN # of trains */
+    Four                type)                   /* IN buffer type */
+{
+    Four                e;                      /* error */
+    Four                i;                      /* index */
+
+
+    if (trainIds == NULL) ERR(eBADBUFFER_BFM);
+    if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
+    if (count < 0) ERR(eBADPARAMETER_EDUBFM);
+
+    for (i = 0; i < count; i++) CHECKKEY((BfMHashKey *)&trainIds[i]);
+
+    // I/O thread가 수행 중이 아니면, 비동기 I/O를 사용하는 경우에만 직접 함께 읽음
+    // (mapping 된 volume의 page/train은 운영체제가 미리 읽도록 요청함)
+    if (edubfm_nMappedVolumes == 0) {
+        if (!edubfm_ReadAheadQueue(trainIds, count, type) && AIO_RUNNING()) {
+            e = edubfm_ReadFrames(trainIds, count, type);
+            if (e < 0) ERR(e);
+        }
+    }
+    else {
+        for (i = 0; i < count; i++) {
+            if (IS_MAPPED_VOLUME(trainIds[i].volNo)) edubfm_PrefetchMapped(&trainIds[i], type);
+            else if (!edubfm_ReadAheadQueue(&trainIds[i], 1, type) && AIO_RUNNING()) {
+                e = edubfm_ReadFrames(&trainIds[i], 1, type);
+                if (e < 0) ERR(e);
+            }
+        }
+    }
+
+    return(eNOERROR);
+
+}  /* EduBfM_Prefetch() */
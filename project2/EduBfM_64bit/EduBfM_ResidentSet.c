@@ -0,0 +1,314 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_ResidentSet.c
+ *
+ * Description :
+ *  Save the list of the pages/trains resident in the buffer pools to a
+ *  file, and read them back into the buffer pools, so that EduBfM starts
+ *  warm after a restart (see edubfm_cfgParams.residentSetFile).
+ *
+ * Exports:
+ *  Four EduBfM_SaveResidentSet(char *)
+ *  Four EduBfM_LoadResidentSet(char *)
+ */
+
+
+#include <stdlib.h> /* for malloc & free */
+#include <string.h> /* for memcmp */
+#include <unistd.h> /* for fsync */
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+/* internal function prototypes */
+static int edubfm_rs_Compare(const void *, const void *);
+
+
+
+/*@================================
+ * EduBfM_SaveResidentSet()
+ *================================*/
+/*
+ * Function: Four EduBfM_SaveResidentSet(char *)
+ *
+ * Description :
+ *  Write a ResidentSetEntry (volNo, pageNo, type) for each page/train in
+ *  the buffer pools to the given file, after a ResidentSetHeader. The
+ *  pages/trains referenced since the clock hand passed them (REFER bit)
+ *  are written first. Each partition is latched while it is scanned, so it
+ *  can be called while the buffer pools are used; the pages/trains being
+ *  read are skipped. The file is written under a temporary name and
+ *  renamed, so a crash never leaves a partial file behind.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - fileName is NULL.
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ *    eFILEIOERR_EDUBFM - The file cannot be written.
+ *    some errors caused by function calls
+ *
+ * 설명:
+ *  bufferPool에 저장된 page/train들의 목록을 파일에 기록함
+ */
+Four EduBfM_SaveResidentSet(
+    char                *fileName)              /* IN name of the file */
+{
+    Four                e;                      /* error code */
+    Four                i, p, type;             /* indexes */
+    Four                capacity = 0;           /* max. # of entries */
+    Four                nRef = 0, nOther = 0;   /* # of the entries of the pages/trains referenced or not */
+    BufferPartition     *part;                  /* a partition */
+    ResidentSetHeader   header;                 /* header of the file */
+    ResidentSetEntry    *entries, *entry;       /* entries of the file */
+    char                *tmpName;               /* temporary name of the file */
+    FILE                *fp;                    /* the file */
+    Boolean             ok;                     /* TRUE if the file is written */
+
+
+    if (fileName == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    // Resizable buffer pool은 최대 크기만큼 entry를 저장할 공간을 할당함
+    for (type = 0; type < NUM_BUF_TYPES; type++) capacity += MAX(BI_NBUFS(type), edubfm_cfgParams.maxBufs[type]);
+
+    entries = (ResidentSetEntry *)malloc(sizeof(ResidentSetEntry) * MAX(capacity, 1));
+    tmpName = (char *)malloc(strlen(fileName) + 5);
+    if (entries == NULL || tmpName == NULL) {
+        free(entries);
+        free(tmpName);
+        ERR(eMEMALLOCERR_EDUBFM);
+    }
+
+    // 각 partition의 latch를 획득한 후, 참조된 page/train은 앞에서부터, 나머지는 뒤에서부터 저장함
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        for (p = 0; p < PI_NLOOP(type); p++) {
+            part = PI_PART(type, p);
+
+            e = edubfm_LatchPartition(part);
+            if (e < 0) {
+                free(entries);
+                free(tmpName);
+                ERR(e);
+            }
+
+            for (i = part->firstBuf; i < part->firstBuf + part->nBufs && nRef + nOther < capacity; i++) {
+                if (IS_NILBFMHASHKEY(BI_KEY(type, i)) || (BI_BITS(type, i) & READING)) continue;
+
+                entry = (BI_BITS(type, i) & REFER) ? &entries[nRef++] : &entries[capacity - ++nOther];
+                entry->pageNo = BI_KEY(type, i).pageNo;
+                entry->volNo = BI_KEY(type, i).volNo;
+                entry->type = type;
+            }
+
+            e = edubfm_UnlatchPartition(part);
+            if (e < 0) {
+                free(entries);
+                free(tmpName);
+                ERR(e);
+            }
+        }
+    }
+
+    memmove(&entries[nRef], &entries[capacity - nOther], sizeof(ResidentSetEntry) * nOther);
+
+    memcpy(header.magic, RESIDENTSET_MAGIC, sizeof(header.magic));
+    header.version = RESIDENTSET_VERSION;
+    header.pageSize = PAGESIZE;
+    header.nEntries = nRef + nOther;
+
+    // 임시 파일에 기록한 후 이름을 바꿈
+    sprintf(tmpName, "%s.tmp", fileName);
+
+    fp = fopen(tmpName, "wb");
+    ok = (fp != NULL);
+    if (ok) {
+        ok = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+             fwrite(entries, sizeof(ResidentSetEntry), header.nEntries, fp) == header.nEntries &&
+             fflush(fp) == 0 && fsync(fileno(fp)) == 0;
+        ok = (fclose(fp) == 0) && ok;
+    }
+    ok = ok && rename(tmpName, fileName) == 0;
+    if (!ok) unlink(tmpName);
+
+    free(entries);
+    free(tmpName);
+
+    if (!ok) ERR(eFILEIOERR_EDUBFM);
+
+    return(eNOERROR);
+
+}  /* EduBfM_SaveResidentSet() */
+
+
+
+/*@================================
+ * EduBfM_LoadResidentSet()
+ *================================*/
+/*
+ * Function: Four EduBfM_LoadResidentSet(char *)
+ *
+ * Description :
+ *  Read the pages/trains listed in the given file, saved by
+ *  EduBfM_SaveResidentSet(), into the buffer pools, and return when all of
+ *  them have been read. Only as many entries as each buffer pool has
+ *  buffer elements in use (not the maximum of a resizable buffer pool) are
+ *  taken from the front of the file, and the pages/trains of the mapped
+ *  volumes are skipped. They are read in the order of (type, volNo,
+ *  pageNo), by the I/O threads in batches of READAHEAD_QUEUE_SIZE if they
+ *  are running, so that the reads overlap, and by the calling thread
+ *  otherwise (with READAHEAD_BATCH_SIZE reads in flight together if the
+ *  asynchronous I/O is running). They are loaded as read ahead (unfixed and PREFETCHED), and
+ *  the pages/trains which cannot be read (e.g. of a volume not mounted any
+ *  more) are skipped.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - fileName is NULL.
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ *    eFILEIOERR_EDUBFM - The file cannot be read, or is not a resident set file of this EduBfM.
+ *    some errors caused by function calls
+ *
+ * 설명:
+ *  파일에 기록된 page/train들을 정렬된 순서로 bufferPool에 다시 읽어 들임
+ */
+Four EduBfM_LoadResidentSet(
+    char                *fileName)              /* IN name of the file */
+{
+    Four                e;                      /* error code */
+    Four                i, n, k, type;          /* indexes */
+    Four                count[NUM_BUF_TYPES];   /* # of the entries taken for each buffer pool */
+    Four                limit[NUM_BUF_TYPES];   /* # of the buffer elements in use of each buffer pool */
+    Four                p;                      /* partition number */
+    Boolean             useThreads = TRUE;      /* TRUE while the I/O threads serve the reads */
+    ResidentSetHeader   header;                 /* header of the file */
+    ResidentSetEntry    *entries;               /* entries of the file */
+    TrainID             batch[READAHEAD_QUEUE_SIZE];    /* pages/trains queued together */
+    FILE                *fp;                    /* the file */
+
+
+    if (fileName == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    fp = fopen(fileName, "rb");
+    if (fp == NULL) ERR(eFILEIOERR_EDUBFM);
+
+    if (fread(&header, sizeof(header), 1, fp) != 1 ||
+        memcmp(header.magic, RESIDENTSET_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != RESIDENTSET_VERSION || header.pageSize != PAGESIZE || header.nEntries < 0) {
+        fclose(fp);
+        ERR(eFILEIOERR_EDUBFM);
+    }
+
+    entries = (ResidentSetEntry *)malloc(sizeof(ResidentSetEntry) * MAX(header.nEntries, 1));
+    if (entries == NULL) {
+        fclose(fp);
+        ERR(eMEMALLOCERR_EDUBFM);
+    }
+
+    if (fread(entries, sizeof(ResidentSetEntry), header.nEntries, fp) != header.nEntries) {
+        free(entries);
+        fclose(fp);
+        ERR(eFILEIOERR_EDUBFM);
+    }
+    fclose(fp);
+
+    // 각 bufferPool이 사용 중인 buffer element 수만큼만 앞에서부터 선택함
+    // (resizable bufferPool의 BI_NBUFS(type)는 예약된 최대 크기이므로, 각 partition의 nBufs를 더함)
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        count[type] = 0;
+        for (limit[type] = 0, p = 0; p < PI_NLOOP(type); p++) limit[type] += PI_PART(type, p)->nBufs;
+    }
+
+    for (n = 0, i = 0; i < header.nEntries; i++) {
+        type = entries[i].type;
+        if (IS_BAD_BUFFERTYPE(type) || count[type] >= limit[type]) continue;
+        if (entries[i].pageNo < 0 || entries[i].volNo < 0 || IS_MAPPED_VOLUME(entries[i].volNo)) continue;
+
+        entries[n++] = entries[i];
+        count[type]++;
+    }
+
+    // Disk 상의 순서대로 읽도록 정렬함
+    qsort(entries, n, sizeof(ResidentSetEntry), edubfm_rs_Compare);
+
+    for (i = 0; i < n; ) {
+        type = entries[i].type;
+
+        // 같은 buffer type의 page/train들을 I/O thread들이 동시에 읽도록 요청하고, 모두 읽을 때까지 기다림
+        if (useThreads) {
+            for (k = 0; k < READAHEAD_QUEUE_SIZE && i + k < n && entries[i + k].type == type; k++) {
+                batch[k].pageNo = entries[i + k].pageNo;
+                batch[k].volNo = entries[i + k].volNo;
+            }
+
+            useThreads = edubfm_ReadAheadQueue(batch, k, type);
+            if (useThreads) {
+                edubfm_WaitReadAheadIdle();
+                i += k;
+                continue;
+            }
+        }
+
+        // I/O thread가 수행 중이 아니면 직접 읽음 (I/O thread와 같이, 읽지 못한 page/train은 건너뜀)
+        // (비동기 I/O를 사용하는 경우, 같은 buffer type의 page/train들을 한꺼번에 읽음)
+        for (k = 0; k < READAHEAD_BATCH_SIZE && i + k < n && entries[i + k].type == type; k++) {
+            batch[k].pageNo = entries[i + k].pageNo;
+            batch[k].volNo = entries[i + k].volNo;
+        }
+
+        e = edubfm_ReadFrames(batch, k, type);
+        if (e < 0) PRTERR(e);
+        i += k;
+    }
+
+    free(entries);
+
+    return(eNOERROR);
+
+}  /* EduBfM_LoadResidentSet() */
+
+
+
+/*
+ * Function: static int edubfm_rs_Compare(const void *, const void *)
+ *
+ * Description:
+ *  Compare two entries of a resident set file by (type, volNo, pageNo), for qsort().
+ *
+ * Returns:
+ *  negative, zero or positive as the first entry precedes, equals or follows the second
+ */
+static int edubfm_rs_Compare(
+    const void          *a,                     /* IN an entry */
+    const void          *b)                     /* IN another entry */
+{
+    const ResidentSetEntry *x = (const ResidentSetEntry *)a;
+    const ResidentSetEntry *y = (const ResidentSetEntry *)b;
+
+    if (x->type != y->type) return( x->type - y->type );
+    if (x->volNo != y->volNo) return( x->volNo - y->volNo );
+    return( (x->pageNo > y->pageNo) - (x->pageNo < y->pageNo) );
+
+}  /* edubfm_rs_Compare */
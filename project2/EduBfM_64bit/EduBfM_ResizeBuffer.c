@@ -0,0 +1,187 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_ResizeBuffer.c
+ *
+ * Description :
+ *  Grow or shrink a buffer pool while it is used.
+ *
+ * Exports:
+ *  Four EduBfM_ResizeBuffer(Four, Four, Four *)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+/* internal function prototypes */
+static Four edubfm_ResizePartition(Four, BufferPartition *, Four);
+
+
+
+/*@================================
+ * EduBfM_ResizeBuffer()
+ *================================*/
+/*
+ * Function: Four EduBfM_ResizeBuffer(Four, Four, Four *)
+ *
+ * Description :
+ *  Change the number of buffer elements of the buffer pool to 'nBufs',
+ *  which are divided evenly among its partitions. The buffer pool must be
+ *  made resizable by edubfm_cfgParams.maxBufs[type] (see EduBfM_Init()).
+ *  The partitions are resized one at a time while holding only their own
+ *  latches, so the others keep being used meanwhile.
+ *  Each partition uses a prefix of the buffer elements reserved for it,
+ *  and the hash value of a page/train does not depend on the number of
+ *  buffer elements in use, so no page/train is moved or rehashed: the
+ *  pages/trains remaining in the buffer pool, fixed or not, stay where
+ *  they are.
+ *  When a partition grows, its reserved buffer elements are simply put to
+ *  use. When it shrinks, the pages/trains of the buffer elements taken
+ *  away are removed from the last one, writing the dirty ones to disk,
+ *  and the memory of the buffer elements is returned to the operating
+ *  system. A fixed page/train is never removed; the partition then stops
+ *  shrinking right after its buffer element, so the resulting size may
+ *  be larger than 'nBufs'.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFERTYPE_BFM - Invalid Buffer type
+ *    eBADPARAMETER_EDUBFM - The buffer pool is not resizable, 'nBufs' is
+ *                           out of range, or 'resized' is NULL.
+ *    some errors caused by function calls
+ *
+ * 설명:
+ *  bufferPool의 각 partition이 사용하는 buffer element의 수를 바꾸어, 실행 중에 bufferPool의 크기를 바꿈
+ *
+ * 관련 함수:
+ *  1. edubfm_EvictTrain() - buffer element에 저장된 page/train을 제거함
+ *  2. edubfm_ReleaseBuffers() - buffer element들의 memory를 운영체제에 반환함
+ */
+Four EduBfM_ResizeBuffer(
+    Four                type,                   /* IN buffer type */
+    Four                nBufs,                  /* IN # of buffer elements requested */
+    Four                *resized)               /* OUT # of buffer elements after resizing */
+{
+    Four                n;                      /* # of buffer elements of a partition */
+    Four                p;                      /* partition number */
+    Four                nParts;                 /* # of partitions */
+
+
+    /* Is the buffer type valid? */
+    if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
+
+    if (resized == NULL || !PI_RESIZABLE(type)) ERR(eBADPARAMETER_EDUBFM);
+
+    // 각 partition은 최소 한 개, 최대 예약된 수의 buffer element를 가짐
+    nParts = PI_NPARTS(type);
+    if (nBufs < nParts || nBufs > nParts * PI_PART(type, 0)->maxBufs) ERR(eBADPARAMETER_EDUBFM);
+
+    *resized = 0;
+
+    for (p = 0; p < nParts; p++) {
+        n = ((p + 1) * nBufs) / nParts - (p * nBufs) / nParts;
+
+        n = edubfm_ResizePartition(type, PI_PART(type, p), n);
+        if (n < 0) ERR(n);
+
+        *resized += n;
+    }
+
+    return(eNOERROR);
+
+}  /* EduBfM_ResizeBuffer() */
+
+
+
+/*@================================
+ * edubfm_ResizePartition()
+ *================================*/
+/*
+ * Function: static Four edubfm_ResizePartition(Four, BufferPartition *, Four)
+ *
+ * Description :
+ *  Change the number of buffer elements in use of the partition to 'nBufs',
+ *  or as close to it as the fixed pages/trains allow.
+ *
+ * Returns:
+ *  1) # of buffer elements of the partition after resizing
+ *  2) Error codes: Negative value means error code.
+ *     some errors caused by function calls
+ */
+static Four edubfm_ResizePartition(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part,                  /* INOUT partition */
+    Four                nBufs)                  /* IN # of buffer elements requested */
+{
+    Four                e;                      /* error */
+    Four                n;                      /* # of buffer elements kept */
+    Four                i;                      /* index of a buffer element */
+
+
+    e = edubfm_LatchPartition(part);
+    if (e < 0) ERR(e);
+
+    // 늘리는 경우: 예약된 buffer element들은 비어 있으므로, 사용하는 범위만 넓히고 replacement policy에 알림
+    if (nBufs >= part->nBufs) {
+        n = part->nBufs;
+        part->nBufs = (Two)nBufs;
+
+        for (i = part->firstBuf + n; i < part->firstBuf + nBufs; i++) PI_POLICY(type)->evict(type, part, i);
+    }
+    else {
+        // 줄이는 경우: 마지막 buffer element부터 page/train을 제거함 (fix 된 page/train을 만나면 멈춤)
+        for (n = part->nBufs; n > nBufs; n--) {
+            i = part->firstBuf + n - 1;
+            if (BI_FIXED(type, i) > 0) break;
+
+            // Replacement policy가 해당 buffer element를 잊도록 하고, 수정된 page/train은 disk에 기록한 후 제거함
+            PI_POLICY(type)->evict(type, part, i);
+
+            e = edubfm_EvictTrain(type, part, i);
+            if (e == eFRAMEPINNED_EDUBFM) break;
+            if (e < 0) {
+                part->nBufs = (Two)n;
+                edubfm_UnlatchPartition(part);
+                ERR(e);
+            }
+        }
+
+        edubfm_ReleaseBuffers(type, part->firstBuf + n, part->nBufs - n);
+
+        part->nBufs = (Two)n;
+        if (part->nextVictim >= part->nBufs) part->nextVictim = 0;
+    }
+
+    n = part->nBufs;
+
+    e = edubfm_UnlatchPartition(part);
+    if (e < 0) ERR(e);
+
+    return(n);
+
+}  /* edubfm_ResizePartition() */
@@ -30,6 +30,7 @@
  * 
  * Exports:
  *  Four EduBfM_SetDirty(TrainID*, Four)
+ *  Four EduBfM_SetDirtyFrame(BfMFrameHandle*)
  *
  * Notes:
  *  This function should be called if the user modify the buffer.
@@ -37,6 +38,7 @@
 
 
 #include "EduBfM_common.h"
+#include "EduBfM.h"
 #include "EduBfM_Internal.h"
 
 
@@ -53,11 +55,15 @@
  *
  *  Set the dirty bit of an entry in the buffer table.
  *  Look up the entry in the using given parameters and set the dirty
- *  bit of the entry.
+ *  bit of the entry, under one acquisition of the latch of its partition.
+ *  A train of a mapped volume, or of a buffer pool whose trains are fixed
+ *  without the latch, is looked up by edubfm_FindFrame() and marked by
+ *  EduBfM_SetDirtyFrame() instead.
  * 
  * Returns:
  *  error code
  *    eBADBUFFERTYPE_BFM - bad buffer type
+ *    eBADHASHKEY_BFM - The train isn't in the buffer pool.
  *    some errors caused by function calls
  * 
  * 설명 :
@@ -65,28 +71,102 @@
  * 
  * 관련 함수 :
  *  1. edubfm_LookUp()
+ *  2. edubfm_FindFrame()
+ *  3. EduBfM_SetDirtyFrame()
  */
 Four EduBfM_SetDirty(
     TrainID             *trainId,               /* IN which train has been modified in the buffer?  */
     Four                type )                  /* IN buffer type */
 {
-    Four                index;                  /* an index of the buffer table & pool */
+    Four                e;                      /* error code */
+    Four                index;                  /* index on buffer holding the train */
+    BufferPartition     *part;                  /* partition of the train */
+    BfMFrameHandle      handle;                 /* handle of the buffer holding the train */
 
     /*@ Is the paramter valid? */
     if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
 
-    // 수정된 page/train의 hash key value를 이용하여, 
-    // 해당 해당 page/train이 저장된 buffer element의 array index를 hashTable에서 검색함
+    // Mapping 된 volume이나 latch 없이 fix 하는 bufferPool의 page/train은 handle을 구하여 표시함
+    if (IS_MAPPED_VOLUME(trainId->volNo) || PI_OPTIMISTIC(type)) {
+        e = edubfm_FindFrame(trainId, type, &handle);
+        if (e < 0) ERR(e);
+
+        e = EduBfM_SetDirtyFrame(&handle);
+        if (e < 0) ERR(e);
+
+        return( eNOERROR );
+    }
+
+    BFM_TRACE(BFM_TRACE_SETDIRTY, trainId, type);
+
+    // 한 번 획득한 latch 아래에서, 수정된 page/train이 저장된 buffer element를 hashTable에서 검색하여 DIRTY bit를 set 함
+    part = edubfm_GetPartition((BfMHashKey *)trainId, type);
+    e = edubfm_LatchPartition(part);
+    if (e < 0) ERR(e);
+
     index = edubfm_LookUp((BfMHashKey *)trainId, type);
+    if (index < 0) ERR_UNLATCH(eBADHASHKEY_BFM, part);
+
+    BI_BITS(type, index) |= DIRTY;
+
+    e = edubfm_UnlatchPartition(part);
+    if (e < 0) ERR(e);
+
+    return( eNOERROR );
+
+}  /* EduBfM_SetDirty */
+
+
+
+/*@================================
+ * EduBfM_SetDirtyFrame()
+ *================================*/
+/*
+ * Function: Four EduBfM_SetDirtyFrame(BfMFrameHandle*)
+ *
+ * Description: 
+ *  Set the dirty bit of the buffer given by the handle which
+ *  EduBfM_GetFrame() returned, without looking it up.
+ * 
+ * Returns:
+ *  error code
+ *    eBADBUFFER_BFM - bad handle
+ *    eBADBUFINDEX_BFM - bad index in the handle
+ *    eBADHASHKEY_BFM - The buffer doesn't hold the train of the handle.
+ *    some errors caused by function calls
+ * 
+ * 설명 :
+ *  Handle이 가리키는 buffer element의 DIRTY bit를 1로 set함
+ */
+Four EduBfM_SetDirtyFrame(
+    BfMFrameHandle      *handle)                /* IN handle of the modified buffer */
+{
+    Four                e;                      /* error code */
+    BufferPartition     *part;                  /* partition of the train */
+
+    // Mapping 된 volume의 page/train인 경우, 수정된 page들을 표시함
+    if (handle != NULL && handle->index == BFM_MAPPED_FRAME && !IS_BAD_BUFFERTYPE(handle->type))
+        return( edubfm_SetDirtyMappedFrame(handle) );
+
+    /*@ Is the paramter valid? */
+    CHECK_FRAMEHANDLE(handle);
+    BFM_TRACE(BFM_TRACE_SETDIRTY, &handle->trainId, handle->type);
+
+    part = edubfm_GetPartition((BfMHashKey *)&handle->trainId, handle->type);
+    e = edubfm_LatchPartition(part);
+    if (e < 0) ERR(e);
 
     // 해당 buffer element에 대한 DIRTY bit를 1로 set함
-    if (index == NOTFOUND_IN_HTABLE) {
-        ERR(eBADHASHKEY_BFM);
+    if (!EQUALKEY(&BI_KEY(handle->type, handle->index), &handle->trainId)) {
+        ERR_UNLATCH(eBADHASHKEY_BFM, part);
     }
     else {
-        BI_BITS(type, index) |= DIRTY;
+        BI_BITS(handle->type, handle->index) |= DIRTY;
     }
 
+    e = edubfm_UnlatchPartition(part);
+    if (e < 0) ERR(e);
+
     return( eNOERROR );
 
-}  /* EduBfM_SetDirty */
+}  /* EduBfM_SetDirtyFrame */
@@ -0,0 +1,72 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_SetThreadNode.c
+ *
+ * Description :
+ *  Set the NUMA node of the calling thread, so that the fixes from another
+ *  node than the partition of the page/train are counted on any machine.
+ *
+ * Exports:
+ *  Four EduBfM_SetThreadNode(Four)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_SetThreadNode()
+ *================================*/
+/*
+ * Function: Four EduBfM_SetThreadNode(Four)
+ *
+ * Description :
+ *  Declare that the calling thread runs on the given NUMA node of the ones
+ *  the partitions are spread over (edubfm_cfgParams.numaNodes), which may
+ *  be simulated; NIL makes it follow the node of the CPU it runs on again.
+ *  The node only decides which fixes of the thread are counted in
+ *  EduBfM_Stats.nRemoteFixes; the thread is not moved to the node.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - node is not one of the NUMA nodes.
+ *
+ * 설명:
+ *  호출한 thread가 속한 NUMA node를 지정함
+ */
+Four EduBfM_SetThreadNode(
+    Four                node)                   /* IN NUMA node (NIL : the node of the CPU) */
+{
+    if (node != NIL && (node < 0 || node >= edubfm_nNumaNodes)) ERR(eBADPARAMETER_EDUBFM);
+
+    edubfm_threadNode = node;
+
+    return(eNOERROR);
+
+}  /* EduBfM_SetThreadNode() */
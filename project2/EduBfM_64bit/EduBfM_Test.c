@@ -33,6 +33,7 @@
  */
 
 #include <string.h>
+#include <unistd.h>
 #include "EduBfM_common.h"
 #include "EduBfM.h"
 #include "EduBfM_Internal.h"
@@ -42,6 +43,11 @@
 
 void edubfm_dump_buffertable(Four);
 void edubfm_dump_hashtable(Four);
+Four edubfm_count_dirty(Four);
+Four edubfm_stamp_pages(PageID *, Four, Four);
+Four edubfm_check_pages(PageID *, Four, Four);
+
+extern CfgParams_T sm_cfgParams;
 
 
 /*@================================
@@ -59,6 +65,15 @@ void edubfm_dump_hashtable(Four);
  *  EduBfM_Test() test these below operations in EduBfM.
  *  EduBfM_GetTrain(), EduBfM_FreeTrain(), EduBfM_SetDirty(),
  *  EduBfM_FlushAll(), EduBfM_DiscardAll().
+ *  It also tests the handles of the fixed buffers returned by
+ *  EduBfM_GetFrame() and used by EduBfM_FreeFrame() and EduBfM_SetDirtyFrame(),
+ *  EduBfM_ResizeBuffer() growing and shrinking the buffer, the list of the
+ *  pages in the buffer saved and loaded again after a restart,
+ *  EduBfM_Checkpoint() and the checkpointer leaving no page dirty, and
+ *  the pages written and read again under each replacement policy, with
+ *  the open addressing page table, after a bulk flush, with the
+ *  optimistic fix, in place in a volume mapped into memory, and by the
+ *  asynchronous I/O of io_uring and of a pool of threads.
  *
  *
  * Returns:
@@ -75,6 +90,20 @@ Four EduBfM_Test(Four volId)
 	Page 			*apage;					/* pointer to buffer holding a page */
     PageID  		pageID[3*NUM_PAGE_BUFS];/* PageID of new page to be allocated */
 	PageID  		nearPid;  	  			/* near pageID */
+	BfMFrameHandle	handles[NUM_PAGE_BUFS];	/* handles of the buffers holding fixed pages */
+	Four			resized;				/* # of buffers after resizing */
+	Four			nCheckpoints;			/* # of checkpoints completed before pages are dirtied */
+	EduBfM_CheckpointStats	ckptStats;		/* progress of the checkpoints */
+	EduBfM_WriterStats	writerStats;		/* counters of the evictions and the writes */
+	UFour			nEvictions;				/* # of evictions before the resident set is loaded */
+	Four			policy;					/* replacement policy */
+	Boolean			useBulkFlush;			/* sm_cfgParams.useBulkFlush before the bulk flush */
+#ifdef EDUBFM_STATS
+	EduBfM_Stats	stats;					/* statistics of the buffer */
+#endif
+	EduBfM_AsyncIOStats	aioStats;			/* counters of the asynchronous I/O */
+	static char		*aioNames[2] = { "io_uring", "a pool of threads" };
+	static char		*policyNames[NUM_BFM_POLICIES] = { "CLOCK", "LRU-K", "2Q", "ARC" };
 
 	printf("\nLoading EduBfM_Test() complete...\n");
 	
@@ -364,6 +393,730 @@ Four EduBfM_Test(Four volId)
 	printf("\n\n");
 	printf("****************************** TEST#3, EduBfM_FlushAll and EduBfM_DiscardAll. ******************************\n");
 	/* #3 End test */
+	printf("\n\n");
+
+
+	/* #4 Start test for EduBfM_GetFrame, EduBfM_FreeFrame and EduBfM_SetDirtyFrame */
+	printf("****************************** TEST#4, EduBfM_GetFrame, EduBfM_FreeFrame and EduBfM_SetDirtyFrame. ******************************\n");
+
+	/* Test for EduBfM_GetFrame() and EduBfM_SetDirtyFrame() */
+	printf("*Test 4_1 : Test for EduBfM_GetFrame() and EduBfM_SetDirtyFrame()\n");
+	printf("->Fix five pages using handles and set dirty bit for two of them using the handles\n\n");
+	for (i = 0; i < NUM_PAGE_BUFS / 2; i++)
+	{
+		e = EduBfM_GetFrame(&pageID[i], (char **)&apage, PAGE_BUF, &handles[i]);
+		if (e < eNOERROR) ERR(e);
+		printf("pageNo %d is fixed in buffer %d using GetFrame()\n", pageID[i].pageNo, handles[i].index);
+
+		if (i % 2 == 1) {
+			apage->header.flags = i+1;
+			e = EduBfM_SetDirtyFrame(&handles[i]);
+			if (e < eNOERROR) ERR(e);
+			printf("The header flags value of pageNo %d is setted \"%d\" and its dirty bit is setted using SetDirtyFrame()\n", pageID[i].pageNo, apage->header.flags);
+		}
+	}
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n---------------------------------- Result ----------------------------------\n");
+	edubfm_dump_buffertable(PAGE_BUF);
+	printf("\t(Buffer Table)\n");
+	printf("\n");
+	edubfm_dump_hashtable(PAGE_BUF);
+	printf("\t(Hash Table)\n");
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	/* Test for EduBfM_FreeFrame() */
+	printf("*Test 4_2 : Test for EduBfM_FreeFrame()\n");
+	printf("->Free the five pages using their handles\n\n");
+	for (i = 0; i < NUM_PAGE_BUFS / 2; i++)
+	{
+		e = EduBfM_FreeFrame(&handles[i]);
+		if (e < eNOERROR) ERR(e);
+		printf("pageNo %d is freed from buffer using FreeFrame()\n", pageID[i].pageNo);
+	}
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n---------------------------------- Result ----------------------------------\n");
+	edubfm_dump_buffertable(PAGE_BUF);
+	printf("\t(Buffer Table)\n");
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	/* Test for the handles of the pages which are not in the buffer any more */
+	printf("*Test 4_3 : Test for the handles of the pages which are not in the buffer any more\n");
+	printf("->Flush and discard all pages, read two pages again and use the stale handle of the first page\n");
+	printf("\n---------------------------------- Result ----------------------------------\n");
+	e = EduBfM_FlushAll();
+	if (e < eNOERROR) ERR(e);
+	e = EduBfM_DiscardAll();
+	if (e < eNOERROR) ERR(e);
+
+	// 다시 읽어 들인 page들이 첫 번째 page의 buffer element를 사용하더라도, stale handle은 거부되어야 함
+	for (i = 1; i < NUM_PAGE_BUFS / 2; i = i + 2)
+	{
+		e = EduBfM_GetTrain(&pageID[i], (char **)&apage, PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+		printf("The header flags value of flushed pageNo %d is %d\n", pageID[i].pageNo, apage->header.flags);
+		e = EduBfM_FreeTrain(&pageID[i], PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	e = EduBfM_FreeFrame(&handles[0]);
+	if (e != eBADHASHKEY_BFM) ERR((e < eNOERROR) ? e : eBADPARAMETER_EDUBFM);
+	printf("FreeFrame() with the stale handle of pageNo %d returns eBADHASHKEY_BFM\n", pageID[0].pageNo);
+
+	e = EduBfM_SetDirtyFrame(&handles[0]);
+	if (e != eBADHASHKEY_BFM) ERR((e < eNOERROR) ? e : eBADPARAMETER_EDUBFM);
+	printf("SetDirtyFrame() with the stale handle of pageNo %d returns eBADHASHKEY_BFM\n", pageID[0].pageNo);
+
+	edubfm_dump_buffertable(PAGE_BUF);
+	printf("\t(Buffer Table)\n");
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+	printf("****************************** TEST#4, EduBfM_GetFrame, EduBfM_FreeFrame and EduBfM_SetDirtyFrame. ******************************\n");
+	/* #4 End test */
+	printf("\n\n");
+
+
+	/* #5 Start test for EduBfM_ResizeBuffer */
+	printf("****************************** TEST#5, EduBfM_ResizeBuffer. ******************************\n");
+	// bufferPool을 두 배까지 늘릴 수 있도록 EduBfM을 다시 초기화함
+	edubfm_cfgParams.maxBufs[PAGE_BUF] = 2 * NUM_PAGE_BUFS;
+	e = EduBfM_Init();
+	if (e < eNOERROR) ERR(e);
+
+	/* Test for EduBfM_ResizeBuffer() when the buffer grows */
+	printf("*Test 5_1 : Test for EduBfM_ResizeBuffer() when the buffer grows\n");
+	printf("->Grow the buffer to twice its size and insert fifteen new pages into it\n\n");
+	e = EduBfM_ResizeBuffer(PAGE_BUF, 2 * NUM_PAGE_BUFS, &resized);
+	if (e < eNOERROR) ERR(e);
+	printf("The buffer is resized to %d buffers using ResizeBuffer()\n", resized);
+
+	// 늘어난 buffer element들이 사용되지 않으면 모두 fix 할 수 없음
+	for (i = 0; i < PAGE_BUFS_RESIZE; i++)
+	{
+		e = EduBfM_GetTrain(&pageID[i], (char **)&apage, PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+		printf("pageNo %d is inserted into buffer using GetTrain()\n", pageID[i].pageNo);
+	}
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n---------------------------------- Result ----------------------------------\n");
+	edubfm_dump_buffertable(PAGE_BUF);
+	printf("\t(Buffer Table)\n");
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	/* Test for EduBfM_ResizeBuffer() when the buffer shrinks while a page is fixed */
+	printf("*Test 5_2 : Test for EduBfM_ResizeBuffer() when the buffer shrinks while a page is fixed\n");
+	printf("->Free all pages but the last one and shrink the buffer to a quarter of its size\n\n");
+	for (i = 0; i < PAGE_BUFS_RESIZE - 1; i++)
+	{
+		e = EduBfM_FreeTrain(&pageID[i], PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+	}
+	index = edubfm_LookUp((BfMHashKey *)&pageID[PAGE_BUFS_RESIZE - 1], PAGE_BUF);
+	printf("pageNo %d in buffer %d is still fixed\n", pageID[PAGE_BUFS_RESIZE - 1].pageNo, index);
+
+	// Fix 된 page가 있는 buffer element 뒤에서 줄이기를 멈추어야 함
+	e = EduBfM_ResizeBuffer(PAGE_BUF, NUM_PAGE_BUFS / 2, &resized);
+	if (e < eNOERROR) ERR(e);
+	printf("The buffer is resized to %d buffers using ResizeBuffer()\n", resized);
+	if (resized != index + 1) ERR(eBADPARAMETER_EDUBFM);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	/* Test for EduBfM_ResizeBuffer() when the buffer shrinks after the page is freed */
+	printf("*Test 5_3 : Test for EduBfM_ResizeBuffer() when the buffer shrinks after the page is freed\n");
+	printf("->Free the last page, shrink the buffer to a quarter of its size and grow it back to its original size\n\n");
+	e = EduBfM_FreeTrain(&pageID[PAGE_BUFS_RESIZE - 1], PAGE_BUF);
+	if (e < eNOERROR) ERR(e);
+	printf("pageNo %d is freed from buffer using FreeTrain()\n", pageID[PAGE_BUFS_RESIZE - 1].pageNo);
+
+	e = EduBfM_ResizeBuffer(PAGE_BUF, NUM_PAGE_BUFS / 2, &resized);
+	if (e < eNOERROR) ERR(e);
+	printf("The buffer is resized to %d buffers using ResizeBuffer()\n", resized);
+	if (resized != NUM_PAGE_BUFS / 2) ERR(eBADPARAMETER_EDUBFM);
+
+	e = EduBfM_ResizeBuffer(PAGE_BUF, NUM_PAGE_BUFS, &resized);
+	if (e < eNOERROR) ERR(e);
+	printf("The buffer is resized to %d buffers using ResizeBuffer()\n", resized);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n---------------------------------- Result ----------------------------------\n");
+	edubfm_dump_buffertable(PAGE_BUF);
+	printf("\t(Buffer Table)\n");
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	// 원래 크기의 bufferPool을 저장 시스템에 돌려줌
+	e = EduBfM_Final();
+	if (e < eNOERROR) ERR(e);
+	edubfm_cfgParams.maxBufs[PAGE_BUF] = 0;
+
+	printf("****************************** TEST#5, EduBfM_ResizeBuffer. ******************************\n");
+	/* #5 End test */
+	printf("\n\n");
+
+
+	/* #6 Start test for EduBfM_SaveResidentSet and EduBfM_LoadResidentSet */
+	printf("****************************** TEST#6, EduBfM_SaveResidentSet and EduBfM_LoadResidentSet. ******************************\n");
+	remove(RESIDENT_SET_FILE);
+
+	/* Test for EduBfM_SaveResidentSet() and EduBfM_LoadResidentSet() */
+	printf("*Test 6_1 : Test for EduBfM_SaveResidentSet() and EduBfM_LoadResidentSet()\n");
+	printf("->Insert five pages, save the list of them, discard all pages and load the list\n\n");
+	for (i = 2 * NUM_PAGE_BUFS; i < 2 * NUM_PAGE_BUFS + 5; i++)
+	{
+		e = EduBfM_GetTrain(&pageID[i], (char **)&apage, PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+		e = EduBfM_FreeTrain(&pageID[i], PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+		printf("pageNo %d is inserted into buffer using GetTrain()\n", pageID[i].pageNo);
+	}
+
+	e = EduBfM_SaveResidentSet(RESIDENT_SET_FILE);
+	if (e < eNOERROR) ERR(e);
+	printf("The list of the pages in buffer is saved using SaveResidentSet()\n");
+
+	e = EduBfM_FlushAll();
+	if (e < eNOERROR) ERR(e);
+	e = EduBfM_DiscardAll();
+	if (e < eNOERROR) ERR(e);
+	printf("All pages are discarded using DiscardAll()\n");
+
+	e = EduBfM_LoadResidentSet(RESIDENT_SET_FILE);
+	if (e < eNOERROR) ERR(e);
+	printf("The list of the pages is loaded using LoadResidentSet()\n");
+
+	for (i = 2 * NUM_PAGE_BUFS; i < 2 * NUM_PAGE_BUFS + 5; i++)
+	{
+		index = edubfm_LookUp((BfMHashKey *)&pageID[i], PAGE_BUF);
+		if (index == NOTFOUND_IN_HTABLE) ERR(eBADHASHKEY_BFM);
+		printf("pageNo %d is in buffer %d again\n", pageID[i].pageNo, index);
+	}
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n---------------------------------- Result ----------------------------------\n");
+	edubfm_dump_buffertable(PAGE_BUF);
+	printf("\t(Buffer Table)\n");
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	/* Test for the resident set saved by EduBfM_Final() and loaded by EduBfM_Init() */
+	printf("*Test 6_2 : Test for the resident set saved by EduBfM_Final() and loaded by EduBfM_Init()\n");
+	printf("->Restart EduBfM with a resident set file, insert five other pages, and restart it again\n\n");
+	e = EduBfM_FlushAll();
+	if (e < eNOERROR) ERR(e);
+	e = EduBfM_DiscardAll();
+	if (e < eNOERROR) ERR(e);
+	remove(RESIDENT_SET_FILE);
+
+	// 파일이 없으므로 빈 bufferPool로 시작하고, EduBfM_Final()이 그 목록을 기록함
+	edubfm_cfgParams.residentSetFile = RESIDENT_SET_FILE;
+	e = EduBfM_Init();
+	if (e < eNOERROR) ERR(e);
+
+	for (i = 2 * NUM_PAGE_BUFS + 5; i < 3 * NUM_PAGE_BUFS; i++)
+	{
+		e = EduBfM_GetTrain(&pageID[i], (char **)&apage, PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+		e = EduBfM_FreeTrain(&pageID[i], PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+		printf("pageNo %d is inserted into buffer using GetTrain()\n", pageID[i].pageNo);
+	}
+
+	e = EduBfM_Final();
+	if (e < eNOERROR) ERR(e);
+	e = EduBfM_FlushAll();
+	if (e < eNOERROR) ERR(e);
+	e = EduBfM_DiscardAll();
+	if (e < eNOERROR) ERR(e);
+	printf("EduBfM is finalized and all pages are discarded\n");
+
+	e = EduBfM_Init();
+	if (e < eNOERROR) ERR(e);
+	printf("EduBfM is initialized again\n");
+
+	for (i = 2 * NUM_PAGE_BUFS + 5; i < 3 * NUM_PAGE_BUFS; i++)
+	{
+		index = edubfm_LookUp((BfMHashKey *)&pageID[i], PAGE_BUF);
+		if (index == NOTFOUND_IN_HTABLE) ERR(eBADHASHKEY_BFM);
+		printf("pageNo %d is in buffer %d again\n", pageID[i].pageNo, index);
+	}
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n---------------------------------- Result ----------------------------------\n");
+	edubfm_dump_buffertable(PAGE_BUF);
+	printf("\t(Buffer Table)\n");
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	e = EduBfM_Final();
+	if (e < eNOERROR) ERR(e);
+	edubfm_cfgParams.residentSetFile = NULL;
+	remove(RESIDENT_SET_FILE);
+
+	/* Test for EduBfM_LoadResidentSet() when the buffer is shrunk */
+	printf("*Test 6_3 : Test for EduBfM_LoadResidentSet() when the buffer is shrunk\n");
+	printf("->Save the list of ten pages, shrink the buffer to half its size and load the list by an I/O thread\n\n");
+	e = EduBfM_FlushAll();
+	if (e < eNOERROR) ERR(e);
+	e = EduBfM_DiscardAll();
+	if (e < eNOERROR) ERR(e);
+
+	// I/O thread는 page를 하나씩 읽으므로, 사용 중인 buffer element보다 많이 읽으면 서로를 교체하게 됨
+	edubfm_cfgParams.maxBufs[PAGE_BUF] = 2 * NUM_PAGE_BUFS;
+	edubfm_cfgParams.nIOThreads = 1;
+	e = EduBfM_Init();
+	if (e < eNOERROR) ERR(e);
+
+	for (i = 0; i < NUM_PAGE_BUFS; i++)
+	{
+		e = EduBfM_GetTrain(&pageID[i], (char **)&apage, PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+		e = EduBfM_FreeTrain(&pageID[i], PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+	}
+	e = EduBfM_SaveResidentSet(RESIDENT_SET_FILE);
+	if (e < eNOERROR) ERR(e);
+	printf("The list of %d pages in buffer is saved using SaveResidentSet()\n", NUM_PAGE_BUFS);
+
+	e = EduBfM_FlushAll();
+	if (e < eNOERROR) ERR(e);
+	e = EduBfM_DiscardAll();
+	if (e < eNOERROR) ERR(e);
+	e = EduBfM_ResizeBuffer(PAGE_BUF, NUM_PAGE_BUFS / 2, &resized);
+	if (e < eNOERROR) ERR(e);
+	printf("The buffer is resized to %d buffers using ResizeBuffer()\n", resized);
+
+	e = EduBfM_GetWriterStats(&writerStats);
+	if (e < eNOERROR) ERR(e);
+	nEvictions = writerStats.nEvictions;
+
+	e = EduBfM_LoadResidentSet(RESIDENT_SET_FILE);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduBfM_GetWriterStats(&writerStats);
+	if (e < eNOERROR) ERR(e);
+	for (j = 0, i = 0; i < NUM_PAGE_BUFS; i++)
+		if (edubfm_LookUp((BfMHashKey *)&pageID[i], PAGE_BUF) != NOTFOUND_IN_HTABLE) j++;
+	if (j != resized || writerStats.nEvictions != nEvictions) ERR(eBADPARAMETER_EDUBFM);
+	printf("%d pages are loaded using LoadResidentSet() and %d pages are replaced\n", j, writerStats.nEvictions - nEvictions);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n---------------------------------- Result ----------------------------------\n");
+	edubfm_dump_buffertable(PAGE_BUF);
+	printf("\t(Buffer Table)\n");
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	e = EduBfM_ResizeBuffer(PAGE_BUF, NUM_PAGE_BUFS, &resized);
+	if (e < eNOERROR) ERR(e);
+	e = EduBfM_Final();
+	if (e < eNOERROR) ERR(e);
+	edubfm_cfgParams.maxBufs[PAGE_BUF] = 0;
+	edubfm_cfgParams.nIOThreads = 0;
+	remove(RESIDENT_SET_FILE);
+
+	printf("****************************** TEST#6, EduBfM_SaveResidentSet and EduBfM_LoadResidentSet. ******************************\n");
+	/* #6 End test */
+	printf("\n\n");
+
+
+	/* #7 Start test for EduBfM_Checkpoint */
+	printf("****************************** TEST#7, EduBfM_Checkpoint. ******************************\n");
+
+	/* Test for EduBfM_Checkpoint() */
+	printf("*Test 7_1 : Test for EduBfM_Checkpoint()\n");
+	printf("->Set dirty bit for five pages and take a checkpoint spread over %d msec\n\n", CHECKPOINT_WINDOW);
+	for (i = 0; i < NUM_PAGE_BUFS / 2; i++)
+	{
+		e = EduBfM_GetTrain(&pageID[i], (char **)&apage, PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+		e = EduBfM_SetDirty(&pageID[i], PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+		e = EduBfM_FreeTrain(&pageID[i], PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+	}
+	printf("%d pages are dirty before the checkpoint\n", edubfm_count_dirty(PAGE_BUF));
+
+	e = EduBfM_Checkpoint(CHECKPOINT_WINDOW);
+	if (e < eNOERROR) ERR(e);
+	e = EduBfM_GetCheckpointStats(&ckptStats);
+	if (e < eNOERROR) ERR(e);
+	printf("The checkpoint found %d dirty pages and wrote %d of them\n", ckptStats.nToWrite, ckptStats.nWritten);
+
+	if (edubfm_count_dirty(PAGE_BUF) != 0) ERR(eBADPARAMETER_EDUBFM);
+	printf("%d pages are dirty after the checkpoint\n", edubfm_count_dirty(PAGE_BUF));
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n---------------------------------- Result ----------------------------------\n");
+	edubfm_dump_buffertable(PAGE_BUF);
+	printf("\t(Buffer Table)\n");
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	/* Test for the checkpoints taken by the checkpointer */
+	printf("*Test 7_2 : Test for the checkpoints taken by the checkpointer\n");
+	printf("->Start the checkpointer, set dirty bit for five other pages and wait until a checkpoint started after that completes\n\n");
+	edubfm_cfgParams.checkpointInterval = CHECKPOINT_WINDOW;
+	e = EduBfM_Init();
+	if (e < eNOERROR) ERR(e);
+
+	e = EduBfM_GetCheckpointStats(&ckptStats);
+	if (e < eNOERROR) ERR(e);
+	nCheckpoints = ckptStats.nCheckpoints;
+
+	for (i = NUM_PAGE_BUFS / 2; i < NUM_PAGE_BUFS; i++)
+	{
+		e = EduBfM_GetTrain(&pageID[i], (char **)&apage, PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+		e = EduBfM_SetDirty(&pageID[i], PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+		e = EduBfM_FreeTrain(&pageID[i], PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+	}
+	printf("%d pages are dirty before the checkpoints\n", edubfm_count_dirty(PAGE_BUF));
+
+	// 진행 중인 checkpoint는 위의 page들을 기록하지 않을 수 있으므로, 그 다음 checkpoint가 끝날 때까지 기다림
+	for (j = 0; ckptStats.nCheckpoints < nCheckpoints + 2; j++)
+	{
+		if (j == CHECKPOINT_MAX_WAIT * CHECKPOINT_WINDOW) ERR(eBADPARAMETER_EDUBFM);
+		usleep(1000);
+		e = EduBfM_GetCheckpointStats(&ckptStats);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	if (edubfm_count_dirty(PAGE_BUF) != 0) ERR(eBADPARAMETER_EDUBFM);
+	printf("%d pages are dirty after the checkpoints\n", edubfm_count_dirty(PAGE_BUF));
+
+	e = EduBfM_Final();
+	if (e < eNOERROR) ERR(e);
+	edubfm_cfgParams.checkpointInterval = 0;
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n---------------------------------- Result ----------------------------------\n");
+	edubfm_dump_buffertable(PAGE_BUF);
+	printf("\t(Buffer Table)\n");
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	printf("****************************** TEST#7, EduBfM_Checkpoint. ******************************\n");
+	/* #7 End test */
+	printf("\n\n");
+
+
+	/* #8 Start test for the replacement policies */
+	printf("****************************** TEST#8, Replacement policies. ******************************\n");
+
+	/* Test for the pages written and read again under each replacement policy */
+	printf("*Test 8_1 : Test for the pages written and read again under each replacement policy\n");
+	printf("->Under each policy, set dirty bit for twenty pages so that the first ten are replaced, and fix them all again\n\n");
+	// CLOCK을 마지막에 수행하여, 이후의 test들이 기본 policy로 돌아가도록 함
+	for (i = 1; i <= NUM_BFM_POLICIES; i++)
+	{
+		policy = i % NUM_BFM_POLICIES;
+		edubfm_cfgParams.replacementPolicy[PAGE_BUF] = policy;
+		e = EduBfM_Init();
+		if (e < eNOERROR) ERR(e);
+
+		e = edubfm_stamp_pages(pageID, 2 * NUM_PAGE_BUFS, 800 + 10 * policy);
+		if (e < eNOERROR) ERR(e);
+		e = edubfm_check_pages(pageID, 2 * NUM_PAGE_BUFS, 800 + 10 * policy);
+		if (e < eNOERROR) ERR(e);
+		if (e != 0) ERR(eBADPARAMETER_EDUBFM);
+		printf("%s : %d pages are written, replaced and read again with %d wrong pages\n", policyNames[policy], 2 * NUM_PAGE_BUFS, e);
+
+		if (policy != BFM_CLOCK) {
+			e = EduBfM_Final();
+			if (e < eNOERROR) ERR(e);
+		}
+	}
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n---------------------------------- Result ----------------------------------\n");
+	edubfm_dump_buffertable(PAGE_BUF);
+	printf("\t(Buffer Table)\n");
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	e = EduBfM_Final();
+	if (e < eNOERROR) ERR(e);
+	edubfm_cfgParams.replacementPolicy[PAGE_BUF] = BFM_CLOCK;
+
+	printf("****************************** TEST#8, Replacement policies. ******************************\n");
+	/* #8 End test */
+	printf("\n\n");
+
+
+	/* #9 Start test for the open addressing page table */
+	printf("****************************** TEST#9, Open addressing page table. ******************************\n");
+
+	/* Test for the pages written and read again with the open addressing page table */
+	printf("*Test 9_1 : Test for the pages written and read again with the open addressing page table\n");
+	printf("->Split the buffer into two partitions with their own page tables, set dirty bit for twenty pages and fix them all again\n\n");
+	edubfm_cfgParams.pageTable = BFM_OPEN_TABLE;
+	edubfm_cfgParams.nPartitions = 2;
+	e = EduBfM_Init();
+	if (e < eNOERROR) ERR(e);
+
+	e = edubfm_stamp_pages(pageID, 2 * NUM_PAGE_BUFS, 900);
+	if (e < eNOERROR) ERR(e);
+	e = edubfm_check_pages(pageID, 2 * NUM_PAGE_BUFS, 900);
+	if (e < eNOERROR) ERR(e);
+	if (e != 0) ERR(eBADPARAMETER_EDUBFM);
+	printf("%d pages are written, replaced and read again with %d wrong pages\n", 2 * NUM_PAGE_BUFS, e);
+
+	// 마지막에 읽은 page들은 page table에서 찾을 수 있어야 함
+	for (j = 0, i = NUM_PAGE_BUFS; i < 2 * NUM_PAGE_BUFS; i++)
+		if (edubfm_LookUp((BfMHashKey *)&pageID[i], PAGE_BUF) != NOTFOUND_IN_HTABLE) j++;
+	if (j != NUM_PAGE_BUFS) ERR(eBADPARAMETER_EDUBFM);
+	printf("%d of the last %d pages are found in the page tables using edubfm_LookUp()\n", j, NUM_PAGE_BUFS);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n---------------------------------- Result ----------------------------------\n");
+	edubfm_dump_buffertable(PAGE_BUF);
+	printf("\t(Buffer Table)\n");
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	e = EduBfM_Final();
+	if (e < eNOERROR) ERR(e);
+	edubfm_cfgParams.pageTable = BFM_CHAINED_TABLE;
+	edubfm_cfgParams.nPartitions = 0;
+
+	printf("****************************** TEST#9, Open addressing page table. ******************************\n");
+	/* #9 End test */
+	printf("\n\n");
+
+
+	/* #10 Start test for the bulk flush */
+	printf("****************************** TEST#10, EduBfM_FlushAll with bulk flush. ******************************\n");
+
+	/* Test for the pages written by the bulk flush and read again */
+	printf("*Test 10_1 : Test for the pages written by the bulk flush and read again\n");
+	printf("->Attach the volume, set dirty bit for ten pages, flush them with useBulkFlush, discard all pages and fix them again\n\n");
+	e = EduBfM_FlushAll();
+	if (e < eNOERROR) ERR(e);
+	// Attach 된 volume의 인접한 page들은 한 번의 vectored write로 기록됨
+	e = EduBfM_AttachVolume(volId, "test.vol");
+	if (e < eNOERROR) ERR(e);
+
+	e = edubfm_stamp_pages(pageID, NUM_PAGE_BUFS, 1000);
+	if (e < eNOERROR) ERR(e);
+	printf("%d pages are dirty before the bulk flush\n", edubfm_count_dirty(PAGE_BUF));
+
+	e = EduBfM_GetWriterStats(&writerStats);
+	if (e < eNOERROR) ERR(e);
+	i = writerStats.nFlushedTrains;
+	j = writerStats.nFlushWrites;
+
+	useBulkFlush = sm_cfgParams.useBulkFlush;
+	sm_cfgParams.useBulkFlush = TRUE;
+	e = EduBfM_FlushAll();
+	sm_cfgParams.useBulkFlush = useBulkFlush;
+	if (e < eNOERROR) ERR(e);
+
+	e = EduBfM_GetWriterStats(&writerStats);
+	if (e < eNOERROR) ERR(e);
+	if (edubfm_count_dirty(PAGE_BUF) != 0 || writerStats.nFlushedTrains - i != NUM_PAGE_BUFS) ERR(eBADPARAMETER_EDUBFM);
+	printf("%d pages are written by %d writes using FlushAll()\n", writerStats.nFlushedTrains - i, writerStats.nFlushWrites - j);
+
+	e = EduBfM_DiscardAll();
+	if (e < eNOERROR) ERR(e);
+	e = EduBfM_DetachVolume(volId);
+	if (e < eNOERROR) ERR(e);
+
+	e = edubfm_check_pages(pageID, NUM_PAGE_BUFS, 1000);
+	if (e < eNOERROR) ERR(e);
+	if (e != 0) ERR(eBADPARAMETER_EDUBFM);
+	printf("%d pages are read again with %d wrong pages\n", NUM_PAGE_BUFS, e);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n---------------------------------- Result ----------------------------------\n");
+	edubfm_dump_buffertable(PAGE_BUF);
+	printf("\t(Buffer Table)\n");
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	printf("****************************** TEST#10, EduBfM_FlushAll with bulk flush. ******************************\n");
+	/* #10 End test */
+	printf("\n\n");
+
+
+	/* #11 Start test for the optimistic fix */
+	printf("****************************** TEST#11, Optimistic fix. ******************************\n");
+
+	/* Test for the pages written and read again with the optimistic fix */
+	printf("*Test 11_1 : Test for the pages written and read again with the optimistic fix\n");
+	printf("->Split the buffer into two partitions fixing their pages without the latch, set dirty bit for twenty pages, fix them all again and fix the last four once more\n\n");
+	edubfm_cfgParams.nPartitions = 2;
+	edubfm_cfgParams.useOptimisticFix = TRUE;
+	e = EduBfM_Init();
+	if (e < eNOERROR) ERR(e);
+	if (!PI_OPTIMISTIC(PAGE_BUF)) ERR(eBADPARAMETER_EDUBFM);
+
+	e = edubfm_stamp_pages(pageID, 2 * NUM_PAGE_BUFS, 1100);
+	if (e < eNOERROR) ERR(e);
+	e = edubfm_check_pages(pageID, 2 * NUM_PAGE_BUFS, 1100);
+	if (e < eNOERROR) ERR(e);
+	if (e != 0) ERR(eBADPARAMETER_EDUBFM);
+	printf("%d pages are written, replaced and read again with %d wrong pages\n", 2 * NUM_PAGE_BUFS, e);
+
+	// 마지막에 읽은 page들은 각 partition에 남아 있으므로, latch 없이 fix 됨
+#ifdef EDUBFM_STATS
+	e = EduBfM_ResetStats();
+	if (e < eNOERROR) ERR(e);
+#endif
+	e = edubfm_check_pages(&pageID[2 * NUM_PAGE_BUFS - 4], 4, 1100);
+	if (e < eNOERROR) ERR(e);
+	if (e != 0) ERR(eBADPARAMETER_EDUBFM);
+#ifdef EDUBFM_STATS
+	e = EduBfM_GetStats(PAGE_BUF, &stats);
+	if (e < eNOERROR) ERR(e);
+	if (stats.nOptimisticFixes != 4) ERR(eBADPARAMETER_EDUBFM);
+	printf("%d pages are found in buffer and %d of them are fixed without the latch\n", 4, (Four)stats.nOptimisticFixes);
+#endif
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n---------------------------------- Result ----------------------------------\n");
+	edubfm_dump_buffertable(PAGE_BUF);
+	printf("\t(Buffer Table)\n");
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	e = EduBfM_Final();
+	if (e < eNOERROR) ERR(e);
+	edubfm_cfgParams.nPartitions = 0;
+	edubfm_cfgParams.useOptimisticFix = FALSE;
+
+	printf("****************************** TEST#11, Optimistic fix. ******************************\n");
+	/* #11 End test */
+	printf("\n\n");
+
+
+	/* #12 Start test for the volume mapped into memory */
+	printf("****************************** TEST#12, Volume mapped into memory. ******************************\n");
+
+	/* Test for the pages written in place in the mapped volume and read again */
+	printf("*Test 12_1 : Test for the pages written in place in the mapped volume and read again\n");
+	printf("->Attach the volume with useMmap, set dirty bit for twenty pages, flush them, detach the volume and fix them again\n\n");
+	// Mapping이 disk의 최신 내용을 보이고, detach 후에 bufferPool의 이전 page들이 읽히지 않도록 함
+	e = EduBfM_FlushAll();
+	if (e < eNOERROR) ERR(e);
+	e = EduBfM_DiscardAll();
+	if (e < eNOERROR) ERR(e);
+	edubfm_cfgParams.useMmap = TRUE;
+	e = EduBfM_AttachVolume(volId, "test.vol");
+	if (e < eNOERROR) ERR(e);
+
+	e = edubfm_stamp_pages(pageID, 2 * NUM_PAGE_BUFS, 1200);
+	if (e < eNOERROR) ERR(e);
+	e = edubfm_check_pages(pageID, 2 * NUM_PAGE_BUFS, 1200);
+	if (e < eNOERROR) ERR(e);
+	if (e != 0) ERR(eBADPARAMETER_EDUBFM);
+
+	// Mapping 된 volume의 page들은 bufferPool에 읽혀지지 않음
+	for (j = 0, i = 0; i < 2 * NUM_PAGE_BUFS; i++)
+		if (edubfm_LookUp((BfMHashKey *)&pageID[i], PAGE_BUF) != NOTFOUND_IN_HTABLE) j++;
+	if (j != 0) ERR(eBADPARAMETER_EDUBFM);
+	printf("%d pages are written in place with %d wrong pages and %d of them are in buffer\n", 2 * NUM_PAGE_BUFS, e, j);
+
+	e = EduBfM_FlushAll();
+	if (e < eNOERROR) ERR(e);
+	e = EduBfM_DetachVolume(volId);
+	if (e < eNOERROR) ERR(e);
+	edubfm_cfgParams.useMmap = FALSE;
+
+	e = edubfm_check_pages(pageID, 2 * NUM_PAGE_BUFS, 1200);
+	if (e < eNOERROR) ERR(e);
+	if (e != 0) ERR(eBADPARAMETER_EDUBFM);
+	printf("%d pages are flushed, and read again into buffer with %d wrong pages\n", 2 * NUM_PAGE_BUFS, e);
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n---------------------------------- Result ----------------------------------\n");
+	edubfm_dump_buffertable(PAGE_BUF);
+	printf("\t(Buffer Table)\n");
+	printf("Press enter key to continue...");
+	getchar();
+	printf("\n\n");
+
+	printf("****************************** TEST#12, Volume mapped into memory. ******************************\n");
+	/* #12 End test */
+	printf("\n\n");
+
+
+	/* #13 Start test for the asynchronous I/O */
+	printf("****************************** TEST#13, Asynchronous I/O. ******************************\n");
+
+	for (i = 0; i < 2; i++)
+	{
+		/* Test for the pages written and read again by the asynchronous I/O */
+		printf("*Test 13_%d : Test for the pages written and read again by %s\n", i + 1, aioNames[i]);
+		printf("->Attach the volume, set dirty bit for twenty pages so that the first ten are replaced, fix them all again, and fix them once more after detaching the volume\n\n");
+		// io_uring을 사용할 수 없으면 thread pool이 사용됨
+		edubfm_cfgParams.ioQueueDepth = 8;
+		edubfm_cfgParams.useIOThreadPool = (i == 1);
+		e = EduBfM_Init();
+		if (e < eNOERROR) ERR(e);
+		e = EduBfM_AttachVolume(volId, "test.vol");
+		if (e < eNOERROR) ERR(e);
+
+		e = edubfm_stamp_pages(pageID, 2 * NUM_PAGE_BUFS, 1300 + 10 * i);
+		if (e < eNOERROR) ERR(e);
+		e = edubfm_check_pages(pageID, 2 * NUM_PAGE_BUFS, 1300 + 10 * i);
+		if (e < eNOERROR) ERR(e);
+		if (e != 0) ERR(eBADPARAMETER_EDUBFM);
+
+		e = EduBfM_GetAsyncIOStats(&aioStats);
+		if (e < eNOERROR) ERR(e);
+		if (aioStats.nReads == 0 || aioStats.nWrites == 0 || (i == 1 && aioStats.usingIoUring)) ERR(eBADPARAMETER_EDUBFM);
+		printf("%d pages are written, replaced and read again asynchronously with %d wrong pages\n", 2 * NUM_PAGE_BUFS, e);
+
+		e = EduBfM_FlushAll();
+		if (e < eNOERROR) ERR(e);
+		e = EduBfM_DiscardAll();
+		if (e < eNOERROR) ERR(e);
+		e = EduBfM_DetachVolume(volId);
+		if (e < eNOERROR) ERR(e);
+		e = EduBfM_Final();
+		if (e < eNOERROR) ERR(e);
+		edubfm_cfgParams.ioQueueDepth = 0;
+		edubfm_cfgParams.useIOThreadPool = FALSE;
+
+		e = edubfm_check_pages(pageID, 2 * NUM_PAGE_BUFS, 1300 + 10 * i);
+		if (e < eNOERROR) ERR(e);
+		if (e != 0) ERR(eBADPARAMETER_EDUBFM);
+		printf("%d pages are read again after detaching the volume with %d wrong pages\n", 2 * NUM_PAGE_BUFS, e);
+		printf("Press enter key to continue...");
+		getchar();
+		printf("\n---------------------------------- Result ----------------------------------\n");
+		edubfm_dump_buffertable(PAGE_BUF);
+		printf("\t(Buffer Table)\n");
+		printf("Press enter key to continue...");
+		getchar();
+		printf("\n\n");
+	}
+
+	printf("****************************** TEST#13, Asynchronous I/O. ******************************\n");
+	/* #13 End test */
 
 	return ( eNOERROR );
 }
@@ -433,3 +1186,111 @@ void edubfm_dump_hashtable(
     printf("\t|=============|=================|\n");
 	
 } /* edubfm_dump_hashtable() */
+
+
+/*@================================
+ * edubfm_count_dirty()
+ *================================*/
+/*
+ * Function: Four edubfm_count_dirty(Four)
+ *
+ * Description:
+ *  Count the buffers whose dirty bit is set.
+ *
+ * Returns:
+ *  # of dirty buffers
+ */
+Four edubfm_count_dirty(
+		Four        type)           /* IN buffer type */
+{
+	Two         i;
+	Four        nDirty = 0;
+
+
+	for( i = 0; i < BI_NBUFS(type); i++ )
+		if (BUFT(i).bits & DIRTY) nDirty++;
+
+	return nDirty;
+
+} /* edubfm_count_dirty() */
+
+
+/*@================================
+ * edubfm_stamp_pages()
+ *================================*/
+/*
+ * Function: Four edubfm_stamp_pages(PageID *, Four, Four)
+ *
+ * Description:
+ *  Fix the pages one after another, write 'stamp' plus the page number
+ *  into each of them and set its dirty bit. If there are more pages than
+ *  buffers, the later pages replace the earlier ones, which are written.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_stamp_pages(
+		PageID      *pageID,        /* IN pages to be stamped */
+		Four        nPages,         /* IN # of pages */
+		Four        stamp)          /* IN stamp */
+{
+	Four        e;
+	Four        i;
+	Four        value;
+	Page        *apage;
+
+
+	for( i = 0; i < nPages; i++ ) {
+		e = EduBfM_GetTrain(&pageID[i], (char **)&apage, PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+		value = stamp + pageID[i].pageNo;
+		memcpy(apage->data, &value, sizeof(Four));
+		e = EduBfM_SetDirty(&pageID[i], PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+		e = EduBfM_FreeTrain(&pageID[i], PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	return eNOERROR;
+
+} /* edubfm_stamp_pages() */
+
+
+/*@================================
+ * edubfm_check_pages()
+ *================================*/
+/*
+ * Function: Four edubfm_check_pages(PageID *, Four, Four)
+ *
+ * Description:
+ *  Fix the pages one after another and check the stamps written into them
+ *  by edubfm_stamp_pages().
+ *
+ * Returns:
+ *  # of pages with a wrong stamp
+ *  error code
+ */
+Four edubfm_check_pages(
+		PageID      *pageID,        /* IN pages to be checked */
+		Four        nPages,         /* IN # of pages */
+		Four        stamp)          /* IN stamp */
+{
+	Four        e;
+	Four        i;
+	Four        value;
+	Four        nWrong = 0;
+	Page        *apage;
+
+
+	for( i = 0; i < nPages; i++ ) {
+		e = EduBfM_GetTrain(&pageID[i], (char **)&apage, PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+		memcpy(&value, apage->data, sizeof(Four));
+		if (value != stamp + pageID[i].pageNo) nWrong++;
+		e = EduBfM_FreeTrain(&pageID[i], PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	return nWrong;
+
+} /* edubfm_check_pages() */
@@ -0,0 +1,976 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_VarTrain.c
+ *
+ * Description :
+ *  The pool of the variable-size trains, which caches trains of 1 to
+ *  VARTRAIN_MAX_PAGES pages of several sizes in one pool
+ *  (edubfm_cfgParams.varTrainPoolPages), so that e.g. the leaves of large
+ *  objects or multi-page B+ tree nodes do not occupy whole buffer elements
+ *  of the largest size. The buffer pools set up by the storage system keep
+ *  one size per buffer type, since it reads and writes their buffer
+ *  elements itself; this pool is owned by EduBfM alone.
+ *  The pages of the pool are allocated by a buddy allocator: a train of n
+ *  pages gets a block of the smallest power of 2 pages not less than n,
+ *  split from a larger free block if needed, and a freed block is merged
+ *  with its buddy whenever the buddy is free, too.
+ *  If there is no free block large enough, a clock hand sweeps the pool in
+ *  aligned regions of the size needed; a region none of whose trains is
+ *  fixed or has been referenced since the last sweep is emptied (the
+ *  dirty trains are written first), which leaves a free block of its size.
+ *  A train is read and written as a whole from and to the device of an
+ *  attached volume, and page by page by RDsM otherwise.
+ *  edubfm_vtMutex protects the pool, and is held during the I/Os; the I/O
+ *  latch is acquired while it is held, never the other way round.
+ *  A train must always be fixed with the same size, and must not be
+ *  accessed through the buffer pools at the same time.
+ *
+ * Exports:
+ *  Four EduBfM_GetVarTrain(TrainID *, char **, Four)
+ *  Four EduBfM_FreeVarTrain(TrainID *)
+ *  Four EduBfM_SetDirtyVarTrain(TrainID *)
+ *  Four EduBfM_GetVarTrainStats(EduBfM_VarTrainStats *)
+ *  Four edubfm_StartVarTrainPool(Four)
+ *  Four edubfm_StopVarTrainPool(void)
+ *  Four edubfm_FlushVarTrains(void)
+ *  void edubfm_DiscardVarTrains(void)
+ */
+
+
+#include <stdlib.h> /* for malloc & free */
+#include <string.h> /* for memset */
+#include <unistd.h>
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "RDsM.h"
+#include "EduBfM_Internal.h"
+
+
+/* Macro: VT_HASH(k)
+ * Description: return the hash value of a train in the pool
+ */
+#define VT_HASH(k)              ((UFour)((k)->volNo + (k)->pageNo) % edubfm_vtHashSize)
+
+/* Macro: VT_SIZE(i)
+ * Description: return the # of pages of the block starting at the page i
+ */
+#define VT_SIZE(i)              (1 << edubfm_vtBlocks[i].order)
+
+
+/* pages of the pool (NULL : no pool), and the entry of each page */
+static char             *edubfm_vtPool = NULL;
+static VarTrainBlock    *edubfm_vtBlocks = NULL;
+static Four             edubfm_vtNPages;
+
+/* first block of the free list of each order */
+static Four             edubfm_vtFree[VARTRAIN_MAX_ORDER + 1];
+
+/* hash table of the blocks holding trains */
+static Four             *edubfm_vtHashTable = NULL;
+static Four             edubfm_vtHashSize;
+
+/* page where the clock hand searches a region to be emptied next */
+static Four             edubfm_vtHand;
+
+/* counters of the pool */
+static EduBfM_VarTrainStats edubfm_vtStats;
+
+static pthread_mutex_t  edubfm_vtMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+/* internal function prototypes */
+static void edubfm_vt_Reset(void);
+static void edubfm_vt_Push(Four);
+static void edubfm_vt_Remove(Four);
+static Four edubfm_vt_Alloc(Four);
+static void edubfm_vt_Free(Four);
+static Four edubfm_vt_Head(Four);
+static Four edubfm_vt_LookUp(BfMHashKey *);
+static void edubfm_vt_Delete(Four);
+static Four edubfm_vt_Read(Four);
+static Four edubfm_vt_Write(Four);
+static Four edubfm_vt_Evict(Four);
+static Four edubfm_vt_Make(Four);
+
+
+
+/*@================================
+ * EduBfM_GetVarTrain()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetVarTrain(TrainID *, char **, Four)
+ *
+ * Description :
+ *  Fix the train of 'nPages' pages (1 to VARTRAIN_MAX_PAGES) starting at
+ *  'trainId' in the pool of the variable-size trains, reading it into a
+ *  block of the pool first if it is not there, and return the pointer to
+ *  its contents. The pages need not form a train of the storage system.
+ *
+ * Returns:
+ *  error code
+ *    eNOTSUPPORTED_EDUBFM - There is no pool, or the volume is mapped into memory.
+ *    eBADPARAMETER_EDUBFM - Invalid parameter, or the train is in the pool with another size.
+ *    eNOUNFIXEDBUF_BFM - The pool has no region large enough which can be emptied.
+ *    some errors caused by function calls
+ *
+ * 설명:
+ *  Variable-size train을 pool에 fix 하고, 그 내용에 대한 포인터를 반환함
+ *
+ * 관련 함수:
+ *  1. edubfm_vt_Make() - 필요한 크기의 빈 block을 만듦
+ *  2. edubfm_vt_Read() - train을 disk로부터 읽어 block에 저장함
+ */
+Four EduBfM_GetVarTrain(
+    TrainID             *trainId,               /* IN first page of the train to be fixed */
+    char                **retBuf,               /* OUT pointer to the contents of the train */
+    Four                nPages)                 /* IN # of pages of the train */
+{
+    Four                e;                      /* error */
+    Four                i;                      /* first page of the block */
+    Four                order;                  /* order of the block */
+    VarTrainBlock       *b;                     /* the block */
+
+
+    if (trainId == NULL || retBuf == NULL) ERR(eBADPARAMETER_EDUBFM);
+    if (nPages < 1 || nPages > VARTRAIN_MAX_PAGES) ERR(eBADPARAMETER_EDUBFM);
+    if (edubfm_vtPool == NULL || IS_MAPPED_VOLUME(trainId->volNo)) ERR(eNOTSUPPORTED_EDUBFM);
+
+    for (order = 0; (1 << order) < nPages; order++);
+
+    pthread_mutex_lock(&edubfm_vtMutex);
+
+    edubfm_vtStats.nFixes++;
+
+    i = edubfm_vt_LookUp((BfMHashKey *)trainId);
+    if (i != NIL) {
+        b = &edubfm_vtBlocks[i];
+        if (b->nPages != nPages) {
+            pthread_mutex_unlock(&edubfm_vtMutex);
+            ERR(eBADPARAMETER_EDUBFM);
+        }
+
+        b->fixed++;
+        b->bits |= REFER;
+        edubfm_vtStats.nHits++;
+    }
+    else {
+        // 필요한 크기의 빈 block을 만들어 train을 읽어 들임
+        i = edubfm_vt_Make(order);
+        if (i < 0) {
+            pthread_mutex_unlock(&edubfm_vtMutex);
+            ERR(i);
+        }
+
+        b = &edubfm_vtBlocks[i];
+        b->key = *(BfMHashKey *)trainId;
+        b->nPages = (Two)nPages;
+
+        e = edubfm_vt_Read(i);
+        if (e < 0) {
+            edubfm_vt_Free(i);
+            pthread_mutex_unlock(&edubfm_vtMutex);
+            ERR(e);
+        }
+
+        b->fixed = 1;
+        b->bits = REFER;
+        b->nextHashEntry = edubfm_vtHashTable[VT_HASH(&b->key)];
+        edubfm_vtHashTable[VT_HASH(&b->key)] = i;
+
+        edubfm_vtStats.nTrains++;
+        edubfm_vtStats.nPagesUsed += VT_SIZE(i);
+        edubfm_vtStats.nPagesRequested += nPages;
+    }
+
+    *retBuf = edubfm_vtPool + (size_t)i * PAGESIZE;
+
+    pthread_mutex_unlock(&edubfm_vtMutex);
+
+    return(eNOERROR);
+
+}  /* EduBfM_GetVarTrain() */
+
+
+
+/*@================================
+ * EduBfM_FreeVarTrain()
+ *================================*/
+/*
+ * Function: Four EduBfM_FreeVarTrain(TrainID *)
+ *
+ * Description :
+ *  Unfix the train fixed by EduBfM_GetVarTrain().
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - trainId is NULL.
+ *    eNOTFOUND_BFM - The train is not in the pool.
+ *
+ * 설명:
+ *  Variable-size train의 fixed 변수 값을 1 감소시킴
+ */
+Four EduBfM_FreeVarTrain(
+    TrainID             *trainId)               /* IN first page of the train to be freed */
+{
+    Four                i;                      /* first page of the block */
+
+
+    if (trainId == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    pthread_mutex_lock(&edubfm_vtMutex);
+
+    i = (edubfm_vtPool == NULL) ? NIL : edubfm_vt_LookUp((BfMHashKey *)trainId);
+    if (i == NIL) {
+        pthread_mutex_unlock(&edubfm_vtMutex);
+        ERR(eNOTFOUND_BFM);
+    }
+
+    // fixed 변수의 값은 0 미만이 될 수 없음
+    if (edubfm_vtBlocks[i].fixed > 0) edubfm_vtBlocks[i].fixed--;
+    else {
+        printf("fixed counter is less than 0!!!\n");
+        printf("trainId = {%d,  %d}\n", trainId->volNo, trainId->pageNo);
+    }
+
+    pthread_mutex_unlock(&edubfm_vtMutex);
+
+    return(eNOERROR);
+
+}  /* EduBfM_FreeVarTrain() */
+
+
+
+/*@================================
+ * EduBfM_SetDirtyVarTrain()
+ *================================*/
+/*
+ * Function: Four EduBfM_SetDirtyVarTrain(TrainID *)
+ *
+ * Description :
+ *  Mark the train fixed by EduBfM_GetVarTrain() as modified, so that it is
+ *  written to disk before it is removed from the pool.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - trainId is NULL.
+ *    eNOTFOUND_BFM - The train is not in the pool.
+ *
+ * 설명:
+ *  Variable-size train의 DIRTY bit를 1로 set 함
+ */
+Four EduBfM_SetDirtyVarTrain(
+    TrainID             *trainId)               /* IN first page of the modified train */
+{
+    Four                i;                      /* first page of the block */
+
+
+    if (trainId == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    pthread_mutex_lock(&edubfm_vtMutex);
+
+    i = (edubfm_vtPool == NULL) ? NIL : edubfm_vt_LookUp((BfMHashKey *)trainId);
+    if (i == NIL) {
+        pthread_mutex_unlock(&edubfm_vtMutex);
+        ERR(eNOTFOUND_BFM);
+    }
+
+    edubfm_vtBlocks[i].bits |= DIRTY;
+
+    pthread_mutex_unlock(&edubfm_vtMutex);
+
+    return(eNOERROR);
+
+}  /* EduBfM_SetDirtyVarTrain() */
+
+
+
+/*@================================
+ * EduBfM_GetVarTrainStats()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetVarTrainStats(EduBfM_VarTrainStats *)
+ *
+ * Description :
+ *  Return the counters of the pool of the variable-size trains since it
+ *  was allocated by EduBfM_Init(): how many trains were fixed and found in
+ *  the pool, how many were evicted or written back, and how many pages of
+ *  the pool the trains in it occupy now, compared with their own sizes.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - stats is NULL.
+ *
+ * 설명:
+ *  Variable-size train pool의 통계를 반환함
+ */
+Four EduBfM_GetVarTrainStats(
+    EduBfM_VarTrainStats *stats)                /* OUT counters */
+{
+    if (stats == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    pthread_mutex_lock(&edubfm_vtMutex);
+    *stats = edubfm_vtStats;
+    pthread_mutex_unlock(&edubfm_vtMutex);
+
+    return(eNOERROR);
+
+}  /* EduBfM_GetVarTrainStats() */
+
+
+
+/*@================================
+ * edubfm_StartVarTrainPool()
+ *================================*/
+/*
+ * Function: Four edubfm_StartVarTrainPool(Four)
+ *
+ * Description:
+ *  Allocate an empty pool of the variable-size trains of 'nPages' pages
+ *  (rounded down to a multiple of VARTRAIN_MAX_PAGES, at least one), and
+ *  reset its counters. The pool allocated before must have been stopped.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ */
+Four edubfm_StartVarTrainPool(
+    Four                nPages)                 /* IN # of pages of the pool */
+{
+    void                *pool;                  /* pages of the pool */
+
+
+    nPages = MAX(nPages / VARTRAIN_MAX_PAGES, 1) * VARTRAIN_MAX_PAGES;
+
+    // O_DIRECT로 attach 된 volume도 읽고 쓸 수 있도록 page 경계에 맞추어 할당함
+    if (posix_memalign(&pool, PAGESIZE, (size_t)nPages * PAGESIZE) != 0) pool = NULL;
+    edubfm_vtBlocks = (VarTrainBlock *)malloc(sizeof(VarTrainBlock) * nPages);
+    edubfm_vtHashTable = (Four *)malloc(sizeof(Four) * nPages);
+    if (pool == NULL || edubfm_vtBlocks == NULL || edubfm_vtHashTable == NULL) {
+        free(pool);
+        free(edubfm_vtBlocks);
+        free(edubfm_vtHashTable);
+        edubfm_vtBlocks = NULL;
+        edubfm_vtHashTable = NULL;
+        ERR(eMEMALLOCERR_EDUBFM);
+    }
+
+    pthread_mutex_lock(&edubfm_vtMutex);
+
+    edubfm_vtPool = (char *)pool;
+    edubfm_vtNPages = nPages;
+    edubfm_vtHashSize = nPages;
+    edubfm_vt_Reset();
+
+    memset(&edubfm_vtStats, 0, sizeof(EduBfM_VarTrainStats));
+    edubfm_vtStats.nPages = nPages;
+
+    pthread_mutex_unlock(&edubfm_vtMutex);
+
+    return(eNOERROR);
+
+}  /* edubfm_StartVarTrainPool */
+
+
+
+/*@================================
+ * edubfm_StopVarTrainPool()
+ *================================*/
+/*
+ * Function: Four edubfm_StopVarTrainPool(void)
+ *
+ * Description:
+ *  Write the dirty trains of the pool of the variable-size trains (if any)
+ *  and free the pool. The pool is kept if a train cannot be written.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_StopVarTrainPool(void)
+{
+    Four                e;                      /* error */
+
+
+    if (edubfm_vtPool == NULL) return(eNOERROR);
+
+    e = edubfm_FlushVarTrains();
+    if (e < 0) ERR(e);
+
+    pthread_mutex_lock(&edubfm_vtMutex);
+
+    free(edubfm_vtPool);
+    free(edubfm_vtBlocks);
+    free(edubfm_vtHashTable);
+    edubfm_vtPool = NULL;
+    edubfm_vtBlocks = NULL;
+    edubfm_vtHashTable = NULL;
+
+    pthread_mutex_unlock(&edubfm_vtMutex);
+
+    return(eNOERROR);
+
+}  /* edubfm_StopVarTrainPool */
+
+
+
+/*@================================
+ * edubfm_FlushVarTrains()
+ *================================*/
+/*
+ * Function: Four edubfm_FlushVarTrains(void)
+ *
+ * Description:
+ *  Write the dirty trains of the pool of the variable-size trains, which
+ *  stay in the pool. Called by EduBfM_FlushAll().
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_FlushVarTrains(void)
+{
+    Four                e;                      /* error */
+    Four                i;                      /* first page of a block */
+
+
+    if (edubfm_vtPool == NULL) return(eNOERROR);
+
+    pthread_mutex_lock(&edubfm_vtMutex);
+
+    for (i = 0; i < edubfm_vtNPages; i += VT_SIZE(i)) {
+        if (edubfm_vtBlocks[i].isFree || !(edubfm_vtBlocks[i].bits & DIRTY)) continue;
+
+        e = edubfm_vt_Write(i);
+        if (e < 0) {
+            pthread_mutex_unlock(&edubfm_vtMutex);
+            ERR(e);
+        }
+    }
+
+    pthread_mutex_unlock(&edubfm_vtMutex);
+
+    return(eNOERROR);
+
+}  /* edubfm_FlushVarTrains */
+
+
+
+/*@================================
+ * edubfm_DiscardVarTrains()
+ *================================*/
+/*
+ * Function: void edubfm_DiscardVarTrains(void)
+ *
+ * Description:
+ *  Remove all trains from the pool of the variable-size trains without
+ *  writing them. Called by EduBfM_DiscardAll().
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_DiscardVarTrains(void)
+{
+    if (edubfm_vtPool == NULL) return;
+
+    pthread_mutex_lock(&edubfm_vtMutex);
+
+    edubfm_vt_Reset();
+
+    edubfm_vtStats.nTrains = 0;
+    edubfm_vtStats.nPagesUsed = 0;
+    edubfm_vtStats.nPagesRequested = 0;
+
+    pthread_mutex_unlock(&edubfm_vtMutex);
+
+}  /* edubfm_DiscardVarTrains */
+
+
+
+/*
+ * Function: static void edubfm_vt_Reset(void)
+ *
+ * Description:
+ *  Make the whole pool free blocks of the max. order, and empty the hash
+ *  table. The caller must hold edubfm_vtMutex.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_vt_Reset(void)
+{
+    Four                i;                      /* index */
+
+
+    for (i = 0; i <= VARTRAIN_MAX_ORDER; i++) edubfm_vtFree[i] = NIL;
+    for (i = 0; i < edubfm_vtHashSize; i++) edubfm_vtHashTable[i] = NIL;
+
+    for (i = 0; i < edubfm_vtNPages; i++) {
+        SET_NILBFMHASHKEY(edubfm_vtBlocks[i].key);
+        edubfm_vtBlocks[i].order = NIL;
+        edubfm_vtBlocks[i].isFree = FALSE;
+    }
+
+    // Pool 전체를 최대 크기의 block들로 나누어 free list에 넣음
+    for (i = 0; i < edubfm_vtNPages; i += VARTRAIN_MAX_PAGES) {
+        edubfm_vtBlocks[i].order = VARTRAIN_MAX_ORDER;
+        edubfm_vt_Push(i);
+    }
+
+    edubfm_vtHand = 0;
+
+}  /* edubfm_vt_Reset */
+
+
+
+/*
+ * Function: static void edubfm_vt_Push(Four)
+ *
+ * Description:
+ *  Put the block into the free list of its order.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_vt_Push(
+    Four                i)                      /* IN first page of the block */
+{
+    VarTrainBlock       *b = &edubfm_vtBlocks[i];
+
+
+    b->isFree = TRUE;
+    b->fixed = 0;
+    b->bits = ALL_0;
+    SET_NILBFMHASHKEY(b->key);
+
+    b->prev = NIL;
+    b->next = edubfm_vtFree[b->order];
+    if (b->next != NIL) edubfm_vtBlocks[b->next].prev = i;
+    edubfm_vtFree[b->order] = i;
+
+}  /* edubfm_vt_Push */
+
+
+
+/*
+ * Function: static void edubfm_vt_Remove(Four)
+ *
+ * Description:
+ *  Take the block out of the free list of its order.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_vt_Remove(
+    Four                i)                      /* IN first page of the block */
+{
+    VarTrainBlock       *b = &edubfm_vtBlocks[i];
+
+
+    if (b->prev != NIL) edubfm_vtBlocks[b->prev].next = b->next;
+    else edubfm_vtFree[b->order] = b->next;
+    if (b->next != NIL) edubfm_vtBlocks[b->next].prev = b->prev;
+
+    b->isFree = FALSE;
+
+}  /* edubfm_vt_Remove */
+
+
+
+/*
+ * Function: static Four edubfm_vt_Alloc(Four)
+ *
+ * Description:
+ *  Allocate a block of the given order from the free lists, splitting a
+ *  larger free block if needed.
+ *
+ * Returns:
+ *  first page of the block (NIL : no free block large enough)
+ */
+static Four edubfm_vt_Alloc(
+    Four                order)                  /* IN order of the block */
+{
+    Four                i;                      /* first page of the block */
+    Four                k;                      /* order of the free block found */
+
+
+    for (k = order; k <= VARTRAIN_MAX_ORDER && edubfm_vtFree[k] == NIL; k++);
+    if (k > VARTRAIN_MAX_ORDER) return(NIL);
+
+    i = edubfm_vtFree[k];
+    edubfm_vt_Remove(i);
+
+    // 필요한 크기가 될 때까지 반으로 나누어, 뒤쪽 절반 (buddy) 을 free list에 넣음
+    while (k > order) {
+        k--;
+        edubfm_vtBlocks[i + (1 << k)].order = (Two)k;
+        edubfm_vt_Push(i + (1 << k));
+    }
+    edubfm_vtBlocks[i].order = (Two)order;
+
+    return(i);
+
+}  /* edubfm_vt_Alloc */
+
+
+
+/*
+ * Function: static void edubfm_vt_Free(Four)
+ *
+ * Description:
+ *  Free the block, merging it with its buddy as long as the buddy is a
+ *  free block of the same order.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_vt_Free(
+    Four                i)                      /* IN first page of the block */
+{
+    Four                k;                      /* order of the block */
+    Four                buddy;                  /* first page of the buddy */
+
+
+    for (k = edubfm_vtBlocks[i].order; k < VARTRAIN_MAX_ORDER; k++) {
+        buddy = i ^ (1 << k);
+        if (edubfm_vtBlocks[buddy].order != k || !edubfm_vtBlocks[buddy].isFree) break;
+
+        edubfm_vt_Remove(buddy);
+        edubfm_vtBlocks[MAX(i, buddy)].order = NIL;
+        i = MIN(i, buddy);
+        edubfm_vtBlocks[i].order = (Two)(k + 1);
+    }
+
+    edubfm_vt_Push(i);
+
+}  /* edubfm_vt_Free */
+
+
+
+/*
+ * Function: static Four edubfm_vt_Head(Four)
+ *
+ * Description:
+ *  Return the first page of the block containing the given page.
+ *
+ * Returns:
+ *  first page of the block
+ */
+static Four edubfm_vt_Head(
+    Four                i)                      /* IN page of the pool */
+{
+    Four                k;                      /* order */
+    Four                head;                   /* first page of the block of order k containing the page */
+
+
+    for (k = 0; k < VARTRAIN_MAX_ORDER; k++) {
+        head = i & ~((1 << k) - 1);
+        if (edubfm_vtBlocks[head].order == k) return(head);
+    }
+
+    return( i & ~(VARTRAIN_MAX_PAGES - 1) );
+
+}  /* edubfm_vt_Head */
+
+
+
+/*
+ * Function: static Four edubfm_vt_LookUp(BfMHashKey *)
+ *
+ * Description:
+ *  Look up the block holding the given train in the hash table.
+ *
+ * Returns:
+ *  first page of the block (NIL : not found)
+ */
+static Four edubfm_vt_LookUp(
+    BfMHashKey          *key)                   /* IN train */
+{
+    Four                i;                      /* first page of a block */
+
+
+    for (i = edubfm_vtHashTable[VT_HASH(key)]; i != NIL; i = edubfm_vtBlocks[i].nextHashEntry)
+        if (EQUALKEY(&edubfm_vtBlocks[i].key, key)) return(i);
+
+    return(NIL);
+
+}  /* edubfm_vt_LookUp */
+
+
+
+/*
+ * Function: static void edubfm_vt_Delete(Four)
+ *
+ * Description:
+ *  Delete the block from the hash table.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_vt_Delete(
+    Four                i)                      /* IN first page of the block */
+{
+    Four                *link;                  /* link to a block of the hash chain */
+
+
+    for (link = &edubfm_vtHashTable[VT_HASH(&edubfm_vtBlocks[i].key)]; *link != NIL;
+         link = &edubfm_vtBlocks[*link].nextHashEntry) {
+        if (*link == i) {
+            *link = edubfm_vtBlocks[i].nextHashEntry;
+            return;
+        }
+    }
+
+}  /* edubfm_vt_Delete */
+
+
+
+/*
+ * Function: static Four edubfm_vt_Read(Four)
+ *
+ * Description:
+ *  Read the train set in the block from disk: at once from the device of
+ *  an attached volume, and page by page by RDsM otherwise.
+ *
+ * Returns:
+ *  error code
+ *    eVOLUMEIOERR_EDUBFM - Reading from the device of an attached volume failed.
+ *    some errors caused by RDsM_ReadTrain()
+ */
+static Four edubfm_vt_Read(
+    Four                i)                      /* IN first page of the block */
+{
+    Four                e;                      /* error */
+    Four                j;                      /* page of the train */
+    Four                fd;                     /* file descriptor of the device */
+    ssize_t             nBytes;                 /* # of bytes to be read */
+    UEight              due;                    /* time when the read of a memory volume completes */
+    PageID              pid;                    /* a page of the train */
+    VarTrainBlock       *b = &edubfm_vtBlocks[i];
+    char                *buf = edubfm_vtPool + (size_t)i * PAGESIZE;
+
+
+    fd = edubfm_VolumeFd(b->key.volNo);
+    if (fd != NIL) {
+        e = edubfm_LatchIOShared();
+        if (e < 0) ERR(e);
+
+        nBytes = (ssize_t)PAGESIZE * b->nPages;
+        due = edubfm_MemoryVolumeCharge(b->key.volNo, nBytes);
+        nBytes -= pread(fd, buf, nBytes, (off_t)b->key.pageNo * PAGESIZE);
+
+        edubfm_UnlatchIO();
+        if (nBytes != 0) ERR(eVOLUMEIOERR_EDUBFM);
+
+        edubfm_MemoryVolumeWait(due);
+
+        return(eNOERROR);
+    }
+
+    e = edubfm_LatchIO();
+    if (e < 0) ERR(e);
+
+    pid.volNo = b->key.volNo;
+    for (j = 0; j < b->nPages; j++) {
+        pid.pageNo = b->key.pageNo + j;
+        e = RDsM_ReadTrain(&pid, buf + (size_t)j * PAGESIZE, 1);
+        if (e < 0) break;
+    }
+
+    edubfm_UnlatchIO();
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+}  /* edubfm_vt_Read */
+
+
+
+/*
+ * Function: static Four edubfm_vt_Write(Four)
+ *
+ * Description:
+ *  Write the train in the block to disk and clear its DIRTY bit: at once
+ *  to the device of a volume attached with O_DIRECT, and page by page by
+ *  RDsM otherwise.
+ *
+ * Returns:
+ *  error code
+ *    eVOLUMEIOERR_EDUBFM - Writing to the device of an attached volume failed.
+ *    some errors caused by RDsM_WriteTrain()
+ */
+static Four edubfm_vt_Write(
+    Four                i)                      /* IN first page of the block */
+{
+    Four                e = eNOERROR;           /* error */
+    Four                j;                      /* page of the train */
+    Four                fd;                     /* file descriptor of the device */
+    ssize_t             nBytes;                 /* # of bytes to be written */
+    UEight              due;                    /* time when the write of a memory volume completes */
+    PageID              pid;                    /* a page of the train */
+    VarTrainBlock       *b = &edubfm_vtBlocks[i];
+    char                *buf = edubfm_vtPool + (size_t)i * PAGESIZE;
+
+
+    e = edubfm_LatchIO();
+    if (e < 0) ERR(e);
+
+    // O_DIRECT로 attach 된 volume인 경우, page cache를 거치지 않도록 device에 직접 기록함
+    fd = edubfm_DirectVolumeFd(b->key.volNo);
+    if (fd != NIL) {
+        nBytes = (ssize_t)PAGESIZE * b->nPages;
+        due = edubfm_MemoryVolumeCharge(b->key.volNo, nBytes);
+        if (pwrite(fd, buf, nBytes, (off_t)b->key.pageNo * PAGESIZE) != nBytes) e = eVOLUMEIOERR_EDUBFM;
+        edubfm_MemoryVolumeWait(due);
+    }
+    else {
+        pid.volNo = b->key.volNo;
+        for (j = 0; j < b->nPages; j++) {
+            pid.pageNo = b->key.pageNo + j;
+            e = RDsM_WriteTrain(buf + (size_t)j * PAGESIZE, &pid, 1);
+            if (e < 0) break;
+        }
+    }
+
+    edubfm_UnlatchIO();
+    if (e < 0) ERR(e);
+
+    b->bits &= ~DIRTY;
+    edubfm_vtStats.nWriteBacks++;
+
+    return(eNOERROR);
+
+}  /* edubfm_vt_Write */
+
+
+
+/*
+ * Function: static Four edubfm_vt_Evict(Four)
+ *
+ * Description:
+ *  Remove the unfixed train from the pool, writing it first if it is
+ *  dirty, and free its block.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four edubfm_vt_Evict(
+    Four                i)                      /* IN first page of the block */
+{
+    Four                e;                      /* error */
+
+
+    if (edubfm_vtBlocks[i].bits & DIRTY) {
+        e = edubfm_vt_Write(i);
+        if (e < 0) ERR(e);
+    }
+
+    edubfm_vt_Delete(i);
+
+    edubfm_vtStats.nEvictions++;
+    edubfm_vtStats.nTrains--;
+    edubfm_vtStats.nPagesUsed -= VT_SIZE(i);
+    edubfm_vtStats.nPagesRequested -= edubfm_vtBlocks[i].nPages;
+
+    edubfm_vt_Free(i);
+
+    return(eNOERROR);
+
+}  /* edubfm_vt_Evict */
+
+
+
+/*
+ * Function: static Four edubfm_vt_Make(Four)
+ *
+ * Description:
+ *  Allocate a block of the given order, emptying a region of the pool if
+ *  there is no free block large enough. The clock hand visits the aligned
+ *  regions of the size of the block (or the larger block containing one);
+ *  a region is emptied if none of its trains is fixed or has its REFER bit
+ *  set, and the REFER bits of the regions passed over are cleared, so that
+ *  every region can be emptied in the second round unless it is fixed.
+ *
+ * Returns:
+ *  first page of the block, or error code
+ *    eNOUNFIXEDBUF_BFM - Every region of the size has a fixed train.
+ *    some errors caused by function calls
+ */
+static Four edubfm_vt_Make(
+    Four                order)                  /* IN order of the block */
+{
+    Four                e;                      /* error */
+    Four                i;                      /* first page of the block */
+    Four                j, n;                   /* index */
+    Four                start, size;            /* region */
+    Four                trains[VARTRAIN_MAX_PAGES]; /* first pages of the blocks holding trains in the region */
+    Four                nTrains;                /* # of them */
+    Four                nSteps;                 /* # of pages visited by the clock hand */
+    Boolean             empty;                  /* TRUE if the region can be emptied */
+    VarTrainBlock       *b;                     /* a block in the region */
+
+
+    i = edubfm_vt_Alloc(order);
+    if (i != NIL) return(i);
+
+    for (nSteps = 0; nSteps < 2 * edubfm_vtNPages; nSteps += size) {
+
+        // Clock hand가 가리키는 region (그보다 큰 block에 포함되면 그 block 전체) 을 구함
+        start = edubfm_vtHand & ~((1 << order) - 1);
+        j = edubfm_vt_Head(start);
+        if (edubfm_vtBlocks[j].order > order) start = j;
+        size = MAX(1 << order, VT_SIZE(start));
+
+        edubfm_vtHand = (start + size) % edubfm_vtNPages;
+
+        // Fix 되어 있거나 최근에 참조된 train이 없으면 region을 비움 (참조된 train의 REFER bit는 지움)
+        empty = TRUE;
+        nTrains = 0;
+        for (j = start; j < start + size; j += VT_SIZE(j)) {
+            b = &edubfm_vtBlocks[j];
+            if (b->isFree) continue;
+            trains[nTrains++] = j;
+            if (b->fixed > 0) empty = FALSE;
+            else if (b->bits & REFER) {
+                b->bits &= ~REFER;
+                empty = FALSE;
+            }
+        }
+        if (!empty) continue;
+
+        // 제거된 block은 free block과 합쳐지므로, 미리 구한 train들의 block만 제거함
+        for (n = 0; n < nTrains; n++) {
+            e = edubfm_vt_Evict(trains[n]);
+            if (e < 0) ERR(e);
+        }
+
+        i = edubfm_vt_Alloc(order);
+        if (i != NIL) return(i);
+    }
+
+    ERR(eNOUNFIXEDBUF_BFM);
+
+}  /* edubfm_vt_Make */
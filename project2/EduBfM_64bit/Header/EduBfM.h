@@ -35,6 +35,35 @@ Four EduBfM_GetTrain(TrainID *, char **, Four);
 Four EduBfM_SetDirty(TrainID *, Four);
 Four EduBfM_DiscardAll(void);
 Four EduBfM_FlushAll(void);
+Four EduBfM_Init(void);
+Four EduBfM_Final(void);
+Four EduBfM_GetFrame(TrainID *, char **, Four, BfMFrameHandle *);
+Four EduBfM_FreeFrame(BfMFrameHandle *);
+Four EduBfM_SetDirtyFrame(BfMFrameHandle *);
+Four EduBfM_GetWriterStats(EduBfM_WriterStats *);
+Four EduBfM_AttachVolume(VolNo, char *);
+Four EduBfM_AttachMemoryVolume(VolNo, char *);
+Four EduBfM_DetachVolume(VolNo);
+Four EduBfM_GetReadAheadStats(EduBfM_ReadAheadStats *);
+Four EduBfM_Prefetch(TrainID *, Four, Four);
+Four EduBfM_GetTrains(TrainID *, char **, Four, Four);
+Four EduBfM_InitAccessStrategy(BfMAccessStrategy *, Four);
+Four EduBfM_GetTrainWithStrategy(TrainID *, char **, Four, BfMAccessStrategy *);
+Four EduBfM_ResizeBuffer(Four, Four, Four *);
+Four EduBfM_GetStats(Four, EduBfM_Stats *);
+Four EduBfM_ResetStats(void);
+Four EduBfM_DumpStats(FILE *);
+Four EduBfM_GetCompressedCacheStats(EduBfM_CompressedCacheStats *);
+Four EduBfM_SaveResidentSet(char *);
+Four EduBfM_LoadResidentSet(char *);
+Four EduBfM_SetThreadNode(Four);
+Four EduBfM_GetVarTrain(TrainID *, char **, Four);
+Four EduBfM_FreeVarTrain(TrainID *);
+Four EduBfM_SetDirtyVarTrain(TrainID *);
+Four EduBfM_GetVarTrainStats(EduBfM_VarTrainStats *);
+Four EduBfM_GetAsyncIOStats(EduBfM_AsyncIOStats *);
+Four EduBfM_Checkpoint(Four);
+Four EduBfM_GetCheckpointStats(EduBfM_CheckpointStats *);
 
 
 #endif /* _EDUBFM_H_ */
@@ -0,0 +1,76 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+#ifndef _EDUBFM_BENCHMODULE_H_
+#define _EDUBFM_BENCHMODULE_H_
+
+
+/*
+ * Definition for EduBfM Benchmark Module
+ */
+#define BENCH_VOLUME_NAME       "bench.vol"
+#define BENCH_VOLUME_NPAGES     640000      /* # of pages of the benchmark volume */
+#define BENCH_NTRAINS           512         /* # of trains accessed by the benchmarks */
+#define BENCH_NOPS              200000      /* default # of operations per thread */
+#define BENCH_MAX_THREADS       64
+#define BENCH_MAX_TRACETRAINS   12000       /* max. # of distinct trains of a trace per buffer type */
+#define BENCH_MAX_SEGMENTS      64          /* max. # of segments allocated by the benchmarks at the same time */
+
+
+/*@
+ * Function Prototypes
+ */
+Four EduBfM_Bench(Four, Four, char **);
+Four edubfm_bench_AllocTrains(Four, Four, Two, PageID *);
+Four edubfm_bench_DropSegments(Four, Four);
+double edubfm_bench_Now(void);
+
+/* benchmarks */
+Four edubfm_bench_MultiThreadedFix(Four, Four, char *);
+Four edubfm_bench_PolicyHitRatio(Four, Four, char *);
+Four edubfm_bench_PageTableLookUp(Four, Four, char *);
+Four edubfm_bench_BgWriter(Four, Four, char *);
+Four edubfm_bench_BulkFlush(Four, Four, char *);
+Four edubfm_bench_ReadAhead(Four, Four, char *);
+Four edubfm_bench_Prefetch(Four, Four, char *);
+Four edubfm_bench_Ring(Four, Four, char *);
+Four edubfm_bench_Resize(Four, Four, char *);
+Four edubfm_bench_Stats(Four, Four, char *);
+Four edubfm_bench_DirectIO(Four, Four, char *);
+Four edubfm_bench_Mmap(Four, Four, char *);
+Four edubfm_bench_CompressedCache(Four, Four, char *);
+Four edubfm_bench_Warmup(Four, Four, char *);
+Four edubfm_bench_OptimisticFix(Four, Four, char *);
+Four edubfm_bench_Numa(Four, Four, char *);
+Four edubfm_bench_VarTrain(Four, Four, char *);
+Four edubfm_bench_CleanFirst(Four, Four, char *);
+Four edubfm_bench_Suite(Four, Four, char *);
+Four edubfm_bench_AsyncIO(Four, Four, char *);
+Four edubfm_bench_MemoryVolume(Four, Four, char *);
+Four edubfm_bench_Replay(Four, Four, char *);
+Four edubfm_bench_Checkpoint(Four, Four, char *);
+Four edubfm_bench_ReadSize(Four, Four, char *);
+
+
+#endif /* _EDUBFM_BENCHMODULE_H_ */
@@ -26,6 +26,9 @@
 #define _EDUBFM_INTERNAL_H_
 
 
+#include <pthread.h>
+#include <sys/uio.h>
+
 /*@
  * Constant Definitions
  */ 
@@ -104,6 +107,15 @@ typedef struct {
 #define ALL_0  0x00
 #define ALL_1  ((sizeof(One) == 1) ? (0xff) : (0xffff))
 
+/* bits used only by EduBfM
+ *
+ * PREFETCHED : page/train read ahead, which has not been fixed yet
+ * READING : page/train being read ahead, or read for a fix without the latch of the partition;
+ *           the buffer element is fixed by the reading thread until the read completes
+ */
+#define PREFETCHED  0x10
+#define READING     0x20
+
 /* type definition for buffer pool information 
  *
  * 현재 bufSize에 있어서, PAGE_BUF는 1이고 LOT_LEAF_BUF는 4이다.
@@ -236,19 +248,809 @@ typedef struct {
 /* constant definition: The BfMHashKey don't exist in the hash table. */
 #define NOTFOUND_IN_HTABLE  -1
 
+/* Macro: BFM_HASH(k,type)
+ * Description: return the hash value of the key given as a parameter
+ * Parameters:
+ *  BfMHashKey *k   : pointer to the key
+ *  Four type       : buffer type
+ * Returns: (Two) hash value
+ */
+#define BFM_HASH(k,type)	(((k)->volNo + (k)->pageNo) % HASHTABLESIZE(type))
+
 extern BufferInfo bufInfo[];
 
+
+/* Replacement policies (selected per buffer type by edubfm_cfgParams.replacementPolicy[type]) */
+#define BFM_CLOCK       0       /* second chance (default) */
+#define BFM_LRUK        1       /* LRU-K (K = LRUK_K) */
+#define BFM_2Q          2       /* 2Q */
+#define BFM_ARC         3       /* Adaptive Replacement Cache */
+#define NUM_BFM_POLICIES 4
+
+/* Page tables (selected by edubfm_cfgParams.pageTable) */
+#define BFM_CHAINED_TABLE   0   /* BI_HASHTABLE chained through nextHashEntry, shared with the storage system (default) */
+#define BFM_OPEN_TABLE      1   /* open addressing table of each partition */
+
+/*
+ * Configuration Parameters of EduBfM
+ * (set before calling EduBfM_Init(); all zero means the original single-threaded EduBfM)
+ */
+typedef struct EduBfM_CfgParams_T_tag {
+    Four    nPartitions;        /* # of latched partitions of each buffer pool (0 : not partitioned, single-threaded) */
+    Four    replacementPolicy[NUM_BUF_TYPES];   /* replacement policy of each buffer pool */
+    Four    pageTable;          /* page table mapping a hash key to a buffer element */
+    Four    bgWriterCleanPercent;   /* % of the unfixed buffers kept clean by the background writer (0 : no background writer) */
+    Four    bgWriterInterval;   /* interval between the rounds of the background writer (unit: msec) */
+    Four    readAheadMaxWindow; /* max. # of pages/trains read ahead of a sequential access (0 : no read-ahead) */
+    Four    nIOThreads;         /* # of threads reading ahead and prefetching (0 : none, or one if readAheadMaxWindow > 0) */
+    Four    maxBufs[NUM_BUF_TYPES];     /* max. # of buffer elements of each buffer pool resized by EduBfM_ResizeBuffer() (0 : not resizable) */
+    Boolean useHugePages;       /* back the buffer pools with huge pages */
+    Boolean useDirectIO;        /* open the attached volumes with O_DIRECT, bypassing the page cache of the OS */
+    Boolean useMmap;            /* map the attached volumes into memory, and fix their pages/trains in place */
+    Four    compressedCacheSize;    /* size of the compressed cache of the replaced pages/trains (unit: bytes, 0 : none) */
+    char    *residentSetFile;   /* file of the resident pages/trains, saved by EduBfM_Final() and reloaded by EduBfM_Init() (NULL : none) */
+    Four    residentSetInterval;    /* interval of saving the resident pages/trains meanwhile (unit: sec, 0 : only by EduBfM_Final()) */
+    Boolean useOptimisticFix;   /* fix the pages/trains found in a partitioned buffer pool without its latch (BFM_CLOCK and BFM_CHAINED_TABLE only) */
+    Four    numaNodes;          /* # of NUMA nodes the partitions are spread over (0 : none, BFM_NUMA_MACHINE : the nodes of the machine) */
+    Four    varTrainPoolPages;  /* # of pages of the pool of the variable-size trains (0 : none) */
+    Four    cleanFirstBudget;   /* max. # of unreferenced dirty buffer elements BFM_CLOCK passes over to select a clean victim (0 : none) */
+    Four    ioQueueDepth;       /* max. # of asynchronous I/Os in flight (0 : synchronous I/O) */
+    Boolean useIOThreadPool;    /* serve the asynchronous I/Os by a pool of threads even if io_uring is available */
+    Four    memVolumeLatency;   /* latency injected into each I/O of the volumes attached by EduBfM_AttachMemoryVolume() (unit: usec) */
+    Four    memVolumeBandwidth; /* bandwidth of the transfers of those volumes (unit: MB/s, 0 : unlimited) */
+    char    *traceFile;         /* file to which the fixes, unfixes and I/Os are traced from EduBfM_Init() to EduBfM_Final() (NULL : none) */
+    Four    checkpointInterval; /* interval between the checkpoints taken by the checkpointer, each spread over it (unit: msec, 0 : only by EduBfM_Checkpoint()) */
+} EduBfM_CfgParams_T;
+
+/* NUMA placement
+ *
+ * BFM_NUMA_MACHINE : edubfm_cfgParams.numaNodes meaning as many nodes as the machine has
+ * BFM_MAX_NUMA_NODES : max. # of NUMA nodes; more nodes than the machine has are simulated,
+ *                      and node n is placed on the node (n % # of nodes of the machine)
+ */
+#define BFM_NUMA_MACHINE        -1
+#define BFM_MAX_NUMA_NODES      64
+
+/* default interval of the background writer (unit: msec) */
+#define BGWRITER_DEFAULT_INTERVAL   10
+
+/* Read-ahead
+ *
+ * READAHEAD_MIN_WINDOW : initial # of pages/trains read ahead of a stream
+ * READAHEAD_TRIGGER : # of consecutive accesses with the same stride which make a stream
+ * READAHEAD_MAX_STRIDE : max. stride of a stream (unit: # of buffer elements)
+ * READAHEAD_NSTREAMS : # of streams tracked at the same time
+ * READAHEAD_QUEUE_SIZE : max. # of pending read-ahead requests (more requests are dropped)
+ * READAHEAD_BATCH_SIZE : max. # of pages/trains whose reads edubfm_ReadFrames() keeps in flight together
+ */
+#define READAHEAD_MIN_WINDOW    2
+#define READAHEAD_TRIGGER       2
+#define READAHEAD_MAX_STRIDE    8
+#define READAHEAD_NSTREAMS      16
+#define READAHEAD_QUEUE_SIZE    256
+#define READAHEAD_BATCH_SIZE    64
+
+/* maximum # of the threads reading ahead and prefetching */
+#define MAX_IO_THREADS          16
+
+/* Asynchronous I/O
+ *
+ * BFM_IO_READ, BFM_IO_WRITE : operation of an I/O request
+ * AIO_MAX_DEPTH : max. edubfm_cfgParams.ioQueueDepth
+ * AIO_NWAITSLOTS : # of condition variables on which the fixes wait for the reads of the buffer elements
+ * BGWRITER_MAX_BATCH : max. # of writes the background writer keeps in flight
+ */
+#define BFM_IO_READ             0
+#define BFM_IO_WRITE            1
+#define AIO_MAX_DEPTH           256
+#define AIO_NWAITSLOTS          64
+#define BGWRITER_MAX_BATCH      32
+
+/* Statistics
+ *
+ * EDUBFM_STATS : defined (by the Makefile) to collect the statistics returned by EduBfM_GetStats()
+ * BFM_STATS(stmt) : 'stmt' is compiled only if EDUBFM_STATS is defined
+ * BFM_STATS_PIN_TIMED(type, idx) : TRUE if the fix of the buffer element is timed (always FALSE without EDUBFM_STATS)
+ * BFM_STATS_MAX_NBUFS : max. # of buffer elements of a buffer pool whose fix counts and fix times are kept
+ * BFM_STATS_PIN_SAMPLE : one of this many fixes of a partition is timed for the pin time histogram
+ */
+#ifdef EDUBFM_STATS
+#define BFM_STATS(stmt)         BEGIN_MACRO stmt; END_MACRO
+#define BFM_STATS_PIN_TIMED(type, idx)  edubfm_StatsPinTimed(type, idx)
+#else
+#define BFM_STATS(stmt)         BEGIN_MACRO END_MACRO
+#define BFM_STATS_PIN_TIMED(type, idx)  FALSE
+#endif
+#define BFM_STATS_MAX_NBUFS     32768
+#define BFM_STATS_PIN_SAMPLE    64
+
+/* Tracing
+ *
+ * BFM_TRACE(op, trainId, type) : record the operation on the page/train if EduBfM is tracing (see edubfm_Trace.c)
+ * TRACE_BUFFER_SIZE : # of records buffered before they are written to the trace file
+ */
+#define BFM_TRACE(op, trainId, type) \
+    BEGIN_MACRO if (edubfm_traceOn) edubfm_Trace(op, (PageID *)(trainId), type); END_MACRO
+#define TRACE_BUFFER_SIZE       4096
+
+/* Checkpoints
+ *
+ * BFM_CHECKPOINT_READ() : count a read of a page/train while a checkpoint is writing (see edubfm_Checkpoint.c)
+ * CHECKPOINT_TARGET_PERCENT : % of the window of a checkpoint over which its writes are spread while no other thread reads
+ *                             (the rest of the window is used only while they do)
+ */
+#define BFM_CHECKPOINT_READ() \
+    BEGIN_MACRO if (edubfm_checkpointActive) __sync_fetch_and_add(&edubfm_nCheckpointReads, 1); END_MACRO
+#define CHECKPOINT_TARGET_PERCENT   50
+
+/* Macro: BFM_STATS_BUCKET(v)
+ * Description: return the histogram bucket of the value
+ * Parameter:
+ *  UEight v    : value
+ * Returns: (Four) bucket number
+ */
+#define BFM_STATS_BUCKET(v)     ((v) == 0 ? 0 : MIN(64 - __builtin_clzll((UEight)(v)), BFM_STATS_NBUCKETS - 1))
+
+/* maximum # of buffer elements of a resizable buffer pool
+ * (the storage system keeps the hash value, which is less than HASHTABLESIZE(type), in a Two) */
+#define MAX_RESIZABLE_NBUFS     10922
+
+/* type definition for an open addressing page table
+ *
+ * 각 slot은 hash key (volNo 16 bits, pageNo 32 bits) 와 buffer element의 array index + 1 (16 bits) 을
+ * 하나의 64-bit word로 저장하며, 0은 빈 slot을 의미함. 한 cache line에 8개의 slot이 들어감.
+ * Linear probing을 사용하고, 삭제 시에는 tombstone 대신 backward shift를 수행함.
+ */
+typedef struct {
+    UFour       mask;           /* # of slots - 1 (# of slots is a power of 2) */
+    UEight*     slots;          /* slots */
+} OpenPageTable;
+
+/* Macro: OPT_PACKKEY(k)
+ * Description: return the 48-bit packed form of the hash key
+ * Parameter:
+ *  BfMHashKey *k   : pointer to the key
+ * Returns: (UEight) packed key
+ */
+#define OPT_PACKKEY(k)          ((((UEight)(UTwo)(k)->volNo) << 32) | (UEight)(UFour)(k)->pageNo)
+
+/* Macro: OPT_SLOT(packedKey, idx)
+ * Description: return the slot holding the packed key and the array index of the buffer element
+ */
+#define OPT_SLOT(packedKey, idx)    (((packedKey) << 16) | (UEight)(UTwo)((idx) + 1))
+
+/* Macro: OPT_SLOTKEY(slot), OPT_SLOTINDEX(slot)
+ * Description: return the packed key / the array index of the buffer element stored in the slot
+ */
+#define OPT_SLOTKEY(slot)       ((slot) >> 16)
+#define OPT_SLOTINDEX(slot)     ((Four)((slot) & 0xffff) - 1)
+
+/* constant definition: an empty slot */
+#define OPT_EMPTY               0
+
+/* type definition for a partition of a buffer pool
+ *
+ * 하나의 buffer pool을 여러 partition으로 나누어, 각 partition이 자신의 latch, hash chain, clock hand를 갖도록 함.
+ * Partition p는 buffer element [firstBuf, firstBuf + nBufs) 와, BFM_PARTITION() 값이 p인 hash value의 hashTable entry들을 소유함.
+ * 따라서 한 partition의 page/train은 항상 그 partition의 buffer element에만 저장되며,
+ * 서로 다른 partition에 대한 GetTrain/FreeTrain/SetDirty는 동시에 수행될 수 있음.
+ * Partition되지 않은 buffer pool은 latch를 사용하지 않는 하나의 partition (whole) 으로 취급함.
+ * Resizable buffer pool에서는 partition p가 buffer element [p*maxBufs, (p+1)*maxBufs) 를 예약하고,
+ * 그 중 앞의 nBufs개만 사용함. BI_NBUFS(type)는 예약된 전체 크기이므로, 크기를 바꾸어도 hash value와
+ * page/train의 partition은 바뀌지 않음.
+ */
+typedef struct {
+    Two                 firstBuf;       /* array index of the first buffer element of this partition */
+    Two                 nBufs;          /* # of buffer elements of this partition */
+    Two                 maxBufs;        /* max. # of buffer elements of this partition (nBufs if the buffer pool is not resizable) */
+    UTwo                nextVictim;     /* starting point for searching a next victim (relative to firstBuf) */
+    Two                 node;           /* NUMA node holding the buffer elements and the state of this partition (NIL : none) */
+    Boolean             useLatch;       /* TRUE if the latch must be acquired */
+    pthread_mutex_t     latch;          /* protects the hash chains, bufTable entries and nextVictim of this partition */
+    void*               policyState;    /* state of the replacement policy of this partition */
+    OpenPageTable       pageTable;      /* page table of this partition (if BFM_OPEN_TABLE is used) */
+    EduBfM_WriterStats  writerStats;    /* eviction and write counters of this partition */
+#ifdef EDUBFM_STATS
+    EduBfM_Stats        stats;          /* statistics of this partition */
+#endif
+} BufferPartition;
+
+/* type definition for a buffer replacement policy
+ *
+ * 각 함수는 partition의 latch를 획득한 상태에서 호출됨.
+ * selectVictim()은 victim으로 선정된 buffer element를 자신의 상태에서 제거하고, 그 array index를 반환함.
+ * fix()는 page/train이 fix 될 때마다 호출되며, hit가 FALSE이면 page/train이 새로 읽혀 들어온 경우임.
+ * evict()는 selectVictim()을 거치지 않고 buffer element가 재사용될 때 (예: buffer ring) 호출되며,
+ * 해당 buffer element를 자신의 상태에서 제거하고, 다음 fix()에서 새로 읽힌 page/train으로 취급하도록 함.
+ */
+typedef struct {
+    char*   name;                                               /* name of the policy */
+    Four    (*init)(Four, BufferPartition *);                   /* IN type, IN partition */
+    void    (*final)(Four, BufferPartition *);                  /* IN type, IN partition */
+    void    (*reset)(Four, BufferPartition *);                  /* IN type, IN partition : forget all pages/trains */
+    Four    (*selectVictim)(BfMHashKey *, Four, BufferPartition *); /* IN key to be stored, IN type, IN partition */
+    void    (*fix)(Four, BufferPartition *, Four, Boolean);     /* IN type, IN partition, IN index, IN hit */
+    void    (*evict)(Four, BufferPartition *, Four);            /* IN type, IN partition, IN index */
+} BfMReplacementPolicy;
+
+/* type definition for partition information of a buffer pool */
+typedef struct {
+    Two                 nParts;         /* # of partitions (0 : the buffer pool is not partitioned) */
+    BufferPartition*    parts;          /* array of partitions */
+    BufferPartition     whole;          /* the partition covering the whole buffer pool if it is not partitioned */
+    BfMReplacementPolicy* policy;       /* replacement policy (NULL : BFM_CLOCK without any state) */
+    Boolean             useOpenTable;   /* TRUE if the page tables of the partitions are used instead of BI_HASHTABLE */
+    Boolean             resizable;      /* TRUE if the buffer pool can be resized by EduBfM_ResizeBuffer() */
+    Boolean             optimistic;     /* TRUE if the pages/trains found in the buffer pool are fixed without the latch */
+    UFour*              versions;       /* version of each buffer element, odd while its page/train is being replaced (if optimistic) */
+    Four                cleanFirstBudget;   /* max. # of unreferenced dirty buffer elements passed over by BFM_CLOCK to select a clean victim */
+} PartitionInfo;
+
+/* Macro: PI_NPARTS(type)
+ * Description: return the number of partitions of a buffer pool
+ * Parameter:
+ *  Four type       : buffer type
+ * Returns: (Two) the number of partitions (0 if the buffer pool is not partitioned)
+ */
+#define PI_NPARTS(type)              (partInfo[type].nParts)
+
+/* Macro: PI_PART(type, p)
+ * Description: return the p-th partition of a buffer pool
+ *              (the whole buffer pool if it is not partitioned)
+ * Parameters:
+ *  Four type       : buffer type
+ *  Four p          : partition number
+ * Returns: (BufferPartition *) pointer to the partition
+ */
+#define PI_PART(type, p)             (IS_PARTITIONED(type) ? &partInfo[type].parts[p] : edubfm_WholePartition(type))
+
+/* Macro: PI_NLOOP(type)
+ * Description: return the number of partitions to visit when visiting all partitions of a buffer pool
+ * Parameter:
+ *  Four type       : buffer type
+ * Returns: (Four) the number of partitions (1 if the buffer pool is not partitioned)
+ */
+#define PI_NLOOP(type)               (MAX(PI_NPARTS(type), 1))
+
+/* Macro: PI_POLICY(type)
+ * Description: return the replacement policy of a buffer pool
+ * Parameter:
+ *  Four type       : buffer type
+ * Returns: (BfMReplacementPolicy *) pointer to the replacement policy
+ */
+#define PI_POLICY(type)              (partInfo[type].policy != NULL ? partInfo[type].policy : &edubfm_policies[BFM_CLOCK])
+
+/* Macro: PI_USEOPENTABLE(type)
+ * Description: check whether the buffer pool uses the open addressing page tables
+ * Parameter:
+ *  Four type       : buffer type
+ * Returns: TRUE(1) if BFM_OPEN_TABLE is used, otherwise FALSE(0)
+ */
+#define PI_USEOPENTABLE(type)        (partInfo[type].useOpenTable)
+
+/* Macro: PI_RESIZABLE(type)
+ * Description: return TRUE if the buffer pool can be resized
+ * Parameter:
+ *  Four type   : buffer type
+ * Returns: (Boolean) TRUE if the buffer pool can be resized
+ */
+#define PI_RESIZABLE(type)           (partInfo[type].resizable)
+
+/* Macro: PI_OPTIMISTIC(type)
+ * Description: check whether the pages/trains found in the buffer pool are fixed without the latch
+ * Parameter:
+ *  Four type   : buffer type
+ * Returns: (Boolean) TRUE if edubfm_OptimisticFix() is used
+ */
+#define PI_OPTIMISTIC(type)          (partInfo[type].optimistic)
+
+/* Macro: PI_CLEANFIRSTBUDGET(type)
+ * Description: return the max. # of unreferenced dirty buffer elements which BFM_CLOCK passes over
+ *              to select a clean victim, before it falls back to the first of them
+ * Parameter:
+ *  Four type   : buffer type
+ * Returns: (Four) the budget (0 : dirty and clean buffer elements are treated alike)
+ */
+#define PI_CLEANFIRSTBUDGET(type)    (partInfo[type].cleanFirstBudget)
+
+/* Macro: PI_VERSION(type, idx)
+ * Description: return the version of the buffer element, which is made odd while its page/train
+ *              is being replaced and even again afterwards, so that edubfm_OptimisticFix() can
+ *              detect the replacement (used only if PI_OPTIMISTIC(type))
+ * Parameters:
+ *  Four type   : buffer type
+ *  Four idx    : array index of the buffer element
+ * Returns: (UFour) version
+ */
+#define PI_VERSION(type, idx)        (partInfo[type].versions[idx])
+
+/* Macro: BI_PIN(type, idx), BI_UNPIN(type, idx)
+ * Description: increment/decrement the fix count of the buffer element atomically,
+ *              since edubfm_OptimisticFix() and EduBfM_FreeFrame() may change it without the latch
+ * Parameters:
+ *  Four type   : buffer type
+ *  Four idx    : array index of the buffer element
+ * Returns: (Two) the new fix count
+ */
+#define BI_PIN(type, idx)            (__atomic_add_fetch(&BI_FIXED(type, idx), 1, __ATOMIC_SEQ_CST))
+#define BI_UNPIN(type, idx)          (__atomic_sub_fetch(&BI_FIXED(type, idx), 1, __ATOMIC_SEQ_CST))
+
+/* Macro: FRAME_WRITE_BEGIN(type, idx), FRAME_WRITE_END(type, idx)
+ * Description: make the version of the buffer element odd before its key is changed, and even
+ *              again afterwards (nothing is done unless PI_OPTIMISTIC(type))
+ * Parameters:
+ *  Four type   : buffer type
+ *  Four idx    : array index of the buffer element
+ */
+#define FRAME_WRITE_BEGIN(type, idx) \
+    BEGIN_MACRO if (PI_OPTIMISTIC(type)) __atomic_add_fetch(&PI_VERSION(type, idx), 1, __ATOMIC_SEQ_CST); END_MACRO
+#define FRAME_WRITE_END(type, idx) \
+    BEGIN_MACRO if (PI_OPTIMISTIC(type)) __atomic_add_fetch(&PI_VERSION(type, idx), 1, __ATOMIC_SEQ_CST); END_MACRO
+
+/* Macro: PI_PAGETABLE(k, type)
+ * Description: return the open addressing page table of the partition to which the key belongs
+ * Parameters:
+ *  BfMHashKey *k   : pointer to the key
+ *  Four type       : buffer type
+ * Returns: (OpenPageTable *) pointer to the page table
+ */
+#define PI_PAGETABLE(k, type)        (IS_PARTITIONED(type) ? &partInfo[type].parts[BFM_PARTITION(k, type)].pageTable \
+                                                           : &partInfo[type].whole.pageTable)
+
+/* Macro: PART_NEXTVICTIM(type, part)
+ * Description: return the clock hand of the partition
+ *              (bufInfo[type].nextVictim, shared with the storage system, if the buffer pool is not partitioned)
+ * Parameters:
+ *  Four type               : buffer type
+ *  BufferPartition *part   : partition
+ * Returns: (UTwo *) pointer to the clock hand
+ */
+#define PART_NEXTVICTIM(type, part)  (IS_PARTITIONED(type) ? &(part)->nextVictim : &BI_NEXTVICTIM(type))
+
+/* Macro: IS_PARTITIONED(type)
+ * Description: check whether the buffer pool is partitioned
+ * Parameter:
+ *  Four type       : buffer type
+ * Returns: TRUE(1) if the buffer pool is partitioned, otherwise FALSE(0)
+ */
+#define IS_PARTITIONED(type)         (PI_NPARTS(type) > 0)
+
+/* Macro: BFM_PARTITION(k, type)
+ * Description: return the partition number to which the key belongs
+ *              (a function of the hash value, so that each hash chain lies in one partition;
+ *               the hash value is mixed first, since the first pages of the trains are a multiple
+ *               of the train size apart and their hash values would fall into a few partitions)
+ * Parameters:
+ *  BfMHashKey *k   : pointer to the key
+ *  Four type       : buffer type
+ * Returns: (Four) partition number
+ */
+#define BFM_PARTITION(k, type)       BFM_HASHPARTITION(BFM_HASH(k, type), type)
+
+/* Macro: BFM_HASHPARTITION(h, type)
+ * Description: return the partition number to which the hash value belongs
+ * Parameters:
+ *  Four h          : hash value
+ *  Four type       : buffer type
+ * Returns: (Four) partition number
+ */
+#define BFM_HASHPARTITION(h, type)   (((((UFour)(h)) * 2654435761U) >> 16) % PI_NPARTS(type))
+
+/* Macro: CHECK_FRAMEHANDLE(h)
+ * Description: check whether the frame handle is well-formed
+ *              (whether its buffer element still holds its train is checked under the latch)
+ * Parameter:
+ *  BfMFrameHandle *h   : pointer to the frame handle
+ */
+#define CHECK_FRAMEHANDLE(h) \
+BEGIN_MACRO \
+    if ((h) == NULL || IS_BAD_BUFFERTYPE((h)->type)) ERR(eBADBUFFER_BFM); \
+    if ((h)->index < 0 || (h)->index >= BI_NBUFS((h)->type)) ERR(eBADBUFINDEX_BFM); \
+END_MACRO
+
+/* Macro: ERR_UNLATCH(e, part)
+ * Description: release the latch of the partition and return the error
+ * Parameters:
+ *  Four e                  : error code
+ *  BufferPartition *part   : partition latched by the caller
+ */
+#define ERR_UNLATCH(e, part) \
+BEGIN_MACRO \
+    edubfm_UnlatchPartition(part); ERR(e); \
+END_MACRO
+
+extern PartitionInfo partInfo[];
+extern EduBfM_CfgParams_T edubfm_cfgParams;
+extern BfMReplacementPolicy edubfm_policies[];
+extern EduBfM_ReadAheadStats edubfm_raStats;
+extern pthread_mutex_t edubfm_raMutex;
+extern EduBfM_CompressedCacheStats edubfm_ccStats;
+extern pthread_mutex_t edubfm_ccMutex;
+
+/* max. # of asynchronous I/Os in flight (0 : not running), and the counters of the asynchronous I/O */
+extern Four edubfm_aioDepth;
+extern EduBfM_AsyncIOStats edubfm_aioStats;
+extern pthread_mutex_t edubfm_aioMutex;
+
+/* Macro: AIO_RUNNING()
+ * Description: check whether the asynchronous I/O is running
+ * Returns: TRUE(1) if edubfm_StartAsyncIO() has been called, otherwise FALSE(0)
+ */
+#define AIO_RUNNING()           (edubfm_aioDepth > 0)
+
+/* # of NUMA nodes the partitions are spread over (0 : none), and the NUMA node of the calling thread
+ * set by EduBfM_SetThreadNode() (NIL : the node of the CPU it runs on) */
+extern Four edubfm_nNumaNodes;
+extern __thread Four edubfm_threadNode;
+
+
+/* size of a huge page of the OS, to which the buffer pools are aligned if edubfm_cfgParams.useHugePages is set */
+#define BFM_HUGEPAGE_SIZE       (2 * 1024 * 1024)
+
+/* maximum # of volumes attached by EduBfM_AttachVolume() */
+#define MAX_ATTACHED_VOLUMES    16
+
+/* type definition for a volume attached by EduBfM_AttachVolume() */
+typedef struct {
+    VolNo       volNo;          /* volume number */
+    Four        fd;             /* file descriptor of the device of the volume */
+    Boolean     direct;         /* TRUE if the device is opened with O_DIRECT or is in memory (written by EduBfM, not RDsM) */
+    char        *map;           /* private mapping of the device (NULL : not mapped) */
+    Four        nPages;         /* # of pages mapped */
+    UFour       *dirty;         /* bitmap of the modified pages of the mapping */
+    Four        nFixed;         /* # of fixes of the pages/trains of the mapping not yet freed */
+    Boolean     memory;         /* TRUE if the device is a copy of the volume in memory (EduBfM_AttachMemoryVolume()) */
+    UEight      latency;        /* latency injected into each I/O of the memory volume (unit: nsec) */
+    Four        bandwidth;      /* bandwidth of the memory volume (unit: MB/s, 0 : unlimited) */
+    UEight      busyUntil;      /* time when the transfers issued so far to the memory volume end (unit: nsec) */
+} VolumeDevice;
+
+/* index in the handle of a page/train fixed in a mapped volume, which is not stored in a buffer element */
+#define BFM_MAPPED_FRAME        (-2)
+
+/* volumes attached by EduBfM_AttachVolume(), and # of them which are mapped */
+extern VolumeDevice edubfm_volumes[];
+extern Four edubfm_nVolumes;
+extern Four edubfm_nMappedVolumes;
+extern Four edubfm_nMemoryVolumes;
+
+/* TRUE while the operations are traced */
+extern Boolean edubfm_traceOn;
+
+/* TRUE while a checkpoint is writing, and the # of reads of pages/trains counted meanwhile by BFM_CHECKPOINT_READ() */
+extern Boolean edubfm_checkpointActive;
+extern UFour edubfm_nCheckpointReads;
+
+/* Macro: IS_MAPPED_VOLUME(volNo)
+ * Description: check whether the volume is mapped into memory
+ * Parameter:
+ *  VolNo volNo     : volume number
+ * Returns: TRUE(1) if the volume is mapped, otherwise FALSE(0)
+ */
+#define IS_MAPPED_VOLUME(volNo)     (edubfm_nMappedVolumes > 0 && edubfm_MappedVolume(volNo) != NULL)
+
+/* Compressed cache of the replaced pages/trains
+ *
+ * CCACHE_MIN_SIZE : min. size of the compressed cache (unit: bytes)
+ * CCACHE_ALIGN : alignment of the compressed pages/trains in the compressed cache (unit: bytes)
+ * CCACHE_ENTRY_BYTES : size of the compressed cache per entry of its entry table (unit: bytes)
+ * CCACHE_MAX_PERCENT : a page/train is stored only if it compresses to at most this % of its size
+ * CCACHE_MAX_TRAIN_PAGES : max. # of pages of a page/train stored in the compressed cache
+ */
+#define CCACHE_MIN_SIZE         (64 * 1024)
+#define CCACHE_ALIGN            16
+#define CCACHE_ENTRY_BYTES      256
+#define CCACHE_MAX_PERCENT      75
+#define CCACHE_MAX_TRAIN_PAGES  4
+
+/* type definition for a page/train stored in the compressed cache
+ *
+ * Entry들은 circular log인 arena에 저장된 순서대로 entry table에 circular하게 할당되므로,
+ * 가장 오래된 entry를 제거하면 arena의 공간과 entry가 함께 회수됨.
+ */
+typedef struct {
+    BfMHashKey  key;            /* page/train (nil : removed since it was read back) */
+    Two         type;           /* buffer type */
+    Four        offset;         /* offset of the compressed page/train in the arena */
+    Four        length;         /* size of the compressed page/train */
+    Four        nextHashEntry;  /* next entry of the hash chain (NIL : end of the chain) */
+} CompressedEntry;
+
+/* Pool of the variable-size trains, fixed by EduBfM_GetVarTrain()
+ *
+ * VARTRAIN_MAX_ORDER : max. order of a block; a block of order k consists of 2^k pages
+ * VARTRAIN_MAX_PAGES : max. # of pages of a variable-size train
+ */
+#define VARTRAIN_MAX_ORDER      4
+#define VARTRAIN_MAX_PAGES      (1 << VARTRAIN_MAX_ORDER)
+
+/* type definition for a block of the pool of the variable-size trains
+ *
+ * Pool은 page마다 entry를 하나씩 가지며, block의 정보는 그 첫 page의 entry에 저장됨 (나머지 page들의 order는 NIL).
+ * Order k의 block은 2^k 크기에 정렬되어 있으므로, block i의 buddy는 (i ^ 2^k) 에서 시작함.
+ */
+typedef struct {
+    BfMHashKey  key;            /* train held by the block */
+    Two         order;          /* order of the block starting at this page (NIL : not the first page of a block) */
+    Two         nPages;         /* # of pages of the train */
+    Boolean     isFree;         /* TRUE if the block is in a free list */
+    Four        fixed;          /* fixed count */
+    Four        bits;           /* DIRTY and REFER bits */
+    Four        nextHashEntry;  /* next block of the hash chain (NIL : end of the chain) */
+    Four        next, prev;     /* next and previous blocks of the free list (NIL : none) */
+} VarTrainBlock;
+
+/* Resident set file, saved by EduBfM_SaveResidentSet() and reloaded by EduBfM_LoadResidentSet()
+ *
+ * Header 다음에 resident page/train마다 entry가 하나씩 저장되며, 최근에 참조된 (REFER bit가 set 된)
+ * page/train들이 먼저 저장되므로 bufferPool이 작아진 경우에는 앞의 entry들만 다시 읽음.
+ */
+#define RESIDENTSET_MAGIC       "EduBfMRS"
+#define RESIDENTSET_VERSION     1
+
+/* type definition for the header of a resident set file */
+typedef struct {
+    char        magic[8];       /* RESIDENTSET_MAGIC */
+    Four        version;        /* RESIDENTSET_VERSION */
+    Four        pageSize;       /* PAGESIZE of EduBfM which saved the file */
+    Four        nEntries;       /* # of entries following the header */
+} ResidentSetHeader;
+
+/* type definition for an entry of a resident set file */
+typedef struct {
+    PageNo      pageNo;         /* first page of the page/train */
+    VolNo       volNo;          /* volume of the page/train */
+    Two         type;           /* buffer type */
+} ResidentSetEntry;
+
+/* type definition for a dirty buffer element collected by the bulk flush and the checkpoints */
+typedef struct {
+    BfMHashKey  key;            /* page/train held by the buffer element */
+    Two         type;           /* buffer type */
+    Two         index;          /* array index of the buffer element */
+} BulkFlushEntry;
+
+
+/* type definition for a sequential or strided access stream detected by the read-ahead
+ *
+ * 각 (volume, buffer type) 에 대해 마지막으로 fix 된 page 번호와 stride를 기억하여,
+ * 같은 stride의 access가 READAHEAD_TRIGGER 번 연속되면 다음 window 개의 page/train을 미리 읽음.
+ * 미리 읽은 page/train이 fix 되면 window를 두 배로 늘리고, fix 되지 않고 교체되면 절반으로 줄임.
+ */
+typedef struct {
+    VolNo       volNo;          /* volume of the stream (NIL : unused) */
+    Two         type;           /* buffer type */
+    PageNo      lastPage;       /* page/train fixed last */
+    Four        stride;         /* difference of the last two pageNos (0 : not a stream yet) */
+    Four        nSeq;           /* # of consecutive accesses with the stride */
+    Four        window;         /* # of pages/trains to be read ahead */
+    PageNo      raEnd;          /* page/train requested last */
+} ReadAheadStream;
+
+/* type definition for an asynchronous I/O request to the device of an attached volume
+ * (prepared by edubfm_PrepareIO(), and owned by the caller until edubfm_WaitIO() returns) */
+typedef struct {
+    Two         op;             /* BFM_IO_READ or BFM_IO_WRITE */
+    Two         type;           /* buffer type of the pages/trains */
+    TrainID     trainId;        /* first page/train */
+    Four        nPages;         /* # of pages transferred, set by edubfm_SubmitIO() */
+    Four        nIov;           /* # of adjacent pages/trains (more than one only for the vectored writes) */
+    struct iovec *iov;          /* buffer of each page/train */
+    struct iovec iov1;          /* buffer of a single page/train */
+    Four        fd;             /* file descriptor of the device */
+    Four        result;         /* error code, valid when done */
+    Boolean     done;           /* TRUE when the request is complete */
+    UEight      due;            /* time when the request of a memory volume completes (unit: nsec, 0 : when done) */
+} BfMIORequest;
+
+/* type definition for a read-ahead request (also used for the prefetch requests) */
+typedef struct {
+    TrainID     trainId;        /* page/train to be read */
+    Two         type;           /* buffer type */
+} ReadAheadRequest;
+
+
+/* K of the LRU-K replacement policy */
+#define LRUK_K          2
+
+/* type definition for a link of the doubly linked lists used by the replacement policies
+ * (an element is a buffer element, as an offset from firstBuf of its partition, or a ghost entry)
+ */
+typedef struct {
+    Four        prev;           /* element toward the MRU end (NIL : none) */
+    Four        next;           /* element toward the LRU end (NIL : none) */
+    Four        list;           /* list containing this element (NIL : none) */
+    Four        load;           /* list which the page/train being read into the buffer enters */
+} PolicyLink;
+
+/* type definition for a doubly linked list used by the replacement policies */
+typedef struct {
+    Four        head;           /* MRU end (NIL : empty) */
+    Four        tail;           /* LRU end (NIL : empty) */
+    Four        count;          /* # of elements */
+} PolicyList;
+
+/* constant definition: the list of the buffers which are in no other list of a replacement policy
+ * (empty, being read, or filled by the storage system itself)
+ */
+#define POLICY_FREELIST 0
+
+/* type definition for an entry of a ghost directory */
+typedef struct {
+    BfMHashKey  key;            /* page/train which is not in the buffer pool any more */
+    Four        hashNext;       /* next entry having the same hash value (NIL : none) */
+    UFour       hist[LRUK_K];   /* reference history (used by LRU-K) */
+} GhostEntry;
+
+/* constant definition: the list of the free entries of a ghost directory */
+#define GHOST_FREELIST  0
+#define MAX_GHOST_LISTS 2
+
+/* type definition for a ghost directory
+ *
+ * Buffer pool에서 제거된 page/train들의 hash key를 기억하는 directory로, 2Q의 A1out, ARC의 B1/B2,
+ * LRU-K의 retained history로 사용됨. 각 entry는 list 1..MAX_GHOST_LISTS 중 하나에 LRU 순서로 연결됨.
+ */
+typedef struct {
+    Four        nEntries;       /* # of entries */
+    GhostEntry* entries;
+    PolicyLink* links;
+    PolicyList  lists[MAX_GHOST_LISTS + 1];  /* GHOST_FREELIST and the lists 1..MAX_GHOST_LISTS */
+    Four        nBuckets;       /* # of hash buckets */
+    Four*       buckets;        /* heads of the hash chains */
+} GhostDir;
+
+/* Macro: GHOST_COUNT(g, listNo)
+ * Description: return the number of entries in a list of a ghost directory
+ */
+#define GHOST_COUNT(g, listNo)       ((g)->lists[listNo].count)
+
 /*@
  * Function Prototypes
  */
 /* internal function prototypes */
-Four edubfm_AllocTrain(Four);
+Four edubfm_AllocTrain(BfMHashKey *, Four);
+Four edubfm_AllocRingTrain(BfMHashKey *, Four, BfMAccessStrategy *);
+Four edubfm_EvictTrain(Four, BufferPartition *, Four);
 Four edubfm_Delete(BfMHashKey *, Four);
 Four edubfm_DeleteAll(void);
 Four edubfm_FlushTrain(TrainID *, Four);
+Four edubfm_WriteTrain(TrainID *, char *, Four);
 Four edubfm_Insert(BfMHashKey *, Two, Four); 
 Four edubfm_LookUp(BfMHashKey *, Four);
 Four edubfm_ReadTrain(TrainID *, char *, Four);
+BufferPartition *edubfm_GetPartition(BfMHashKey *, Four);
+BufferPartition *edubfm_WholePartition(Four);
+Four edubfm_LatchPartition(BufferPartition *);
+Four edubfm_UnlatchPartition(BufferPartition *);
+Four edubfm_LatchAll(void);
+void edubfm_UnlatchAll(Four);
+Four edubfm_LatchIO(void);
+Four edubfm_LatchIOShared(void);
+Four edubfm_UnlatchIO(void);
+Four edubfm_opt_Init(OpenPageTable *, Four);
+void edubfm_opt_Final(OpenPageTable *);
+void edubfm_opt_Clear(OpenPageTable *);
+Four edubfm_opt_LookUp(OpenPageTable *, BfMHashKey *);
+Four edubfm_opt_Insert(OpenPageTable *, BfMHashKey *, Two);
+Four edubfm_opt_Delete(OpenPageTable *, BfMHashKey *);
+Four edubfm_RebuildHashTable(Four);
+Four edubfm_FindFrame(TrainID *, Four, BfMFrameHandle *);
+Four edubfm_StartOptimisticFix(Four);
+void edubfm_StopOptimisticFix(Four);
+Four edubfm_OptimisticFix(BfMHashKey *, Four);
+Four edubfm_OptimisticFind(BfMHashKey *, Four);
+Boolean edubfm_OptimisticUnfix(Four, Four);
+Boolean edubfm_ClaimFrame(Four, Four);
+Four edubfm_StartVarTrainPool(Four);
+Four edubfm_StopVarTrainPool(void);
+Four edubfm_FlushVarTrains(void);
+void edubfm_DiscardVarTrains(void);
+Four edubfm_StartNuma(Four);
+void edubfm_StopNuma(void);
+void edubfm_SetMemoryNode(Four);
+void edubfm_PlacePartition(Four, BufferPartition *);
+Four edubfm_ThreadNode(void);
+Four edubfm_MemoryNode(void *);
+Four edubfm_StartBgWriter(void);
+Four edubfm_StopBgWriter(void);
+Four edubfm_VolumeFd(VolNo);
+Four edubfm_DirectVolumeFd(VolNo);
+VolumeDevice *edubfm_MappedVolume(VolNo);
+Four edubfm_MapVolume(VolumeDevice *);
+void edubfm_UnmapVolume(VolumeDevice *);
+Four edubfm_LoadMemoryVolume(VolumeDevice *, char *);
+UEight edubfm_MemoryVolumeCharge(VolNo, Four);
+void edubfm_MemoryVolumeWait(UEight);
+Four edubfm_GetMappedFrame(TrainID *, char **, Four, BfMFrameHandle *);
+Four edubfm_FreeMappedFrame(BfMFrameHandle *);
+Four edubfm_SetDirtyMappedFrame(BfMFrameHandle *);
+void edubfm_PrefetchMapped(TrainID *, Four);
+Four edubfm_FlushMappedVolumes(void);
+void edubfm_DiscardMappedVolumes(void);
+Four edubfm_BulkFlush(void);
+int edubfm_CompareFlushEntry(const void *, const void *);
+Four edubfm_StartCompressedCache(Four);
+void edubfm_StopCompressedCache(void);
+void edubfm_CompressedCacheInsert(BfMHashKey *, Four, char *);
+Boolean edubfm_CompressedCacheRead(TrainID *, char *, Four);
+void edubfm_CompressedCacheClear(void);
+Four edubfm_StartReadAhead(void);
+Four edubfm_StopReadAhead(void);
+void edubfm_ReadAheadNotify(TrainID *, Four, Boolean);
+Boolean edubfm_ReadAheadQueue(TrainID *, Four, Four);
+void edubfm_ReadAheadWasted(BfMHashKey *, Four);
+Four edubfm_ReadFrames(TrainID *, Four, Four);
+void edubfm_WaitReadAheadIdle(void);
+Four edubfm_StartAsyncIO(Four, Boolean);
+void edubfm_StopAsyncIO(void);
+void edubfm_PrepareIO(BfMIORequest *, Four, TrainID *, char *, Four);
+Four edubfm_SubmitIO(BfMIORequest *, Four);
+Four edubfm_WaitIO(BfMIORequest *, Four);
+Four edubfm_BeginFrameRead(TrainID *, Four, Four);
+Boolean edubfm_EndFrameRead(TrainID *, Four, BufferPartition *, Four, Four, One, Boolean);
+Four edubfm_WaitFrameIO(Four, Four, BufferPartition *);
+Four edubfm_StartResidentSetWriter(void);
+Four edubfm_StopResidentSetWriter(void);
+Four edubfm_ReserveBufferPool(Four, Four);
+void edubfm_CompactBufferPool(Four, Four);
+void edubfm_ReleaseBuffers(Four, Four, Four);
+void edubfm_StatsFix(Four, BufferPartition *, Four, Boolean);
+void edubfm_StatsUnfix(Four, BufferPartition *, Four);
+void edubfm_StatsEvict(Four, BufferPartition *, Four);
+void edubfm_StatsDiscard(Four, Four);
+void edubfm_StatsVictim(BufferPartition *, UEight);
+void edubfm_StatsLookUp(Four, Four, UEight);
+void edubfm_StatsOptimisticFix(Four, BufferPartition *, Four);
+Boolean edubfm_StatsPinTimed(Four, Four);
+Four edubfm_StartTrace(char *);
+Four edubfm_StopTrace(void);
+void edubfm_Trace(Four, PageID *, Four);
+Four edubfm_StartCheckpointer(void);
+Four edubfm_StopCheckpointer(void);
+Four edubfm_Checkpoint(Four);
+void edubfm_GetCheckpointStats(EduBfM_CheckpointStats *);
+void edubfm_ResetCheckpointStats(void);
+
+/* replacement policy support functions */
+void edubfm_ListInit(PolicyList *, Four);
+void edubfm_ListPush(PolicyList *, PolicyLink *, Four, Four);
+void edubfm_ListRemove(PolicyList *, PolicyLink *, Four);
+Four edubfm_ListUnfixedLRU(PolicyList *, PolicyLink *, Four, Four, BufferPartition *);
+void edubfm_FreeListInit(PolicyList *, PolicyLink *, Four, Four, BufferPartition *);
+Four edubfm_UnlistedUnfixed(PolicyList *, PolicyLink *, Four, BufferPartition *);
+Four edubfm_GhostInit(GhostDir *, Four);
+void edubfm_GhostFinal(GhostDir *);
+void edubfm_GhostReset(GhostDir *);
+Four edubfm_GhostLookUp(GhostDir *, BfMHashKey *);
+Four edubfm_GhostInsert(GhostDir *, BfMHashKey *, Four);
+void edubfm_GhostDelete(GhostDir *, Four);
+
+/* replacement policies */
+Four edubfm_clock_Init(Four, BufferPartition *);
+void edubfm_clock_Final(Four, BufferPartition *);
+void edubfm_clock_Reset(Four, BufferPartition *);
+Four edubfm_clock_SelectVictim(BfMHashKey *, Four, BufferPartition *);
+void edubfm_clock_Fix(Four, BufferPartition *, Four, Boolean);
+void edubfm_clock_Evict(Four, BufferPartition *, Four);
+Four edubfm_lruk_Init(Four, BufferPartition *);
+void edubfm_lruk_Final(Four, BufferPartition *);
+void edubfm_lruk_Reset(Four, BufferPartition *);
+Four edubfm_lruk_SelectVictim(BfMHashKey *, Four, BufferPartition *);
+void edubfm_lruk_Fix(Four, BufferPartition *, Four, Boolean);
+void edubfm_lruk_Evict(Four, BufferPartition *, Four);
+Four edubfm_2q_Init(Four, BufferPartition *);
+void edubfm_2q_Final(Four, BufferPartition *);
+void edubfm_2q_Reset(Four, BufferPartition *);
+Four edubfm_2q_SelectVictim(BfMHashKey *, Four, BufferPartition *);
+void edubfm_2q_Fix(Four, BufferPartition *, Four, Boolean);
+void edubfm_2q_Evict(Four, BufferPartition *, Four);
+Four edubfm_arc_Init(Four, BufferPartition *);
+void edubfm_arc_Final(Four, BufferPartition *);
+void edubfm_arc_Reset(Four, BufferPartition *);
+Four edubfm_arc_SelectVictim(BfMHashKey *, Four, BufferPartition *);
+void edubfm_arc_Fix(Four, BufferPartition *, Four, Boolean);
+void edubfm_arc_Evict(Four, BufferPartition *, Four);
 
 
 #endif /* _EDUBFM_INTERNAL_H_ */
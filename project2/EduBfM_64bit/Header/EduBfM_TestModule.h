@@ -39,6 +39,10 @@
 #define NUM_PAGE_BUFS 10
 #define LAST_PAGE_NUM 29
 #define PAGE_BUFS_CLOCKALG 14
+#define PAGE_BUFS_RESIZE 15
+#define RESIDENT_SET_FILE "test.resident"
+#define CHECKPOINT_WINDOW 20
+#define CHECKPOINT_MAX_WAIT 100
 #define MAX_DEVICES_IN_VOLUME 20
 
 #define BI_BUFTABLE_ENTRY(type, idx) (((BufferTable*)bufInfo[type].bufTable)[idx]) 
@@ -96,6 +100,7 @@ Four LRDS_Final(void);
 Four RDsM_CreateSetment(Four, Four*);
 Four RDsM_ExtNoToPageId(Four, Four, PageID*);
 Four RDsM_AllocTrains(Four, Four, PageID *, Two, Four, Two, PageID *);
+Four RDsM_DropSegment(Four, Four);
 
 Four EduBfM_Test(Four);
 
@@ -90,11 +90,199 @@ typedef PageID TrainID;		/* use its first page's PageID as the TrainID */
 
 #define PRINT_TRAINID(x,y) PRINT_PAGEID(x,y)
 
+/*
+** Type Definition for Frame Handle
+*/
+/* handle of the buffer element holding a fixed page/train, returned by EduBfM_GetFrame();
+ * it is valid until the page/train is freed, and its fields must not be used by the caller */
+typedef struct {
+    TrainID trainId;		/* train held by the buffer element */
+    Two     type;		/* buffer type */
+    Two     index;		/* array index of the buffer element */
+} BfMFrameHandle;
+
+/*
+** Type Definition for Access Strategy
+*/
+/* access hints given to EduBfM_GetTrainWithStrategy() */
+#define BFM_ACCESS_NORMAL       0   /* the shared buffer pool is used as usual */
+#define BFM_ACCESS_SEQSCAN      1   /* sequential scan : the clean buffers of a small ring are reused */
+#define BFM_ACCESS_BULKWRITE    2   /* bulk write : the buffers of a ring are written and reused */
+
+/* sizes of the rings (unit: # of buffer elements), at most 1/BFM_RING_POOL_FRACTION of the buffer pool */
+#define BFM_SEQSCAN_RING_SIZE   32
+#define BFM_BULKWRITE_RING_SIZE 128
+#define BFM_MAX_RING_SIZE       128
+#define BFM_RING_POOL_FRACTION  8
+
+/* access strategy initialized by EduBfM_InitAccessStrategy(), which keeps the ring of a scan or a bulk write;
+ * its fields must not be used by the caller */
+typedef struct {
+    Two     hint;		/* access hint */
+    Two     type;		/* buffer type of the ring (NIL : nothing has been read into the ring yet) */
+    Two     nFrames;		/* # of buffer elements of the ring */
+    Two     current;		/* slot of the ring used last */
+    Two     frames[BFM_MAX_RING_SIZE];	/* array index of the buffer element in each slot (NIL : empty) */
+    PageID  keys[BFM_MAX_RING_SIZE];	/* page/train read into the buffer element of each slot */
+} BfMAccessStrategy;
+
+/*
+** Type Definition for Writer Statistics
+*/
+/* counters of the evictions and the writes of dirty pages/trains, returned by EduBfM_GetWriterStats() */
+typedef struct {
+    UFour   nEvictions;		/* # of pages/trains replaced by EduBfM_GetTrain() */
+    UFour   nSyncWrites;	/* # of replaced pages/trains which had to be written synchronously */
+    UFour   nBgWrites;		/* # of pages/trains written by the background writer */
+    UFour   nFlushedTrains;	/* # of pages/trains written by EduBfM_FlushAll() */
+    UFour   nFlushWrites;	/* # of write requests issued by EduBfM_FlushAll() */
+    UFour   nCheckpointWrites;	/* # of pages/trains written by the checkpoints */
+} EduBfM_WriterStats;
+
+/*
+** Type Definition for Read-ahead Statistics
+*/
+/* counters of the read-ahead, returned by EduBfM_GetReadAheadStats() */
+typedef struct {
+    UFour   nReadAheads;	/* # of pages/trains read ahead */
+    UFour   nReadAheadHits;	/* # of pages/trains read ahead and then fixed */
+    UFour   nReadAheadWasted;	/* # of pages/trains read ahead and replaced without being fixed */
+} EduBfM_ReadAheadStats;
+
+/*
+** Type Definition for Compressed Cache Statistics
+*/
+/* counters of the compressed cache of the replaced pages/trains, returned by EduBfM_GetCompressedCacheStats() */
+typedef struct {
+    UFour   nLookUps;		/* # of pages/trains to be read into the buffer pools, looked up in the compressed cache first */
+    UFour   nHits;		/* # of them decompressed from the compressed cache instead of being read from disk */
+    UFour   nInserts;		/* # of replaced pages/trains stored in the compressed cache */
+    UFour   nRejected;		/* # of replaced pages/trains not stored since they did not compress well enough */
+    UFour   nEvictions;		/* # of pages/trains dropped from the compressed cache to make room for others */
+    UEight  nBytesIn;		/* total size of the pages/trains stored */
+    UEight  nBytesStored;	/* total size they were compressed into */
+    UFour   nEntries;		/* # of pages/trains in the compressed cache now */
+    UFour   nBytesUsed;		/* # of bytes of the compressed cache used by them now */
+} EduBfM_CompressedCacheStats;
+
+/*
+** Type Definition for Variable-size Train Statistics
+*/
+/* counters of the pool of the variable-size trains, returned by EduBfM_GetVarTrainStats() */
+typedef struct {
+    UFour   nFixes;		/* # of trains fixed by EduBfM_GetVarTrain() */
+    UFour   nHits;		/* # of fixes which found the train in the pool */
+    UFour   nEvictions;		/* # of trains removed from the pool to make room for others */
+    UFour   nWriteBacks;	/* # of dirty trains written to disk */
+    UFour   nPages;		/* # of pages of the pool */
+    UFour   nTrains;		/* # of trains in the pool now */
+    UFour   nPagesUsed;		/* # of pages of the blocks holding them now */
+    UFour   nPagesRequested;	/* # of pages of the trains themselves (the rest of nPagesUsed is lost to the rounding) */
+} EduBfM_VarTrainStats;
+
+/*
+** Type Definition for Asynchronous I/O Statistics
+*/
+/* counters of the asynchronous I/O, returned by EduBfM_GetAsyncIOStats() */
+typedef struct {
+    Boolean usingIoUring;	/* TRUE if the requests are served by io_uring, FALSE if by a pool of threads */
+    UFour   nReads;		/* # of read requests submitted */
+    UFour   nWrites;		/* # of write requests submitted (a vectored write of several pages/trains counts once) */
+    UFour   maxInFlight;	/* max. # of requests in flight at the same time */
+    UFour   nOrderWaits;	/* # of requests which waited for an overlapping write in flight */
+    UFour   nFrameWaits;	/* # of fixes which waited for a read of the page/train in progress instead of reading it again */
+} EduBfM_AsyncIOStats;
+
+/*
+** Type Definition for Checkpoint Statistics
+*/
+/* progress of the checkpoints, returned by EduBfM_GetCheckpointStats() */
+typedef struct {
+    UFour   nCheckpoints;	/* # of checkpoints completed */
+    UFour   nAborted;		/* # of checkpoints stopped before completing (by EduBfM_Final() or an error) */
+    Boolean inProgress;		/* TRUE while a checkpoint is writing the dirty pages/trains */
+    UFour   nToWrite;		/* # of dirty pages/trains found by the current (or last) checkpoint */
+    UFour   nWritten;		/* # of them written so far */
+    UFour   nSkipped;		/* # of them already clean or replaced when their turn came */
+    UFour   nThrottled;		/* # of writes of all checkpoints delayed since the other threads were reading meanwhile */
+    UFour   elapsed;		/* time since the current (or last) checkpoint started, or its duration if completed (unit: msec) */
+} EduBfM_CheckpointStats;
+
+/*
+** Type Definition for Trace Records
+*/
+/* operations recorded in the trace file written by EduBfM (edubfm_cfgParams.traceFile) */
+#define BFM_TRACE_FIXHIT        0   /* a fix which found the page/train in the buffer pool */
+#define BFM_TRACE_FIXMISS       1   /* a fix which read the page/train into the buffer pool */
+#define BFM_TRACE_FREE          2   /* an unfix */
+#define BFM_TRACE_SETDIRTY      3   /* a modification marked by EduBfM_SetDirty() */
+#define BFM_TRACE_READ          4   /* a read from disk (including the read-ahead and the prefetch) */
+#define BFM_TRACE_WRITE         5   /* a write to disk (each page/train of a vectored write is recorded) */
+
+#define BFM_TRACE_MAGIC         "EDUBFMT1"
+#define BFM_TRACE_MAX_TYPES     4
+
+/* header at the beginning of a trace file, followed by the records */
+typedef struct {
+    char    magic[8];		/* BFM_TRACE_MAGIC */
+    Four    pageSize;		/* PAGESIZE */
+    Four    nTypes;		/* # of buffer types */
+    Four    nBufs[BFM_TRACE_MAX_TYPES];	/* # of buffer elements of each buffer pool when the trace was started */
+    Four    bufSize[BFM_TRACE_MAX_TYPES];	/* # of pages of a page/train of each buffer pool */
+} EduBfM_TraceHeader;
+
+/* record of an operation in a trace file (16 bytes) */
+typedef struct {
+    UEight  time;		/* time since the trace was started (unit: nsec) */
+    PageNo  pageNo;		/* page/train */
+    VolNo   volNo;
+    One     op;			/* BFM_TRACE_XXX */
+    One     type;		/* buffer type */
+} EduBfM_TraceRecord;
+
+/*
+** Type Definition for Buffer Manager Statistics
+*/
+/* # of buckets of a histogram : bucket 0 counts the value 0, and bucket b (> 0) counts the values in [2^(b-1), 2^b)
+ * (the last bucket also counts all larger values) */
+#define BFM_STATS_NBUCKETS      24
+
+/* counters and histograms of a buffer pool, returned by EduBfM_GetStats()
+ * (collected only if EduBfM is compiled with EDUBFM_STATS) */
+typedef struct {
+    UEight  nFixes;		/* # of pages/trains fixed */
+    UEight  nHits;		/* # of fixes which found the page/train in the buffer pool */
+    UEight  nMisses;		/* # of fixes which read the page/train from disk */
+    UEight  nEvictions;		/* # of pages/trains removed from the buffer pool to reuse or release their buffers */
+    UEight  nWriteBacks;	/* # of dirty pages/trains written to disk */
+    UEight  nVictimSearches;	/* # of victims selected by the replacement policy */
+    UEight  nVictimSteps;	/* # of buffer elements visited to select them (clock sweep length) */
+    UEight  maxVictimSteps;	/* max. # of buffer elements visited to select a victim */
+    UEight  nLookUps;		/* # of look-ups of the hash table */
+    UEight  nChainSteps;	/* # of hash chain entries compared by them */
+    UEight  maxChainSteps;	/* max. # of hash chain entries compared by a look-up */
+    UEight  nOptimisticFixes;	/* # of hits fixed without the latch of the partition (included in nFixes and nHits) */
+    UEight  nRemoteFixes;	/* # of fixes by the threads on another NUMA node than the partition (included in nFixes) */
+    UEight  nDirtySkips;	/* # of unreferenced dirty buffer elements passed over to select a clean victim */
+    UEight  victimStepsHist[BFM_STATS_NBUCKETS];	/* histogram of the # of buffer elements visited to select a victim */
+    UEight  chainStepsHist[BFM_STATS_NBUCKETS];	/* histogram of the # of hash chain entries compared by a look-up */
+    UEight  fixCountHist[BFM_STATS_NBUCKETS];	/* histogram of the # of fixes of a page/train while it stayed in the buffer pool */
+    UEight  pinTimeHist[BFM_STATS_NBUCKETS];	/* histogram of the time a page/train stayed fixed, sampled (unit: usec) */
+} EduBfM_Stats;
+
 /*
  * Error Handling
  */
 /* Error Number Indicating NO ERROR */
 #define eNOERROR 0
 
+/*
+** Macro Definitions
+*/
+#undef MIN
+#define MIN(a,b) (((a) < (b)) ? (a):(b))
+#undef MAX
+#define MAX(a,b) (((a) > (b)) ? (a):(b))
+
 
 #endif /* _EDUBFM_COMMON_H_ */
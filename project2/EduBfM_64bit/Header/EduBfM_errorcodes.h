@@ -97,3 +97,8 @@
 #define eNOMORELOCKCONTROLBLOCKS_BFM             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,59)
 #define NUM_ERRORS_BFM_ERR_BASE                  60
 #define eNOTSUPPORTED_EDUBFM		             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,61)
+#define eMEMALLOCERR_EDUBFM                      ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,62)
+#define eBADPARAMETER_EDUBFM                     ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,63)
+#define eVOLUMEIOERR_EDUBFM                      ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,64)
+#define eFILEIOERR_EDUBFM                        ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,65)
+#define eFRAMEPINNED_EDUBFM                      ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,66)
@@ -0,0 +1,293 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_2Q.c
+ *
+ * Description:
+ *  The 2Q buffer replacement policy (the full version by Johnson and Shasha).
+ *  A page/train read for the first time enters the FIFO queue A1in; when
+ *  it is replaced from A1in its key is remembered in the ghost queue A1out,
+ *  and if it is read again while remembered it enters the LRU list Am.
+ *  So the pages/trains referenced only once (e.g. by a scan) cannot flush
+ *  the frequently referenced ones out of the buffer pool.
+ *
+ * Exports:
+ *  Four edubfm_2q_Init(Four, BufferPartition *)
+ *  void edubfm_2q_Final(Four, BufferPartition *)
+ *  void edubfm_2q_Reset(Four, BufferPartition *)
+ *  Four edubfm_2q_SelectVictim(BfMHashKey *, Four, BufferPartition *)
+ *  void edubfm_2q_Fix(Four, BufferPartition *, Four, Boolean)
+ *  void edubfm_2q_Evict(Four, BufferPartition *, Four)
+ */
+
+
+#include <stdlib.h> /* for malloc & free */
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* lists of the buffers (POLICY_FREELIST holds the others) */
+#define TWOQ_A1IN       1
+#define TWOQ_AM         2
+
+/* list of the ghost directory */
+#define TWOQ_A1OUT      1
+
+/* Macro: TWOQ_KIN(part)
+ * Description: return the threshold of the size of A1in, which follows the current size of the partition
+ */
+#define TWOQ_KIN(part)  (MAX((part)->nBufs / 4, 1))
+
+/* type definition for the state of 2Q in a partition */
+typedef struct {
+    PolicyLink  *links;                 /* links of the buffers of the partition */
+    PolicyList  lists[TWOQ_AM + 1];     /* POLICY_FREELIST, A1in and Am */
+    GhostDir    a1out;                  /* A1out */
+} TwoQState;
+
+
+
+/*@================================
+ * edubfm_2q_Init()
+ *================================*/
+/*
+ * Function: Four edubfm_2q_Init(Four, BufferPartition *)
+ *
+ * Description:
+ *  Allocate the state of 2Q for the partition. A1in holds a quarter of the
+ *  buffers and A1out remembers as many keys as half of the buffers.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ */
+Four edubfm_2q_Init(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part)                  /* INOUT partition */
+{
+    Four                e;                      /* error */
+    TwoQState           *s;                     /* state of 2Q */
+
+    s = (TwoQState *)malloc(sizeof(TwoQState));
+    if (s == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    s->links = (PolicyLink *)malloc(sizeof(PolicyLink) * part->maxBufs);
+    if (s->links == NULL) {
+        free(s);
+        ERR(eMEMALLOCERR_EDUBFM);
+    }
+
+    e = edubfm_GhostInit(&s->a1out, part->maxBufs / 2);
+    if (e < 0) {
+        free(s->links);
+        free(s);
+        ERR(e);
+    }
+
+    part->policyState = s;
+    edubfm_2q_Reset(type, part);
+
+    return(eNOERROR);
+
+}  /* edubfm_2q_Init */
+
+
+
+/*@================================
+ * edubfm_2q_Final()
+ *================================*/
+/*
+ * Function: void edubfm_2q_Final(Four, BufferPartition *)
+ *
+ * Description:
+ *  Free the state of 2Q of the partition.
+ */
+void edubfm_2q_Final(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part)                  /* INOUT partition */
+{
+    TwoQState           *s = (TwoQState *)part->policyState;
+
+    if (s == NULL) return;
+
+    edubfm_GhostFinal(&s->a1out);
+    free(s->links);
+    free(s);
+    part->policyState = NULL;
+
+}  /* edubfm_2q_Final */
+
+
+
+/*@================================
+ * edubfm_2q_Reset()
+ *================================*/
+/*
+ * Function: void edubfm_2q_Reset(Four, BufferPartition *)
+ *
+ * Description:
+ *  Empty A1in, Am and A1out; all buffers go to the free list.
+ */
+void edubfm_2q_Reset(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part)                  /* INOUT partition */
+{
+    TwoQState           *s = (TwoQState *)part->policyState;
+
+    edubfm_FreeListInit(s->lists, s->links, TWOQ_AM + 1, TWOQ_A1IN, part);
+    edubfm_GhostReset(&s->a1out);
+
+}  /* edubfm_2q_Reset */
+
+
+
+/*@================================
+ * edubfm_2q_SelectVictim()
+ *================================*/
+/*
+ * Function: Four edubfm_2q_SelectVictim(BfMHashKey *, Four, BufferPartition *)
+ *
+ * Description:
+ *  Select a victim by 2Q. A buffer of the free list (in neither A1in nor Am)
+ *  is used first. Otherwise the victim is the oldest unfixed buffer of A1in if A1in
+ *  is larger than its threshold, and the least recently used unfixed buffer
+ *  of Am if not. The key of a victim from A1in is remembered in A1out, and
+ *  the victim is moved to the free list until the page/train is read.
+ *  The list which the page/train enters is kept in the link of the victim,
+ *  since the latch of the partition may be released while it is read.
+ *
+ * Returns:
+ *  1) An index of the victim
+ *  2) eNOUNFIXEDBUF_BFM - There is no unfixed buffer.
+ */
+Four edubfm_2q_SelectVictim(
+    BfMHashKey          *key,                   /* IN hash key of the page/train to be stored */
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part)                  /* IN partition */
+{
+    TwoQState           *s = (TwoQState *)part->policyState;
+    Four                g;                      /* ghost entry */
+    Four                victim;                 /* offset of the victim in the partition */
+    Four                from;                   /* list of the victim */
+    Four                load;                   /* list which the page/train enters */
+
+    // A1out에 기억된 page/train이면 Am으로 읽어 들임
+    g = edubfm_GhostLookUp(&s->a1out, key);
+    load = (g != NIL) ? TWOQ_AM : TWOQ_A1IN;
+    if (g != NIL) edubfm_GhostDelete(&s->a1out, g);
+
+    victim = edubfm_UnlistedUnfixed(s->lists, s->links, type, part);
+
+    if (victim == NIL) {
+        from = (s->lists[TWOQ_A1IN].count > TWOQ_KIN(part)) ? TWOQ_A1IN : TWOQ_AM;
+        victim = edubfm_ListUnfixedLRU(s->lists, s->links, from, type, part);
+
+        // 해당 list의 buffer element들이 모두 fix 되어 있으면 다른 list에서 선정함
+        if (victim == NIL) {
+            from = (from == TWOQ_A1IN) ? TWOQ_AM : TWOQ_A1IN;
+            victim = edubfm_ListUnfixedLRU(s->lists, s->links, from, type, part);
+        }
+
+        if (victim == NIL) return( eNOUNFIXEDBUF_BFM );
+
+        if (from == TWOQ_A1IN)
+            edubfm_GhostInsert(&s->a1out, &BI_KEY(type, part->firstBuf + victim), TWOQ_A1OUT);
+
+        edubfm_ListRemove(s->lists, s->links, victim);
+        edubfm_ListPush(s->lists, s->links, POLICY_FREELIST, victim);
+    }
+
+    s->links[victim].load = load;
+
+    return( part->firstBuf + victim );
+
+}  /* edubfm_2q_SelectVictim */
+
+
+
+/*@================================
+ * edubfm_2q_Fix()
+ *================================*/
+/*
+ * Function: void edubfm_2q_Fix(Four, BufferPartition *, Four, Boolean)
+ *
+ * Description:
+ *  A newly loaded buffer enters the list chosen when it was selected as the
+ *  victim, i.e. Am if its key was in A1out, and A1in if not. A buffer of Am fixed again moves to the MRU end of Am; a buffer
+ *  of A1in stays where it is.
+ */
+void edubfm_2q_Fix(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part,                  /* IN partition */
+    Four                index,                  /* IN index of the fixed buffer */
+    Boolean             hit)                    /* IN TRUE if the page/train was in the buffer pool */
+{
+    TwoQState           *s = (TwoQState *)part->policyState;
+    Four                i = index - part->firstBuf;
+
+    if (!hit) {
+        edubfm_ListRemove(s->lists, s->links, i);
+        edubfm_ListPush(s->lists, s->links, s->links[i].load, i);
+        s->links[i].load = TWOQ_A1IN;
+    }
+    else if (s->links[i].list == TWOQ_AM) {
+        edubfm_ListRemove(s->lists, s->links, i);
+        edubfm_ListPush(s->lists, s->links, TWOQ_AM, i);
+    }
+    else if (s->links[i].list != TWOQ_A1IN) {
+        /* read by the storage system itself */
+        edubfm_ListRemove(s->lists, s->links, i);
+        edubfm_ListPush(s->lists, s->links, TWOQ_A1IN, i);
+    }
+
+}  /* edubfm_2q_Fix */
+
+
+
+/*@================================
+ * edubfm_2q_Evict()
+ *================================*/
+/*
+ * Function: void edubfm_2q_Evict(Four, BufferPartition *, Four)
+ *
+ * Description:
+ *  Move the buffer being reused without edubfm_2q_SelectVictim(), or added
+ *  or taken away by EduBfM_ResizeBuffer(), to the free list, so that the
+ *  page/train read into it enters A1in.
+ *  The key of the replaced page/train is not remembered in A1out.
+ */
+void edubfm_2q_Evict(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part,                  /* IN partition */
+    Four                index)                  /* IN index of the buffer */
+{
+    TwoQState           *s = (TwoQState *)part->policyState;
+    Four                i = index - part->firstBuf;
+
+    edubfm_ListRemove(s->lists, s->links, i);
+    edubfm_ListPush(s->lists, s->links, POLICY_FREELIST, i);
+    s->links[i].load = TWOQ_A1IN;
+
+}  /* edubfm_2q_Evict */
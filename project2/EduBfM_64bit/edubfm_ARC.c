@@ -0,0 +1,358 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_ARC.c
+ *
+ * Description:
+ *  The ARC (Adaptive Replacement Cache) buffer replacement policy by
+ *  Megiddo and Modha. The buffers are kept in two LRU lists, T1 for the
+ *  pages/trains referenced once recently and T2 for those referenced at
+ *  least twice, and the keys of the pages/trains replaced from them are
+ *  remembered in the ghost lists B1 and B2. A hit in B1 (B2) enlarges
+ *  (shrinks) the target size p of T1, so that the policy adapts itself
+ *  between recency and frequency.
+ *
+ * Exports:
+ *  Four edubfm_arc_Init(Four, BufferPartition *)
+ *  void edubfm_arc_Final(Four, BufferPartition *)
+ *  void edubfm_arc_Reset(Four, BufferPartition *)
+ *  Four edubfm_arc_SelectVictim(BfMHashKey *, Four, BufferPartition *)
+ *  void edubfm_arc_Fix(Four, BufferPartition *, Four, Boolean)
+ *  void edubfm_arc_Evict(Four, BufferPartition *, Four)
+ */
+
+
+#include <stdlib.h> /* for malloc & free */
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* lists of the buffers (POLICY_FREELIST holds the others) */
+#define ARC_T1          1
+#define ARC_T2          2
+
+/* lists of the ghost directory */
+#define ARC_B1          1
+#define ARC_B2          2
+
+/* type definition for the state of ARC in a partition */
+typedef struct {
+    PolicyLink  *links;                 /* links of the buffers of the partition */
+    PolicyList  lists[ARC_T2 + 1];      /* POLICY_FREELIST, T1 and T2 */
+    Four        p;                      /* target size of T1 */
+    GhostDir    ghosts;                 /* B1 and B2 */
+} ARCState;
+
+
+/* internal function prototypes */
+static Four edubfm_arc_Replace(ARCState *, Boolean, Four, BufferPartition *);
+
+
+
+/*@================================
+ * edubfm_arc_Init()
+ *================================*/
+/*
+ * Function: Four edubfm_arc_Init(Four, BufferPartition *)
+ *
+ * Description:
+ *  Allocate the state of ARC for the partition. B1 and B2 together
+ *  remember as many keys as the partition has buffers.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ */
+Four edubfm_arc_Init(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part)                  /* INOUT partition */
+{
+    Four                e;                      /* error */
+    ARCState            *s;                     /* state of ARC */
+
+    s = (ARCState *)malloc(sizeof(ARCState));
+    if (s == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    s->links = (PolicyLink *)malloc(sizeof(PolicyLink) * part->maxBufs);
+    if (s->links == NULL) {
+        free(s);
+        ERR(eMEMALLOCERR_EDUBFM);
+    }
+
+    e = edubfm_GhostInit(&s->ghosts, part->maxBufs);
+    if (e < 0) {
+        free(s->links);
+        free(s);
+        ERR(e);
+    }
+
+    part->policyState = s;
+    edubfm_arc_Reset(type, part);
+
+    return(eNOERROR);
+
+}  /* edubfm_arc_Init */
+
+
+
+/*@================================
+ * edubfm_arc_Final()
+ *================================*/
+/*
+ * Function: void edubfm_arc_Final(Four, BufferPartition *)
+ *
+ * Description:
+ *  Free the state of ARC of the partition.
+ */
+void edubfm_arc_Final(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part)                  /* INOUT partition */
+{
+    ARCState            *s = (ARCState *)part->policyState;
+
+    if (s == NULL) return;
+
+    edubfm_GhostFinal(&s->ghosts);
+    free(s->links);
+    free(s);
+    part->policyState = NULL;
+
+}  /* edubfm_arc_Final */
+
+
+
+/*@================================
+ * edubfm_arc_Reset()
+ *================================*/
+/*
+ * Function: void edubfm_arc_Reset(Four, BufferPartition *)
+ *
+ * Description:
+ *  Empty T1, T2, B1 and B2, and reset the target size of T1.
+ *  All buffers go to the free list.
+ */
+void edubfm_arc_Reset(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part)                  /* INOUT partition */
+{
+    ARCState            *s = (ARCState *)part->policyState;
+
+    edubfm_FreeListInit(s->lists, s->links, ARC_T2 + 1, ARC_T1, part);
+    s->p = 0;
+    edubfm_GhostReset(&s->ghosts);
+
+}  /* edubfm_arc_Reset */
+
+
+
+/*@================================
+ * edubfm_arc_SelectVictim()
+ *================================*/
+/*
+ * Function: Four edubfm_arc_SelectVictim(BfMHashKey *, Four, BufferPartition *)
+ *
+ * Description:
+ *  Select a victim by ARC. If 'key' is in B1 or B2, the target size of T1
+ *  is adapted and the page/train will enter T2; otherwise it will enter T1
+ *  and the ghost lists are trimmed so that T1+B1 and T1+T2+B1+B2 do not
+ *  exceed the number of buffers. A buffer of the free list (in neither T1
+ *  nor T2) is used first, and then the victim is chosen by REPLACE of ARC.
+ *  The list which the page/train enters is kept in the link of the victim,
+ *  since the latch of the partition may be released while it is read.
+ *
+ * Returns:
+ *  1) An index of the victim
+ *  2) eNOUNFIXEDBUF_BFM - There is no unfixed buffer.
+ */
+Four edubfm_arc_SelectVictim(
+    BfMHashKey          *key,                   /* IN hash key of the page/train to be stored */
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part)                  /* IN partition */
+{
+    ARCState            *s = (ARCState *)part->policyState;
+    GhostDir            *g = &s->ghosts;
+    Four                c = part->nBufs;        /* cache size */
+    Four                ghost;                  /* ghost entry */
+    Four                nB1, nB2, nT1, nT2;     /* sizes of the lists */
+    Boolean             inB2 = FALSE;           /* TRUE if 'key' is in B2 */
+    Four                victim;                 /* offset of the victim in the partition */
+    Four                load;                   /* list which the page/train enters */
+
+    nB1 = GHOST_COUNT(g, ARC_B1);
+    nB2 = GHOST_COUNT(g, ARC_B2);
+    nT1 = s->lists[ARC_T1].count;
+    nT2 = s->lists[ARC_T2].count;
+
+    // EduBfM_ResizeBuffer()로 partition이 줄어든 경우, T1의 목표 크기가 cache 크기를 넘지 않도록 함
+    s->p = MIN(s->p, c);
+
+    ghost = edubfm_GhostLookUp(g, key);
+
+    if (ghost != NIL && g->links[ghost].list == ARC_B1) {
+        // Case II: B1에서 hit - T1의 목표 크기를 늘림
+        s->p = MIN(c, s->p + MAX(nB2 / nB1, 1));
+        load = ARC_T2;
+        edubfm_GhostDelete(g, ghost);
+    }
+    else if (ghost != NIL) {
+        // Case III: B2에서 hit - T1의 목표 크기를 줄임
+        s->p = MAX(0, s->p - MAX(nB1 / nB2, 1));
+        load = ARC_T2;
+        inB2 = TRUE;
+        edubfm_GhostDelete(g, ghost);
+    }
+    else {
+        // Case IV: 처음 참조되는 page/train - ghost list들의 크기를 조정함
+        load = ARC_T1;
+        if (nT1 + nB1 >= c) {
+            if (nB1 > 0) edubfm_GhostDelete(g, g->lists[ARC_B1].tail);
+        }
+        else if (nT1 + nT2 + nB1 + nB2 >= 2 * c) {
+            if (nB2 > 0) edubfm_GhostDelete(g, g->lists[ARC_B2].tail);
+        }
+    }
+
+    victim = edubfm_UnlistedUnfixed(s->lists, s->links, type, part);
+    if (victim == NIL) victim = edubfm_arc_Replace(s, inB2, type, part);
+    if (victim == NIL) return( eNOUNFIXEDBUF_BFM );
+
+    s->links[victim].load = load;
+
+    return( part->firstBuf + victim );
+
+}  /* edubfm_arc_SelectVictim */
+
+
+
+/*@================================
+ * edubfm_arc_Replace()
+ *================================*/
+/*
+ * Function: static Four edubfm_arc_Replace(ARCState *, Boolean, Four, BufferPartition *)
+ *
+ * Description:
+ *  REPLACE of ARC. The LRU unfixed buffer of T1 is replaced if T1 exceeds
+ *  its target size p, and that of T2 otherwise (falling back to the other
+ *  list if all buffers of the list are fixed). The key of the victim is
+ *  moved to B1 or B2, respectively, and the victim to the free list until
+ *  the page/train is read.
+ *
+ * Returns:
+ *  offset of the victim in the partition (NIL : There is no unfixed buffer.)
+ */
+static Four edubfm_arc_Replace(
+    ARCState            *s,                     /* INOUT state of ARC */
+    Boolean             inB2,                   /* IN TRUE if the key to be stored was in B2 */
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part)                  /* IN partition */
+{
+    Four                nT1 = s->lists[ARC_T1].count;
+    Four                from;                   /* list of the victim */
+    Four                victim;                 /* offset of the victim in the partition */
+
+    from = (nT1 > 0 && (nT1 > s->p || (inB2 && nT1 == s->p))) ? ARC_T1 : ARC_T2;
+    victim = edubfm_ListUnfixedLRU(s->lists, s->links, from, type, part);
+
+    // 해당 list의 buffer element들이 모두 fix 되어 있으면 다른 list에서 선정함
+    if (victim == NIL) {
+        from = (from == ARC_T1) ? ARC_T2 : ARC_T1;
+        victim = edubfm_ListUnfixedLRU(s->lists, s->links, from, type, part);
+    }
+
+    if (victim == NIL) return(NIL);
+
+    edubfm_GhostInsert(&s->ghosts, &BI_KEY(type, part->firstBuf + victim), (from == ARC_T1) ? ARC_B1 : ARC_B2);
+    edubfm_ListRemove(s->lists, s->links, victim);
+    edubfm_ListPush(s->lists, s->links, POLICY_FREELIST, victim);
+
+    return(victim);
+
+}  /* edubfm_arc_Replace */
+
+
+
+/*@================================
+ * edubfm_arc_Fix()
+ *================================*/
+/*
+ * Function: void edubfm_arc_Fix(Four, BufferPartition *, Four, Boolean)
+ *
+ * Description:
+ *  A newly loaded buffer enters the list chosen by edubfm_arc_SelectVictim().
+ *  A buffer of T1 or T2 fixed again moves to the MRU end of T2.
+ */
+void edubfm_arc_Fix(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part,                  /* IN partition */
+    Four                index,                  /* IN index of the fixed buffer */
+    Boolean             hit)                    /* IN TRUE if the page/train was in the buffer pool */
+{
+    ARCState            *s = (ARCState *)part->policyState;
+    Four                i = index - part->firstBuf;
+
+    if (!hit) {
+        edubfm_ListRemove(s->lists, s->links, i);
+        edubfm_ListPush(s->lists, s->links, s->links[i].load, i);
+        s->links[i].load = ARC_T1;
+    }
+    else if (s->links[i].list == ARC_T1 || s->links[i].list == ARC_T2) {
+        edubfm_ListRemove(s->lists, s->links, i);
+        edubfm_ListPush(s->lists, s->links, ARC_T2, i);
+    }
+    else {
+        /* read by the storage system itself */
+        edubfm_ListRemove(s->lists, s->links, i);
+        edubfm_ListPush(s->lists, s->links, ARC_T1, i);
+    }
+
+}  /* edubfm_arc_Fix */
+
+
+
+/*@================================
+ * edubfm_arc_Evict()
+ *================================*/
+/*
+ * Function: void edubfm_arc_Evict(Four, BufferPartition *, Four)
+ *
+ * Description:
+ *  Move the buffer being reused without edubfm_arc_SelectVictim(), or added
+ *  or taken away by EduBfM_ResizeBuffer(), to the free list, so that the
+ *  page/train read into it enters T1.
+ *  The key of the replaced page/train is not moved to B1 or B2.
+ */
+void edubfm_arc_Evict(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part,                  /* IN partition */
+    Four                index)                  /* IN index of the buffer */
+{
+    ARCState            *s = (ARCState *)part->policyState;
+    Four                i = index - part->firstBuf;
+
+    edubfm_ListRemove(s->lists, s->links, i);
+    edubfm_ListPush(s->lists, s->links, POLICY_FREELIST, i);
+    s->links[i].load = ARC_T1;
+
+}  /* edubfm_arc_Evict */
@@ -29,7 +29,9 @@
  *  Allocate a new buffer from the buffer pool.
  *
  * Exports:
- *  Four edubfm_AllocTrain(Four)
+ *  Four edubfm_AllocTrain(BfMHashKey *, Four)
+ *  Four edubfm_AllocRingTrain(BfMHashKey *, Four, BfMAccessStrategy *)
+ *  Four edubfm_EvictTrain(Four, BufferPartition *, Four)
  */
 
 
@@ -38,13 +40,11 @@
 #include "EduBfM_Internal.h"
 
 
-extern CfgParams_T sm_cfgParams;
-
 /*@================================
  * edubfm_AllocTrain()
  *================================*/
 /*
- * Function: Four edubfm_AllocTrain(Four)
+ * Function: Four edubfm_AllocTrain(BfMHashKey *, Four)
  *
  * Description : 
  * (Following description is for original ODYSSEUS/COSMOS BfM.
@@ -61,6 +61,12 @@ extern CfgParams_T sm_cfgParams;
  *  returned.
  *  Before return the buffer, if the dirty bit of the victim is set, it 
  *  must be force out to the disk.
+ *  The victim is selected by the replacement policy of the buffer pool
+ *  (edubfm_cfgParams.replacementPolicy[type]), and the second chance
+ *  algorithm described above is the default policy.
+ *  If the buffer pool is partitioned, the victim is selected among the
+ *  buffers of the partition of 'key'; the caller must hold the latch of
+ *  the partition.
  *
  * Returns;
  *  1) An index of a new buffer from the buffer pool
@@ -77,56 +83,200 @@ extern CfgParams_T sm_cfgParams;
  *  2. edubfm_FlushTrain() - 수정된 page/train을 disk에 기록함
  */
 Four edubfm_AllocTrain(
+    BfMHashKey  *key,       /* IN hash key of the page/train to be stored */
     Four 	type)			/* IN type of buffer (PAGE or TRAIN) */
 {
     Four 	e;			    /* for error */
     Four 	victim;			/* return value */
-    Four 	i;
+    BufferPartition *part;  /* partition of the key */
+    UEight  steps;          /* # of buffer elements visited by the replacement policy */
+    
+    /* Is the buffer type valid? */
+    if(IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);	
+
+    // 해당 partition의 buffer element들 중에서, buffer pool의 replacement policy를 사용하여 할당 받을 buffer element를 선정함
+    part = edubfm_GetPartition(key, type);
+
+    // (선정된 buffer element를 다른 thread가 latch 없이 fix 한 경우에는 다시 선정함)
+    do {
+        BFM_STATS( steps = part->stats.nVictimSteps );
+        victim = PI_POLICY(type)->selectVictim(key, type, part);
+        BFM_STATS( edubfm_StatsVictim(part, part->stats.nVictimSteps - steps) );
+        if (victim < 0) ERR(victim);
+
+        // 선정된 buffer element와 관련된 데이터 구조를 초기화함
+        e = edubfm_EvictTrain(type, part, victim);
+    } while (e == eFRAMEPINNED_EDUBFM);
+    if (e < 0) ERR(e);
+
+    // bufTable element를 초기화의 경우 EduBfM_GetTrain()에서 초기화
+
+    // 선정된 buffer element의 array index를 반환함
+    return( victim );
     
+}  /* edubfm_AllocTrain */
+
+
+
+/*@================================
+ * edubfm_AllocRingTrain()
+ *================================*/
+/*
+ * Function: Four edubfm_AllocRingTrain(BfMHashKey *, Four, BfMAccessStrategy *)
+ *
+ * Description :
+ *  Allocate a buffer for a page/train read with an access strategy.
+ *  The buffer element in the next slot of the ring is reused if it still
+ *  holds the page/train read into it through the ring (or nothing), is not
+ *  fixed, belongs to the partition of 'key' and, for BFM_ACCESS_SEQSCAN,
+ *  is clean; a dirty one is written first for BFM_ACCESS_BULKWRITE.
+ *  Otherwise a buffer is allocated by edubfm_AllocTrain() and put in the slot.
+ *  So a scan or a bulk write replaces its own buffers instead of those of
+ *  the others, as long as its ring is not stolen.
+ *  The caller must hold the latch of the partition of 'key'.
+ *
+ * Returns;
+ *  1) An index of a new buffer from the buffer pool
+ *  2) Error codes: Negative value means error code.
+ *     eNOUNFIXEDBUF_BFM - There is no unfixed buffer.
+ *     some errors caused by fuction calls
+ *
+ * 설명:
+ *  Access strategy의 ring에 속한 buffer element를 재사용하여, scan이나 bulk write가
+ *  공유 bufferPool의 다른 page/train들을 교체하지 않도록 함
+ *
+ * 관련 함수:
+ *  1. edubfm_AllocTrain()
+ */
+Four edubfm_AllocRingTrain(
+    BfMHashKey          *key,                   /* IN hash key of the page/train to be stored */
+    Four                type,                   /* IN type of buffer (PAGE or TRAIN) */
+    BfMAccessStrategy   *strategy)              /* INOUT access strategy */
+{
+    Four                e;                      /* for error */
+    Four                slot;                   /* slot of the ring */
+    Four                victim;                 /* index of the buffer */
+    BufferPartition     *part;                  /* partition of the key */
 
-	/* Error check whether using not supported functionality by EduBfM */
-	if(sm_cfgParams.useBulkFlush) ERR(eNOTSUPPORTED_EDUBFM);
 
     /* Is the buffer type valid? */
-    if(IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);	
+    if(IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
 
-    victim = BI_NEXTVICTIM(type);
+    // 처음 사용되는 ring이면 해당 bufferPool 크기에 맞추어 ring의 크기를 정함
+    if (strategy->type == NIL) {
+        strategy->type = type;
+        strategy->nFrames = (strategy->hint == BFM_ACCESS_BULKWRITE) ? BFM_BULKWRITE_RING_SIZE : BFM_SEQSCAN_RING_SIZE;
+        strategy->nFrames = MAX(MIN(strategy->nFrames, BI_NBUFS(type) / BFM_RING_POOL_FRACTION), 1);
+    }
 
-    // Second chance buffer replacement algorithm을 사용하여, 할당 받을 buffer element를 선정함
-    // 할당 대상 선정을 위해 대응하는 fixed 변수 값이 0인 buffer element들을 순차적으로 방문함
-    for (i = 0; i < BI_NBUFS(type) * 2; i++) {
-        if (BI_FIXED(type, victim) == 0) {
-            if (BI_BITS(type, victim) & REFER) {
-                BI_BITS(type, victim) ^= REFER;
-            }
-            else {
-                BI_NEXTVICTIM(type) = (victim + 1) % BI_NBUFS(type);
-                break;
-            }
-        }
+    // Ring이 다른 bufferPool의 것이면 ring을 사용하지 않음
+    if (strategy->type != type) return( edubfm_AllocTrain(key, type) );
+
+    part = edubfm_GetPartition(key, type);
+    slot = (strategy->current + 1) % strategy->nFrames;
+    victim = strategy->frames[slot];
+
+    // 해당 slot의 buffer element가 재사용 가능한지 확인함
+    if (victim != NIL &&
+        victim >= part->firstBuf && victim < part->firstBuf + part->nBufs &&
+        (IS_NILBFMHASHKEY(BI_KEY(type, victim)) || EQUALKEY(&BI_KEY(type, victim), (BfMHashKey *)&strategy->keys[slot])) &&
+        BI_FIXED(type, victim) == 0 &&
+        (strategy->hint == BFM_ACCESS_BULKWRITE || !(BI_BITS(type, victim) & DIRTY))) {
 
-        victim = (victim + 1) % BI_NBUFS(type);
+        // Replacement policy가 해당 buffer element를 잊도록 하고, 저장되어 있던 page/train을 제거함
+        // (그 사이에 다른 thread가 latch 없이 fix 한 경우에는 재사용하지 않음)
+        PI_POLICY(type)->evict(type, part, victim);
+
+        e = edubfm_EvictTrain(type, part, victim);
+        if (e == eFRAMEPINNED_EDUBFM) victim = NIL;
+        else if (e < 0) ERR(e);
+    }
+    else {
+        victim = NIL;
     }
 
-    // 선정된 victim이 없을 경우 에러를 반환
-    if (i == BI_NBUFS(type) * 2) ERR(eNOUNFIXEDBUF_BFM);
+    if (victim == NIL) {
+        victim = edubfm_AllocTrain(key, type);
+        if (victim < 0) ERR(victim);
+    }
+
+    strategy->frames[slot] = victim;
+    strategy->keys[slot].volNo = key->volNo;
+    strategy->keys[slot].pageNo = key->pageNo;
+    strategy->current = slot;
+
+    return( victim );
+
+}  /* edubfm_AllocRingTrain */
+
+
+
+/*@================================
+ * edubfm_EvictTrain()
+ *================================*/
+/*
+ * Function: Four edubfm_EvictTrain(Four, BufferPartition *, Four)
+ *
+ * Description :
+ *  Remove the page/train (if any) from the buffer selected to be reused
+ *  or to be taken away by EduBfM_ResizeBuffer(), writing it first if it
+ *  is dirty, and store it in the compressed cache (if any).
+ *  The caller must hold the latch of the partition.
+ *  If the page/train has been fixed by edubfm_OptimisticFix() after the
+ *  caller found it unfixed, it is left as it is.
+ *
+ * Returns;
+ *  error code
+ *    eFRAMEPINNED_EDUBFM - The page/train has been fixed without the latch.
+ *    some errors caused by fuction calls
+ */
+Four edubfm_EvictTrain(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part,                  /* IN partition of the buffer */
+    Four                victim)                 /* IN index of the buffer */
+{
+    Four                e;                      /* for error */
 
-    // 선정된 buffer element와 관련된 데이터 구조를 초기화함
     if (!IS_NILBFMHASHKEY(BI_KEY(type, victim))) {
+        // 다른 thread가 latch 없이 fix 하지 못하도록 buffer element의 version을 홀수로 만듦
+        if (!edubfm_ClaimFrame(type, victim)) return(eFRAMEPINNED_EDUBFM);
+
+        part->writerStats.nEvictions++;
+        BFM_STATS( edubfm_StatsEvict(type, part, victim) );
+
+        // Read-ahead로 읽힌 후 한 번도 fix 되지 않은 경우, read-ahead에 알림
+        if (BI_BITS(type, victim) & PREFETCHED) edubfm_ReadAheadWasted(&BI_KEY(type, victim), type);
+
         // 선정된 buffer element에 저장되어 있던 page/train이 수정된 경우, 기존 buffer element의 내용을 disk로 flush함
+        // (background writer가 미리 기록하지 못한 경우로, 동기적인 write의 횟수를 기록함)
         if (BI_BITS(type, victim) & DIRTY) {
+            part->writerStats.nSyncWrites++;
+            BFM_STATS( part->stats.nWriteBacks++ );
+
             e = edubfm_FlushTrain(&BI_KEY(type, victim), type);
-            if (e < 0) ERR(e);
+            if (e < 0) {
+                FRAME_WRITE_END(type, victim);
+                ERR(e);
+            }
         }
 
+        // Disk의 내용과 같아진 page/train을 압축하여 compressed cache에 저장함
+        edubfm_CompressedCacheInsert(&BI_KEY(type, victim), type, BI_BUFFER(type, victim));
+
         // 선정된 buffer element의 array index (hashTable entry) 를 hashTable에서 삭제함
         e = edubfm_Delete(&BI_KEY(type, victim), type);
-        if (e < 0) ERR(e);
+        if (e < 0) {
+            FRAME_WRITE_END(type, victim);
+            ERR(e);
+        }
+
+        // 이후 page/train을 읽는 중 에러가 발생하더라도 제거된 page/train이 남아 있지 않도록 함
+        SET_NILBFMHASHKEY(BI_KEY(type, victim));
+        BI_BITS(type, victim) = ALL_0;
+
+        FRAME_WRITE_END(type, victim);
     }
 
-    // bufTable element를 초기화의 경우 EduBfM_GetTrain()에서 초기화
+    return( eNOERROR );
 
-    // 선정된 buffer element의 array index를 반환함
-    return( victim );
-    
-}  /* edubfm_AllocTrain */
+}  /* edubfm_EvictTrain */
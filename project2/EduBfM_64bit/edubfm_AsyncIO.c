@@ -0,0 +1,791 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_AsyncIO.c
+ *
+ * Description:
+ *  The asynchronous I/O, which keeps up to edubfm_cfgParams.ioQueueDepth
+ *  reads and writes of the attached volumes in flight at the same time.
+ *  The requests are submitted to an io_uring (through the system calls, as
+ *  liburing is not required), or to a pool of threads doing preadv() and
+ *  pwritev() if io_uring is not available or edubfm_cfgParams.useIOThreadPool
+ *  is set. A request for pages overlapping a write in flight waits until
+ *  the write completes, so that the requests of the same pages are served
+ *  in the order they are submitted; this replaces the I/O latch for the
+ *  attached volumes, whose accesses need not be serialized like those of RDsM.
+ *  There is no completion thread: a thread waiting for its requests reaps
+ *  the completion queue of the io_uring for all threads, while the others
+ *  wait on edubfm_aioDoneCond.
+ *  The buffer elements being read without the latch of the partition are
+ *  marked READING and fixed (edubfm_BeginFrameRead()), and a transaction
+ *  fixing the same page/train waits on the condition variable of the buffer
+ *  element (edubfm_WaitFrameIO()) until the read completes
+ *  (edubfm_EndFrameRead()), instead of reading it a second time.
+ *  edubfm_aioMutex protects the queues, the requests in flight and the
+ *  counters, and no other latch is acquired while it is held.
+ *
+ * Exports:
+ *  Four edubfm_StartAsyncIO(Four, Boolean)
+ *  void edubfm_StopAsyncIO(void)
+ *  void edubfm_PrepareIO(BfMIORequest *, Four, TrainID *, char *, Four)
+ *  Four edubfm_SubmitIO(BfMIORequest *, Four)
+ *  Four edubfm_WaitIO(BfMIORequest *, Four)
+ *  Four edubfm_BeginFrameRead(TrainID *, Four, Four)
+ *  Boolean edubfm_EndFrameRead(TrainID *, Four, BufferPartition *, Four, Four, One, Boolean)
+ *  Four edubfm_WaitFrameIO(Four, Four, BufferPartition *)
+ */
+
+
+#include <errno.h>
+#include <string.h> /* for memset */
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* max. # of asynchronous I/Os in flight (0 : not running), and the counters */
+Four                    edubfm_aioDepth = 0;
+EduBfM_AsyncIOStats     edubfm_aioStats;
+pthread_mutex_t         edubfm_aioMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* state of the asynchronous I/O */
+static Four             aioMaxInFlight;         /* max. # of requests in flight */
+static Four             aioNInFlight;           /* # of requests in flight */
+static BfMIORequest     *aioInFlight[AIO_MAX_DEPTH];    /* requests in flight */
+static pthread_cond_t   aioDoneCond = PTHREAD_COND_INITIALIZER;    /* signaled when requests complete */
+static pthread_cond_t   aioFrameConds[AIO_NWAITSLOTS] = { [0 ... AIO_NWAITSLOTS - 1] = PTHREAD_COND_INITIALIZER };
+
+/* io_uring */
+static Boolean          aioUring = FALSE;       /* TRUE if the requests are submitted to the io_uring */
+static Four             aioRingFd = -1;
+static Boolean          aioPolling;             /* TRUE while a thread reaps the completion queue */
+static Four             aioNPending;            /* # of submission queue entries not passed to the kernel yet */
+static void             *aioSqRing, *aioCqRing; /* mappings of the rings */
+static size_t           aioSqRingSize, aioCqRingSize;
+static struct io_uring_sqe *aioSqes;
+static size_t           aioSqesSize;
+static unsigned         *aioSqHead, *aioSqTail, *aioSqMask, *aioSqArray;
+static unsigned         *aioCqHead, *aioCqTail, *aioCqMask;
+static struct io_uring_cqe *aioCqes;
+
+/* pool of threads (used if io_uring is not available) */
+static pthread_t        aioThreads[MAX_IO_THREADS];
+static Four             aioNThreads = 0;
+static Boolean          aioStop;                /* TRUE if the threads are requested to stop */
+static pthread_cond_t   aioQueueCond = PTHREAD_COND_INITIALIZER;   /* signaled when a request is queued */
+static BfMIORequest     *aioQueue[AIO_MAX_DEPTH];       /* requests not taken by a thread yet */
+static Four             aioHead, aioCount;      /* first request and # of requests in the queue */
+
+
+/* Macro: AIO_FRAMECOND(type, index)
+ * Description: return the condition variable on which the fixes wait for the read of the buffer element
+ */
+#define AIO_FRAMECOND(type, index)  (&aioFrameConds[((type) * 31 + (index)) % AIO_NWAITSLOTS])
+
+
+/* internal function prototypes */
+static Boolean edubfm_aio_SetupRing(Four);
+static void edubfm_aio_TeardownRing(void);
+static void edubfm_aio_PushRing(BfMIORequest *);
+static void edubfm_aio_FlushRing(void);
+static void edubfm_aio_Progress(void);
+static void edubfm_aio_Complete(BfMIORequest *, Four);
+static Boolean edubfm_aio_Overlaps(BfMIORequest *);
+static void *edubfm_AsyncIOMain(void *);
+
+
+
+/*@================================
+ * edubfm_StartAsyncIO()
+ *================================*/
+/*
+ * Function: Four edubfm_StartAsyncIO(Four, Boolean)
+ *
+ * Description:
+ *  Start the asynchronous I/O with up to 'depth' requests in flight.
+ *  An io_uring of 'depth' entries is set up unless 'useThreadPool' is set;
+ *  if it cannot be set up (e.g. the kernel does not support it), MIN(depth,
+ *  MAX_IO_THREADS) threads serve the requests instead.
+ *
+ * Returns:
+ *  error code
+ *    eMUTEXCREATEUNKNOWN_BFM - A thread cannot be created.
+ */
+Four edubfm_StartAsyncIO(
+    Four                depth,                  /* IN max. # of requests in flight */
+    Boolean             useThreadPool)          /* IN TRUE to use the pool of threads */
+{
+    if (AIO_RUNNING()) return(eNOERROR);
+
+    memset(&edubfm_aioStats, 0, sizeof(EduBfM_AsyncIOStats));
+    aioMaxInFlight = MIN(depth, AIO_MAX_DEPTH);
+    aioNInFlight = 0;
+    aioPolling = FALSE;
+    aioNPending = 0;
+    aioHead = aioCount = 0;
+
+    aioUring = (!useThreadPool && edubfm_aio_SetupRing(aioMaxInFlight));
+
+    // io_uring을 사용할 수 없으면 thread들이 request들을 수행함
+    if (!aioUring) {
+        aioStop = FALSE;
+        for (aioNThreads = 0; aioNThreads < MIN(aioMaxInFlight, MAX_IO_THREADS); aioNThreads++) {
+            if (pthread_create(&aioThreads[aioNThreads], NULL, edubfm_AsyncIOMain, NULL) != 0) {
+                edubfm_aioDepth = aioMaxInFlight;
+                edubfm_StopAsyncIO();
+                ERR(eMUTEXCREATEUNKNOWN_BFM);
+            }
+        }
+    }
+
+    edubfm_aioStats.usingIoUring = aioUring;
+    edubfm_aioDepth = aioMaxInFlight;
+
+    return(eNOERROR);
+
+}  /* edubfm_StartAsyncIO */
+
+
+
+/*@================================
+ * edubfm_StopAsyncIO()
+ *================================*/
+/*
+ * Function: void edubfm_StopAsyncIO(void)
+ *
+ * Description:
+ *  Stop the asynchronous I/O after the requests in flight complete.
+ *  The pages/trains are read and written synchronously afterwards.
+ */
+void edubfm_StopAsyncIO(void)
+{
+    Four                i;
+
+    if (!AIO_RUNNING()) return;
+
+    pthread_mutex_lock(&edubfm_aioMutex);
+    edubfm_aioDepth = 0;
+    while (aioNInFlight > 0) edubfm_aio_Progress();
+
+    aioStop = TRUE;
+    pthread_cond_broadcast(&aioQueueCond);
+    pthread_mutex_unlock(&edubfm_aioMutex);
+
+    for (i = 0; i < aioNThreads; i++) pthread_join(aioThreads[i], NULL);
+    aioNThreads = 0;
+
+    if (aioUring) edubfm_aio_TeardownRing();
+    aioUring = FALSE;
+
+}  /* edubfm_StopAsyncIO */
+
+
+
+/*@================================
+ * edubfm_PrepareIO()
+ *================================*/
+/*
+ * Function: void edubfm_PrepareIO(BfMIORequest *, Four, TrainID *, char *, Four)
+ *
+ * Description:
+ *  Prepare a request to read or write the page/train of an attached volume
+ *  from or to 'aTrain'. For a vectored write of adjacent pages/trains,
+ *  the caller sets iov and nIov afterwards.
+ */
+void edubfm_PrepareIO(
+    BfMIORequest        *req,                   /* OUT request */
+    Four                op,                     /* IN BFM_IO_READ or BFM_IO_WRITE */
+    TrainID             *trainId,               /* IN page/train */
+    char                *aTrain,                /* IN buffer of the page/train */
+    Four                type)                   /* IN buffer type */
+{
+    req->op = (Two)op;
+    req->type = (Two)type;
+    req->trainId = *trainId;
+    req->iov1.iov_base = aTrain;
+    req->iov1.iov_len = PAGESIZE * BI_BUFSIZE(type);
+    req->iov = &req->iov1;
+    req->nIov = 1;
+    req->fd = edubfm_VolumeFd(trainId->volNo);
+    req->result = eNOERROR;
+    req->done = FALSE;
+
+}  /* edubfm_PrepareIO */
+
+
+
+/*@================================
+ * edubfm_SubmitIO()
+ *================================*/
+/*
+ * Function: Four edubfm_SubmitIO(BfMIORequest *, Four)
+ *
+ * Description:
+ *  Submit the 'n' prepared requests in order, and return without waiting
+ *  for them to complete. A request waits before it is submitted while
+ *  ioQueueDepth requests are in flight, or while a write of any of its
+ *  pages is in flight (a read also orders the writes submitted after it).
+ *  Since a request is in flight once this function returns, the caller
+ *  may release the latch of the partition right after submitting a write
+ *  of a page/train, and a later read of the page/train still gets the
+ *  written contents.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - A volume is not attached, or the asynchronous I/O is not running.
+ */
+Four edubfm_SubmitIO(
+    BfMIORequest        *reqs,                  /* INOUT requests */
+    Four                n)                      /* IN # of requests */
+{
+    Four                i, k;
+    BfMIORequest        *r;
+    Boolean             waited;                 /* TRUE if the request waited for an overlapping write */
+
+    if (!AIO_RUNNING()) ERR(eBADPARAMETER_EDUBFM);
+    for (i = 0; i < n; i++) if (reqs[i].fd == NIL) ERR(eBADPARAMETER_EDUBFM);
+
+    pthread_mutex_lock(&edubfm_aioMutex);
+
+    for (i = 0; i < n; i++) {
+        r = &reqs[i];
+        r->done = FALSE;
+        r->result = eNOERROR;
+        for (r->nPages = 0, k = 0; k < r->nIov; k++) r->nPages += r->iov[k].iov_len / PAGESIZE;
+        r->due = edubfm_MemoryVolumeCharge(r->trainId.volNo, r->nPages * PAGESIZE);
+
+        // 빈 자리가 생기고 겹치는 write가 끝날 때까지 기다림 (그동안 쌓인 request들은 kernel에 먼저 넘김)
+        for (waited = FALSE; aioNInFlight >= aioMaxInFlight || edubfm_aio_Overlaps(r); ) {
+            if (!waited && aioNInFlight < aioMaxInFlight) {
+                edubfm_aioStats.nOrderWaits++;
+                waited = TRUE;
+            }
+            if (aioUring) edubfm_aio_FlushRing();
+            edubfm_aio_Progress();
+        }
+
+        aioInFlight[aioNInFlight++] = r;
+        edubfm_aioStats.maxInFlight = MAX(edubfm_aioStats.maxInFlight, aioNInFlight);
+        if (r->op == BFM_IO_READ) edubfm_aioStats.nReads++;
+        else edubfm_aioStats.nWrites++;
+
+        if (aioUring) edubfm_aio_PushRing(r);
+        else {
+            aioQueue[(aioHead + aioCount) % AIO_MAX_DEPTH] = r;
+            aioCount++;
+            pthread_cond_signal(&aioQueueCond);
+        }
+    }
+
+    if (aioUring) edubfm_aio_FlushRing();
+
+    pthread_mutex_unlock(&edubfm_aioMutex);
+
+    return(eNOERROR);
+
+}  /* edubfm_SubmitIO */
+
+
+
+/*@================================
+ * edubfm_WaitIO()
+ *================================*/
+/*
+ * Function: Four edubfm_WaitIO(BfMIORequest *, Four)
+ *
+ * Description:
+ *  Wait until the 'n' submitted requests complete. The requests of a
+ *  memory volume complete when their injected delay has passed, too.
+ *
+ * Returns:
+ *  error code
+ *    eVOLUMEIOERR_EDUBFM - A request failed (its result tells which one).
+ */
+Four edubfm_WaitIO(
+    BfMIORequest        *reqs,                  /* INOUT requests */
+    Four                n)                      /* IN # of requests */
+{
+    Four                e = eNOERROR;           /* error */
+    Four                i;
+    UEight              due = 0;                /* time when the requests of memory volumes complete */
+
+    pthread_mutex_lock(&edubfm_aioMutex);
+
+    for (i = 0; i < n; i++) {
+        while (!reqs[i].done) edubfm_aio_Progress();
+        if (reqs[i].result < 0 && e == eNOERROR) e = reqs[i].result;
+        due = MAX(due, reqs[i].due);
+    }
+
+    pthread_mutex_unlock(&edubfm_aioMutex);
+
+    // Memory volume의 request들은 주어진 지연 시간이 지날 때까지 기다림
+    edubfm_MemoryVolumeWait(due);
+
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+}  /* edubfm_WaitIO */
+
+
+
+/*@================================
+ * edubfm_BeginFrameRead()
+ *================================*/
+/*
+ * Function: Four edubfm_BeginFrameRead(TrainID *, Four, Four)
+ *
+ * Description:
+ *  Insert the buffer element allocated for the page/train into the hash
+ *  table, marked READING and fixed, so that the page/train can be read
+ *  into it after the latch of the partition is released; the transactions
+ *  fixing the page/train meanwhile wait by edubfm_WaitFrameIO().
+ *  It is called with the latch of the partition held.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_BeginFrameRead(
+    TrainID             *trainId,               /* IN page/train to be read */
+    Four                type,                   /* IN buffer type */
+    Four                index)                  /* IN index of the allocated buffer element */
+{
+    Four                e;                      /* for error */
+
+    // 읽는 동안 교체되지 않도록 fix 하고, 다른 transaction이 기다리도록 READING으로 표시하여 hashTable에 삽입함
+    FRAME_WRITE_BEGIN(type, index);
+    BI_BITS(type, index) = READING;
+    BI_PIN(type, index);
+    BI_KEY(type, index) = *(BfMHashKey *)trainId;
+    BI_NEXTHASHENTRY(type, index) = NIL;
+    FRAME_WRITE_END(type, index);
+
+    e = edubfm_Insert(&BI_KEY(type, index), index, type);
+    if (e < 0) {
+        FRAME_WRITE_BEGIN(type, index);
+        SET_NILBFMHASHKEY(BI_KEY(type, index));
+        BI_BITS(type, index) = ALL_0;
+        BI_UNPIN(type, index);
+        FRAME_WRITE_END(type, index);
+        ERR(e);
+    }
+
+    return(eNOERROR);
+
+}  /* edubfm_BeginFrameRead */
+
+
+
+/*@================================
+ * edubfm_EndFrameRead()
+ *================================*/
+/*
+ * Function: Boolean edubfm_EndFrameRead(TrainID *, Four, BufferPartition *, Four, Four, One, Boolean)
+ *
+ * Description:
+ *  Finish the read into the buffer element begun by edubfm_BeginFrameRead(),
+ *  and wake up the transactions waiting for it. It is called with the latch
+ *  of the partition held.
+ *  If the read succeeded, the buffer element gets 'bits' instead of READING
+ *  and is reported to the replacement policy; it stays fixed if 'keepFixed'
+ *  is set. If the read failed, the buffer element is emptied. If the buffer
+ *  element was emptied meanwhile (e.g. by EduBfM_DiscardAll()), it is left as it is.
+ *
+ * Returns:
+ *  TRUE if the buffer element holds the page/train read, otherwise FALSE
+ */
+Boolean edubfm_EndFrameRead(
+    TrainID             *trainId,               /* IN page/train read */
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part,                  /* IN partition latched by the caller */
+    Four                index,                  /* IN index of the buffer element */
+    Four                ioError,                /* IN error of the read */
+    One                 bits,                   /* IN bits of the buffer element after the read */
+    Boolean             keepFixed)              /* IN TRUE to keep the buffer element fixed */
+{
+    Boolean             loaded = FALSE;         /* TRUE if the buffer element holds the page/train */
+
+    // EduBfM_DiscardAll() 등에 의해 buffer element가 이미 비워진 경우에는 그대로 둠
+    if (!EQUALKEY(&BI_KEY(type, index), (BfMHashKey *)trainId) || !(BI_BITS(type, index) & READING)) {
+        loaded = FALSE;
+    }
+    // 읽기에 실패한 경우 (예: volume의 마지막 page 다음을 가리키는 경우), 해당 buffer element를 비움
+    else if (ioError < 0) {
+        FRAME_WRITE_BEGIN(type, index);
+        edubfm_Delete(&BI_KEY(type, index), type);
+        SET_NILBFMHASHKEY(BI_KEY(type, index));
+        BI_BITS(type, index) = ALL_0;
+        BI_UNPIN(type, index);
+        FRAME_WRITE_END(type, index);
+    }
+    else {
+        loaded = TRUE;
+        FRAME_WRITE_BEGIN(type, index);
+        BI_BITS(type, index) = bits;
+        if (!keepFixed) BI_UNPIN(type, index);
+        FRAME_WRITE_END(type, index);
+        PI_POLICY(type)->fix(type, part, index, FALSE);
+    }
+
+    // 기다리는 transaction들을 깨움 (기다리는 transaction은 partition의 latch를 해제하기 전에 edubfm_aioMutex를 획득하므로 깨움을 놓치지 않음)
+    pthread_mutex_lock(&edubfm_aioMutex);
+    pthread_cond_broadcast(AIO_FRAMECOND(type, index));
+    pthread_mutex_unlock(&edubfm_aioMutex);
+
+    return(loaded);
+
+}  /* edubfm_EndFrameRead */
+
+
+
+/*@================================
+ * edubfm_WaitFrameIO()
+ *================================*/
+/*
+ * Function: Four edubfm_WaitFrameIO(Four, Four, BufferPartition *)
+ *
+ * Description:
+ *  Wait until the read into the buffer element marked READING ends.
+ *  It is called with the latch of the partition held, and returns without
+ *  it; the caller should latch the partition and look the page/train up
+ *  again, since the condition variable is shared by several buffer elements.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_WaitFrameIO(
+    Four                type,                   /* IN buffer type */
+    Four                index,                  /* IN index of the buffer element */
+    BufferPartition     *part)                  /* IN partition latched by the caller */
+{
+    Four                e;                      /* for error */
+
+    pthread_mutex_lock(&edubfm_aioMutex);
+    edubfm_aioStats.nFrameWaits++;
+
+    e = edubfm_UnlatchPartition(part);
+    if (e < 0) {
+        pthread_mutex_unlock(&edubfm_aioMutex);
+        ERR(e);
+    }
+
+    pthread_cond_wait(AIO_FRAMECOND(type, index), &edubfm_aioMutex);
+    pthread_mutex_unlock(&edubfm_aioMutex);
+
+    return(eNOERROR);
+
+}  /* edubfm_WaitFrameIO */
+
+
+
+/*
+ * Function: static Boolean edubfm_aio_SetupRing(Four)
+ *
+ * Description:
+ *  Set up an io_uring of 'entries' entries and map its rings.
+ *
+ * Returns:
+ *  TRUE if the io_uring is set up, otherwise FALSE
+ */
+static Boolean edubfm_aio_SetupRing(
+    Four                entries)                /* IN # of entries */
+{
+    struct io_uring_params p;
+    char                *sq, *cq;
+
+#ifdef __NR_io_uring_setup
+    memset(&p, 0, sizeof(p));
+    aioRingFd = syscall(__NR_io_uring_setup, entries, &p);
+    if (aioRingFd < 0) return(FALSE);
+
+    aioSqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    aioCqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) aioSqRingSize = aioCqRingSize = MAX(aioSqRingSize, aioCqRingSize);
+    aioSqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+
+    aioSqRing = aioCqRing = aioSqes = NULL;
+
+    aioSqRing = mmap(NULL, aioSqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, aioRingFd, IORING_OFF_SQ_RING);
+    if (aioSqRing == MAP_FAILED) aioSqRing = NULL;
+
+    // 한 번의 mapping으로 두 ring을 모두 볼 수 있으면 completion queue를 따로 mapping 하지 않음
+    if (aioSqRing != NULL && (p.features & IORING_FEAT_SINGLE_MMAP)) aioCqRing = aioSqRing;
+    else if (aioSqRing != NULL) {
+        aioCqRing = mmap(NULL, aioCqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, aioRingFd, IORING_OFF_CQ_RING);
+        if (aioCqRing == MAP_FAILED) aioCqRing = NULL;
+    }
+
+    if (aioCqRing != NULL) {
+        aioSqes = mmap(NULL, aioSqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, aioRingFd, IORING_OFF_SQES);
+        if (aioSqes == MAP_FAILED) aioSqes = NULL;
+    }
+
+    if (aioSqes == NULL) {
+        edubfm_aio_TeardownRing();
+        return(FALSE);
+    }
+
+    sq = (char *)aioSqRing;
+    aioSqHead = (unsigned *)(sq + p.sq_off.head);
+    aioSqTail = (unsigned *)(sq + p.sq_off.tail);
+    aioSqMask = (unsigned *)(sq + p.sq_off.ring_mask);
+    aioSqArray = (unsigned *)(sq + p.sq_off.array);
+
+    cq = (char *)aioCqRing;
+    aioCqHead = (unsigned *)(cq + p.cq_off.head);
+    aioCqTail = (unsigned *)(cq + p.cq_off.tail);
+    aioCqMask = (unsigned *)(cq + p.cq_off.ring_mask);
+    aioCqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+
+    return(TRUE);
+#else
+    return(FALSE);
+#endif
+
+}  /* edubfm_aio_SetupRing */
+
+
+
+/*
+ * Function: static void edubfm_aio_TeardownRing(void)
+ *
+ * Description:
+ *  Unmap the rings of the io_uring and close it.
+ */
+static void edubfm_aio_TeardownRing(void)
+{
+    if (aioSqes != NULL) munmap(aioSqes, aioSqesSize);
+    if (aioCqRing != NULL && aioCqRing != aioSqRing) munmap(aioCqRing, aioCqRingSize);
+    if (aioSqRing != NULL) munmap(aioSqRing, aioSqRingSize);
+    aioSqes = NULL;
+    aioSqRing = aioCqRing = NULL;
+
+    if (aioRingFd >= 0) close(aioRingFd);
+    aioRingFd = -1;
+
+}  /* edubfm_aio_TeardownRing */
+
+
+
+/*
+ * Function: static void edubfm_aio_PushRing(BfMIORequest *)
+ *
+ * Description:
+ *  Put the request into the submission queue of the io_uring; it is passed
+ *  to the kernel by edubfm_aio_FlushRing(). edubfm_aioMutex must be held.
+ *  The submission queue does not overflow since it has as many entries as
+ *  requests can be in flight.
+ */
+static void edubfm_aio_PushRing(
+    BfMIORequest        *req)                   /* IN request */
+{
+    unsigned            tail, idx;
+    struct io_uring_sqe *sqe;
+
+    tail = *aioSqTail;
+    idx = tail & *aioSqMask;
+    sqe = &aioSqes[idx];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = (req->op == BFM_IO_READ) ? IORING_OP_READV : IORING_OP_WRITEV;
+    sqe->fd = req->fd;
+    sqe->addr = (unsigned long)req->iov;
+    sqe->len = req->nIov;
+    sqe->off = (off_t)req->trainId.pageNo * PAGESIZE;
+    sqe->user_data = (unsigned long)req;
+
+    aioSqArray[idx] = idx;
+    __atomic_store_n(aioSqTail, tail + 1, __ATOMIC_RELEASE);
+    aioNPending++;
+
+}  /* edubfm_aio_PushRing */
+
+
+
+/*
+ * Function: static void edubfm_aio_FlushRing(void)
+ *
+ * Description:
+ *  Pass the entries put into the submission queue to the kernel.
+ *  edubfm_aioMutex must be held.
+ */
+static void edubfm_aio_FlushRing(void)
+{
+    long                n;
+
+    while (aioNPending > 0) {
+        n = syscall(__NR_io_uring_enter, aioRingFd, aioNPending, 0, 0, NULL, 0);
+        if (n < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) break;
+        if (n > 0) aioNPending -= n;
+    }
+
+}  /* edubfm_aio_FlushRing */
+
+
+
+/*
+ * Function: static void edubfm_aio_Progress(void)
+ *
+ * Description:
+ *  Wait until some requests complete. edubfm_aioMutex must be held, and is
+ *  released while waiting. With the io_uring, the first waiting thread
+ *  reaps the completion queue for all threads, and the others wait until
+ *  it is done.
+ */
+static void edubfm_aio_Progress(void)
+{
+    unsigned            head, tail;
+    struct io_uring_cqe *cqe;
+
+    if (!aioUring || aioPolling || aioNInFlight == 0) {
+        pthread_cond_wait(&aioDoneCond, &edubfm_aioMutex);
+        return;
+    }
+
+    aioPolling = TRUE;
+    pthread_mutex_unlock(&edubfm_aioMutex);
+
+    syscall(__NR_io_uring_enter, aioRingFd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+
+    pthread_mutex_lock(&edubfm_aioMutex);
+
+    head = *aioCqHead;
+    tail = __atomic_load_n(aioCqTail, __ATOMIC_ACQUIRE);
+    for ( ; head != tail; head++) {
+        cqe = &aioCqes[head & *aioCqMask];
+        edubfm_aio_Complete((BfMIORequest *)(unsigned long)cqe->user_data, cqe->res);
+    }
+    __atomic_store_n(aioCqHead, head, __ATOMIC_RELEASE);
+
+    aioPolling = FALSE;
+    pthread_cond_broadcast(&aioDoneCond);
+
+}  /* edubfm_aio_Progress */
+
+
+
+/*
+ * Function: static void edubfm_aio_Complete(BfMIORequest *, Four)
+ *
+ * Description:
+ *  Mark the request complete with the result of the read or write
+ *  (# of bytes transferred or -errno) and remove it from the requests in
+ *  flight. edubfm_aioMutex must be held.
+ */
+static void edubfm_aio_Complete(
+    BfMIORequest        *req,                   /* IN request */
+    Four                res)                    /* IN # of bytes transferred, or -errno */
+{
+    Four                i;
+
+    req->result = (res == req->nPages * PAGESIZE) ? eNOERROR : eVOLUMEIOERR_EDUBFM;
+    req->done = TRUE;
+
+    for (i = 0; i < aioNInFlight; i++) {
+        if (aioInFlight[i] == req) {
+            aioInFlight[i] = aioInFlight[--aioNInFlight];
+            break;
+        }
+    }
+
+}  /* edubfm_aio_Complete */
+
+
+
+/*
+ * Function: static Boolean edubfm_aio_Overlaps(BfMIORequest *)
+ *
+ * Description:
+ *  Check whether a request in flight accesses any page of the request and
+ *  either of them is a write. edubfm_aioMutex must be held.
+ *
+ * Returns:
+ *  TRUE if the request has to wait, otherwise FALSE
+ */
+static Boolean edubfm_aio_Overlaps(
+    BfMIORequest        *req)                   /* IN request to be submitted */
+{
+    Four                i;
+    BfMIORequest        *r;
+
+    for (i = 0; i < aioNInFlight; i++) {
+        r = aioInFlight[i];
+        if (r->op == BFM_IO_READ && req->op == BFM_IO_READ) continue;
+        if (r->trainId.volNo != req->trainId.volNo) continue;
+        if (r->trainId.pageNo < req->trainId.pageNo + req->nPages &&
+            req->trainId.pageNo < r->trainId.pageNo + r->nPages) return(TRUE);
+    }
+
+    return(FALSE);
+
+}  /* edubfm_aio_Overlaps */
+
+
+
+/*
+ * Function: static void *edubfm_AsyncIOMain(void *)
+ *
+ * Description:
+ *  Main loop of a thread of the pool, which serves the queued requests
+ *  in order by preadv() and pwritev().
+ */
+static void *edubfm_AsyncIOMain(
+    void                *arg)                   /* IN not used */
+{
+    BfMIORequest        *r;                     /* request being served */
+    ssize_t             n;                      /* # of bytes transferred */
+    off_t               offset;
+
+    for (;;) {
+        pthread_mutex_lock(&edubfm_aioMutex);
+        while (aioCount == 0 && !aioStop) pthread_cond_wait(&aioQueueCond, &edubfm_aioMutex);
+        if (aioCount == 0) {
+            pthread_mutex_unlock(&edubfm_aioMutex);
+            break;
+        }
+        r = aioQueue[aioHead];
+        aioHead = (aioHead + 1) % AIO_MAX_DEPTH;
+        aioCount--;
+        pthread_mutex_unlock(&edubfm_aioMutex);
+
+        offset = (off_t)r->trainId.pageNo * PAGESIZE;
+        if (r->op == BFM_IO_READ) n = preadv(r->fd, r->iov, r->nIov, offset);
+        else n = pwritev(r->fd, r->iov, r->nIov, offset);
+
+        pthread_mutex_lock(&edubfm_aioMutex);
+        edubfm_aio_Complete(r, (n < 0) ? -errno : (Four)n);
+        pthread_cond_broadcast(&aioDoneCond);
+        pthread_mutex_unlock(&edubfm_aioMutex);
+    }
+
+    return(NULL);
+
+}  /* edubfm_AsyncIOMain */
@@ -0,0 +1,420 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_BgWriter.c
+ *
+ * Description:
+ *  The background writer, a thread which writes the dirty pages/trains
+ *  ahead of the clock hand of each partition, so that
+ *  edubfm_cfgParams.bgWriterCleanPercent % of the unfixed buffers are
+ *  clean and a buffer replaced by edubfm_AllocTrain() seldom has to be
+ *  written synchronously.
+ *  A page/train is copied and marked clean under the latch of its
+ *  partition, and the copy is written after the latch is released. The
+ *  I/O latch is acquired before the partition latch is released, so that
+ *  the page/train cannot be read from the disk again before it is written.
+ *  If the asynchronous I/O is running, the pages/trains of the attached
+ *  volumes are copied and submitted in batches of up to BGWRITER_MAX_BATCH
+ *  under the latch of the partition, so that their writes are in flight
+ *  together; a read of such a page/train submitted afterwards waits for
+ *  its write instead of the I/O latch.
+ *
+ * Exports:
+ *  Four edubfm_StartBgWriter(void)
+ *  Four edubfm_StopBgWriter(void)
+ */
+
+
+#include <stdlib.h> /* for malloc & free */
+#include <string.h> /* for memcpy */
+#include <time.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* state of the background writer */
+static pthread_t        bgWriterThread;
+static Boolean          bgWriterRunning = FALSE;
+static Boolean          bgWriterStop;           /* TRUE if the writer is requested to stop */
+static pthread_mutex_t  bgWriterMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   bgWriterCond = PTHREAD_COND_INITIALIZER;
+static char             *bgWriterBuf;           /* copy of the page/train being written */
+static char             *bgWriterBatchBuf;      /* copies of the pages/trains written asynchronously */
+static Four             bgWriterBatchSize;      /* max. # of asynchronous writes in flight (0 : none) */
+static BfMIORequest     bgWriterReqs[BGWRITER_MAX_BATCH];  /* asynchronous writes */
+static BfMHashKey       bgWriterKeys[BGWRITER_MAX_BATCH];  /* pages/trains written by them */
+static Four             bgWriterIndexes[BGWRITER_MAX_BATCH];   /* buffer elements from which they were copied */
+static Four             bgWriterMaxSize;        /* size of the largest buffer element (unit: # of pages) */
+
+
+/* internal function prototypes */
+static void *edubfm_BgWriterMain(void *);
+static Four edubfm_bgw_CleanPartition(Four, BufferPartition *);
+static Four edubfm_bgw_WriteBuffer(Four, BufferPartition *, Four);
+static Four edubfm_bgw_WriteBatch(Four, BufferPartition *, Four);
+
+
+
+/*@================================
+ * edubfm_StartBgWriter()
+ *================================*/
+/*
+ * Function: Four edubfm_StartBgWriter(void)
+ *
+ * Description:
+ *  Start the background writer. The buffer pools must be partitioned.
+ *  If the asynchronous I/O is running, it must have been started first.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ *    eMUTEXCREATEUNKNOWN_BFM - The thread cannot be created.
+ */
+Four edubfm_StartBgWriter(void)
+{
+    Four                type;
+    Four                maxSize = 0;            /* size of the largest buffer element */
+
+    if (bgWriterRunning) return(eNOERROR);
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) maxSize = MAX(maxSize, BI_BUFSIZE(type));
+
+    // O_DIRECT로 attach 된 volume에도 기록할 수 있도록 page 단위로 정렬된 buffer를 할당함
+    if (posix_memalign((void **)&bgWriterBuf, PAGESIZE, PAGESIZE * maxSize) != 0) ERR(eMEMALLOCERR_EDUBFM);
+
+    // 비동기 I/O를 사용하는 경우, 함께 기록할 page/train들을 복사할 buffer들도 할당함
+    bgWriterMaxSize = maxSize;
+    bgWriterBatchSize = AIO_RUNNING() ? MIN(edubfm_aioDepth, BGWRITER_MAX_BATCH) : 0;
+    bgWriterBatchBuf = NULL;
+    if (bgWriterBatchSize > 0 &&
+        posix_memalign((void **)&bgWriterBatchBuf, PAGESIZE, (size_t)PAGESIZE * maxSize * bgWriterBatchSize) != 0) {
+        free(bgWriterBuf);
+        ERR(eMEMALLOCERR_EDUBFM);
+    }
+
+    bgWriterStop = FALSE;
+    if (pthread_create(&bgWriterThread, NULL, edubfm_BgWriterMain, NULL) != 0) {
+        free(bgWriterBuf);
+        free(bgWriterBatchBuf);
+        ERR(eMUTEXCREATEUNKNOWN_BFM);
+    }
+    bgWriterRunning = TRUE;
+
+    return(eNOERROR);
+
+}  /* edubfm_StartBgWriter */
+
+
+
+/*@================================
+ * edubfm_StopBgWriter()
+ *================================*/
+/*
+ * Function: Four edubfm_StopBgWriter(void)
+ *
+ * Description:
+ *  Stop the background writer and wait until it finishes the current round.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_StopBgWriter(void)
+{
+    if (!bgWriterRunning) return(eNOERROR);
+
+    pthread_mutex_lock(&bgWriterMutex);
+    bgWriterStop = TRUE;
+    pthread_cond_signal(&bgWriterCond);
+    pthread_mutex_unlock(&bgWriterMutex);
+
+    pthread_join(bgWriterThread, NULL);
+    bgWriterRunning = FALSE;
+
+    free(bgWriterBuf);
+    bgWriterBuf = NULL;
+    free(bgWriterBatchBuf);
+    bgWriterBatchBuf = NULL;
+
+    return(eNOERROR);
+
+}  /* edubfm_StopBgWriter */
+
+
+
+/*
+ * Function: static void *edubfm_BgWriterMain(void *)
+ *
+ * Description:
+ *  Main loop of the background writer. Every bgWriterInterval msec, each
+ *  partition of each buffer pool is cleaned.
+ */
+static void *edubfm_BgWriterMain(
+    void                *arg)                   /* IN not used */
+{
+    Four                e;                      /* for error */
+    Four                type, p;
+    Four                interval;               /* interval between the rounds (unit: msec) */
+    struct timespec     ts;
+
+    interval = (edubfm_cfgParams.bgWriterInterval > 0) ? edubfm_cfgParams.bgWriterInterval : BGWRITER_DEFAULT_INTERVAL;
+
+    for (;;) {
+        for (type = 0; type < NUM_BUF_TYPES; type++) {
+            for (p = 0; p < PI_NPARTS(type); p++) {
+                e = edubfm_bgw_CleanPartition(type, PI_PART(type, p));
+                if (e < 0) PRTERR(e);
+            }
+        }
+
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += (long)(interval % 1000) * 1000000;
+        ts.tv_sec += interval / 1000 + ts.tv_nsec / 1000000000;
+        ts.tv_nsec %= 1000000000;
+
+        pthread_mutex_lock(&bgWriterMutex);
+        if (!bgWriterStop) pthread_cond_timedwait(&bgWriterCond, &bgWriterMutex, &ts);
+        if (bgWriterStop) {
+            pthread_mutex_unlock(&bgWriterMutex);
+            break;
+        }
+        pthread_mutex_unlock(&bgWriterMutex);
+    }
+
+    return(NULL);
+
+}  /* edubfm_BgWriterMain */
+
+
+
+/*
+ * Function: static Four edubfm_bgw_CleanPartition(Four, BufferPartition *)
+ *
+ * Description:
+ *  Write the dirty unfixed buffers of the partition, visiting the buffers
+ *  from the clock hand (i.e. in the order they become victims), until
+ *  bgWriterCleanPercent % of the unfixed buffers are clean.
+ *  With the asynchronous I/O, the buffers of the attached volumes are
+ *  gathered into batches written by edubfm_bgw_WriteBatch().
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four edubfm_bgw_CleanPartition(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part)                  /* IN partition */
+{
+    Four                e;                      /* for error */
+    Four                i, n;
+    Four                nUnfixed = 0;           /* # of unfixed buffers */
+    Four                nDirty = 0;             /* # of dirty unfixed buffers */
+    Four                nToWrite;               /* # of buffers to be written */
+    Four                hand;                   /* clock hand of the partition */
+    Four                nBatch = 0;             /* # of buffers copied into the batch */
+    BfMHashKey          key;                    /* page/train of a buffer */
+
+    e = edubfm_LatchPartition(part);
+    if (e < 0) ERR(e);
+
+    for (i = part->firstBuf; i < part->firstBuf + part->nBufs; i++) {
+        if (BI_FIXED(type, i) != 0) continue;
+        nUnfixed++;
+        if (BI_BITS(type, i) & DIRTY) nDirty++;
+    }
+
+    // 목표 비율을 넘는 dirty buffer element들을 clock hand가 도달할 순서대로 기록함
+    nToWrite = nDirty - (nUnfixed * (100 - edubfm_cfgParams.bgWriterCleanPercent)) / 100;
+    hand = part->nextVictim;
+
+    for (n = 0; n < part->nBufs && nToWrite > 0; n++) {
+        i = part->firstBuf + (hand + n) % part->nBufs;
+
+        if (BI_FIXED(type, i) == 0 && (BI_BITS(type, i) & DIRTY)) {
+            // Attach 된 volume의 page/train은 복사하여 batch에 모으고, batch가 차면 함께 기록함
+            if (bgWriterBatchSize > 0 && edubfm_VolumeFd(BI_KEY(type, i).volNo) != NIL) {
+                key = BI_KEY(type, i);
+                memcpy(bgWriterBatchBuf + (size_t)PAGESIZE * bgWriterMaxSize * nBatch, BI_BUFFER(type, i), PAGESIZE * BI_BUFSIZE(type));
+                BI_BITS(type, i) &= ~DIRTY;
+
+                edubfm_PrepareIO(&bgWriterReqs[nBatch], BFM_IO_WRITE, (TrainID *)&key,
+                                 bgWriterBatchBuf + (size_t)PAGESIZE * bgWriterMaxSize * nBatch, type);
+                bgWriterKeys[nBatch] = key;
+                bgWriterIndexes[nBatch] = i;
+                nBatch++;
+
+                if (nBatch == bgWriterBatchSize) {
+                    e = edubfm_bgw_WriteBatch(type, part, nBatch);
+                    if (e < 0) ERR(e);  /* the partition is not latched */
+                    nBatch = 0;
+                }
+            }
+            else {
+                // 복사만 되고 제출되지 않은 page/train들이 latch가 해제된 동안 다시 읽히지 않도록 먼저 기록함
+                if (nBatch > 0) {
+                    e = edubfm_bgw_WriteBatch(type, part, nBatch);
+                    if (e < 0) ERR(e);  /* the partition is not latched */
+                    nBatch = 0;
+                }
+
+                e = edubfm_bgw_WriteBuffer(type, part, i);
+                if (e < 0) ERR(e);      /* the partition is not latched */
+            }
+            nToWrite--;
+        }
+    }
+
+    if (nBatch > 0) {
+        e = edubfm_bgw_WriteBatch(type, part, nBatch);
+        if (e < 0) ERR(e);              /* the partition is not latched */
+    }
+
+    e = edubfm_UnlatchPartition(part);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+}  /* edubfm_bgw_CleanPartition */
+
+
+
+/*
+ * Function: static Four edubfm_bgw_WriteBuffer(Four, BufferPartition *, Four)
+ *
+ * Description:
+ *  Write the dirty unfixed buffer. It is called and returns with the latch
+ *  of the partition held, but the latch is released during the write.
+ *  If the write fails, the buffer is marked dirty again if it still holds
+ *  the same page/train, and the error is returned without the latch.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four edubfm_bgw_WriteBuffer(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part,                  /* IN partition latched by the caller */
+    Four                index)                  /* IN index of the buffer */
+{
+    Four                e, e2;                  /* for error */
+    BfMHashKey          key;                    /* page/train being written */
+
+    key = BI_KEY(type, index);
+    memcpy(bgWriterBuf, BI_BUFFER(type, index), PAGESIZE * BI_BUFSIZE(type));
+    BI_BITS(type, index) &= ~DIRTY;
+
+    // Partition의 latch를 해제하기 전에 I/O latch를 획득하여, 기록이 끝나기 전에 같은 page/train이 다시 읽히지 않도록 함
+    e = edubfm_LatchIO();
+    if (e < 0) {
+        BI_BITS(type, index) |= DIRTY;
+        ERR_UNLATCH(e, part);
+    }
+
+    e = edubfm_UnlatchPartition(part);
+    if (e < 0) {
+        edubfm_UnlatchIO();
+        ERR(e);
+    }
+
+    e = edubfm_WriteTrain((TrainID *)&key, bgWriterBuf, type);
+
+    edubfm_UnlatchIO();
+
+    e2 = edubfm_LatchPartition(part);
+    if (e2 < 0) ERR(e2);
+
+    if (e < 0) {
+        if (EQUALKEY(&BI_KEY(type, index), &key)) BI_BITS(type, index) |= DIRTY;
+        ERR_UNLATCH(e, part);
+    }
+
+    part->writerStats.nBgWrites++;
+    BFM_STATS( part->stats.nWriteBacks++ );
+
+    return(eNOERROR);
+
+}  /* edubfm_bgw_WriteBuffer */
+
+
+
+/*
+ * Function: static Four edubfm_bgw_WriteBatch(Four, BufferPartition *, Four)
+ *
+ * Description:
+ *  Write the first 'n' buffers copied into the batch by the asynchronous
+ *  I/O. It is called and returns with the latch of the partition held.
+ *  The writes are submitted before the latch is released, and the latch
+ *  is released while they are in flight. The buffers whose writes fail
+ *  are marked dirty again if they still hold the same pages/trains, and
+ *  the error is returned without the latch.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four edubfm_bgw_WriteBatch(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part,                  /* IN partition latched by the caller */
+    Four                n)                      /* IN # of buffers in the batch */
+{
+    Four                e, e2;                  /* for error */
+    Four                k;
+    Four                nWritten = 0;           /* # of buffers written */
+
+    // Partition의 latch를 해제하기 전에 제출하여, 기록이 끝나기 전에 제출된 같은 page/train의 읽기가 기다리도록 함
+    e = edubfm_SubmitIO(bgWriterReqs, n);
+    if (e < 0) {
+        for (k = 0; k < n; k++) BI_BITS(type, bgWriterIndexes[k]) |= DIRTY;
+        ERR_UNLATCH(e, part);
+    }
+
+    e = edubfm_UnlatchPartition(part);
+    if (e < 0) {
+        (void) edubfm_WaitIO(bgWriterReqs, n);
+        ERR(e);
+    }
+
+    e = edubfm_WaitIO(bgWriterReqs, n);
+
+    e2 = edubfm_LatchPartition(part);
+    if (e2 < 0) ERR(e2);
+
+    for (k = 0; k < n; k++) {
+        if (bgWriterReqs[k].result < 0) {
+            if (EQUALKEY(&BI_KEY(type, bgWriterIndexes[k]), &bgWriterKeys[k])) BI_BITS(type, bgWriterIndexes[k]) |= DIRTY;
+        }
+        else {
+            BFM_TRACE(BFM_TRACE_WRITE, &bgWriterKeys[k], type);
+            nWritten++;
+        }
+    }
+
+    part->writerStats.nBgWrites += nWritten;
+    BFM_STATS( part->stats.nWriteBacks += nWritten );
+
+    if (e < 0) ERR_UNLATCH(e, part);
+
+    return(eNOERROR);
+
+}  /* edubfm_bgw_WriteBatch */
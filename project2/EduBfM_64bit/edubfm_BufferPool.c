@@ -0,0 +1,207 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_BufferPool.c
+ *
+ * Description :
+ *  Some functions are provided to change the arrays of a buffer pool set up
+ *  by the storage system (bufInfo[]), which are used to make the buffer
+ *  pool resizable, or to back it by huge pages or align it for O_DIRECT.
+ *  The arrays are reallocated once for the maximum size, so that they never
+ *  move while the buffer pool is resized; the memory of the buffer elements
+ *  which are not in use is returned to the operating system.
+ *  The new arrays are allocated by the malloc() family like the original
+ *  ones, since the storage system frees them when it is finalized; so the
+ *  huge pages are the transparent huge pages of the OS requested by
+ *  madvise(), not the ones reserved by hugetlbfs (which cannot be freed by
+ *  free()).
+ *
+ * Exports:
+ *  Four edubfm_ReserveBufferPool(Four, Four)
+ *  void edubfm_CompactBufferPool(Four, Four)
+ *  void edubfm_ReleaseBuffers(Four, Four, Four)
+ */
+
+
+#include <stdlib.h> /* for malloc, calloc & free */
+#include <unistd.h>
+#include <sys/mman.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * edubfm_ReserveBufferPool()
+ *================================*/
+/*
+ * Function: Four edubfm_ReserveBufferPool(Four, Four)
+ *
+ * Description:
+ *  Reallocate bufTable, hashTable and bufferPool of the buffer pool for
+ *  'maxBufs' buffer elements, all of which become part of BI_NBUFS(type).
+ *  The buffer pool must be empty. The buffer elements are allocated page
+ *  aligned, so that the memory of any of them can be released and they can
+ *  be read and written with O_DIRECT. If edubfm_cfgParams.useHugePages is
+ *  set, they are aligned to BFM_HUGEPAGE_SIZE and backed by huge pages.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ *
+ * 설명:
+ *  최대 크기의 bufTable, hashTable과 bufferPool을 할당하여 storage system이 할당한 것들을 대체함
+ */
+Four edubfm_ReserveBufferPool(
+    Four                type,                   /* IN buffer type */
+    Four                maxBufs)                /* IN # of buffer elements to be reserved */
+{
+    Four                i;                      /* index */
+    BufferTable         *bufTable;              /* new bufTable */
+    Two                 *hashTable;             /* new hashTable */
+    void                *bufferPool;            /* new bufferPool */
+    size_t              poolSize;               /* size of bufferPool */
+    size_t              align;                  /* alignment of bufferPool */
+
+
+    // Huge page를 사용하는 경우, huge page 경계에 맞추어 huge page 크기의 배수로 할당함
+    poolSize = (size_t)PAGESIZE * BI_BUFSIZE(type) * maxBufs;
+    align = PAGESIZE;
+    if (edubfm_cfgParams.useHugePages) {
+        align = BFM_HUGEPAGE_SIZE;
+        poolSize = ((poolSize + align - 1) / align) * align;
+    }
+
+    // Storage system이 할당한 bufTable처럼, 사용되지 않은 buffer element의 key도 0으로 초기화함
+    bufTable = (BufferTable *)calloc(maxBufs, sizeof(BufferTable));
+    hashTable = (Two *)malloc(sizeof(Two) * HASHTABLESIZE_TO_NBUFS(maxBufs));
+    if (posix_memalign(&bufferPool, align, poolSize) != 0) bufferPool = NULL;
+
+    if (bufTable == NULL || hashTable == NULL || bufferPool == NULL) {
+        free(bufTable);
+        free(hashTable);
+        free(bufferPool);
+        ERR(eMEMALLOCERR_EDUBFM);
+    }
+
+    // 운영체제가 지원하지 않으면 일반 page로 사용함
+    if (edubfm_cfgParams.useHugePages) madvise(bufferPool, poolSize, MADV_HUGEPAGE);
+
+    for (i = 0; i < maxBufs; i++) {
+        SET_NILBFMHASHKEY(bufTable[i].key);
+        bufTable[i].fixed = 0;
+        bufTable[i].bits = ALL_0;
+        bufTable[i].nextHashEntry = NIL;
+    }
+
+    for (i = 0; i < HASHTABLESIZE_TO_NBUFS(maxBufs); i++) hashTable[i] = NIL;
+
+    free(bufInfo[type].bufTable);
+    free(bufInfo[type].hashTable);
+    free(bufInfo[type].bufferPool);
+
+    bufInfo[type].bufTable = bufTable;
+    bufInfo[type].hashTable = hashTable;
+    bufInfo[type].bufferPool = (char *)bufferPool;
+    BI_NBUFS(type) = (Two)maxBufs;
+    BI_NEXTVICTIM(type) = 0;
+
+    return(eNOERROR);
+
+}  /* edubfm_ReserveBufferPool */
+
+
+
+/*@================================
+ * edubfm_CompactBufferPool()
+ *================================*/
+/*
+ * Function: void edubfm_CompactBufferPool(Four, Four)
+ *
+ * Description:
+ *  Shrink the empty buffer pool to its first 'nBufs' buffer elements.
+ *  The arrays are kept as they are, but the memory of the other buffer
+ *  elements is released.
+ *
+ * 설명:
+ *  비어 있는 bufferPool의 크기를 줄여, storage system이 앞의 nBufs개의 buffer element만 사용하도록 함
+ */
+void edubfm_CompactBufferPool(
+    Four                type,                   /* IN buffer type */
+    Four                nBufs)                  /* IN # of buffer elements to be kept */
+{
+    Four                i;                      /* index */
+
+
+    edubfm_ReleaseBuffers(type, nBufs, BI_NBUFS(type) - nBufs);
+
+    BI_NBUFS(type) = (Two)nBufs;
+    BI_NEXTVICTIM(type) = 0;
+
+    // hash value의 범위가 바뀌므로 hashTable을 다시 초기화함
+    for (i = 0; i < HASHTABLESIZE(type); i++) BI_HASHTABLEENTRY(type, i) = NIL;
+
+}  /* edubfm_CompactBufferPool */
+
+
+
+/*@================================
+ * edubfm_ReleaseBuffers()
+ *================================*/
+/*
+ * Function: void edubfm_ReleaseBuffers(Four, Four, Four)
+ *
+ * Description:
+ *  Return the memory of 'nBufs' buffer elements starting at 'firstBuf' to
+ *  the operating system. The buffer elements stay usable; they are filled
+ *  with zeros when they are touched again. Only the pages of the memory
+ *  lying entirely in the buffer elements are released.
+ *
+ * 설명:
+ *  사용하지 않게 된 buffer element들의 memory를 운영체제에 반환함
+ */
+void edubfm_ReleaseBuffers(
+    Four                type,                   /* IN buffer type */
+    Four                firstBuf,               /* IN index of the first buffer element */
+    Four                nBufs)                  /* IN # of buffer elements */
+{
+    char                *start, *end;           /* range of the memory to be released */
+    unsigned long       osPageSize;             /* size of a page of the operating system */
+
+
+    if (nBufs <= 0) return;
+
+    osPageSize = (unsigned long)sysconf(_SC_PAGESIZE);
+
+    start = BI_BUFFER(type, firstBuf);
+    end = BI_BUFFER(type, (firstBuf + nBufs));
+
+    // 운영체제의 페이지 경계에 맞추어 buffer element들 안에 완전히 포함된 페이지들만 반환함
+    start = (char *)((((unsigned long)start + osPageSize - 1) / osPageSize) * osPageSize);
+    end = (char *)(((unsigned long)end / osPageSize) * osPageSize);
+
+    if (start < end) madvise(start, end - start, MADV_DONTNEED);
+
+}  /* edubfm_ReleaseBuffers */
@@ -0,0 +1,326 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_BulkFlush.c
+ *
+ * Description :
+ *  Flush all dirty buffers in the order of their disk addresses.
+ *  The dirty pages/trains are sorted by (volNo, pageNo), and each run of
+ *  adjacent pages/trains of an attached volume is written by one vectored
+ *  write. The pages/trains of the volumes which are not attached are
+ *  written one by one through RDsM, in the sorted order.
+ *  If the asynchronous I/O is running, the vectored writes of all runs are
+ *  submitted as they are found and kept in flight together (up to
+ *  edubfm_cfgParams.ioQueueDepth of them), and waited for at the end.
+ *
+ * Exports:
+ *  Four edubfm_BulkFlush(void)
+ *  int edubfm_CompareFlushEntry(const void *, const void *)
+ */
+
+
+#include <stdlib.h>
+#include <limits.h>
+#include <sys/uio.h>
+#include "EduBfM_common.h"
+#include "RM.h"
+#include "EduBfM_Internal.h"
+
+
+/* maximum # of buffer elements written by one vectored write */
+#ifdef IOV_MAX
+#define MAX_BULKFLUSH_RUN   IOV_MAX
+#else
+#define MAX_BULKFLUSH_RUN   1024
+#endif
+
+
+/* internal function prototypes */
+static Four edubfm_WriteRun(BulkFlushEntry *, Four, Four);
+static void edubfm_RunWritten(BulkFlushEntry *, Four);
+
+
+
+/*@================================
+ * edubfm_BulkFlush()
+ *================================*/
+/*
+ * Function: Four edubfm_BulkFlush(void)
+ *
+ * Description :
+ *  Flush dirty buffers holding trains, used by EduBfM_FlushAll() when
+ *  sm_cfgParams.useBulkFlush is set.
+ *  All partitions of all buffer pools are latched while the dirty buffers
+ *  are collected and written.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ *    eVOLUMEIOERR_EDUBFM - Writing to the device of an attached volume failed.
+ *    some errors caused by function calls
+ *
+ * 설명:
+ *  수정된 page/train들을 (volNo, pageNo) 순으로 정렬하여, disk 상에서 인접한 page/train들을
+ *  하나의 vectored write로 기록함
+ *
+ * 관련 함수:
+ *  1. edubfm_FlushTrain()
+ *  2. edubfm_VolumeFd()
+ */
+Four edubfm_BulkFlush(void)
+{
+    Four                e = eNOERROR;           /* error */
+    Four                type;                   /* buffer type */
+    Two                 i;                      /* index */
+    Four                nEntries;               /* # of dirty buffer elements */
+    Four                maxEntries;             /* # of all buffer elements */
+    Four                nLatched;               /* # of latched partitions */
+    Four                start, end;             /* a run of the dirty buffer elements */
+    Four                fd;                     /* file descriptor of the device */
+    BulkFlushEntry      *entries;               /* dirty buffer elements */
+    BulkFlushEntry      *last;                  /* last buffer element of the run */
+    Four                k;                      /* index */
+    Four                nReqs = 0;              /* # of asynchronous writes */
+    struct iovec        *iovs = NULL;           /* buffers of the asynchronous writes */
+    BfMIORequest        *reqs = NULL;           /* asynchronous writes (one per run) */
+    Four                *runStart = NULL;       /* first entry of the run of each asynchronous write */
+
+
+    /* Error check whether using not supported functionality by EduBfM */
+    if (RM_IS_ROLLBACK_REQUIRED()) ERR(eNOTSUPPORTED_EDUBFM);
+
+    for (maxEntries = 0, type = 0; type < NUM_BUF_TYPES; type++) maxEntries += BI_NBUFS(type);
+
+    entries = (BulkFlushEntry *)malloc(sizeof(BulkFlushEntry) * MAX(maxEntries, 1));
+    if (entries == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    // 비동기 I/O를 사용하는 경우, 모든 run의 write를 함께 제출할 수 있도록 request들을 할당함
+    if (AIO_RUNNING()) {
+        iovs = (struct iovec *)malloc(sizeof(struct iovec) * MAX(maxEntries, 1));
+        reqs = (BfMIORequest *)malloc(sizeof(BfMIORequest) * MAX(maxEntries, 1));
+        runStart = (Four *)malloc(sizeof(Four) * MAX(maxEntries, 1));
+        if (iovs == NULL || reqs == NULL || runStart == NULL) {
+            free(iovs); free(reqs); free(runStart); free(entries);
+            ERR(eMEMALLOCERR_EDUBFM);
+        }
+    }
+
+    // 모든 buffer pool의 모든 partition의 latch를 차례로 획득함 (EduBfM_DiscardAll()과 같은 순서)
+    e = edubfm_LatchAll();
+    if (e < eNOERROR) {
+        free(iovs); free(reqs); free(runStart); free(entries);
+        ERR(e);
+    }
+
+    // DIRTY bit가 1로 set 된 buffer element들을 모아 (volNo, pageNo) 순으로 정렬함
+    for (nEntries = 0, type = 0; type < NUM_BUF_TYPES; type++) {
+        for (i = 0; i < BI_NBUFS(type); i++) {
+            if (BI_BITS(type, i) & DIRTY) {
+                entries[nEntries].key = BI_KEY(type, i);
+                entries[nEntries].type = type;
+                entries[nEntries].index = i;
+                nEntries++;
+            }
+        }
+    }
+
+    qsort(entries, nEntries, sizeof(BulkFlushEntry), edubfm_CompareFlushEntry);
+
+    // 정렬된 순서로, 같은 volume에서 연속된 page/train들의 run을 하나의 write로 기록함
+    for (start = 0; start < nEntries && e >= eNOERROR; start = end) {
+        fd = edubfm_VolumeFd(entries[start].key.volNo);
+
+        // Attach 되지 않은 volume의 page/train은 RDsM을 통해 하나씩 기록함
+        if (fd == NIL) {
+            end = start + 1;
+            e = edubfm_FlushTrain((TrainID *)&entries[start].key, entries[start].type);
+            if (e >= eNOERROR) {
+                edubfm_GetPartition(&entries[start].key, entries[start].type)->writerStats.nFlushedTrains++;
+                edubfm_GetPartition(&entries[start].key, entries[start].type)->writerStats.nFlushWrites++;
+                BFM_STATS( edubfm_GetPartition(&entries[start].key, entries[start].type)->stats.nWriteBacks++ );
+            }
+            continue;
+        }
+
+        for (end = start + 1; end < nEntries && end - start < MAX_BULKFLUSH_RUN; end++) {
+            last = &entries[end - 1];
+            if (entries[end].key.volNo != last->key.volNo ||
+                entries[end].key.pageNo != last->key.pageNo + BI_BUFSIZE(last->type)) break;
+        }
+
+        // 비동기 I/O를 사용하는 경우, run의 vectored write를 제출만 하고 다음 run으로 넘어감
+        if (reqs != NULL) {
+            edubfm_PrepareIO(&reqs[nReqs], BFM_IO_WRITE, (TrainID *)&entries[start].key, NULL, entries[start].type);
+            for (k = start; k < end; k++) {
+                iovs[k].iov_base = BI_BUFFER(entries[k].type, entries[k].index);
+                iovs[k].iov_len = PAGESIZE * BI_BUFSIZE(entries[k].type);
+            }
+            reqs[nReqs].iov = &iovs[start];
+            reqs[nReqs].nIov = end - start;
+            runStart[nReqs] = start;
+
+            e = edubfm_SubmitIO(&reqs[nReqs], 1);
+            if (e >= eNOERROR) nReqs++;
+            continue;
+        }
+
+        e = edubfm_WriteRun(&entries[start], end - start, fd);
+    }
+
+    // 제출한 write들이 모두 끝나기를 기다린 후, 기록된 run들의 DIRTY bit를 unset 함
+    if (nReqs > 0) {
+        if (edubfm_WaitIO(reqs, nReqs) < eNOERROR && e >= eNOERROR) e = eVOLUMEIOERR_EDUBFM;
+
+        for (k = 0; k < nReqs; k++) {
+            if (reqs[k].result < eNOERROR) continue;
+            edubfm_RunWritten(&entries[runStart[k]], reqs[k].nIov);
+        }
+    }
+
+    for (nLatched = 0, type = 0; type < NUM_BUF_TYPES; type++) nLatched += PI_NLOOP(type);
+    edubfm_UnlatchAll(nLatched);
+
+    free(iovs);
+    free(reqs);
+    free(runStart);
+    free(entries);
+
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}  /* edubfm_BulkFlush() */
+
+
+
+/*@================================
+ * edubfm_CompareFlushEntry()
+ *================================*/
+/*
+ * Function: int edubfm_CompareFlushEntry(const void *, const void *)
+ *
+ * Description :
+ *  Compare two dirty buffer elements by (volNo, pageNo) for qsort()
+ *  (used by the checkpoints, too).
+ *
+ * Returns:
+ *  negative, zero or positive
+ */
+int edubfm_CompareFlushEntry(
+    const void          *a,                     /* IN a dirty buffer element */
+    const void          *b)                     /* IN a dirty buffer element */
+{
+    const BfMHashKey    *k1 = &((const BulkFlushEntry *)a)->key;
+    const BfMHashKey    *k2 = &((const BulkFlushEntry *)b)->key;
+
+    if (k1->volNo != k2->volNo) return((k1->volNo < k2->volNo) ? -1 : 1);
+    if (k1->pageNo != k2->pageNo) return((k1->pageNo < k2->pageNo) ? -1 : 1);
+
+    return(0);
+
+}  /* edubfm_CompareFlushEntry() */
+
+
+
+/*@================================
+ * edubfm_WriteRun()
+ *================================*/
+/*
+ * Function: static Four edubfm_WriteRun(BulkFlushEntry *, Four, Four)
+ *
+ * Description :
+ *  Write a run of dirty buffer elements holding adjacent pages/trains
+ *  to the device of an attached volume by one vectored write, and clear
+ *  their DIRTY bits.
+ *
+ * Returns:
+ *  error code
+ *    eVOLUMEIOERR_EDUBFM - Writing to the device failed.
+ */
+static Four edubfm_WriteRun(
+    BulkFlushEntry      *run,                   /* IN dirty buffer elements sorted by pageNo */
+    Four                nEntries,               /* IN # of the buffer elements */
+    Four                fd)                     /* IN file descriptor of the device */
+{
+    Four                e;                      /* error */
+    Four                i;                      /* index */
+    ssize_t             nBytes;                 /* # of bytes to be written */
+    ssize_t             nWritten;               /* # of bytes written */
+    UEight              due;                    /* time when the write of a memory volume completes */
+    struct iovec        iov[MAX_BULKFLUSH_RUN]; /* buffers of the run */
+
+
+    for (nBytes = 0, i = 0; i < nEntries; i++) {
+        iov[i].iov_base = BI_BUFFER(run[i].type, run[i].index);
+        iov[i].iov_len = PAGESIZE * BI_BUFSIZE(run[i].type);
+        nBytes += iov[i].iov_len;
+    }
+
+    // RDsM과 같은 device를 사용하므로, partition된 경우 I/O latch를 획득한 후 기록함
+    e = edubfm_LatchIO();
+    if (e < eNOERROR) ERR(e);
+
+    due = edubfm_MemoryVolumeCharge(run[0].key.volNo, nBytes);
+    nWritten = pwritev(fd, iov, nEntries, (off_t)run[0].key.pageNo * PAGESIZE);
+
+    edubfm_UnlatchIO();
+    if (nWritten != nBytes) ERR(eVOLUMEIOERR_EDUBFM);
+
+    edubfm_MemoryVolumeWait(due);
+
+    edubfm_RunWritten(run, nEntries);
+
+    return(eNOERROR);
+
+}  /* edubfm_WriteRun() */
+
+
+
+/*@================================
+ * edubfm_RunWritten()
+ *================================*/
+/*
+ * Function: static void edubfm_RunWritten(BulkFlushEntry *, Four)
+ *
+ * Description :
+ *  Clear the DIRTY bits of a run of buffer elements written by one
+ *  vectored write, and count the write.
+ */
+static void edubfm_RunWritten(
+    BulkFlushEntry      *run,                   /* IN buffer elements written */
+    Four                nEntries)               /* IN # of the buffer elements */
+{
+    Four                i;                      /* index */
+
+    // 기록된 buffer element들의 DIRTY bit를 unset 함
+    for (i = 0; i < nEntries; i++) {
+        BI_BITS(run[i].type, run[i].index) &= ~DIRTY;
+        BFM_TRACE(BFM_TRACE_WRITE, &run[i].key, run[i].type);
+        edubfm_GetPartition(&run[i].key, run[i].type)->writerStats.nFlushedTrains++;
+        BFM_STATS( edubfm_GetPartition(&run[i].key, run[i].type)->stats.nWriteBacks++ );
+    }
+    edubfm_GetPartition(&run[0].key, run[0].type)->writerStats.nFlushWrites++;
+
+}  /* edubfm_RunWritten() */
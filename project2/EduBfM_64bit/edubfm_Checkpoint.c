@@ -0,0 +1,536 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_Checkpoint.c
+ *
+ * Description:
+ *  Fuzzy checkpoints, which write the pages/trains that are dirty when a
+ *  checkpoint starts, spread over a window of time, instead of writing all
+ *  of them at once like EduBfM_FlushAll().
+ *  A checkpoint collects the dirty buffer elements one partition at a time
+ *  and sorts them by (volNo, pageNo). It then writes them one by one,
+ *  holding only the latch of the partition of each, while the other threads
+ *  keep using the buffer pools: a page/train is copied under the latch, and
+ *  the copy is written after the latch is released (as the background
+ *  writer does). A page/train already written or replaced when its turn
+ *  comes is skipped, and one dirtied after the start is left to the next
+ *  checkpoint. A fixed page/train is written but stays dirty, since its
+ *  fixer may still be modifying it.
+ *  The writes are paced to complete within CHECKPOINT_TARGET_PERCENT % of
+ *  the window; while the other threads read pages/trains, the pace is
+ *  slowed to complete at the end of the window instead, to leave the
+ *  device to them.
+ *  If edubfm_cfgParams.checkpointInterval is set, the checkpointer thread
+ *  takes a checkpoint spread over each interval; EduBfM_Checkpoint() takes
+ *  one in the calling thread.
+ *
+ * Exports:
+ *  Four edubfm_StartCheckpointer(void)
+ *  Four edubfm_StopCheckpointer(void)
+ *  Four edubfm_Checkpoint(Four)
+ *  void edubfm_GetCheckpointStats(EduBfM_CheckpointStats *)
+ *  void edubfm_ResetCheckpointStats(void)
+ */
+
+
+#include <stdlib.h> /* for malloc & free */
+#include <string.h> /* for memcpy */
+#include <time.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* TRUE while a checkpoint is writing, and the # of reads of pages/trains counted meanwhile */
+Boolean                 edubfm_checkpointActive = FALSE;
+UFour                   edubfm_nCheckpointReads = 0;
+
+/* state of the checkpointer */
+static pthread_t        ckptThread;
+static Boolean          ckptRunning = FALSE;
+static Boolean          ckptStop;               /* TRUE if the checkpoints are requested to stop */
+static pthread_mutex_t  ckptMutex = PTHREAD_MUTEX_INITIALIZER;     /* protects ckptStop and the progress */
+static pthread_cond_t   ckptCond = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t  ckptSerialMutex = PTHREAD_MUTEX_INITIALIZER;   /* serializes the checkpoints */
+
+/* progress of the checkpoints, and the time when the current (or last) one started (unit: nsec) */
+static EduBfM_CheckpointStats ckptStats;
+static UEight           ckptStart;
+
+
+/* internal function prototypes */
+static void *edubfm_CheckpointerMain(void *);
+static UEight edubfm_ckpt_Now(void);
+static Boolean edubfm_ckpt_SleepUntil(UEight);
+static Four edubfm_ckpt_Collect(BulkFlushEntry *, Four *);
+static Four edubfm_ckpt_Write(BulkFlushEntry *, char *, Boolean *);
+
+
+
+/*@================================
+ * edubfm_StartCheckpointer()
+ *================================*/
+/*
+ * Function: Four edubfm_StartCheckpointer(void)
+ *
+ * Description:
+ *  Start the checkpointer, which takes a checkpoint every
+ *  edubfm_cfgParams.checkpointInterval msec. The buffer pools must be
+ *  partitioned.
+ *
+ * Returns:
+ *  error code
+ *    eMUTEXCREATEUNKNOWN_BFM - The thread cannot be created.
+ */
+Four edubfm_StartCheckpointer(void)
+{
+    if (ckptRunning) return(eNOERROR);
+
+    ckptStop = FALSE;
+    if (pthread_create(&ckptThread, NULL, edubfm_CheckpointerMain, NULL) != 0) ERR(eMUTEXCREATEUNKNOWN_BFM);
+    ckptRunning = TRUE;
+
+    return(eNOERROR);
+
+}  /* edubfm_StartCheckpointer */
+
+
+
+/*@================================
+ * edubfm_StopCheckpointer()
+ *================================*/
+/*
+ * Function: Four edubfm_StopCheckpointer(void)
+ *
+ * Description:
+ *  Stop the checkpointer. A checkpoint in progress stops after its current
+ *  write, without waiting for its schedule, and is counted as aborted.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_StopCheckpointer(void)
+{
+    if (!ckptRunning) return(eNOERROR);
+
+    pthread_mutex_lock(&ckptMutex);
+    ckptStop = TRUE;
+    pthread_cond_broadcast(&ckptCond);
+    pthread_mutex_unlock(&ckptMutex);
+
+    pthread_join(ckptThread, NULL);
+    ckptRunning = FALSE;
+    ckptStop = FALSE;
+
+    return(eNOERROR);
+
+}  /* edubfm_StopCheckpointer */
+
+
+
+/*
+ * Function: static void *edubfm_CheckpointerMain(void *)
+ *
+ * Description:
+ *  Main loop of the checkpointer. A checkpoint spread over checkpointInterval
+ *  msec is started every checkpointInterval msec (or as soon as the last one
+ *  completes, if it took longer).
+ */
+static void *edubfm_CheckpointerMain(
+    void                *arg)                   /* IN not used */
+{
+    Four                e;                      /* for error */
+    Four                interval;               /* interval between the checkpoints (unit: msec) */
+    UEight              next;                   /* time when the next checkpoint starts (unit: nsec) */
+
+    interval = edubfm_cfgParams.checkpointInterval;
+    next = edubfm_ckpt_Now() + (UEight)interval * 1000000;
+
+    while (!edubfm_ckpt_SleepUntil(next)) {
+        next = edubfm_ckpt_Now() + (UEight)interval * 1000000;
+
+        e = edubfm_Checkpoint(interval);
+        if (e < 0) PRTERR(e);
+    }
+
+    return(NULL);
+
+}  /* edubfm_CheckpointerMain */
+
+
+
+/*@================================
+ * edubfm_Checkpoint()
+ *================================*/
+/*
+ * Function: Four edubfm_Checkpoint(Four)
+ *
+ * Description:
+ *  Take a checkpoint: write the pages/trains dirty at its start, spread over
+ *  'duration' msec (0 : as fast as possible, still one partition latch at a
+ *  time), and then the dirty pages of the mapped volumes and the dirty
+ *  trains of the pool of the variable-size trains. The checkpoints are
+ *  serialized; one requested while another is in progress starts after it.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - 'duration' is negative.
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ *    some errors caused by function calls
+ *
+ * 설명:
+ *  Checkpoint 시작 시점에 수정되어 있던 page/train들을 disk 상의 위치 순으로, 주어진 시간에 걸쳐 나누어 기록함
+ *
+ * 관련 함수:
+ *  1. edubfm_WriteTrain()
+ *  2. edubfm_CompareFlushEntry()
+ */
+Four edubfm_Checkpoint(
+    Four                duration)               /* IN time over which the writes are spread (unit: msec) */
+{
+    Four                e = eNOERROR;           /* for error */
+    Four                type;                   /* buffer type */
+    Four                k;                      /* index */
+    Four                nEntries;               /* # of dirty buffer elements */
+    Four                maxEntries;             /* # of all buffer elements */
+    Four                maxSize = 0;            /* size of the largest buffer element */
+    BulkFlushEntry      *entries;               /* dirty buffer elements */
+    char                *copy = NULL;           /* copy of the page/train being written */
+    UEight              window;                 /* time over which the writes are spread (unit: nsec) */
+    UEight              due;                    /* time when the next write is due */
+    UFour               nReads, lastReads = 0;  /* # of reads counted meanwhile */
+    Boolean             throttled;              /* TRUE if the other threads read since the last write */
+    Boolean             written;                /* TRUE if the page/train was written */
+    Boolean             stop = FALSE;           /* TRUE if the checkpoint is stopped */
+
+
+    if (duration < 0) ERR(eBADPARAMETER_EDUBFM);
+
+    pthread_mutex_lock(&ckptSerialMutex);
+
+    for (maxEntries = 0, type = 0; type < NUM_BUF_TYPES; type++) {
+        maxEntries += BI_NBUFS(type);
+        maxSize = MAX(maxSize, BI_BUFSIZE(type));
+    }
+
+    // O_DIRECT로 attach 된 volume에도 기록할 수 있도록 page 단위로 정렬된 buffer를 할당함
+    entries = (BulkFlushEntry *)malloc(sizeof(BulkFlushEntry) * MAX(maxEntries, 1));
+    if (entries == NULL || posix_memalign((void **)&copy, PAGESIZE, PAGESIZE * maxSize) != 0) {
+        free(entries);
+        pthread_mutex_unlock(&ckptSerialMutex);
+        ERR(eMEMALLOCERR_EDUBFM);
+    }
+
+    pthread_mutex_lock(&ckptMutex);
+    ckptStart = edubfm_ckpt_Now();
+    ckptStats.inProgress = TRUE;
+    ckptStats.nToWrite = ckptStats.nWritten = ckptStats.nSkipped = 0;
+    pthread_mutex_unlock(&ckptMutex);
+
+    // 수정된 buffer element들을 partition 별로 모아 (volNo, pageNo) 순으로 정렬함
+    e = edubfm_ckpt_Collect(entries, &nEntries);
+    if (e >= eNOERROR) qsort(entries, nEntries, sizeof(BulkFlushEntry), edubfm_CompareFlushEntry);
+    else nEntries = 0;
+
+    pthread_mutex_lock(&ckptMutex);
+    ckptStats.nToWrite = nEntries;
+    pthread_mutex_unlock(&ckptMutex);
+
+    edubfm_nCheckpointReads = 0;
+    edubfm_checkpointActive = TRUE;
+
+    for (k = 0; k < nEntries; k++) {
+        // 다른 thread들이 그 사이에 page/train을 읽었으면, 이번 기록은 window 전체에 걸친 일정에 맞추어 늦춤
+        nReads = edubfm_nCheckpointReads;
+        throttled = (nReads != lastReads);
+        lastReads = nReads;
+
+        window = (UEight)duration * 1000000 * (throttled ? 100 : CHECKPOINT_TARGET_PERCENT) / 100;
+        due = ckptStart + window * k / nEntries;
+
+        if (throttled && due > edubfm_ckpt_Now()) {
+            pthread_mutex_lock(&ckptMutex);
+            ckptStats.nThrottled++;
+            pthread_mutex_unlock(&ckptMutex);
+        }
+
+        stop = edubfm_ckpt_SleepUntil(due);
+        if (stop) break;
+
+        e = edubfm_ckpt_Write(&entries[k], copy, &written);
+        if (e < eNOERROR) break;
+
+        pthread_mutex_lock(&ckptMutex);
+        if (written) ckptStats.nWritten++;
+        else ckptStats.nSkipped++;
+        pthread_mutex_unlock(&ckptMutex);
+    }
+
+    edubfm_checkpointActive = FALSE;
+
+    // Mapping 된 volume들과 variable-size train pool의 수정된 page/train들을 disk에 기록함
+    if (e >= eNOERROR && !stop && edubfm_nMappedVolumes > 0) e = edubfm_FlushMappedVolumes();
+    if (e >= eNOERROR && !stop) e = edubfm_FlushVarTrains();
+
+    pthread_mutex_lock(&ckptMutex);
+    ckptStats.inProgress = FALSE;
+    ckptStats.elapsed = (edubfm_ckpt_Now() - ckptStart) / 1000000;
+    if (e >= eNOERROR && !stop) ckptStats.nCheckpoints++;
+    else ckptStats.nAborted++;
+    pthread_mutex_unlock(&ckptMutex);
+
+    free(copy);
+    free(entries);
+
+    pthread_mutex_unlock(&ckptSerialMutex);
+
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+}  /* edubfm_Checkpoint */
+
+
+
+/*@================================
+ * edubfm_GetCheckpointStats()
+ *================================*/
+/*
+ * Function: void edubfm_GetCheckpointStats(EduBfM_CheckpointStats *)
+ *
+ * Description:
+ *  Return the progress of the checkpoints since EduBfM_Init().
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_GetCheckpointStats(
+    EduBfM_CheckpointStats  *stats)             /* OUT progress */
+{
+    pthread_mutex_lock(&ckptMutex);
+    *stats = ckptStats;
+    if (ckptStats.inProgress) stats->elapsed = (edubfm_ckpt_Now() - ckptStart) / 1000000;
+    pthread_mutex_unlock(&ckptMutex);
+
+}  /* edubfm_GetCheckpointStats */
+
+
+
+/*@================================
+ * edubfm_ResetCheckpointStats()
+ *================================*/
+/*
+ * Function: void edubfm_ResetCheckpointStats(void)
+ *
+ * Description:
+ *  Reset the progress of the checkpoints, called by EduBfM_Init().
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_ResetCheckpointStats(void)
+{
+    pthread_mutex_lock(&ckptMutex);
+    memset(&ckptStats, 0, sizeof(EduBfM_CheckpointStats));
+    pthread_mutex_unlock(&ckptMutex);
+
+}  /* edubfm_ResetCheckpointStats */
+
+
+
+/* return the current time of the clock used by pthread_cond_timedwait() (unit: nsec) */
+static UEight edubfm_ckpt_Now(void)
+{
+    struct timespec     ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    return( (UEight)ts.tv_sec * 1000000000ULL + ts.tv_nsec );
+
+}  /* edubfm_ckpt_Now */
+
+
+
+/*
+ * Function: static Boolean edubfm_ckpt_SleepUntil(UEight)
+ *
+ * Description:
+ *  Sleep until the given time, or until the checkpoints are requested to stop.
+ *
+ * Returns:
+ *  TRUE if the checkpoints are requested to stop
+ */
+static Boolean edubfm_ckpt_SleepUntil(
+    UEight              due)                    /* IN time to wake up (unit: nsec) */
+{
+    Boolean             stop;
+    struct timespec     ts;
+
+    ts.tv_sec = due / 1000000000ULL;
+    ts.tv_nsec = due % 1000000000ULL;
+
+    pthread_mutex_lock(&ckptMutex);
+    while (!ckptStop && edubfm_ckpt_Now() < due)
+        pthread_cond_timedwait(&ckptCond, &ckptMutex, &ts);
+    stop = ckptStop;
+    pthread_mutex_unlock(&ckptMutex);
+
+    return(stop);
+
+}  /* edubfm_ckpt_SleepUntil */
+
+
+
+/*
+ * Function: static Four edubfm_ckpt_Collect(BulkFlushEntry *, Four *)
+ *
+ * Description:
+ *  Collect the dirty buffer elements of all buffer pools, holding the
+ *  latch of one partition at a time.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four edubfm_ckpt_Collect(
+    BulkFlushEntry      *entries,               /* OUT dirty buffer elements */
+    Four                *nEntries)              /* OUT # of them */
+{
+    Four                e;                      /* for error */
+    Four                type, p, i;
+    BufferPartition     *part;                  /* a partition */
+
+    *nEntries = 0;
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        for (p = 0; p < PI_NLOOP(type); p++) {
+            part = PI_PART(type, p);
+
+            e = edubfm_LatchPartition(part);
+            if (e < 0) ERR(e);
+
+            for (i = part->firstBuf; i < part->firstBuf + part->nBufs; i++) {
+                if (BI_BITS(type, i) & DIRTY) {
+                    entries[*nEntries].key = BI_KEY(type, i);
+                    entries[*nEntries].type = type;
+                    entries[*nEntries].index = i;
+                    (*nEntries)++;
+                }
+            }
+
+            e = edubfm_UnlatchPartition(part);
+            if (e < 0) ERR(e);
+        }
+    }
+
+    return(eNOERROR);
+
+}  /* edubfm_ckpt_Collect */
+
+
+
+/*
+ * Function: static Four edubfm_ckpt_Write(BulkFlushEntry *, char *, Boolean *)
+ *
+ * Description:
+ *  Write the page/train collected by the checkpoint if its buffer element
+ *  still holds it dirty. It is copied and, unless it is fixed, marked clean
+ *  under the latch of its partition, and the copy is written after the
+ *  latch is released. The I/O latch is acquired before the partition latch
+ *  is released, so that the page/train cannot be read from the disk again
+ *  before it is written. If the write fails, the buffer element is marked
+ *  dirty again if it still holds the same page/train.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four edubfm_ckpt_Write(
+    BulkFlushEntry      *entry,                 /* IN dirty buffer element collected */
+    char                *copy,                  /* IN buffer for the copy of the page/train */
+    Boolean             *written)               /* OUT TRUE if it was written, FALSE if skipped */
+{
+    Four                e, e2;                  /* for error */
+    Four                type = entry->type;     /* buffer type */
+    Four                index = entry->index;   /* array index of the buffer element */
+    Boolean             fixed;                  /* TRUE if the page/train is fixed */
+    BufferPartition     *part;                  /* partition of the page/train */
+
+    *written = FALSE;
+
+    part = edubfm_GetPartition(&entry->key, type);
+
+    e = edubfm_LatchPartition(part);
+    if (e < 0) ERR(e);
+
+    // 그 사이에 기록되었거나 교체된 (교체될 때 기록된) page/train, 또는 줄어든 partition에서 제거된 page/train은 건너뜀
+    if (index >= part->firstBuf + part->nBufs || !EQUALKEY(&BI_KEY(type, index), &entry->key) ||
+        !(BI_BITS(type, index) & DIRTY)) {
+        e = edubfm_UnlatchPartition(part);
+        if (e < 0) ERR(e);
+
+        return(eNOERROR);
+    }
+
+    // Fix 된 page/train은 그 사이에 수정될 수 있으므로, 기록하되 DIRTY bit는 그대로 둠
+    memcpy(copy, BI_BUFFER(type, index), PAGESIZE * BI_BUFSIZE(type));
+    fixed = (BI_FIXED(type, index) != 0);
+    if (!fixed) BI_BITS(type, index) &= ~DIRTY;
+
+    // Partition의 latch를 해제하기 전에 I/O latch를 획득하여, 기록이 끝나기 전에 같은 page/train이 다시 읽히지 않도록 함
+    e = edubfm_LatchIO();
+    if (e < 0) {
+        if (!fixed) BI_BITS(type, index) |= DIRTY;
+        ERR_UNLATCH(e, part);
+    }
+
+    e = edubfm_UnlatchPartition(part);
+    if (e < 0) {
+        edubfm_UnlatchIO();
+        ERR(e);
+    }
+
+    e = edubfm_WriteTrain((TrainID *)&entry->key, copy, type);
+
+    edubfm_UnlatchIO();
+
+    e2 = edubfm_LatchPartition(part);
+    if (e2 < 0) ERR(e2);
+
+    if (e < 0) {
+        if (!fixed && EQUALKEY(&BI_KEY(type, index), &entry->key)) BI_BITS(type, index) |= DIRTY;
+        ERR_UNLATCH(e, part);
+    }
+
+    part->writerStats.nCheckpointWrites++;
+    BFM_STATS( part->stats.nWriteBacks++ );
+
+    e = edubfm_UnlatchPartition(part);
+    if (e < 0) ERR(e);
+
+    *written = TRUE;
+
+    return(eNOERROR);
+
+}  /* edubfm_ckpt_Write */
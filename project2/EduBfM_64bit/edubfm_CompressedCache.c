@@ -0,0 +1,702 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_CompressedCache.c
+ *
+ * Description:
+ *  The compressed cache, a second tier below the buffer pools which keeps
+ *  the pages/trains replaced from them compressed in a bounded arena.
+ *  edubfm_EvictTrain() stores each replaced page/train (written first if
+ *  it was dirty) unless it does not compress to CCACHE_MAX_PERCENT % of
+ *  its size, and edubfm_ReadTrain() looks a page/train up here before
+ *  reading it from disk. A page/train read back is removed, so that the
+ *  compressed cache never holds a page/train which is in a buffer pool and
+ *  may be modified there.
+ *  The arena is a circular log: the compressed pages/trains are appended
+ *  at its head, and the oldest ones are dropped to make room.
+ *  The pages/trains are compressed by a byte-oriented LZ77 codec in the
+ *  format of LZ4 blocks, which is fast enough to run on every replacement.
+ *  edubfm_ccMutex protects the arena, the entries and the counters, and
+ *  no other latch is acquired while it is held.
+ *  Only the pages/trains read and written through EduBfM are tracked; if
+ *  the storage system writes a page on its own, EduBfM_DiscardAll() must
+ *  be called, which empties the compressed cache, too.
+ *
+ * Exports:
+ *  Four edubfm_StartCompressedCache(Four)
+ *  void edubfm_StopCompressedCache(void)
+ *  void edubfm_CompressedCacheInsert(BfMHashKey *, Four, char *)
+ *  Boolean edubfm_CompressedCacheRead(TrainID *, char *, Four)
+ *  void edubfm_CompressedCacheClear(void)
+ */
+
+
+#include <stdlib.h> /* for malloc & free */
+#include <string.h> /* for memcpy */
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* minimum length of a match of the codec */
+#define CC_MIN_MATCH            4
+/* # of bits of the hash of 4 bytes used to find the matches */
+#define CC_HASH_BITS            12
+
+/* Macro: CC_ALIGN(n)
+ * Description: round the size of a compressed page/train up to CCACHE_ALIGN
+ */
+#define CC_ALIGN(n)             (((n) + CCACHE_ALIGN - 1) & ~(CCACHE_ALIGN - 1))
+
+
+/* counters of the compressed cache */
+EduBfM_CompressedCacheStats edubfm_ccStats;
+pthread_mutex_t         edubfm_ccMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* arena (NULL : no compressed cache) and its size */
+static char             *edubfm_ccArena = NULL;
+static Four             edubfm_ccSize;
+/* offset in the arena where the next page/train is stored */
+static Four             edubfm_ccHead;
+
+/* entries, allocated circularly in the order of their offsets in the arena */
+static CompressedEntry  *edubfm_ccEntries = NULL;
+static Four             edubfm_ccMaxEntries;
+static Four             edubfm_ccFirst;         /* oldest entry */
+static Four             edubfm_ccNUsed;         /* # of entries in use, including the removed ones not yet dropped */
+
+/* hash table of the entries */
+static Four             *edubfm_ccHashTable = NULL;
+static Four             edubfm_ccHashBits;
+
+
+static Four edubfm_cc_Hash(BfMHashKey *, Four);
+static Four edubfm_cc_Find(BfMHashKey *, Four);
+static void edubfm_cc_Remove(Four);
+static void edubfm_cc_DropOldest(void);
+static Four edubfm_cc_PutLength(unsigned char *, Four, Four);
+static Four edubfm_cc_PutSequence(unsigned char *, Four, Four, unsigned char *, Four, Four, Four, Four);
+static Four edubfm_cc_Compress(unsigned char *, Four, unsigned char *, Four);
+static Boolean edubfm_cc_Decompress(unsigned char *, Four, unsigned char *, Four);
+
+
+
+/*@================================
+ * edubfm_StartCompressedCache()
+ *================================*/
+/*
+ * Function: Four edubfm_StartCompressedCache(Four)
+ *
+ * Description:
+ *  Allocate an empty compressed cache of the given size (at least
+ *  CCACHE_MIN_SIZE bytes), replacing the one allocated before, if any,
+ *  and reset its counters. Its entry table has one entry per
+ *  CCACHE_ENTRY_BYTES bytes of the arena.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ */
+Four edubfm_StartCompressedCache(
+    Four                size)                   /* IN size of the arena (unit: bytes) */
+{
+    edubfm_StopCompressedCache();
+
+    edubfm_ccMaxEntries = size / CCACHE_ENTRY_BYTES;
+    for (edubfm_ccHashBits = 1; (1 << edubfm_ccHashBits) < edubfm_ccMaxEntries; edubfm_ccHashBits++);
+
+    edubfm_ccArena = (char *)malloc(size);
+    edubfm_ccEntries = (CompressedEntry *)malloc(sizeof(CompressedEntry) * edubfm_ccMaxEntries);
+    edubfm_ccHashTable = (Four *)malloc(sizeof(Four) * (1 << edubfm_ccHashBits));
+    if (edubfm_ccArena == NULL || edubfm_ccEntries == NULL || edubfm_ccHashTable == NULL) {
+        edubfm_StopCompressedCache();
+        ERR(eMEMALLOCERR_EDUBFM);
+    }
+
+    edubfm_ccSize = size;
+    edubfm_CompressedCacheClear();
+
+    pthread_mutex_lock(&edubfm_ccMutex);
+    memset(&edubfm_ccStats, 0, sizeof(EduBfM_CompressedCacheStats));
+    pthread_mutex_unlock(&edubfm_ccMutex);
+
+    return(eNOERROR);
+
+}  /* edubfm_StartCompressedCache() */
+
+
+
+/*@================================
+ * edubfm_StopCompressedCache()
+ *================================*/
+/*
+ * Function: void edubfm_StopCompressedCache(void)
+ *
+ * Description:
+ *  Free the compressed cache, if any. Its counters are left as they are.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_StopCompressedCache(void)
+{
+    pthread_mutex_lock(&edubfm_ccMutex);
+
+    free(edubfm_ccArena);
+    free(edubfm_ccEntries);
+    free(edubfm_ccHashTable);
+    edubfm_ccArena = NULL;
+    edubfm_ccEntries = NULL;
+    edubfm_ccHashTable = NULL;
+
+    pthread_mutex_unlock(&edubfm_ccMutex);
+
+}  /* edubfm_StopCompressedCache() */
+
+
+
+/*@================================
+ * edubfm_CompressedCacheInsert()
+ *================================*/
+/*
+ * Function: void edubfm_CompressedCacheInsert(BfMHashKey *, Four, char *)
+ *
+ * Description:
+ *  Store the given page/train, which is being replaced from the buffer
+ *  pool and is the same as on disk, in the compressed cache. It is
+ *  compressed before edubfm_ccMutex is acquired, and not stored if it does
+ *  not compress to CCACHE_MAX_PERCENT % of its size; the oldest
+ *  pages/trains are dropped if there is no room for it.
+ *  Nothing is done if there is no compressed cache.
+ *
+ * Returns:
+ *  None
+ *
+ * 설명:
+ *  bufferPool에서 교체되는 page/train을 압축하여 compressed cache에 저장함
+ */
+void edubfm_CompressedCacheInsert(
+    BfMHashKey          *key,                   /* IN hash key of the page/train */
+    Four                type,                   /* IN buffer type */
+    char                *aTrain)                /* IN the page/train */
+{
+    Four                idx;                    /* index of the entry */
+    Four                nBytes;                 /* size of the page/train */
+    Four                length;                 /* size of the compressed page/train */
+    CompressedEntry     *entry;                 /* entry of the page/train */
+    unsigned char       out[PAGESIZE * CCACHE_MAX_TRAIN_PAGES]; /* compressed page/train (larger than the max. size kept) */
+
+
+    if (edubfm_ccArena == NULL || BI_BUFSIZE(type) > CCACHE_MAX_TRAIN_PAGES) return;
+
+    nBytes = PAGESIZE * BI_BUFSIZE(type);
+    length = edubfm_cc_Compress((unsigned char *)aTrain, nBytes, out, nBytes * CCACHE_MAX_PERCENT / 100);
+
+    pthread_mutex_lock(&edubfm_ccMutex);
+
+    if (edubfm_ccArena == NULL) {
+        pthread_mutex_unlock(&edubfm_ccMutex);
+        return;
+    }
+
+    // 이전에 저장된 같은 page/train이 남아 있으면 제거함
+    idx = edubfm_cc_Find(key, type);
+    if (idx != NIL) edubfm_cc_Remove(idx);
+
+    if (length == NIL) {
+        edubfm_ccStats.nRejected++;
+        pthread_mutex_unlock(&edubfm_ccMutex);
+        return;
+    }
+
+    // Arena의 끝에 공간이 부족하면 끝부분을 건너뛰고 처음부터 저장하며, 건너뛴 부분의 entry들을 먼저 제거함
+    if (edubfm_ccHead + CC_ALIGN(length) > edubfm_ccSize) {
+        while (edubfm_ccNUsed > 0 && edubfm_ccEntries[edubfm_ccFirst].offset >= edubfm_ccHead) edubfm_cc_DropOldest();
+        edubfm_ccHead = 0;
+    }
+
+    // 저장할 위치와 겹치는 entry들을 오래된 것부터 제거함 (entry table이 가득 찬 경우에도 제거함)
+    while (edubfm_ccNUsed > 0 &&
+           (edubfm_ccNUsed == edubfm_ccMaxEntries ||
+            (edubfm_ccEntries[edubfm_ccFirst].offset >= edubfm_ccHead &&
+             edubfm_ccEntries[edubfm_ccFirst].offset < edubfm_ccHead + CC_ALIGN(length)))) edubfm_cc_DropOldest();
+
+    idx = (edubfm_ccFirst + edubfm_ccNUsed) % edubfm_ccMaxEntries;
+    edubfm_ccNUsed++;
+
+    entry = &edubfm_ccEntries[idx];
+    entry->key = *key;
+    entry->type = type;
+    entry->offset = edubfm_ccHead;
+    entry->length = length;
+    memcpy(edubfm_ccArena + entry->offset, out, length);
+    edubfm_ccHead += CC_ALIGN(length);
+
+    entry->nextHashEntry = edubfm_ccHashTable[edubfm_cc_Hash(key, type)];
+    edubfm_ccHashTable[edubfm_cc_Hash(key, type)] = idx;
+
+    edubfm_ccStats.nInserts++;
+    edubfm_ccStats.nBytesIn += nBytes;
+    edubfm_ccStats.nBytesStored += length;
+    edubfm_ccStats.nEntries++;
+    edubfm_ccStats.nBytesUsed += CC_ALIGN(length);
+
+    pthread_mutex_unlock(&edubfm_ccMutex);
+
+}  /* edubfm_CompressedCacheInsert() */
+
+
+
+/*@================================
+ * edubfm_CompressedCacheRead()
+ *================================*/
+/*
+ * Function: Boolean edubfm_CompressedCacheRead(TrainID *, char *, Four)
+ *
+ * Description:
+ *  If the given page/train is in the compressed cache, decompress it into
+ *  the given buffer and remove it from the compressed cache.
+ *
+ * Returns:
+ *  TRUE if the page/train has been read from the compressed cache, otherwise FALSE
+ *
+ * 설명:
+ *  Page/train이 compressed cache에 있으면 압축을 풀어 buffer element에 저장함
+ */
+Boolean edubfm_CompressedCacheRead(
+    TrainID             *trainId,               /* IN page/train to be read */
+    char                *aTrain,                /* OUT buffer */
+    Four                type)                   /* IN buffer type */
+{
+    Four                idx;                    /* index of the entry */
+    Boolean             found;                  /* TRUE if the page/train has been read */
+
+
+    if (edubfm_ccArena == NULL) return(FALSE);
+
+    pthread_mutex_lock(&edubfm_ccMutex);
+
+    if (edubfm_ccArena == NULL) {
+        pthread_mutex_unlock(&edubfm_ccMutex);
+        return(FALSE);
+    }
+
+    edubfm_ccStats.nLookUps++;
+
+    idx = edubfm_cc_Find((BfMHashKey *)trainId, type);
+    if (idx == NIL) {
+        pthread_mutex_unlock(&edubfm_ccMutex);
+        return(FALSE);
+    }
+
+    found = edubfm_cc_Decompress((unsigned char *)edubfm_ccArena + edubfm_ccEntries[idx].offset, edubfm_ccEntries[idx].length,
+                                 (unsigned char *)aTrain, PAGESIZE * BI_BUFSIZE(type));
+    if (found) edubfm_ccStats.nHits++;
+
+    // bufferPool에서 수정될 수 있으므로 compressed cache에서는 제거함
+    edubfm_cc_Remove(idx);
+
+    pthread_mutex_unlock(&edubfm_ccMutex);
+
+    return(found);
+
+}  /* edubfm_CompressedCacheRead() */
+
+
+
+/*@================================
+ * edubfm_CompressedCacheClear()
+ *================================*/
+/*
+ * Function: void edubfm_CompressedCacheClear(void)
+ *
+ * Description:
+ *  Remove all pages/trains from the compressed cache, if any.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_CompressedCacheClear(void)
+{
+    Four                i;                      /* index */
+
+
+    pthread_mutex_lock(&edubfm_ccMutex);
+
+    if (edubfm_ccArena != NULL) {
+        for (i = 0; i < (1 << edubfm_ccHashBits); i++) edubfm_ccHashTable[i] = NIL;
+
+        edubfm_ccHead = 0;
+        edubfm_ccFirst = 0;
+        edubfm_ccNUsed = 0;
+        edubfm_ccStats.nEntries = 0;
+        edubfm_ccStats.nBytesUsed = 0;
+    }
+
+    pthread_mutex_unlock(&edubfm_ccMutex);
+
+}  /* edubfm_CompressedCacheClear() */
+
+
+
+/*@================================
+ * edubfm_cc_Hash()
+ *================================*/
+/*
+ * Function: static Four edubfm_cc_Hash(BfMHashKey *, Four)
+ *
+ * Description:
+ *  Return the bucket of the hash table of the given page/train. The high
+ *  bits of a multiplicative hash are used, so that the trains, whose
+ *  pageNos are multiples of their size, spread over all buckets.
+ *
+ * Returns:
+ *  bucket number
+ */
+static Four edubfm_cc_Hash(
+    BfMHashKey          *key,                   /* IN hash key of the page/train */
+    Four                type)                   /* IN buffer type */
+{
+    UFour               h;                      /* hash value */
+
+    h = ((UFour)key->pageNo ^ ((UFour)key->volNo << 20) ^ ((UFour)type << 30)) * 2654435761U;
+
+    return( (Four)(h >> (32 - edubfm_ccHashBits)) );
+
+}  /* edubfm_cc_Hash() */
+
+
+
+/*@================================
+ * edubfm_cc_Find()
+ *================================*/
+/*
+ * Function: static Four edubfm_cc_Find(BfMHashKey *, Four)
+ *
+ * Description:
+ *  Find the entry of the given page/train. The caller must hold edubfm_ccMutex.
+ *
+ * Returns:
+ *  index of the entry (NIL : not found)
+ */
+static Four edubfm_cc_Find(
+    BfMHashKey          *key,                   /* IN hash key of the page/train */
+    Four                type)                   /* IN buffer type */
+{
+    Four                idx;                    /* index of an entry */
+
+    for (idx = edubfm_ccHashTable[edubfm_cc_Hash(key, type)]; idx != NIL; idx = edubfm_ccEntries[idx].nextHashEntry)
+        if (edubfm_ccEntries[idx].type == type && EQUALKEY(&edubfm_ccEntries[idx].key, key)) break;
+
+    return( idx );
+
+}  /* edubfm_cc_Find() */
+
+
+
+/*@================================
+ * edubfm_cc_Remove()
+ *================================*/
+/*
+ * Function: static void edubfm_cc_Remove(Four)
+ *
+ * Description:
+ *  Remove the given entry from the hash table. Its space in the arena is
+ *  reused when it becomes the oldest entry and is dropped.
+ *  The caller must hold edubfm_ccMutex.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_cc_Remove(
+    Four                idx)                    /* IN index of the entry */
+{
+    Four                *link;                  /* link to the entry */
+    CompressedEntry     *entry = &edubfm_ccEntries[idx];
+
+    for (link = &edubfm_ccHashTable[edubfm_cc_Hash(&entry->key, entry->type)]; *link != idx;
+         link = &edubfm_ccEntries[*link].nextHashEntry);
+    *link = entry->nextHashEntry;
+
+    SET_NILBFMHASHKEY(entry->key);
+
+    edubfm_ccStats.nEntries--;
+    edubfm_ccStats.nBytesUsed -= CC_ALIGN(entry->length);
+
+}  /* edubfm_cc_Remove() */
+
+
+
+/*@================================
+ * edubfm_cc_DropOldest()
+ *================================*/
+/*
+ * Function: static void edubfm_cc_DropOldest(void)
+ *
+ * Description:
+ *  Drop the oldest entry, removing its page/train if it is still in the
+ *  compressed cache. The caller must hold edubfm_ccMutex.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_cc_DropOldest(void)
+{
+    if (!IS_NILBFMHASHKEY(edubfm_ccEntries[edubfm_ccFirst].key)) {
+        edubfm_cc_Remove(edubfm_ccFirst);
+        edubfm_ccStats.nEvictions++;
+    }
+
+    edubfm_ccFirst = (edubfm_ccFirst + 1) % edubfm_ccMaxEntries;
+    edubfm_ccNUsed--;
+
+}  /* edubfm_cc_DropOldest() */
+
+
+
+/*@================================
+ * edubfm_cc_PutLength()
+ *================================*/
+/*
+ * Function: static Four edubfm_cc_PutLength(unsigned char *, Four, Four)
+ *
+ * Description:
+ *  Write the rest of a length which did not fit in its 4 bits of the
+ *  token (the length minus 15) as a run of 255s ended by a smaller byte.
+ *
+ * Returns:
+ *  offset following the length
+ */
+static Four edubfm_cc_PutLength(
+    unsigned char       *dst,                   /* OUT compressed page/train */
+    Four                op,                     /* IN offset to write the length */
+    Four                len)                    /* IN length minus 15 */
+{
+    for (; len >= 255; len -= 255) dst[op++] = 255;
+    dst[op++] = (unsigned char)len;
+
+    return( op );
+
+}  /* edubfm_cc_PutLength() */
+
+
+
+/*@================================
+ * edubfm_cc_PutSequence()
+ *================================*/
+/*
+ * Function: static Four edubfm_cc_PutSequence(unsigned char *, Four, Four, unsigned char *, Four, Four, Four, Four)
+ *
+ * Description:
+ *  Write a sequence of the codec: a token with the # of literals and the
+ *  length of the match, the literals, and the offset of the match.
+ *  The last sequence of a page/train has no match (matchLen == 0).
+ *  dst must have 16 bytes of room after maxOut bytes.
+ *
+ * Returns:
+ *  offset following the sequence (NIL : it does not fit in maxOut bytes)
+ */
+static Four edubfm_cc_PutSequence(
+    unsigned char       *dst,                   /* OUT compressed page/train */
+    Four                op,                     /* IN offset to write the sequence */
+    Four                maxOut,                 /* IN max. size of the compressed page/train */
+    unsigned char       *literals,              /* IN literals */
+    Four                litLen,                 /* IN # of literals */
+    Four                srcLeft,                /* IN # of bytes of the page/train from the literals to its end */
+    Four                offset,                 /* IN offset of the match */
+    Four                matchLen)               /* IN length of the match (0 : no match) */
+{
+    Four                token;                  /* offset of the token */
+    Four                mlen;                   /* length of the match minus CC_MIN_MATCH */
+
+    if (op + 1 + litLen / 255 + 1 + litLen + 2 + matchLen / 255 + 1 > maxOut) return(NIL);
+
+    token = op++;
+    dst[token] = (unsigned char)(MIN(litLen, 15) << 4);
+    if (litLen >= 15) op = edubfm_cc_PutLength(dst, op, litLen - 15);
+
+    // 짧은 literal들은 16 bytes를 한 번에 복사함 (page/train의 끝을 넘어 읽지 않는 경우)
+    if (litLen <= 16 && srcLeft >= 16) memcpy(dst + op, literals, 16);
+    else memcpy(dst + op, literals, litLen);
+    op += litLen;
+
+    if (matchLen == 0) return(op);
+
+    dst[op++] = (unsigned char)(offset & 0xff);
+    dst[op++] = (unsigned char)(offset >> 8);
+
+    mlen = matchLen - CC_MIN_MATCH;
+    dst[token] |= (unsigned char)MIN(mlen, 15);
+    if (mlen >= 15) op = edubfm_cc_PutLength(dst, op, mlen - 15);
+
+    return( op );
+
+}  /* edubfm_cc_PutSequence() */
+
+
+
+/*@================================
+ * edubfm_cc_Compress()
+ *================================*/
+/*
+ * Function: static Four edubfm_cc_Compress(unsigned char *, Four, unsigned char *, Four)
+ *
+ * Description:
+ *  Compress a page/train (at most 64KB) into a block of the format of LZ4.
+ *  Each position is hashed by its next 4 bytes to find the last position
+ *  with the same hash, and a match of at least CC_MIN_MATCH bytes found
+ *  there is extended as far as possible. The positions are skipped faster
+ *  as the literals run longer, so that the data which does not compress
+ *  is given up soon. The mismatch in 8 bytes is located assuming a little
+ *  endian CPU. dst must have 16 bytes of room after maxOut bytes.
+ *
+ * Returns:
+ *  size of the compressed page/train (NIL : it does not fit in maxOut bytes)
+ */
+static Four edubfm_cc_Compress(
+    unsigned char       *src,                   /* IN page/train */
+    Four                n,                      /* IN size of the page/train */
+    unsigned char       *dst,                   /* OUT compressed page/train */
+    Four                maxOut)                 /* IN max. size of the compressed page/train */
+{
+    Four                ip = 0;                 /* current position */
+    Four                anchor = 0;             /* first literal not yet written */
+    Four                op = 0;                 /* size written */
+    Four                cand;                   /* candidate position of a match */
+    Four                len;                    /* length of a match */
+    UFour               seq, seq2;              /* 4 bytes at ip and cand */
+    UEight              a, b;                   /* 8 bytes compared at once */
+    UTwo                table[1 << CC_HASH_BITS];   /* last position of each hash */
+
+
+    memset(table, 0, sizeof(table));
+
+    while (ip + CC_MIN_MATCH <= n) {
+        memcpy(&seq, src + ip, sizeof(UFour));
+        cand = table[(seq * 2654435761U) >> (32 - CC_HASH_BITS)];
+        table[(seq * 2654435761U) >> (32 - CC_HASH_BITS)] = (UTwo)ip;
+
+        memcpy(&seq2, src + cand, sizeof(UFour));
+        if (cand >= ip || seq2 != seq) {
+            ip += 1 + ((ip - anchor) >> 6);
+            continue;
+        }
+
+        // Match를 가능한 길게 늘림
+        // (8 bytes씩 비교하여, 다른 첫 byte의 위치를 xor의 trailing zero 수로 구함)
+        for (len = CC_MIN_MATCH; ip + len + (Four)sizeof(UEight) <= n; len += sizeof(UEight)) {
+            memcpy(&a, src + cand + len, sizeof(UEight));
+            memcpy(&b, src + ip + len, sizeof(UEight));
+            if (a != b) break;
+        }
+        if (ip + len + (Four)sizeof(UEight) <= n) len += __builtin_ctzll(a ^ b) >> 3;
+        else while (ip + len < n && src[cand + len] == src[ip + len]) len++;
+
+        op = edubfm_cc_PutSequence(dst, op, maxOut, src + anchor, ip - anchor, n - anchor, ip - cand, len);
+        if (op == NIL) return(NIL);
+
+        ip += len;
+        anchor = ip;
+    }
+
+    return( edubfm_cc_PutSequence(dst, op, maxOut, src + anchor, n - anchor, n - anchor, 0, 0) );
+
+}  /* edubfm_cc_Compress() */
+
+
+
+/*@================================
+ * edubfm_cc_Decompress()
+ *================================*/
+/*
+ * Function: static Boolean edubfm_cc_Decompress(unsigned char *, Four, unsigned char *, Four)
+ *
+ * Description:
+ *  Decompress a page/train compressed by edubfm_cc_Compress(), checking
+ *  that every literal and match stays within the buffers.
+ *
+ * Returns:
+ *  TRUE if exactly n bytes are decompressed, otherwise FALSE
+ */
+static Boolean edubfm_cc_Decompress(
+    unsigned char       *src,                   /* IN compressed page/train */
+    Four                length,                 /* IN size of the compressed page/train */
+    unsigned char       *dst,                   /* OUT page/train */
+    Four                n)                      /* IN size of the page/train */
+{
+    Four                ip = 0;                 /* position in the compressed page/train */
+    Four                op = 0;                 /* position in the page/train */
+    Four                token;                  /* token of a sequence */
+    Four                len;                    /* # of literals or length of a match */
+    Four                offset;                 /* offset of a match */
+    Four                b;                      /* a byte of a length */
+
+
+    while (ip < length) {
+        token = src[ip++];
+
+        len = token >> 4;
+        if (len == 15)
+            do {
+                if (ip >= length) return(FALSE);
+                b = src[ip++];
+                len += b;
+            } while (b == 255);
+
+        if (ip + len > length || op + len > n) return(FALSE);
+
+        // 짧은 literal들은 양쪽 buffer에 여유가 있으면 16 bytes를 한 번에 복사함
+        if (len <= 16 && ip + 16 <= length && op + 16 <= n) memcpy(dst + op, src + ip, 16);
+        else memcpy(dst + op, src + ip, len);
+        ip += len;
+        op += len;
+
+        // 마지막 sequence는 match 없이 끝남
+        if (ip == length) break;
+
+        if (ip + 2 > length) return(FALSE);
+        offset = src[ip] | (src[ip + 1] << 8);
+        ip += 2;
+
+        len = token & 15;
+        if (len == 15)
+            do {
+                if (ip >= length) return(FALSE);
+                b = src[ip++];
+                len += b;
+            } while (b == 255);
+        len += CC_MIN_MATCH;
+
+        if (offset == 0 || offset > op || op + len > n) return(FALSE);
+
+        // 겹치는 match는 한 byte씩 복사함
+        if (offset >= 16 && len <= 16 && op + 16 <= n) memcpy(dst + op, dst + op - offset, 16);
+        else if (offset >= len) memcpy(dst + op, dst + op - offset, len);
+        else for (b = 0; b < len; b++) dst[op + b] = dst[op - offset + b];
+        op += len;
+    }
+
+    return( op == n );
+
+}  /* edubfm_cc_Decompress() */
@@ -30,9 +30,11 @@
  *
  * Exports:
  *  Four edubfm_FlushTrain(TrainID *, Four)
+ *  Four edubfm_WriteTrain(TrainID *, char *, Four)
  */
 
 
+#include <unistd.h>
 #include "EduBfM_common.h"
 #include "RDsM.h"
 #include "RM.h"
@@ -65,7 +67,7 @@
  * 
  * 관련 함수:
  *  1. edubfm_LookUp()
- *  2. RDsM_WriteTrain()
+ *  2. edubfm_WriteTrain()
  */
 Four edubfm_FlushTrain(
     TrainID 			*trainId,		/* IN train to be flushed */
@@ -87,7 +89,13 @@ Four edubfm_FlushTrain(
 
     // 해당 buffer element에 대한 DIRTY bit가 1로 set 된 경우, 해당 page/train을 disk에 기록함
     if (BI_BITS(type, index) & DIRTY) {
-        e = RDsM_WriteTrain(BI_BUFFER(type, index), (PageID *) trainId, BI_BUFSIZE(type));
+        // RDsM은 reentrant 하지 않으므로, partition된 경우 I/O latch를 획득한 후 disk에 기록함
+        e = edubfm_LatchIO();
+        if (e < 0) ERR(e);
+
+        e = edubfm_WriteTrain(trainId, BI_BUFFER(type, index), type);
+
+        edubfm_UnlatchIO();
         if(e < 0) ERR(e);
 
         // 해당 DIRTY bit를 unset 함
@@ -97,3 +105,73 @@ Four edubfm_FlushTrain(
     return( eNOERROR );
 
 }  /* edubfm_FlushTrain */
+
+
+
+/*@================================
+ * edubfm_WriteTrain()
+ *================================*/
+/*
+ * Function: Four edubfm_WriteTrain(TrainID *, char *, Four)
+ *
+ * Description :
+ *  Write the contents of 'aTrain' to the train specified by 'trainId'.
+ *  If the volume is attached with O_DIRECT, the train is written to its
+ *  device directly ('aTrain' must be page aligned); otherwise it is
+ *  written by RDsM_WriteTrain(). The caller must hold the I/O latch.
+ *  If the asynchronous I/O is running, the train of any attached volume is
+ *  written by it, which orders the write against the other reads and
+ *  writes of the train in flight.
+ *
+ * Returns:
+ *  error code
+ *    eVOLUMEIOERR_EDUBFM - Writing to the device of an attached volume failed.
+ *    some errors caused by RDsM_WriteTrain()
+ *
+ * 설명:
+ *  Buffer의 내용을 disk의 page/train에 기록함
+ */
+Four edubfm_WriteTrain(
+    TrainID             *trainId,               /* IN train to be written */
+    char                *aTrain,                /* IN contents of the train */
+    Four                type)                   /* IN buffer type */
+{
+    Four                e;                      /* for errors */
+    Four                fd;                     /* file descriptor of the device */
+    ssize_t             nBytes;                 /* # of bytes to be written */
+    UEight              due;                    /* time when the write of a memory volume completes */
+    BfMIORequest        req;                    /* asynchronous write */
+
+    BFM_TRACE(BFM_TRACE_WRITE, trainId, type);
+
+    // 비동기 I/O를 사용하는 경우, attach 된 volume의 page/train은 제출하고 완료될 때까지 기다림
+    if (AIO_RUNNING() && edubfm_VolumeFd(trainId->volNo) != NIL) {
+        edubfm_PrepareIO(&req, BFM_IO_WRITE, trainId, aTrain, type);
+
+        e = edubfm_SubmitIO(&req, 1);
+        if (e < 0) ERR(e);
+
+        e = edubfm_WaitIO(&req, 1);
+        if (e < 0) ERR(e);
+
+        return( eNOERROR );
+    }
+
+    // O_DIRECT로 attach 된 volume인 경우, page cache를 거치지 않도록 device에 직접 기록함
+    fd = edubfm_DirectVolumeFd(trainId->volNo);
+    if (fd != NIL) {
+        nBytes = PAGESIZE * BI_BUFSIZE(type);
+        due = edubfm_MemoryVolumeCharge(trainId->volNo, nBytes);
+        if (pwrite(fd, aTrain, nBytes, (off_t)trainId->pageNo * PAGESIZE) != nBytes) ERR(eVOLUMEIOERR_EDUBFM);
+
+        edubfm_MemoryVolumeWait(due);
+
+        return( eNOERROR );
+    }
+
+    e = RDsM_WriteTrain(aTrain, (PageID *)trainId, BI_BUFSIZE(type));
+    if (e < 0) ERR(e);
+
+    return( eNOERROR );
+
+}  /* edubfm_WriteTrain */
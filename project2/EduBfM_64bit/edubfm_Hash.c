@@ -31,12 +31,16 @@
  *  and each entry has an index which indicates a buffer in a buffer pool.
  *  An ordinary hashing method is used and linear probing strategy is
  *  used if collision has occurred.
+ *  If BFM_OPEN_TABLE is used, the open addressing page table of the
+ *  partition of each key (edubfm_PageTable.c) is used instead.
  *
  * Exports:
  *  Four edubfm_LookUp(BfMHashKey *, Four)
  *  Four edubfm_Insert(BfMHaskKey *, Two, Four)
  *  Four edubfm_Delete(BfMHashKey *, Four)
  *  Four edubfm_DeleteAll(void)
+ *  Four edubfm_RebuildHashTable(Four)
+ *  Four edubfm_FindFrame(TrainID *, Four, BfMFrameHandle *)
  */
 
 
@@ -46,20 +50,6 @@
 
 
 
-/*@
- * macro definitions
- */  
-
-/* Macro: BFM_HASH(k,type)
- * Description: return the hash value of the key given as a parameter
- * Parameters:
- *  BfMHashKey *k   : pointer to the key
- *  Four type       : buffer type
- * Returns: (Two) hash value
- */
-#define BFM_HASH(k,type)	(((k)->volNo + (k)->pageNo) % HASHTABLESIZE(type))
-
-
 /*@================================
  * edubfm_Insert()
  *================================*/
@@ -88,6 +78,7 @@ Four edubfm_Insert(
 {
     Four 		i;			
     Two  		hashValue;
+    Four        e;              /* for error */
 
 
     CHECKKEY(key);    /*@ check validity of key */
@@ -97,6 +88,14 @@ Four edubfm_Insert(
 
     if(index < 0 || index > BI_NBUFS(type)) ERR(eBADBUFINDEX_BFM);
 
+    // Open addressing page table을 사용하는 경우, 해당 partition의 page table에 삽입함
+    if (PI_USEOPENTABLE(type)) {
+        e = edubfm_opt_Insert(PI_PAGETABLE(key, type), key, index);
+        if (e < 0) ERR(e);
+
+        return( eNOERROR );
+    }
+
     // 해당 buffer element에 저장된 page/train의 hash key value를 이용하여, 
     // hashTable에서 해당 array index를 삽입할 위치를 결정함
 
@@ -146,12 +145,21 @@ Four edubfm_Delete(
 {
     Two                 i, prev;                
     Two                 hashValue;
+    Four                e;                      /* for error */
 
     CHECKKEY(key);    /*@ check validity of key */
 
     /* Is the buffer type valid? */
     if(IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);	
 
+    // Open addressing page table을 사용하는 경우, 해당 partition의 page table에서 삭제함
+    if (PI_USEOPENTABLE(type)) {
+        e = edubfm_opt_Delete(PI_PAGETABLE(key, type), key);
+        if (e < 0) ERR(e);
+
+        return( eNOERROR );
+    }
+
     // 해당 buffer element에 저장된 page/train의 hash key value를 이용하여, 
     // 삭제할 buffer element의 array index를 hashTable에서 검색함
     hashValue = BFM_HASH(key, type);
@@ -220,12 +228,17 @@ Four edubfm_LookUp(
 {
     Two                 i, j;                   /* indices */
     Two                 hashValue;
+    UEight              steps = 0;              /* # of hash chain entries compared */
 
     CHECKKEY(key);    /*@ check validity of key */
 
     /* Is the buffer type valid? */
     if(IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);	
 
+    // Open addressing page table을 사용하는 경우, 해당 partition의 page table에서 검색함
+    if (PI_USEOPENTABLE(type))
+        return( edubfm_opt_LookUp(PI_PAGETABLE(key, type), key) );
+
     hashValue = BFM_HASH(key, type);
 
     // 해당 hash key를 갖는 page/train이 저장된 buffer element의 array index를 hashTable에서 검색함
@@ -233,19 +246,83 @@ Four edubfm_LookUp(
     i = BI_HASHTABLEENTRY(type, hashValue);
     
     while (i != NIL) {
+        BFM_STATS( steps++ );
+
         // 검색된 array index를 반환함
-        if (EQUALKEY(&BI_KEY(type, i), key)) return i;
+        if (EQUALKEY(&BI_KEY(type, i), key)) {
+            BFM_STATS( edubfm_StatsLookUp(hashValue, type, steps) );
+            return i;
+        }
         
         // 혹시나 hashValue가 같은 next 값이 있다면 똑같이 비교
         i = BI_NEXTHASHENTRY(type, i);
     }
     
+    BFM_STATS( edubfm_StatsLookUp(hashValue, type, steps) );
     return(NOTFOUND_IN_HTABLE);
     
 }  /* edubfm_LookUp */
 
 
 
+/*@================================
+ * edubfm_FindFrame()
+ *================================*/
+/*
+ * Function: Four edubfm_FindFrame(TrainID *, Four, BfMFrameHandle *)
+ *
+ * Description:
+ *  Look up the train, which must be fixed by the caller, under the latch
+ *  of its partition and return the handle of the buffer element holding
+ *  it. The handle stays valid after the latch is released, since a fixed
+ *  train is never replaced. The handle of a train of a mapped volume has
+ *  the index BFM_MAPPED_FRAME. If the trains of the buffer pool are fixed
+ *  without the latch, it is looked up without the latch first.
+ *
+ * Returns:
+ *  error code
+ *    eBADHASHKEY_BFM - The train isn't in the buffer pool.
+ *    some errors caused by function calls
+ *
+ * 설명:
+ *  TrainID 기반 함수들이 handle 기반 함수를 호출할 수 있도록, page/train이 저장된 buffer element의 handle을 반환함
+ */
+Four edubfm_FindFrame(
+    TrainID             *trainId,               /* IN train fixed by the caller */
+    Four                type,                   /* IN buffer type */
+    BfMFrameHandle      *handle)                /* OUT handle of the buffer element */
+{
+    Four                e;                      /* for error */
+    Four                index;                  /* index on buffer holding the train */
+    BufferPartition     *part;                  /* partition of the train */
+
+    // Mapping 된 volume의 page/train은 buffer element에 저장되지 않음
+    if (IS_MAPPED_VOLUME(trainId->volNo)) {
+        index = BFM_MAPPED_FRAME;
+    }
+    // Latch 없이 fix 하는 bufferPool에서는 먼저 latch 없이 검색함
+    else if (!PI_OPTIMISTIC(type) || (index = edubfm_OptimisticFind((BfMHashKey *)trainId, type)) == NOTFOUND_IN_HTABLE) {
+        part = edubfm_GetPartition((BfMHashKey *)trainId, type);
+        e = edubfm_LatchPartition(part);
+        if (e < 0) ERR(e);
+
+        index = edubfm_LookUp((BfMHashKey *)trainId, type);
+        if (index < 0) ERR_UNLATCH(eBADHASHKEY_BFM, part);
+
+        e = edubfm_UnlatchPartition(part);
+        if (e < 0) ERR(e);
+    }
+
+    handle->trainId = *trainId;
+    handle->type = type;
+    handle->index = index;
+
+    return(eNOERROR);
+
+} /* edubfm_FindFrame() */
+
+
+
 /*@================================
  * edubfm_DeleteAll()
  *================================*/
@@ -269,10 +346,14 @@ Four edubfm_DeleteAll(void)
     Two 	    i;
     Four        type;
     Four        tableSize;
+    Four        p;          /* partition number */
     
     for (type = 0; type < NUM_BUF_TYPES; type++) {
         tableSize = HASHTABLESIZE(type);
 
+        if (PI_USEOPENTABLE(type))
+            for (p = 0; p < PI_NLOOP(type); p++) edubfm_opt_Clear(&PI_PART(type, p)->pageTable);
+
         // chaining 까지 삭제하지는 않는다. 왜냐하면 bufTable도 EduBfM_DiscardAll() 함수에서 모두 지워지기 때문에 
         for (i = 0; i < tableSize; i++) {
             BI_HASHTABLEENTRY(type, i) = NIL;
@@ -282,3 +363,45 @@ Four edubfm_DeleteAll(void)
     return(eNOERROR);
 
 } /* edubfm_DeleteAll() */ 
+
+
+
+/*@================================
+ * edubfm_RebuildHashTable()
+ *================================*/
+/*
+ * Function: Four edubfm_RebuildHashTable(Four)
+ *
+ * Description:
+ *  Rebuild the chained hash table of the buffer pool from the bufTable,
+ *  so that the pages/trains stored while BFM_OPEN_TABLE was used can be
+ *  found by the storage system again.
+ *  It must be called after PI_USEOPENTABLE(type) is cleared.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * 설명:
+ *  bufTable에 저장된 hash key들을 이용하여 hashTable을 다시 구성함
+ */
+Four edubfm_RebuildHashTable(
+    Four        type)       /* IN buffer type */
+{
+    Four        e;          /* for error */
+    Two         i;
+
+    for (i = 0; i < HASHTABLESIZE(type); i++) BI_HASHTABLEENTRY(type, i) = NIL;
+
+    for (i = 0; i < BI_NBUFS(type); i++) {
+        BI_NEXTHASHENTRY(type, i) = NIL;
+
+        if (!IS_NILBFMHASHKEY(BI_KEY(type, i))) {
+            e = edubfm_Insert(&BI_KEY(type, i), i, type);
+            if (e < 0) ERR(e);
+        }
+    }
+
+    return(eNOERROR);
+
+} /* edubfm_RebuildHashTable() */
@@ -0,0 +1,462 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_LRUK.c
+ *
+ * Description:
+ *  The LRU-K buffer replacement policy (K = LRUK_K).
+ *  The victim is the unfixed buffer whose K-th most recent reference is
+ *  the oldest; buffers referenced less than K times are considered to
+ *  have an infinite backward K-distance and are replaced first, in LRU
+ *  order. The buffers referenced through EduBfM are kept in a binary heap
+ *  in that order, and the others (empty, being read, or filled by the
+ *  storage system itself) in the free list, which is used first.
+ *  The reference history of a replaced page/train is retained in a ghost
+ *  directory, so that it is restored when the page/train is read again.
+ *
+ * Exports:
+ *  Four edubfm_lruk_Init(Four, BufferPartition *)
+ *  void edubfm_lruk_Final(Four, BufferPartition *)
+ *  void edubfm_lruk_Reset(Four, BufferPartition *)
+ *  Four edubfm_lruk_SelectVictim(BfMHashKey *, Four, BufferPartition *)
+ *  void edubfm_lruk_Fix(Four, BufferPartition *, Four, Boolean)
+ *  void edubfm_lruk_Evict(Four, BufferPartition *, Four)
+ */
+
+
+#include <stdlib.h> /* for malloc & free */
+#include <string.h> /* for memset & memcpy */
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* the list of the ghost directory holding the retained histories */
+#define LRUK_RETAINED   1
+
+/* type definition for the state of LRU-K in a partition */
+typedef struct {
+    UFour       clock;                  /* logical time, advanced on each fix */
+    UFour       (*hist)[LRUK_K];        /* hist[i][k] : time of the (k+1)-th most recent reference of buffer i (0 : none) */
+    PolicyLink  *links;                 /* links of the buffers of the partition */
+    PolicyList  lists[POLICY_FREELIST + 1];     /* POLICY_FREELIST */
+    Four        *heap;                  /* buffers referenced through EduBfM, the next victim first */
+    Four        *pos;                   /* pos[i] : position of buffer i in the heap (NIL : not in the heap) */
+    Four        nHeap;                  /* # of buffers in the heap */
+    Four        *skipped;               /* fixed buffers taken out of the heap while a victim is searched */
+    GhostDir    retained;               /* retained histories of the replaced pages/trains */
+} LRUKState;
+
+/* Macro: LRUK_BEFORE(s, a, b)
+ * Description: return TRUE if buffer a is to be replaced before buffer b
+ *              (an infinite backward K-distance first, in LRU order, and then the oldest K-th reference)
+ */
+#define LRUK_BEFORE(s, a, b) \
+    (((s)->hist[a][LRUK_K-1] == 0) != ((s)->hist[b][LRUK_K-1] == 0) ? ((s)->hist[a][LRUK_K-1] == 0) : \
+     ((s)->hist[a][LRUK_K-1] == 0) ? ((s)->hist[a][0] < (s)->hist[b][0]) : \
+                                     ((s)->hist[a][LRUK_K-1] < (s)->hist[b][LRUK_K-1]))
+
+
+/* internal function prototypes */
+static void edubfm_lruk_HeapUp(LRUKState *, Four);
+static void edubfm_lruk_HeapDown(LRUKState *, Four);
+static void edubfm_lruk_HeapInsert(LRUKState *, Four);
+static void edubfm_lruk_HeapRemove(LRUKState *, Four);
+
+
+
+/*@================================
+ * edubfm_lruk_Init()
+ *================================*/
+/*
+ * Function: Four edubfm_lruk_Init(Four, BufferPartition *)
+ *
+ * Description:
+ *  Allocate the state of LRU-K for the partition. The histories of as
+ *  many pages/trains as the partition has buffers are retained.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ */
+Four edubfm_lruk_Init(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part)                  /* INOUT partition */
+{
+    Four                e;                      /* error */
+    LRUKState           *s;                     /* state of LRU-K */
+
+    s = (LRUKState *)calloc(1, sizeof(LRUKState));
+    if (s == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    s->hist = malloc(sizeof(UFour) * LRUK_K * part->maxBufs);
+    s->links = (PolicyLink *)malloc(sizeof(PolicyLink) * part->maxBufs);
+    s->heap = (Four *)malloc(sizeof(Four) * part->maxBufs);
+    s->pos = (Four *)malloc(sizeof(Four) * part->maxBufs);
+    s->skipped = (Four *)malloc(sizeof(Four) * part->maxBufs);
+
+    if (s->hist == NULL || s->links == NULL || s->heap == NULL || s->pos == NULL || s->skipped == NULL)
+        e = eMEMALLOCERR_EDUBFM;
+    else
+        e = edubfm_GhostInit(&s->retained, part->maxBufs);
+
+    if (e < 0) {
+        free(s->hist);
+        free(s->links);
+        free(s->heap);
+        free(s->pos);
+        free(s->skipped);
+        free(s);
+        ERR(e);
+    }
+
+    part->policyState = s;
+    edubfm_lruk_Reset(type, part);
+
+    return(eNOERROR);
+
+}  /* edubfm_lruk_Init */
+
+
+
+/*@================================
+ * edubfm_lruk_Final()
+ *================================*/
+/*
+ * Function: void edubfm_lruk_Final(Four, BufferPartition *)
+ *
+ * Description:
+ *  Free the state of LRU-K of the partition.
+ */
+void edubfm_lruk_Final(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part)                  /* INOUT partition */
+{
+    LRUKState           *s = (LRUKState *)part->policyState;
+
+    if (s == NULL) return;
+
+    edubfm_GhostFinal(&s->retained);
+    free(s->hist);
+    free(s->links);
+    free(s->heap);
+    free(s->pos);
+    free(s->skipped);
+    free(s);
+    part->policyState = NULL;
+
+}  /* edubfm_lruk_Final */
+
+
+
+/*@================================
+ * edubfm_lruk_Reset()
+ *================================*/
+/*
+ * Function: void edubfm_lruk_Reset(Four, BufferPartition *)
+ *
+ * Description:
+ *  Forget the histories of all pages/trains; all buffers go to the free list.
+ */
+void edubfm_lruk_Reset(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part)                  /* INOUT partition */
+{
+    LRUKState           *s = (LRUKState *)part->policyState;
+    Four                i;
+
+    s->clock = 0;
+    memset(s->hist, 0, sizeof(UFour) * LRUK_K * part->maxBufs);
+
+    s->nHeap = 0;
+    for (i = 0; i < part->maxBufs; i++) s->pos[i] = NIL;
+
+    edubfm_FreeListInit(s->lists, s->links, POLICY_FREELIST + 1, NIL, part);
+    edubfm_GhostReset(&s->retained);
+
+}  /* edubfm_lruk_Reset */
+
+
+
+/*@================================
+ * edubfm_lruk_SelectVictim()
+ *================================*/
+/*
+ * Function: Four edubfm_lruk_SelectVictim(BfMHashKey *, Four, BufferPartition *)
+ *
+ * Description:
+ *  Select a victim by LRU-K. A buffer of the free list is used first.
+ *  Otherwise the unfixed buffer nearest to the top of the heap is taken
+ *  out of it, i.e. the least recently used one of those referenced less
+ *  than K times, or, if there is none, the one whose K-th most recent
+ *  reference is the oldest; the fixed buffers taken out on the way are
+ *  put back. The victim is moved to the free list until the page/train
+ *  is read.
+ *  The history of the victim is retained, and the retained history of
+ *  'key' (if any) is taken out into the history of the victim, so that
+ *  the page/train read into it starts with that history even if the
+ *  latch of the partition is released while it is read.
+ *
+ * Returns:
+ *  1) An index of the victim
+ *  2) eNOUNFIXEDBUF_BFM - There is no unfixed buffer.
+ */
+Four edubfm_lruk_SelectVictim(
+    BfMHashKey          *key,                   /* IN hash key of the page/train to be stored */
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part)                  /* IN partition */
+{
+    LRUKState           *s = (LRUKState *)part->policyState;
+    Four                i;
+    Four                g;                      /* ghost entry */
+    Four                victim;                 /* offset of the victim in the partition */
+    Four                nSkipped = 0;           /* # of fixed buffers taken out of the heap */
+
+    victim = edubfm_UnlistedUnfixed(s->lists, s->links, type, part);
+
+    if (victim == NIL) {
+        // Heap의 top부터 fix 되지 않은 buffer element를 찾고, 그동안 꺼낸 fix 된 것들은 다시 넣음
+        while (s->nHeap > 0) {
+            BFM_STATS( part->stats.nVictimSteps++ );
+            i = s->heap[0];
+            edubfm_lruk_HeapRemove(s, i);
+
+            if (BI_FIXED(type, part->firstBuf + i) == 0) {
+                victim = i;
+                break;
+            }
+            s->skipped[nSkipped++] = i;
+        }
+
+        while (nSkipped > 0) edubfm_lruk_HeapInsert(s, s->skipped[--nSkipped]);
+
+        if (victim == NIL) return( eNOUNFIXEDBUF_BFM );
+
+        edubfm_ListPush(s->lists, s->links, POLICY_FREELIST, victim);
+    }
+
+    // 제거될 page/train의 참조 기록을 보관함
+    if (!IS_NILBFMHASHKEY(BI_KEY(type, part->firstBuf + victim)) && s->hist[victim][0] != 0) {
+        g = edubfm_GhostInsert(&s->retained, &BI_KEY(type, part->firstBuf + victim), LRUK_RETAINED);
+        memcpy(s->retained.entries[g].hist, s->hist[victim], sizeof(s->hist[victim]));
+    }
+
+    // 새로 저장될 page/train의 보관된 참조 기록을 꺼내어 victim의 참조 기록으로 함
+    g = edubfm_GhostLookUp(&s->retained, key);
+    if (g != NIL) {
+        memcpy(s->hist[victim], s->retained.entries[g].hist, sizeof(s->hist[victim]));
+        edubfm_GhostDelete(&s->retained, g);
+    }
+    else {
+        memset(s->hist[victim], 0, sizeof(s->hist[victim]));
+    }
+
+    return( part->firstBuf + victim );
+
+}  /* edubfm_lruk_SelectVictim */
+
+
+
+/*@================================
+ * edubfm_lruk_Fix()
+ *================================*/
+/*
+ * Function: void edubfm_lruk_Fix(Four, BufferPartition *, Four, Boolean)
+ *
+ * Description:
+ *  Record a reference to the buffer. A newly loaded buffer starts with
+ *  the history put into it by edubfm_lruk_SelectVictim() or
+ *  edubfm_lruk_Evict(), and moves from the free list to the heap.
+ */
+void edubfm_lruk_Fix(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part,                  /* IN partition */
+    Four                index,                  /* IN index of the fixed buffer */
+    Boolean             hit)                    /* IN TRUE if the page/train was in the buffer pool */
+{
+    LRUKState           *s = (LRUKState *)part->policyState;
+    Four                i = index - part->firstBuf;
+    UFour               *h = s->hist[i];
+    Four                k;
+
+    for (k = LRUK_K - 1; k > 0; k--) h[k] = h[k-1];
+    h[0] = ++s->clock;
+
+    // 참조 시각이 늘어나기만 하므로, heap에 있는 buffer element는 아래로만 이동함
+    if (s->pos[i] != NIL) {
+        edubfm_lruk_HeapDown(s, s->pos[i]);
+    }
+    else {
+        edubfm_ListRemove(s->lists, s->links, i);
+        edubfm_lruk_HeapInsert(s, i);
+    }
+
+}  /* edubfm_lruk_Fix */
+
+
+
+/*@================================
+ * edubfm_lruk_Evict()
+ *================================*/
+/*
+ * Function: void edubfm_lruk_Evict(Four, BufferPartition *, Four)
+ *
+ * Description:
+ *  Forget the history of the buffer being reused without
+ *  edubfm_lruk_SelectVictim(), or added or taken away by
+ *  EduBfM_ResizeBuffer(), and move it to the free list, so that the
+ *  page/train read into it starts with no history. The history of the
+ *  replaced page/train is not retained.
+ */
+void edubfm_lruk_Evict(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part,                  /* IN partition */
+    Four                index)                  /* IN index of the buffer */
+{
+    LRUKState           *s = (LRUKState *)part->policyState;
+    Four                i = index - part->firstBuf;
+
+    if (s->pos[i] != NIL) edubfm_lruk_HeapRemove(s, i);
+    edubfm_ListRemove(s->lists, s->links, i);
+    edubfm_ListPush(s->lists, s->links, POLICY_FREELIST, i);
+
+    memset(s->hist[i], 0, sizeof(s->hist[i]));
+
+}  /* edubfm_lruk_Evict */
+
+
+
+/*@================================
+ * edubfm_lruk_HeapUp()
+ *================================*/
+/*
+ * Function: static void edubfm_lruk_HeapUp(LRUKState *, Four)
+ *
+ * Description:
+ *  Move the buffer at the position 'p' of the heap toward the top while
+ *  it is to be replaced before its parent.
+ */
+static void edubfm_lruk_HeapUp(
+    LRUKState           *s,                     /* INOUT state of LRU-K */
+    Four                p)                      /* IN position in the heap */
+{
+    Four                i = s->heap[p];
+    Four                parent;
+
+    while (p > 0) {
+        parent = (p - 1) / 2;
+        if (!LRUK_BEFORE(s, i, s->heap[parent])) break;
+
+        s->heap[p] = s->heap[parent];
+        s->pos[s->heap[p]] = p;
+        p = parent;
+    }
+
+    s->heap[p] = i;
+    s->pos[i] = p;
+
+}  /* edubfm_lruk_HeapUp */
+
+
+
+/*@================================
+ * edubfm_lruk_HeapDown()
+ *================================*/
+/*
+ * Function: static void edubfm_lruk_HeapDown(LRUKState *, Four)
+ *
+ * Description:
+ *  Move the buffer at the position 'p' of the heap toward the bottom while
+ *  one of its children is to be replaced before it.
+ */
+static void edubfm_lruk_HeapDown(
+    LRUKState           *s,                     /* INOUT state of LRU-K */
+    Four                p)                      /* IN position in the heap */
+{
+    Four                i = s->heap[p];
+    Four                child;
+
+    while ((child = 2 * p + 1) < s->nHeap) {
+        if (child + 1 < s->nHeap && LRUK_BEFORE(s, s->heap[child + 1], s->heap[child])) child++;
+        if (!LRUK_BEFORE(s, s->heap[child], i)) break;
+
+        s->heap[p] = s->heap[child];
+        s->pos[s->heap[p]] = p;
+        p = child;
+    }
+
+    s->heap[p] = i;
+    s->pos[i] = p;
+
+}  /* edubfm_lruk_HeapDown */
+
+
+
+/*@================================
+ * edubfm_lruk_HeapInsert()
+ *================================*/
+/*
+ * Function: static void edubfm_lruk_HeapInsert(LRUKState *, Four)
+ *
+ * Description:
+ *  Insert the buffer into the heap.
+ */
+static void edubfm_lruk_HeapInsert(
+    LRUKState           *s,                     /* INOUT state of LRU-K */
+    Four                i)                      /* IN buffer */
+{
+    s->heap[s->nHeap] = i;
+    s->pos[i] = s->nHeap++;
+    edubfm_lruk_HeapUp(s, s->pos[i]);
+
+}  /* edubfm_lruk_HeapInsert */
+
+
+
+/*@================================
+ * edubfm_lruk_HeapRemove()
+ *================================*/
+/*
+ * Function: static void edubfm_lruk_HeapRemove(LRUKState *, Four)
+ *
+ * Description:
+ *  Remove the buffer from the heap; the last buffer of the heap fills
+ *  its position.
+ */
+static void edubfm_lruk_HeapRemove(
+    LRUKState           *s,                     /* INOUT state of LRU-K */
+    Four                i)                      /* IN buffer */
+{
+    Four                p = s->pos[i];
+    Four                last = s->heap[--s->nHeap];
+
+    s->pos[i] = NIL;
+    if (last == i) return;
+
+    s->heap[p] = last;
+    s->pos[last] = p;
+    edubfm_lruk_HeapUp(s, p);
+    edubfm_lruk_HeapDown(s, s->pos[last]);
+
+}  /* edubfm_lruk_HeapRemove */
@@ -0,0 +1,486 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_MappedVolume.c
+ *
+ * Description:
+ *  Some functions are provided to fix the pages/trains of the volumes
+ *  attached with edubfm_cfgParams.useMmap in place. The device of such a
+ *  volume is mapped privately (copy-on-write), and EduBfM_GetTrain()
+ *  returns a pointer into the mapping instead of reading the page/train
+ *  into a buffer element; so the pages/trains are cached only by the OS,
+ *  which also replaces them. The modified pages are recorded in a bitmap
+ *  by EduBfM_SetDirty() and are written back to the device by
+ *  EduBfM_FlushAll(); EduBfM_DiscardAll() drops their private copies, so
+ *  that the mapping shows the device again. The modified pages stay in
+ *  private memory until then.
+ *  The pages/trains fixed in place do not belong to any partition, so
+ *  they are not counted by the statistics of the buffer pools.
+ *
+ * Exports:
+ *  VolumeDevice *edubfm_MappedVolume(VolNo)
+ *  Four edubfm_MapVolume(VolumeDevice *)
+ *  void edubfm_UnmapVolume(VolumeDevice *)
+ *  Four edubfm_GetMappedFrame(TrainID *, char **, Four, BfMFrameHandle *)
+ *  Four edubfm_FreeMappedFrame(BfMFrameHandle *)
+ *  Four edubfm_SetDirtyMappedFrame(BfMFrameHandle *)
+ *  void edubfm_PrefetchMapped(TrainID *, Four)
+ *  Four edubfm_FlushMappedVolumes(void)
+ *  void edubfm_DiscardMappedVolumes(void)
+ */
+
+
+#include <stdlib.h> /* for malloc & free */
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* # of volumes mapped by EduBfM_AttachVolume() */
+Four edubfm_nMappedVolumes = 0;
+
+
+/* Macro: MAP_NWORDS(nPages)
+ * Description: return the # of words of the dirty bitmap of 'nPages' pages
+ */
+#define MAP_NWORDS(nPages)      (((nPages) + 31) / 32)
+
+/* function to be applied to each run of modified pages */
+typedef Four (*MapRunFunc)(VolumeDevice *, Four, Four);
+
+static Four edubfm_ForEachDirtyRun(VolumeDevice *, MapRunFunc);
+static Four edubfm_WriteMappedRun(VolumeDevice *, Four, Four);
+static Four edubfm_DropMappedRun(VolumeDevice *, Four, Four);
+
+
+
+/*@================================
+ * edubfm_MappedVolume()
+ *================================*/
+/*
+ * Function: VolumeDevice *edubfm_MappedVolume(VolNo)
+ *
+ * Description:
+ *  Return the attached volume if it is mapped into memory.
+ *
+ * Returns:
+ *  pointer to the volume (NULL : The volume is not mapped.)
+ */
+VolumeDevice *edubfm_MappedVolume(
+    VolNo               volNo)                  /* IN volume number */
+{
+    Four                i;
+
+    for (i = 0; i < edubfm_nVolumes; i++)
+        if (edubfm_volumes[i].volNo == volNo) return(edubfm_volumes[i].map != NULL ? &edubfm_volumes[i] : NULL);
+
+    return(NULL);
+
+}  /* edubfm_MappedVolume */
+
+
+
+/*@================================
+ * edubfm_MapVolume()
+ *================================*/
+/*
+ * Function: Four edubfm_MapVolume(VolumeDevice *)
+ *
+ * Description:
+ *  Map the whole device of the volume being attached privately, and
+ *  allocate its bitmap of the modified pages.
+ *
+ * Returns:
+ *  error code
+ *    eVOLUMEIOERR_EDUBFM - The device cannot be mapped.
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ */
+Four edubfm_MapVolume(
+    VolumeDevice        *vol)                   /* INOUT volume being attached */
+{
+    struct stat         st;                     /* status of the device */
+    void                *map;                   /* mapping */
+
+    if (fstat(vol->fd, &st) != 0 || st.st_size < PAGESIZE) ERR(eVOLUMEIOERR_EDUBFM);
+
+    vol->nPages = (Four)(st.st_size / PAGESIZE);
+
+    map = mmap(NULL, (size_t)vol->nPages * PAGESIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE, vol->fd, 0);
+    if (map == MAP_FAILED) ERR(eVOLUMEIOERR_EDUBFM);
+
+    vol->dirty = (UFour *)calloc(MAP_NWORDS(vol->nPages), sizeof(UFour));
+    if (vol->dirty == NULL) {
+        munmap(map, (size_t)vol->nPages * PAGESIZE);
+        ERR(eMEMALLOCERR_EDUBFM);
+    }
+
+    vol->map = (char *)map;
+    vol->nFixed = 0;
+    edubfm_nMappedVolumes++;
+
+    return(eNOERROR);
+
+}  /* edubfm_MapVolume */
+
+
+
+/*@================================
+ * edubfm_UnmapVolume()
+ *================================*/
+/*
+ * Function: void edubfm_UnmapVolume(VolumeDevice *)
+ *
+ * Description:
+ *  Unmap the device of the volume being detached. The modifications not
+ *  written by EduBfM_FlushAll() are lost.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_UnmapVolume(
+    VolumeDevice        *vol)                   /* INOUT volume being detached */
+{
+    munmap(vol->map, (size_t)vol->nPages * PAGESIZE);
+    free(vol->dirty);
+
+    vol->map = NULL;
+    vol->dirty = NULL;
+    edubfm_nMappedVolumes--;
+
+}  /* edubfm_UnmapVolume */
+
+
+
+/*@================================
+ * edubfm_GetMappedFrame()
+ *================================*/
+/*
+ * Function: Four edubfm_GetMappedFrame(TrainID *, char **, Four, BfMFrameHandle *)
+ *
+ * Description:
+ *  Fix the train of a mapped volume in place: return the pointer to the
+ *  train in the mapping and a handle whose index is BFM_MAPPED_FRAME.
+ *  The OS reads the train when it is touched first.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - The volume is not mapped.
+ *    eVOLUMEIOERR_EDUBFM - The train lies beyond the end of the device.
+ */
+Four edubfm_GetMappedFrame(
+    TrainID             *trainId,               /* IN train to be used */
+    char                **retBuf,               /* OUT pointer to the train */
+    Four                type,                   /* IN buffer type */
+    BfMFrameHandle      *handle)                /* OUT handle of the train */
+{
+    VolumeDevice        *vol;                   /* mapped volume */
+
+    vol = edubfm_MappedVolume(trainId->volNo);
+    if (vol == NULL) ERR(eBADPARAMETER_EDUBFM);
+    if (trainId->pageNo < 0 || trainId->pageNo + BI_BUFSIZE(type) > vol->nPages) ERR(eVOLUMEIOERR_EDUBFM);
+
+    __sync_fetch_and_add(&vol->nFixed, 1);
+
+    *retBuf = vol->map + (size_t)trainId->pageNo * PAGESIZE;
+    handle->trainId = *trainId;
+    handle->type = type;
+    handle->index = BFM_MAPPED_FRAME;
+
+    return(eNOERROR);
+
+}  /* edubfm_GetMappedFrame */
+
+
+
+/*@================================
+ * edubfm_FreeMappedFrame()
+ *================================*/
+/*
+ * Function: Four edubfm_FreeMappedFrame(BfMFrameHandle *)
+ *
+ * Description:
+ *  Unfix the train of a mapped volume fixed by edubfm_GetMappedFrame().
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFER_BFM - The volume of the handle is not mapped.
+ */
+Four edubfm_FreeMappedFrame(
+    BfMFrameHandle      *handle)                /* IN handle of the train */
+{
+    VolumeDevice        *vol;                   /* mapped volume */
+
+    vol = edubfm_MappedVolume(handle->trainId.volNo);
+    if (vol == NULL) ERR(eBADBUFFER_BFM);
+
+    if (__sync_fetch_and_sub(&vol->nFixed, 1) <= 0) {
+        __sync_fetch_and_add(&vol->nFixed, 1);
+        printf("fixed counter is less than 0!!!\n");
+        printf("trainId = {%d,  %d}\n", handle->trainId.volNo, handle->trainId.pageNo);
+    }
+
+    return(eNOERROR);
+
+}  /* edubfm_FreeMappedFrame */
+
+
+
+/*@================================
+ * edubfm_SetDirtyMappedFrame()
+ *================================*/
+/*
+ * Function: Four edubfm_SetDirtyMappedFrame(BfMFrameHandle *)
+ *
+ * Description:
+ *  Record that the pages of the train of a mapped volume are modified.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFER_BFM - The volume of the handle is not mapped.
+ */
+Four edubfm_SetDirtyMappedFrame(
+    BfMFrameHandle      *handle)                /* IN handle of the train */
+{
+    VolumeDevice        *vol;                   /* mapped volume */
+    Four                pageNo;                 /* a page of the train */
+
+    vol = edubfm_MappedVolume(handle->trainId.volNo);
+    if (vol == NULL) ERR(eBADBUFFER_BFM);
+
+    for (pageNo = handle->trainId.pageNo; pageNo < handle->trainId.pageNo + BI_BUFSIZE(handle->type); pageNo++)
+        __sync_fetch_and_or(&vol->dirty[pageNo / 32], 1U << (pageNo % 32));
+
+    return(eNOERROR);
+
+}  /* edubfm_SetDirtyMappedFrame */
+
+
+
+/*@================================
+ * edubfm_PrefetchMapped()
+ *================================*/
+/*
+ * Function: void edubfm_PrefetchMapped(TrainID *, Four)
+ *
+ * Description:
+ *  Ask the OS to read the train of a mapped volume ahead.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_PrefetchMapped(
+    TrainID             *trainId,               /* IN train to be read */
+    Four                type)                   /* IN buffer type */
+{
+    VolumeDevice        *vol;                   /* mapped volume */
+
+    vol = edubfm_MappedVolume(trainId->volNo);
+    if (vol == NULL || trainId->pageNo < 0 || trainId->pageNo + BI_BUFSIZE(type) > vol->nPages) return;
+
+    madvise(vol->map + (size_t)trainId->pageNo * PAGESIZE, (size_t)PAGESIZE * BI_BUFSIZE(type), MADV_WILLNEED);
+
+}  /* edubfm_PrefetchMapped */
+
+
+
+/*@================================
+ * edubfm_FlushMappedVolumes()
+ *================================*/
+/*
+ * Function: Four edubfm_FlushMappedVolumes(void)
+ *
+ * Description:
+ *  Write the modified pages of all mapped volumes back to their devices,
+ *  each run of adjacent modified pages by one write.
+ *
+ * Returns:
+ *  error code
+ *    eVOLUMEIOERR_EDUBFM - Writing to a device failed.
+ *    some errors caused by function calls
+ */
+Four edubfm_FlushMappedVolumes(void)
+{
+    Four                e;                      /* error code */
+    Four                i;
+
+    for (i = 0; i < edubfm_nVolumes; i++) {
+        if (edubfm_volumes[i].map == NULL) continue;
+
+        e = edubfm_ForEachDirtyRun(&edubfm_volumes[i], edubfm_WriteMappedRun);
+        if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+}  /* edubfm_FlushMappedVolumes */
+
+
+
+/*@================================
+ * edubfm_DiscardMappedVolumes()
+ *================================*/
+/*
+ * Function: void edubfm_DiscardMappedVolumes(void)
+ *
+ * Description:
+ *  Drop the private copies of the modified pages of all mapped volumes
+ *  without writing them, so that the mappings show the devices again.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_DiscardMappedVolumes(void)
+{
+    Four                i;
+
+    for (i = 0; i < edubfm_nVolumes; i++)
+        if (edubfm_volumes[i].map != NULL) (void) edubfm_ForEachDirtyRun(&edubfm_volumes[i], edubfm_DropMappedRun);
+
+}  /* edubfm_DiscardMappedVolumes */
+
+
+
+/*
+ * Function: static Four edubfm_ForEachDirtyRun(VolumeDevice *, MapRunFunc)
+ *
+ * Description:
+ *  Clear the bitmap of the modified pages of the volume, and apply 'func'
+ *  to each run of adjacent pages which were marked in it. If 'func' fails,
+ *  the pages not yet handled are marked again.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four edubfm_ForEachDirtyRun(
+    VolumeDevice        *vol,                   /* IN mapped volume */
+    MapRunFunc          func)                   /* IN function applied to each run */
+{
+    Four                e;                      /* error code */
+    Four                w;                      /* word of the bitmap */
+    Four                pageNo;                 /* a page */
+    Four                start = NIL;            /* first page of the current run */
+    UFour               bits;                   /* marks taken from a word */
+
+    for (w = 0; w < MAP_NWORDS(vol->nPages); w++) {
+        bits = (vol->dirty[w] != 0) ? __sync_fetch_and_and(&vol->dirty[w], 0) : 0;
+
+        for (pageNo = w * 32; pageNo < (w + 1) * 32; pageNo++) {
+            if (bits & (1U << (pageNo % 32))) {
+                if (start == NIL) start = pageNo;
+                continue;
+            }
+            if (start == NIL) continue;
+
+            // 연속된 수정된 page들을 한꺼번에 처리하고, 실패하면 아직 처리하지 않은 page들을 다시 표시함
+            e = func(vol, start, pageNo - start);
+            if (e < 0) {
+                for (; start < pageNo; start++) __sync_fetch_and_or(&vol->dirty[start / 32], 1U << (start % 32));
+                for (pageNo++; pageNo < (w + 1) * 32; pageNo++)
+                    if (bits & (1U << (pageNo % 32))) __sync_fetch_and_or(&vol->dirty[w], 1U << (pageNo % 32));
+                ERR(e);
+            }
+            start = NIL;
+        }
+    }
+
+    if (start != NIL) {
+        e = func(vol, start, MAP_NWORDS(vol->nPages) * 32 - start);
+        if (e < 0) {
+            for (; start < MAP_NWORDS(vol->nPages) * 32; start++) __sync_fetch_and_or(&vol->dirty[start / 32], 1U << (start % 32));
+            ERR(e);
+        }
+    }
+
+    return(eNOERROR);
+
+}  /* edubfm_ForEachDirtyRun */
+
+
+
+/*
+ * Function: static Four edubfm_WriteMappedRun(VolumeDevice *, Four, Four)
+ *
+ * Description:
+ *  Write the run of 'nPages' modified pages starting at 'start' from the
+ *  mapping to the device.
+ *
+ * Returns:
+ *  error code
+ *    eVOLUMEIOERR_EDUBFM - Writing to the device failed.
+ *    some errors caused by function calls
+ */
+static Four edubfm_WriteMappedRun(
+    VolumeDevice        *vol,                   /* IN mapped volume */
+    Four                start,                  /* IN first page of the run */
+    Four                nPages)                 /* IN # of pages of the run */
+{
+    Four                e;                      /* error code */
+    ssize_t             nBytes;                 /* # of bytes to be written */
+    ssize_t             nWritten;               /* # of bytes written */
+    UEight              due;                    /* time when the write of a memory volume completes */
+
+    nBytes = (ssize_t)nPages * PAGESIZE;
+
+    // RDsM과 같은 device를 사용하므로, partition된 경우 I/O latch를 획득한 후 기록함
+    e = edubfm_LatchIO();
+    if (e < 0) ERR(e);
+
+    due = edubfm_MemoryVolumeCharge(vol->volNo, nBytes);
+    nWritten = pwrite(vol->fd, vol->map + (size_t)start * PAGESIZE, nBytes, (off_t)start * PAGESIZE);
+
+    edubfm_UnlatchIO();
+    if (nWritten != nBytes) ERR(eVOLUMEIOERR_EDUBFM);
+
+    edubfm_MemoryVolumeWait(due);
+
+    return(eNOERROR);
+
+}  /* edubfm_WriteMappedRun */
+
+
+
+/*
+ * Function: static Four edubfm_DropMappedRun(VolumeDevice *, Four, Four)
+ *
+ * Description:
+ *  Drop the private copies of the run of 'nPages' modified pages starting
+ *  at 'start'; they are read from the device again when touched.
+ *
+ * Returns:
+ *  error code
+ */
+static Four edubfm_DropMappedRun(
+    VolumeDevice        *vol,                   /* IN mapped volume */
+    Four                start,                  /* IN first page of the run */
+    Four                nPages)                 /* IN # of pages of the run */
+{
+    madvise(vol->map + (size_t)start * PAGESIZE, (size_t)nPages * PAGESIZE, MADV_DONTNEED);
+
+    return(eNOERROR);
+
+}  /* edubfm_DropMappedRun */
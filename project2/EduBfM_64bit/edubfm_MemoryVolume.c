@@ -0,0 +1,249 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_MemoryVolume.c
+ *
+ * Description:
+ *  Some functions are provided to support the volumes attached by
+ *  EduBfM_AttachMemoryVolume(), which stand in for the devices so that the
+ *  buffer manager (and the layers above it) can be measured without the
+ *  variance of the disk. The device of such a volume is copied into an
+ *  anonymous memory file when it is attached, and EduBfM reads and writes
+ *  the copy through the same paths as the device of an attached volume
+ *  (including the asynchronous I/O), instead of through RDsM.
+ *  The holes of a sparse device stay holes of the copy, so that a large
+ *  volume costs only the memory of the pages written.
+ *  Each I/O of a memory volume is delayed as a device with the latency
+ *  edubfm_cfgParams.memVolumeLatency and the bandwidth
+ *  edubfm_cfgParams.memVolumeBandwidth would be: the transfers of a volume
+ *  are done one after another at the bandwidth, and each I/O completes the
+ *  latency after its transfer, so that I/Os in flight together overlap
+ *  their latencies but share the bandwidth.
+ *
+ * Exports:
+ *  Four edubfm_LoadMemoryVolume(VolumeDevice *, char *)
+ *  UEight edubfm_MemoryVolumeCharge(VolNo, Four)
+ *  void edubfm_MemoryVolumeWait(UEight)
+ */
+
+
+#define _GNU_SOURCE /* for memfd_create() and SEEK_DATA */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h> /* for malloc & free */
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* size of the chunks copied from the device into a memory volume (unit: bytes) */
+#define MEMVOL_COPY_CHUNK       (1024 * 1024)
+
+/* # of volumes attached by EduBfM_AttachMemoryVolume() */
+Four edubfm_nMemoryVolumes = 0;
+
+/* mutex protecting the busy time of the memory volumes */
+static pthread_mutex_t memVolMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+/* return the current time of the monotonic clock (unit: nsec) */
+static UEight edubfm_MemoryVolumeNow(void)
+{
+    struct timespec     ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return( (UEight)ts.tv_sec * 1000000000ULL + ts.tv_nsec );
+
+}  /* edubfm_MemoryVolumeNow */
+
+
+
+/*@================================
+ * edubfm_LoadMemoryVolume()
+ *================================*/
+/*
+ * Function: Four edubfm_LoadMemoryVolume(VolumeDevice *, char *)
+ *
+ * Description:
+ *  Create an anonymous memory file as large as the given device, copy the
+ *  data of the device into it (skipping its holes), and make it the device
+ *  of the volume being attached. The latency and the bandwidth of the
+ *  volume are taken from edubfm_cfgParams.
+ *
+ * Returns:
+ *  error code
+ *    eVOLUMEIOERR_EDUBFM - The device cannot be read, or the memory file cannot be created.
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ *
+ * 설명:
+ *  Device의 내용을 memory file에 복사하여, attach 되는 volume의 device로 사용함
+ */
+Four edubfm_LoadMemoryVolume(
+    VolumeDevice        *vol,                   /* INOUT volume being attached */
+    char                *devName)               /* IN device name of the volume */
+{
+    Four                e = eNOERROR;           /* error code */
+    Four                dev, fd;                /* file descriptors of the device and the copy */
+    off_t               size;                   /* size of the device */
+    off_t               start, end, off;        /* range of data of the device */
+    ssize_t             n;                      /* # of bytes to be copied */
+    struct stat         st;                     /* status of the device */
+    char                *chunk;                 /* buffer of the copy */
+
+    if (edubfm_cfgParams.memVolumeLatency < 0 || edubfm_cfgParams.memVolumeBandwidth < 0) ERR(eBADPARAMETER_EDUBFM);
+
+    dev = open(devName, O_RDONLY);
+    if (dev < 0) ERR(eVOLUMEIOERR_EDUBFM);
+
+    chunk = (char *)malloc(MEMVOL_COPY_CHUNK);
+    if (chunk == NULL) {
+        close(dev);
+        ERR(eMEMALLOCERR_EDUBFM);
+    }
+
+    fd = memfd_create("edubfm_volume", 0);
+    if (fd < 0 || fstat(dev, &st) != 0 || ftruncate(fd, st.st_size) != 0) e = eVOLUMEIOERR_EDUBFM;
+    size = st.st_size;
+
+    // Device의 data가 있는 구간만 복사함 (SEEK_DATA를 지원하지 않으면 전체를 복사함)
+    for (start = 0; e == eNOERROR && start < size; start = end) {
+        start = lseek(dev, start, SEEK_DATA);
+        if (start < 0 && errno == ENXIO) break;
+        if (start < 0) {
+            start = 0;
+            end = size;
+        }
+        else {
+            end = lseek(dev, start, SEEK_HOLE);
+            if (end < 0) end = size;
+        }
+
+        for (off = start; e == eNOERROR && off < end; off += n) {
+            n = pread(dev, chunk, MIN(end - off, MEMVOL_COPY_CHUNK), off);
+            if (n <= 0 || pwrite(fd, chunk, n, off) != n) e = eVOLUMEIOERR_EDUBFM;
+        }
+    }
+
+    free(chunk);
+    close(dev);
+
+    if (e < eNOERROR) {
+        if (fd >= 0) close(fd);
+        ERR(e);
+    }
+
+    vol->fd = fd;
+    vol->direct = TRUE;
+    vol->memory = TRUE;
+    vol->latency = (UEight)edubfm_cfgParams.memVolumeLatency * 1000;
+    vol->bandwidth = edubfm_cfgParams.memVolumeBandwidth;
+    vol->busyUntil = 0;
+
+    return(eNOERROR);
+
+}  /* edubfm_LoadMemoryVolume */
+
+
+
+/*@================================
+ * edubfm_MemoryVolumeCharge()
+ *================================*/
+/*
+ * Function: UEight edubfm_MemoryVolumeCharge(VolNo, Four)
+ *
+ * Description:
+ *  Charge an I/O of 'nBytes' bytes issued now to the volume if it is a
+ *  memory volume: its transfer starts when the transfers issued before
+ *  end, and the I/O completes the latency of the volume after the transfer.
+ *  The caller passes the returned time to edubfm_MemoryVolumeWait() once
+ *  the I/O itself is done.
+ *
+ * Returns:
+ *  time when the I/O completes (unit: nsec, 0 : The volume is not a memory volume, or it has no delay.)
+ */
+UEight edubfm_MemoryVolumeCharge(
+    VolNo               volNo,                  /* IN volume number */
+    Four                nBytes)                 /* IN # of bytes transferred */
+{
+    Four                i;
+    UEight              now, due;               /* time */
+    VolumeDevice        *vol;                   /* attached volume */
+
+    if (edubfm_nMemoryVolumes == 0) return(0);
+
+    for (vol = NULL, i = 0; i < edubfm_nVolumes; i++)
+        if (edubfm_volumes[i].volNo == volNo) vol = &edubfm_volumes[i];
+
+    if (vol == NULL || !vol->memory || (vol->latency == 0 && vol->bandwidth == 0)) return(0);
+
+    now = edubfm_MemoryVolumeNow();
+
+    // 앞서 요청된 전송이 끝난 후에 bandwidth로 전송하고, 그로부터 latency 후에 완료됨
+    pthread_mutex_lock(&memVolMutex);
+
+    if (vol->bandwidth > 0) {
+        vol->busyUntil = MAX(vol->busyUntil, now) + (UEight)nBytes * 1000 / vol->bandwidth;
+        due = vol->busyUntil + vol->latency;
+    }
+    else due = now + vol->latency;
+
+    pthread_mutex_unlock(&memVolMutex);
+
+    return(due);
+
+}  /* edubfm_MemoryVolumeCharge */
+
+
+
+/*@================================
+ * edubfm_MemoryVolumeWait()
+ *================================*/
+/*
+ * Function: void edubfm_MemoryVolumeWait(UEight)
+ *
+ * Description:
+ *  Sleep until the time returned by edubfm_MemoryVolumeCharge().
+ *  Nothing is done if it is 0 or has passed.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_MemoryVolumeWait(
+    UEight              due)                    /* IN time when the I/O completes (unit: nsec) */
+{
+    struct timespec     ts;
+
+    if (due == 0) return;
+
+    ts.tv_sec = due / 1000000000ULL;
+    ts.tv_nsec = due % 1000000000ULL;
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+
+}  /* edubfm_MemoryVolumeWait */
@@ -0,0 +1,354 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_Numa.c
+ *
+ * Description:
+ *  Some functions are provided to place the partitions of the buffer pools
+ *  on NUMA nodes (edubfm_cfgParams.numaNodes). The partitions are spread
+ *  over the nodes in contiguous groups; the buffer elements, the bufTable
+ *  entries and the versions of a partition, and the state of its
+ *  replacement policy and of its page table, are put on its node, so that
+ *  a victim selected in a partition is always a buffer element of its own
+ *  node and the search for it touches only the memory of that node.
+ *  The memory policies are set by the system calls directly (mbind(2) and
+ *  set_mempolicy(2)), so that EduBfM does not depend on libnuma. A node of
+ *  the machine is only preferred, not enforced, so that an exhausted node
+ *  does not make the allocation fail; a machine (or a kernel) without NUMA
+ *  ignores them. More nodes than the machine has can be simulated: node n
+ *  is placed on the node (n % # of nodes of the machine), and the threads
+ *  declare their simulated node by EduBfM_SetThreadNode(), so that the
+ *  fixes from another node can be counted on any machine.
+ *
+ * Exports:
+ *  Four edubfm_StartNuma(Four)
+ *  void edubfm_StopNuma(void)
+ *  void edubfm_SetMemoryNode(Four)
+ *  void edubfm_PlacePartition(Four, BufferPartition *)
+ *  Four edubfm_ThreadNode(void)
+ *  Four edubfm_MemoryNode(void *)
+ */
+
+
+#include <string.h> /* for memset */
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* memory policies and flags of mbind(2), set_mempolicy(2) and get_mempolicy(2) */
+#define NUMA_MPOL_DEFAULT       0
+#define NUMA_MPOL_PREFERRED     1
+#define NUMA_MPOL_F_NODE        (1 << 0)
+#define NUMA_MPOL_F_ADDR        (1 << 1)
+#define NUMA_MPOL_MF_MOVE       (1 << 1)
+
+/* max. # of nodes of the machine in a node mask */
+#define NUMA_MASK_NODES         1024
+#define NUMA_MASK_BITS          (8 * sizeof(unsigned long))
+
+/* file listing the online nodes of the machine */
+#define NUMA_ONLINE_FILE        "/sys/devices/system/node/online"
+
+
+/* # of NUMA nodes the partitions are spread over (0 : none) */
+Four edubfm_nNumaNodes = 0;
+
+/* NUMA node of the calling thread set by EduBfM_SetThreadNode() (NIL : the node of the CPU it runs on) */
+__thread Four edubfm_threadNode = NIL;
+
+/* # of NUMA nodes of the machine */
+static Four edubfm_nMachineNodes = 1;
+
+
+/* internal function prototypes */
+static Four edubfm_numa_MachineNodes(void);
+static void edubfm_numa_Bind(void *, void *, Four);
+
+
+
+/*@================================
+ * edubfm_StartNuma()
+ *================================*/
+/*
+ * Function: Four edubfm_StartNuma(Four)
+ *
+ * Description:
+ *  Spread the partitions made afterwards over 'numaNodes' NUMA nodes
+ *  (BFM_NUMA_MACHINE : as many as the machine has, 0 : none).
+ *
+ * Returns:
+ *  # of NUMA nodes
+ *
+ * 설명:
+ *  Machine의 NUMA node 개수를 구하고, partition들을 배치할 node 개수를 정함
+ */
+Four edubfm_StartNuma(
+    Four                numaNodes)              /* IN # of NUMA nodes */
+{
+    edubfm_nMachineNodes = edubfm_numa_MachineNodes();
+
+    edubfm_nNumaNodes = (numaNodes == BFM_NUMA_MACHINE) ? edubfm_nMachineNodes : numaNodes;
+    edubfm_nNumaNodes = MIN(edubfm_nNumaNodes, BFM_MAX_NUMA_NODES);
+
+    return(edubfm_nNumaNodes);
+
+}  /* edubfm_StartNuma */
+
+
+
+/*@================================
+ * edubfm_StopNuma()
+ *================================*/
+/*
+ * Function: void edubfm_StopNuma(void)
+ *
+ * Description:
+ *  Stop placing the partitions on NUMA nodes. The memory already placed
+ *  stays where it is.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_StopNuma(void)
+{
+    edubfm_nNumaNodes = 0;
+
+}  /* edubfm_StopNuma */
+
+
+
+/*@================================
+ * edubfm_SetMemoryNode()
+ *================================*/
+/*
+ * Function: void edubfm_SetMemoryNode(Four)
+ *
+ * Description:
+ *  Make the memory touched first by the calling thread from now on be
+ *  allocated on the given NUMA node (NIL : the default policy again).
+ *  It brackets the allocation and the initialization of the state of a
+ *  partition, which is placed where it is touched first.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_SetMemoryNode(
+    Four                node)                   /* IN NUMA node (NIL : none) */
+{
+    unsigned long       mask[NUMA_MASK_NODES / NUMA_MASK_BITS]; /* node mask */
+    Four                m;                      /* node of the machine */
+
+
+    if (node == NIL) {
+        syscall(SYS_set_mempolicy, NUMA_MPOL_DEFAULT, NULL, 0);
+        return;
+    }
+
+    m = node % edubfm_nMachineNodes;
+
+    memset(mask, 0, sizeof(mask));
+    mask[m / NUMA_MASK_BITS] = 1UL << (m % NUMA_MASK_BITS);
+
+    // NUMA를 지원하지 않는 kernel에서는 실패하며, 이 경우 기본 정책대로 할당됨
+    syscall(SYS_set_mempolicy, NUMA_MPOL_PREFERRED, mask, NUMA_MASK_NODES);
+
+}  /* edubfm_SetMemoryNode */
+
+
+
+/*@================================
+ * edubfm_PlacePartition()
+ *================================*/
+/*
+ * Function: void edubfm_PlacePartition(Four, BufferPartition *)
+ *
+ * Description:
+ *  Put the buffer elements reserved for the partition, their bufTable
+ *  entries and versions (if any) on the NUMA node of the partition.
+ *  The pages of the memory not yet touched are allocated there, and the
+ *  others are moved there. Only the pages lying entirely in the memory of
+ *  the partition are placed, so a page shared with a neighbouring
+ *  partition stays where it is.
+ *
+ * Returns:
+ *  None
+ *
+ * 설명:
+ *  Partition의 buffer element들과 bufTable entry들을 partition의 NUMA node에 배치함
+ */
+void edubfm_PlacePartition(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part)                  /* IN partition */
+{
+    Four                end;                    /* index of the buffer element after the partition */
+
+
+    if (part->node == NIL) return;
+
+    end = part->firstBuf + part->maxBufs;
+
+    edubfm_numa_Bind(BI_BUFFER(type, part->firstBuf), BI_BUFFER(type, end), part->node);
+    edubfm_numa_Bind(&bufInfo[type].bufTable[part->firstBuf], &bufInfo[type].bufTable[end], part->node);
+    if (PI_OPTIMISTIC(type))
+        edubfm_numa_Bind(&PI_VERSION(type, part->firstBuf), &PI_VERSION(type, end), part->node);
+
+}  /* edubfm_PlacePartition */
+
+
+
+/*@================================
+ * edubfm_ThreadNode()
+ *================================*/
+/*
+ * Function: Four edubfm_ThreadNode(void)
+ *
+ * Description:
+ *  Return the NUMA node of the calling thread: the one set by
+ *  EduBfM_SetThreadNode(), or else the node of the CPU it runs on.
+ *
+ * Returns:
+ *  NUMA node
+ */
+Four edubfm_ThreadNode(void)
+{
+    unsigned int        cpu, node;              /* CPU and node the thread runs on */
+
+
+    if (edubfm_threadNode != NIL) return(edubfm_threadNode);
+
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) != 0) return(0);
+
+    return((Four)node);
+
+}  /* edubfm_ThreadNode */
+
+
+
+/*@================================
+ * edubfm_MemoryNode()
+ *================================*/
+/*
+ * Function: Four edubfm_MemoryNode(void *)
+ *
+ * Description:
+ *  Return the NUMA node of the machine holding the page of the memory at
+ *  'addr', which must have been touched.
+ *
+ * Returns:
+ *  NUMA node of the machine (NIL : unknown)
+ */
+Four edubfm_MemoryNode(
+    void                *addr)                  /* IN address */
+{
+    int                 node;                   /* node of the page */
+
+
+    if (syscall(SYS_get_mempolicy, &node, NULL, 0, addr, NUMA_MPOL_F_NODE | NUMA_MPOL_F_ADDR) != 0) return(NIL);
+
+    return((Four)node);
+
+}  /* edubfm_MemoryNode */
+
+
+
+/*
+ * Function: static Four edubfm_numa_MachineNodes(void)
+ *
+ * Description:
+ *  Return the # of NUMA nodes of the machine, read from the list of the
+ *  online nodes (e.g. "0-1" or "0,2") : the highest node number plus one.
+ *
+ * Returns:
+ *  # of NUMA nodes of the machine (1 if unknown)
+ */
+static Four edubfm_numa_MachineNodes(void)
+{
+    FILE                *fp;                    /* list of the online nodes */
+    Four                c;                      /* a character */
+    Four                n = 0;                  /* a node number */
+    Four                maxNode = 0;            /* highest node number */
+
+
+    fp = fopen(NUMA_ONLINE_FILE, "r");
+    if (fp == NULL) return(1);
+
+    while ((c = fgetc(fp)) != EOF) {
+        if (c >= '0' && c <= '9') {
+            n = n * 10 + (c - '0');
+            continue;
+        }
+        maxNode = MAX(maxNode, n);
+        n = 0;
+    }
+    maxNode = MAX(maxNode, n);
+
+    fclose(fp);
+
+    return(MIN(maxNode + 1, NUMA_MASK_NODES));
+
+}  /* edubfm_numa_MachineNodes */
+
+
+
+/*
+ * Function: static void edubfm_numa_Bind(void *, void *, Four)
+ *
+ * Description:
+ *  Prefer the NUMA node of the machine on which the given node is placed
+ *  for the pages lying entirely in the memory [start, end), and move the
+ *  pages already touched there.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_numa_Bind(
+    void                *start,                 /* IN start of the memory */
+    void                *end,                   /* IN end of the memory */
+    Four                node)                   /* IN NUMA node */
+{
+    unsigned long       mask[NUMA_MASK_NODES / NUMA_MASK_BITS]; /* node mask */
+    unsigned long       osPageSize;             /* size of a page of the operating system */
+    unsigned long       s, t;                   /* range of the pages */
+    Four                m;                      /* node of the machine */
+
+
+    osPageSize = (unsigned long)sysconf(_SC_PAGESIZE);
+
+    // 운영체제의 페이지 경계에 맞추어 범위 안에 완전히 포함된 페이지들만 배치함
+    s = (((unsigned long)start + osPageSize - 1) / osPageSize) * osPageSize;
+    t = ((unsigned long)end / osPageSize) * osPageSize;
+    if (s >= t) return;
+
+    m = node % edubfm_nMachineNodes;
+
+    memset(mask, 0, sizeof(mask));
+    mask[m / NUMA_MASK_BITS] = 1UL << (m % NUMA_MASK_BITS);
+
+    // NUMA를 지원하지 않는 kernel에서는 실패하며, 이 경우 그대로 둠
+    syscall(SYS_mbind, s, t - s, NUMA_MPOL_PREFERRED, mask, NUMA_MASK_NODES, NUMA_MPOL_MF_MOVE);
+
+}  /* edubfm_numa_Bind */
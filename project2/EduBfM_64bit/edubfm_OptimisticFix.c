@@ -0,0 +1,296 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_OptimisticFix.c
+ *
+ * Description:
+ *  Some functions are provided to fix the pages/trains found in a
+ *  partitioned buffer pool without the latch of the partition
+ *  (edubfm_cfgParams.useOptimisticFix).
+ *  Each buffer element has a version, which is made odd (FRAME_WRITE_BEGIN)
+ *  before its page/train is replaced or its key is set, and even again
+ *  (FRAME_WRITE_END) afterwards, under the latch. A fixing thread walks the
+ *  hash chain without the latch, reads the version and the key of the
+ *  buffer element holding the page/train, increments the fix count with a
+ *  compare-and-swap, and reads the version again; if it has not changed,
+ *  the page/train was in the buffer element when it was fixed.
+ *  A thread replacing a page/train makes the version odd first and then
+ *  reads the fix count (edubfm_ClaimFrame()), while a fixing thread
+ *  increments the fix count first and then reads the version, so at least
+ *  one of them sees the other and backs off.
+ *  Only the hits of BFM_CLOCK, whose fix() does nothing on a hit, are
+ *  handled; the misses and the pages/trains being read ahead take the latch.
+ *
+ * Exports:
+ *  Four edubfm_StartOptimisticFix(Four)
+ *  void edubfm_StopOptimisticFix(Four)
+ *  Four edubfm_OptimisticFix(BfMHashKey *, Four)
+ *  Four edubfm_OptimisticFind(BfMHashKey *, Four)
+ *  Boolean edubfm_OptimisticUnfix(Four, Four)
+ *  Boolean edubfm_ClaimFrame(Four, Four)
+ */
+
+
+#include <stdlib.h> /* for calloc & free */
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * edubfm_StartOptimisticFix()
+ *================================*/
+/*
+ * Function: Four edubfm_StartOptimisticFix(Four)
+ *
+ * Description:
+ *  Allocate the versions of the buffer elements and let the pages/trains
+ *  found in the buffer pool be fixed without the latch. Nothing is done
+ *  unless the buffer pool is partitioned, uses BFM_CLOCK and
+ *  BFM_CHAINED_TABLE, since otherwise the fix needs no latch or needs it
+ *  to update the state of the replacement policy or of the page table.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ */
+Four edubfm_StartOptimisticFix(
+    Four                type)                   /* IN buffer type */
+{
+    if (!IS_PARTITIONED(type) || PI_POLICY(type) != &edubfm_policies[BFM_CLOCK] || PI_USEOPENTABLE(type)) return(eNOERROR);
+
+    partInfo[type].versions = (UFour *)calloc(BI_NBUFS(type), sizeof(UFour));
+    if (partInfo[type].versions == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    PI_OPTIMISTIC(type) = TRUE;
+
+    return(eNOERROR);
+
+}  /* edubfm_StartOptimisticFix */
+
+
+
+/*@================================
+ * edubfm_StopOptimisticFix()
+ *================================*/
+/*
+ * Function: void edubfm_StopOptimisticFix(Four)
+ *
+ * Description:
+ *  Free the versions of the buffer elements. No other thread may use the
+ *  buffer pool.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_StopOptimisticFix(
+    Four                type)                   /* IN buffer type */
+{
+    PI_OPTIMISTIC(type) = FALSE;
+
+    free(partInfo[type].versions);
+    partInfo[type].versions = NULL;
+
+}  /* edubfm_StopOptimisticFix */
+
+
+
+/*@================================
+ * edubfm_OptimisticFix()
+ *================================*/
+/*
+ * Function: Four edubfm_OptimisticFix(BfMHashKey *, Four)
+ *
+ * Description:
+ *  Fix the page/train if it is found in the buffer pool, without the latch.
+ *  NOTFOUND_IN_HTABLE is returned, and nothing is fixed, if it is not
+ *  found, is being read ahead or has been read ahead and not fixed yet,
+ *  or if its buffer element is being replaced; then the caller fixes it
+ *  under the latch as usual.
+ *
+ * Returns:
+ *  array index of the buffer element holding the fixed page/train
+ *  (NOTFOUND_IN_HTABLE - The page/train is not fixed.)
+ *
+ * 설명:
+ *  Partition의 latch를 획득하지 않고 bufferPool에 존재하는 page/train을 fix 함
+ */
+Four edubfm_OptimisticFix(
+    BfMHashKey          *key,                   /* IN hash key of the page/train */
+    Four                type)                   /* IN buffer type */
+{
+    Four                i;                      /* index of a buffer element */
+    Four                steps;                  /* # of hash chain entries visited */
+    Four                nBufs = BI_NBUFS(type); /* # of buffer elements */
+    UFour               version;                /* version of the buffer element when its key was read */
+    Two                 fixed;                  /* fix count of the buffer element */
+    One                 bits;                   /* bits of the buffer element */
+
+    if (key->volNo < 0 || key->pageNo < 0) return(NOTFOUND_IN_HTABLE);
+
+    // Latch 없이 hash chain을 따라가므로, 다른 thread가 바꾸는 중인 chain을 따라갈 수 있음
+    // (chain의 길이를 bufferPool 크기로 제한하고, 찾지 못하면 latch를 획득하여 다시 검색하도록 함)
+    i = __atomic_load_n(&BI_HASHTABLEENTRY(type, BFM_HASH(key, type)), __ATOMIC_ACQUIRE);
+
+    for (steps = 0; i != NIL && steps < nBufs; steps++) {
+        if (i < 0 || i >= nBufs) return(NOTFOUND_IN_HTABLE);
+
+        version = __atomic_load_n(&PI_VERSION(type, i), __ATOMIC_ACQUIRE);
+
+        if (__atomic_load_n(&BI_KEY(type, i).pageNo, __ATOMIC_RELAXED) == key->pageNo &&
+            __atomic_load_n(&BI_KEY(type, i).volNo, __ATOMIC_RELAXED) == key->volNo) {
+
+            // Page/train이 교체되는 중이면 latch를 획득하여 fix 하도록 함
+            if (version & 1) return(NOTFOUND_IN_HTABLE);
+
+            // Fix 횟수를 compare-and-swap으로 증가시킨 후, 그 사이에 교체가 시작되지 않았는지 version으로 확인함
+            fixed = __atomic_load_n(&BI_FIXED(type, i), __ATOMIC_RELAXED);
+            do {
+                if (fixed < 0) return(NOTFOUND_IN_HTABLE);
+            } while (!__atomic_compare_exchange_n(&BI_FIXED(type, i), &fixed, fixed + 1, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+
+            bits = __atomic_load_n(&BI_BITS(type, i), __ATOMIC_RELAXED);
+
+            if (__atomic_load_n(&PI_VERSION(type, i), __ATOMIC_SEQ_CST) == version && !(bits & (READING | PREFETCHED)))
+                return(i);
+
+            // 교체가 시작되었거나, read-ahead로 읽힌 page/train이면 fix를 취소함
+            BI_UNPIN(type, i);
+            return(NOTFOUND_IN_HTABLE);
+        }
+
+        i = __atomic_load_n(&BI_NEXTHASHENTRY(type, i), __ATOMIC_RELAXED);
+    }
+
+    return(NOTFOUND_IN_HTABLE);
+
+}  /* edubfm_OptimisticFix */
+
+
+
+/*@================================
+ * edubfm_OptimisticFind()
+ *================================*/
+/*
+ * Function: Four edubfm_OptimisticFind(BfMHashKey *, Four)
+ *
+ * Description:
+ *  Look up the page/train, which must be fixed by the caller, without the
+ *  latch. Since a fixed page/train is never replaced, its buffer element
+ *  is found unless the hash chain is being changed by another thread.
+ *
+ * Returns:
+ *  array index of the buffer element holding the page/train
+ *  (NOTFOUND_IN_HTABLE - The page/train is not found.)
+ */
+Four edubfm_OptimisticFind(
+    BfMHashKey          *key,                   /* IN hash key of the page/train fixed by the caller */
+    Four                type)                   /* IN buffer type */
+{
+    Four                i;                      /* index of a buffer element */
+    Four                steps;                  /* # of hash chain entries visited */
+    Four                nBufs = BI_NBUFS(type); /* # of buffer elements */
+
+    if (key->volNo < 0 || key->pageNo < 0) return(NOTFOUND_IN_HTABLE);
+
+    i = __atomic_load_n(&BI_HASHTABLEENTRY(type, BFM_HASH(key, type)), __ATOMIC_ACQUIRE);
+
+    for (steps = 0; i != NIL && steps < nBufs; steps++) {
+        if (i < 0 || i >= nBufs) return(NOTFOUND_IN_HTABLE);
+
+        if (EQUALKEY(&BI_KEY(type, i), key) && __atomic_load_n(&BI_FIXED(type, i), __ATOMIC_RELAXED) > 0) return(i);
+
+        i = __atomic_load_n(&BI_NEXTHASHENTRY(type, i), __ATOMIC_RELAXED);
+    }
+
+    return(NOTFOUND_IN_HTABLE);
+
+}  /* edubfm_OptimisticFind */
+
+
+
+/*@================================
+ * edubfm_OptimisticUnfix()
+ *================================*/
+/*
+ * Function: Boolean edubfm_OptimisticUnfix(Four, Four)
+ *
+ * Description:
+ *  Decrement the fix count of the buffer element, which holds a page/train
+ *  fixed by the caller, without the latch.
+ *
+ * Returns:
+ *  TRUE if the fix count has been decremented (FALSE if it was not positive)
+ */
+Boolean edubfm_OptimisticUnfix(
+    Four                type,                   /* IN buffer type */
+    Four                index)                  /* IN index of the buffer element */
+{
+    Two                 fixed;                  /* fix count of the buffer element */
+
+    fixed = __atomic_load_n(&BI_FIXED(type, index), __ATOMIC_RELAXED);
+    do {
+        if (fixed <= 0) return(FALSE);
+    } while (!__atomic_compare_exchange_n(&BI_FIXED(type, index), &fixed, fixed - 1, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+
+    return(TRUE);
+
+}  /* edubfm_OptimisticUnfix */
+
+
+
+/*@================================
+ * edubfm_ClaimFrame()
+ *================================*/
+/*
+ * Function: Boolean edubfm_ClaimFrame(Four, Four)
+ *
+ * Description:
+ *  Make the version of the unfixed buffer element odd before its page/train
+ *  is replaced, and check that it has not been fixed by edubfm_OptimisticFix()
+ *  meanwhile. If it has, the version is made even again and the page/train
+ *  must not be replaced. Otherwise the caller makes the version even with
+ *  FRAME_WRITE_END() after the replacement. The caller must hold the latch
+ *  of the partition.
+ *
+ * Returns:
+ *  TRUE if the page/train can be replaced
+ */
+Boolean edubfm_ClaimFrame(
+    Four                type,                   /* IN buffer type */
+    Four                index)                  /* IN index of the buffer element */
+{
+    if (!PI_OPTIMISTIC(type)) return(TRUE);
+
+    FRAME_WRITE_BEGIN(type, index);
+
+    if (__atomic_load_n(&BI_FIXED(type, index), __ATOMIC_SEQ_CST) != 0) {
+        FRAME_WRITE_END(type, index);
+        return(FALSE);
+    }
+
+    return(TRUE);
+
+}  /* edubfm_ClaimFrame */
@@ -0,0 +1,239 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_PageTable.c
+ *
+ * Description:
+ *  An open addressing page table, which may replace the chained hash table
+ *  (BI_HASHTABLE) of a buffer pool. Each partition of the buffer pool has
+ *  its own table. A slot packs the hash key and the array index of the
+ *  buffer element into one 64-bit word, the slot of a key is chosen by a
+ *  64-bit integer mixer, and collisions are resolved by linear probing, so
+ *  that a look-up usually touches a single cache line.
+ *
+ * Exports:
+ *  Four edubfm_opt_Init(OpenPageTable *, Four)
+ *  void edubfm_opt_Final(OpenPageTable *)
+ *  void edubfm_opt_Clear(OpenPageTable *)
+ *  Four edubfm_opt_LookUp(OpenPageTable *, BfMHashKey *)
+ *  Four edubfm_opt_Insert(OpenPageTable *, BfMHashKey *, Two)
+ *  Four edubfm_opt_Delete(OpenPageTable *, BfMHashKey *)
+ */
+
+
+#include <stdlib.h> /* for malloc & free */
+#include <string.h> /* for memset */
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* Macro: OPT_HOME(t, packedKey)
+ * Description: return the first slot to be probed for the packed key
+ *              (the 64-bit multiplicative mixer of splitmix64/murmur3, so that
+ *               nearby keys and keys of different volumes spread over the table)
+ */
+#define OPT_MIX1(x)             (((x) ^ ((x) >> 33)) * 0xff51afd7ed558ccdULL)
+#define OPT_MIX2(x)             (((x) ^ ((x) >> 33)) * 0xc4ceb9fe1a85ec53ULL)
+#define OPT_HOME(t, packedKey)  ((UFour)(OPT_MIX2(OPT_MIX1(packedKey)) >> 32) & (t)->mask)
+
+
+
+/*@================================
+ * edubfm_opt_Init()
+ *================================*/
+/*
+ * Function: Four edubfm_opt_Init(OpenPageTable *, Four)
+ *
+ * Description:
+ *  Allocate an empty page table for 'nBufs' buffer elements. The number of
+ *  slots is the smallest power of 2 not less than four times 'nBufs', so
+ *  that the load factor never exceeds 0.25 and a miss usually ends at the
+ *  first or second slot probed.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ */
+Four edubfm_opt_Init(
+    OpenPageTable       *t,                     /* OUT page table */
+    Four                nBufs)                  /* IN # of buffer elements */
+{
+    UFour               nSlots;                 /* # of slots */
+
+    for (nSlots = 8; nSlots < (UFour)nBufs * 4; nSlots <<= 1);
+
+    t->slots = (UEight *)malloc(sizeof(UEight) * nSlots);
+    if (t->slots == NULL) ERR(eMEMALLOCERR_EDUBFM);
+
+    t->mask = nSlots - 1;
+    edubfm_opt_Clear(t);
+
+    return(eNOERROR);
+
+}  /* edubfm_opt_Init */
+
+
+
+/*@================================
+ * edubfm_opt_Final()
+ *================================*/
+/*
+ * Function: void edubfm_opt_Final(OpenPageTable *)
+ *
+ * Description:
+ *  Free the slots of the page table.
+ */
+void edubfm_opt_Final(
+    OpenPageTable       *t)                     /* INOUT page table */
+{
+    free(t->slots);
+    t->slots = NULL;
+
+}  /* edubfm_opt_Final */
+
+
+
+/*@================================
+ * edubfm_opt_Clear()
+ *================================*/
+/*
+ * Function: void edubfm_opt_Clear(OpenPageTable *)
+ *
+ * Description:
+ *  Delete all entries of the page table.
+ */
+void edubfm_opt_Clear(
+    OpenPageTable       *t)                     /* INOUT page table */
+{
+    memset(t->slots, 0, sizeof(UEight) * (t->mask + 1));
+
+}  /* edubfm_opt_Clear */
+
+
+
+/*@================================
+ * edubfm_opt_LookUp()
+ *================================*/
+/*
+ * Function: Four edubfm_opt_LookUp(OpenPageTable *, BfMHashKey *)
+ *
+ * Description:
+ *  Look up the given key in the page table.
+ *
+ * Returns:
+ *  index on buffer table entry holding the train specified by 'key'
+ *  (NOTFOUND_IN_HTABLE - The key don't exist in the page table.)
+ */
+Four edubfm_opt_LookUp(
+    OpenPageTable       *t,                     /* IN page table */
+    BfMHashKey          *key)                   /* IN a hash key in Buffer Manager */
+{
+    UEight              k = OPT_PACKKEY(key);   /* packed key */
+    UFour               i;
+
+    // 빈 slot을 만날 때까지 연속된 slot들을 검사함
+    for (i = OPT_HOME(t, k); t->slots[i] != OPT_EMPTY; i = (i + 1) & t->mask)
+        if (OPT_SLOTKEY(t->slots[i]) == k) return( OPT_SLOTINDEX(t->slots[i]) );
+
+    return(NOTFOUND_IN_HTABLE);
+
+}  /* edubfm_opt_LookUp */
+
+
+
+/*@================================
+ * edubfm_opt_Insert()
+ *================================*/
+/*
+ * Function: Four edubfm_opt_Insert(OpenPageTable *, BfMHashKey *, Two)
+ *
+ * Description:
+ *  Insert a new entry into the first empty slot from the home slot of the key.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFTBLENTRY_BFM - The page table is full.
+ */
+Four edubfm_opt_Insert(
+    OpenPageTable       *t,                     /* INOUT page table */
+    BfMHashKey          *key,                   /* IN a hash key in Buffer Manager */
+    Two                 index)                  /* IN an index used in the buffer pool */
+{
+    UEight              k = OPT_PACKKEY(key);   /* packed key */
+    UFour               i, n;
+
+    for (i = OPT_HOME(t, k), n = 0; n <= t->mask; i = (i + 1) & t->mask, n++) {
+        if (t->slots[i] == OPT_EMPTY) {
+            t->slots[i] = OPT_SLOT(k, index);
+            return(eNOERROR);
+        }
+    }
+
+    ERR(eBADBUFTBLENTRY_BFM);
+
+}  /* edubfm_opt_Insert */
+
+
+
+/*@================================
+ * edubfm_opt_Delete()
+ *================================*/
+/*
+ * Function: Four edubfm_opt_Delete(OpenPageTable *, BfMHashKey *)
+ *
+ * Description:
+ *  Delete the entry of the key. The following entries of the probe
+ *  sequence are shifted backward into the hole, so that no tombstone is
+ *  left and the look-ups stay short.
+ *
+ * Returns:
+ *  error code
+ *    eNOTFOUND_BFM - The key isn't in the page table.
+ */
+Four edubfm_opt_Delete(
+    OpenPageTable       *t,                     /* INOUT page table */
+    BfMHashKey          *key)                   /* IN a hash key in Buffer Manager */
+{
+    UEight              k = OPT_PACKKEY(key);   /* packed key */
+    UFour               i, j, home;
+
+    for (i = OPT_HOME(t, k); t->slots[i] != OPT_EMPTY; i = (i + 1) & t->mask)
+        if (OPT_SLOTKEY(t->slots[i]) == k) break;
+
+    if (t->slots[i] == OPT_EMPTY) ERR(eNOTFOUND_BFM);
+
+    // 빈 slot (i) 이후의 entry 중 home slot이 (i, j] 밖에 있는 entry를 i로 옮김
+    for (j = (i + 1) & t->mask; t->slots[j] != OPT_EMPTY; j = (j + 1) & t->mask) {
+        home = OPT_HOME(t, OPT_SLOTKEY(t->slots[j]));
+        if (((j - home) & t->mask) >= ((j - i) & t->mask)) {
+            t->slots[i] = t->slots[j];
+            i = j;
+        }
+    }
+    t->slots[i] = OPT_EMPTY;
+
+    return(eNOERROR);
+
+}  /* edubfm_opt_Delete */
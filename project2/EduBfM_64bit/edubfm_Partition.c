@@ -0,0 +1,326 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_Partition.c
+ *
+ * Description:
+ *  Some functions are provided to support the partitioned buffer pool.
+ *  Each BfMHashKey is mapped to one partition of the buffer pool, and the
+ *  latch of the partition serializes the accesses to the hash chains,
+ *  the bufTable entries and the clock hand of the partition.
+ *  RDsM is not reentrant, so the disk I/Os are serialized by the I/O latch.
+ *  The reads from the devices of the attached volumes hold the I/O latch in
+ *  the shared mode, so that they can overlap with each other.
+ *
+ * Exports:
+ *  BufferPartition *edubfm_GetPartition(BfMHashKey *, Four)
+ *  BufferPartition *edubfm_WholePartition(Four)
+ *  Four edubfm_LatchPartition(BufferPartition *)
+ *  Four edubfm_UnlatchPartition(BufferPartition *)
+ *  Four edubfm_LatchAll(void)
+ *  void edubfm_UnlatchAll(Four)
+ *  Four edubfm_LatchIO(void)
+ *  Four edubfm_LatchIOShared(void)
+ *  Four edubfm_UnlatchIO(void)
+ */
+
+
+#include <errno.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* partition information of each buffer pool */
+PartitionInfo partInfo[NUM_BUF_TYPES];
+
+/* latch serializing the disk I/Os of the partitioned buffer pools */
+static pthread_rwlock_t edubfm_ioLatch = PTHREAD_RWLOCK_INITIALIZER;
+
+
+
+/*@================================
+ * edubfm_GetPartition()
+ *================================*/
+/*
+ * Function: BufferPartition *edubfm_GetPartition(BfMHashKey *, Four)
+ *
+ * Description:
+ *  Return the partition to which the given key belongs.
+ *  If the buffer pool is not partitioned, the partition covering the whole
+ *  buffer pool is returned.
+ *
+ * Returns:
+ *  pointer to the partition
+ *
+ * 설명:
+ *  파라미터로 주어진 hash key (BfMHashKey) 가 속하는 partition을 반환함
+ */
+BufferPartition *edubfm_GetPartition(
+    BfMHashKey          *key,                   /* IN a hash key in Buffer Manager */
+    Four                type)                   /* IN buffer type */
+{
+    if (!IS_PARTITIONED(type)) return( edubfm_WholePartition(type) );
+
+    return( PI_PART(type, BFM_PARTITION(key, type)) );
+
+}  /* edubfm_GetPartition */
+
+
+
+/*@================================
+ * edubfm_WholePartition()
+ *================================*/
+/*
+ * Function: BufferPartition *edubfm_WholePartition(Four)
+ *
+ * Description:
+ *  Return the partition covering the whole buffer pool, which is used
+ *  when the buffer pool is not partitioned. Its latch is never acquired.
+ *
+ * Returns:
+ *  pointer to the partition
+ */
+BufferPartition *edubfm_WholePartition(
+    Four                type)                   /* IN buffer type */
+{
+    BufferPartition     *part = &partInfo[type].whole;
+
+    /* bufInfo[] is set up by the storage system, so follow its size */
+    part->firstBuf = 0;
+    part->nBufs = BI_NBUFS(type);
+    part->maxBufs = part->nBufs;
+    part->node = NIL;
+
+    return( part );
+
+}  /* edubfm_WholePartition */
+
+
+
+/*@================================
+ * edubfm_LatchPartition()
+ *================================*/
+/*
+ * Function: Four edubfm_LatchPartition(BufferPartition *)
+ *
+ * Description:
+ *  Acquire the latch of the given partition.
+ *  Nothing is done if the partition does not use a latch.
+ *
+ * Returns:
+ *  error code
+ *    eMUTEXLOCKDEADLK_BFM - The latch is already held by the caller.
+ *    eMUTEXLOCKUNKNOWN_BFM - Unknown error
+ */
+Four edubfm_LatchPartition(
+    BufferPartition     *part)                  /* IN partition to be latched */
+{
+    Four                e;                      /* error returned by pthread */
+
+    if (!part->useLatch) return(eNOERROR);
+
+    e = pthread_mutex_lock(&part->latch);
+    if (e == EDEADLK) ERR(eMUTEXLOCKDEADLK_BFM);
+    else if (e != 0) ERR(eMUTEXLOCKUNKNOWN_BFM);
+
+    return(eNOERROR);
+
+}  /* edubfm_LatchPartition */
+
+
+
+/*@================================
+ * edubfm_UnlatchPartition()
+ *================================*/
+/*
+ * Function: Four edubfm_UnlatchPartition(BufferPartition *)
+ *
+ * Description:
+ *  Release the latch of the given partition.
+ *  Nothing is done if the partition does not use a latch.
+ *
+ * Returns:
+ *  error code
+ *    eMUTEXUNLOCKPERM_BFM - The latch is not held by the caller.
+ *    eMUTEXUNLOCKUNKNOWN_BFM - Unknown error
+ */
+Four edubfm_UnlatchPartition(
+    BufferPartition     *part)                  /* IN partition to be unlatched */
+{
+    Four                e;                      /* error returned by pthread */
+
+    if (!part->useLatch) return(eNOERROR);
+
+    e = pthread_mutex_unlock(&part->latch);
+    if (e == EPERM) ERR(eMUTEXUNLOCKPERM_BFM);
+    else if (e != 0) ERR(eMUTEXUNLOCKUNKNOWN_BFM);
+
+    return(eNOERROR);
+
+}  /* edubfm_UnlatchPartition */
+
+
+
+/*@================================
+ * edubfm_LatchAll()
+ *================================*/
+/*
+ * Function: Four edubfm_LatchAll(void)
+ *
+ * Description :
+ *  Acquire the latches of all partitions of all buffer pools in order.
+ *  On an error, the latches acquired so far are released.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_LatchAll(void)
+{
+    Four                e;                      /* error */
+    Four                type;                   /* buffer type */
+    Four                p;                      /* partition number */
+    Four                nLatched = 0;           /* # of latched partitions */
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        for (p = 0; p < PI_NLOOP(type); p++, nLatched++) {
+            e = edubfm_LatchPartition(PI_PART(type, p));
+            if (e < eNOERROR) {
+                edubfm_UnlatchAll(nLatched);
+                ERR(e);
+            }
+        }
+    }
+
+    return(eNOERROR);
+
+}  /* edubfm_LatchAll() */
+
+
+
+/*@================================
+ * edubfm_UnlatchAll()
+ *================================*/
+/*
+ * Function: void edubfm_UnlatchAll(Four)
+ *
+ * Description :
+ *  Release the latches of the first nLatched partitions, in the order
+ *  of edubfm_LatchAll().
+ */
+void edubfm_UnlatchAll(
+    Four                nLatched)               /* IN # of latched partitions */
+{
+    Four                type;                   /* buffer type */
+    Four                p;                      /* partition number */
+
+    for (type = 0; type < NUM_BUF_TYPES && nLatched > 0; type++) {
+        for (p = 0; p < PI_NLOOP(type) && nLatched > 0; p++, nLatched--) {
+            edubfm_UnlatchPartition(PI_PART(type, p));
+        }
+    }
+
+}  /* edubfm_UnlatchAll() */
+
+
+
+/*@================================
+ * edubfm_LatchIO()
+ *================================*/
+/*
+ * Function: Four edubfm_LatchIO(void)
+ *
+ * Description:
+ *  Acquire the I/O latch in the exclusive mode before calling RDsM.
+ *  Nothing is done if the buffer pools are not partitioned
+ *  (all buffer pools are partitioned together by EduBfM_Init()).
+ *
+ * Returns:
+ *  error code
+ *    eMUTEXLOCKUNKNOWN_BFM - Unknown error
+ */
+Four edubfm_LatchIO(void)
+{
+    if (!IS_PARTITIONED(PAGE_BUF)) return(eNOERROR);
+
+    if (pthread_rwlock_wrlock(&edubfm_ioLatch) != 0) ERR(eMUTEXLOCKUNKNOWN_BFM);
+
+    return(eNOERROR);
+
+}  /* edubfm_LatchIO */
+
+
+
+/*@================================
+ * edubfm_LatchIOShared()
+ *================================*/
+/*
+ * Function: Four edubfm_LatchIOShared(void)
+ *
+ * Description:
+ *  Acquire the I/O latch in the shared mode before reading from the device
+ *  of an attached volume directly. It excludes the writes, but not the
+ *  other direct reads.
+ *  Nothing is done if the buffer pools are not partitioned.
+ *
+ * Returns:
+ *  error code
+ *    eMUTEXLOCKUNKNOWN_BFM - Unknown error
+ */
+Four edubfm_LatchIOShared(void)
+{
+    if (!IS_PARTITIONED(PAGE_BUF)) return(eNOERROR);
+
+    if (pthread_rwlock_rdlock(&edubfm_ioLatch) != 0) ERR(eMUTEXLOCKUNKNOWN_BFM);
+
+    return(eNOERROR);
+
+}  /* edubfm_LatchIOShared */
+
+
+
+/*@================================
+ * edubfm_UnlatchIO()
+ *================================*/
+/*
+ * Function: Four edubfm_UnlatchIO(void)
+ *
+ * Description:
+ *  Release the I/O latch acquired in either mode.
+ *  Nothing is done if the buffer pools are not partitioned.
+ *
+ * Returns:
+ *  error code
+ *    eMUTEXUNLOCKUNKNOWN_BFM - Unknown error
+ */
+Four edubfm_UnlatchIO(void)
+{
+    if (!IS_PARTITIONED(PAGE_BUF)) return(eNOERROR);
+
+    if (pthread_rwlock_unlock(&edubfm_ioLatch) != 0) ERR(eMUTEXUNLOCKUNKNOWN_BFM);
+
+    return(eNOERROR);
+
+}  /* edubfm_UnlatchIO */
@@ -0,0 +1,558 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_Policy.c
+ *
+ * Description:
+ *  The buffer replacement policies which edubfm_AllocTrain() uses to
+ *  select a victim, the second chance (clock) policy, and the lists and
+ *  ghost directories with which the other policies keep their state.
+ *
+ * Exports:
+ *  BfMReplacementPolicy edubfm_policies[]
+ *  Four edubfm_clock_Init(Four, BufferPartition *)
+ *  void edubfm_clock_Final(Four, BufferPartition *)
+ *  void edubfm_clock_Reset(Four, BufferPartition *)
+ *  Four edubfm_clock_SelectVictim(BfMHashKey *, Four, BufferPartition *)
+ *  void edubfm_clock_Fix(Four, BufferPartition *, Four, Boolean)
+ *  void edubfm_clock_Evict(Four, BufferPartition *, Four)
+ *  void edubfm_ListInit(PolicyList *, Four)
+ *  void edubfm_FreeListInit(PolicyList *, PolicyLink *, Four, Four, BufferPartition *)
+ *  void edubfm_ListPush(PolicyList *, PolicyLink *, Four, Four)
+ *  void edubfm_ListRemove(PolicyList *, PolicyLink *, Four)
+ *  Four edubfm_ListUnfixedLRU(PolicyList *, PolicyLink *, Four, Four, BufferPartition *)
+ *  Four edubfm_UnlistedUnfixed(PolicyList *, PolicyLink *, Four, BufferPartition *)
+ *  Four edubfm_GhostInit(GhostDir *, Four)
+ *  void edubfm_GhostFinal(GhostDir *)
+ *  void edubfm_GhostReset(GhostDir *)
+ *  Four edubfm_GhostLookUp(GhostDir *, BfMHashKey *)
+ *  Four edubfm_GhostInsert(GhostDir *, BfMHashKey *, Four)
+ *  void edubfm_GhostDelete(GhostDir *, Four)
+ */
+
+
+#include <stdlib.h> /* for malloc & free */
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* replacement policies, indexed by BFM_CLOCK, BFM_LRUK, BFM_2Q and BFM_ARC */
+BfMReplacementPolicy edubfm_policies[NUM_BFM_POLICIES] = {
+    { "CLOCK", edubfm_clock_Init, edubfm_clock_Final, edubfm_clock_Reset, edubfm_clock_SelectVictim, edubfm_clock_Fix, edubfm_clock_Evict },
+    { "LRU-K", edubfm_lruk_Init,  edubfm_lruk_Final,  edubfm_lruk_Reset,  edubfm_lruk_SelectVictim,  edubfm_lruk_Fix,  edubfm_lruk_Evict },
+    { "2Q",    edubfm_2q_Init,    edubfm_2q_Final,    edubfm_2q_Reset,    edubfm_2q_SelectVictim,    edubfm_2q_Fix,    edubfm_2q_Evict },
+    { "ARC",   edubfm_arc_Init,   edubfm_arc_Final,   edubfm_arc_Reset,   edubfm_arc_SelectVictim,   edubfm_arc_Fix,   edubfm_arc_Evict }
+};
+
+/* Macro: GHOST_HASH(k, n)
+ * Description: return the hash value of the key in a ghost directory having n buckets
+ */
+#define GHOST_HASH(k, n)    ((((UFour)(k)->pageNo * 2654435761U) ^ (UFour)(k)->volNo) % (UFour)(n))
+
+
+
+/*@================================
+ * edubfm_clock_SelectVictim()
+ *================================*/
+/*
+ * Function: Four edubfm_clock_SelectVictim(BfMHashKey *, Four, BufferPartition *)
+ *
+ * Description:
+ *  Select a victim by the second chance buffer replacement algorithm.
+ *  That is, if the reference bit of current checking entry (indicated by
+ *  the clock hand of the partition) is set, then simply clear the bit for
+ *  the second chance and proceed to the next entry, otherwise the current
+ *  buffer is selected. Fixed buffers are skipped.
+ *  If PI_CLEANFIRSTBUDGET(type) > 0, an unreferenced dirty buffer is also
+ *  passed over, up to that many of them, since replacing it costs a
+ *  synchronous write in addition to the read. If the budget runs out, or
+ *  no clean buffer is found, the first dirty buffer passed over is selected.
+ *
+ * Returns:
+ *  1) An index of the victim
+ *  2) eNOUNFIXEDBUF_BFM - There is no unfixed buffer.
+ */
+Four edubfm_clock_SelectVictim(
+    BfMHashKey          *key,                   /* IN hash key of the page/train to be stored */
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part)                  /* IN partition */
+{
+    Four                i;
+    Four                victim;                 /* offset of the victim in the partition */
+    UTwo                *nextVictim;            /* clock hand of the partition */
+    Four                budget;                 /* max. # of unreferenced dirty buffers to be passed over */
+    Four                nSkipped = 0;           /* # of unreferenced dirty buffers passed over */
+    Four                dirty = NIL;            /* offset of the first unreferenced dirty buffer passed over */
+
+    nextVictim = PART_NEXTVICTIM(type, part);
+    victim = *nextVictim;
+    budget = PI_CLEANFIRSTBUDGET(type);
+
+    // 할당 대상 선정을 위해 대응하는 fixed 변수 값이 0인 buffer element들을 순차적으로 방문함
+    for (i = 0; i < part->nBufs * 2; i++) {
+        if (BI_FIXED(type, part->firstBuf + victim) == 0) {
+            if (BI_BITS(type, part->firstBuf + victim) & REFER) {
+                BI_BITS(type, part->firstBuf + victim) ^= REFER;
+            }
+            else if (budget > 0 && (BI_BITS(type, part->firstBuf + victim) & DIRTY)) {
+                // 수정된 buffer element는 budget만큼 건너뛰며, 처음 건너뛴 것을 기억해 둠
+                if (dirty == NIL) dirty = victim;
+                if (++nSkipped > budget) break;
+            }
+            else {
+                *nextVictim = (victim + 1) % part->nBufs;
+                BFM_STATS( part->stats.nVictimSteps += i + 1 );
+                BFM_STATS( part->stats.nDirtySkips += nSkipped );
+                return( part->firstBuf + victim );
+            }
+        }
+
+        victim = (victim + 1) % part->nBufs;
+    }
+
+    BFM_STATS( part->stats.nVictimSteps += MIN(i + 1, part->nBufs * 2) );
+
+    // Budget 안에 수정되지 않은 buffer element를 찾지 못하면, 처음 건너뛴 수정된 buffer element를 선정함
+    if (dirty != NIL) {
+        *nextVictim = (dirty + 1) % part->nBufs;
+        return( part->firstBuf + dirty );
+    }
+
+    return( eNOUNFIXEDBUF_BFM );
+
+}  /* edubfm_clock_SelectVictim */
+
+
+
+/*@================================
+ * edubfm_clock_Fix()
+ *================================*/
+/*
+ * Function: void edubfm_clock_Fix(Four, BufferPartition *, Four, Boolean)
+ *
+ * Description:
+ *  Nothing is done; EduBfM_GetTrain() sets the reference bit of a newly
+ *  loaded buffer, and the bit of a buffer fixed again is left as it is.
+ */
+void edubfm_clock_Fix(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part,                  /* IN partition */
+    Four                index,                  /* IN index of the fixed buffer */
+    Boolean             hit)                    /* IN TRUE if the page/train was in the buffer pool */
+{
+}  /* edubfm_clock_Fix */
+
+
+
+/*
+ * The second chance algorithm keeps its state in the bufTable entries
+ * and the clock hand, so it has nothing to initialize, finalize or forget.
+ */
+Four edubfm_clock_Init(Four type, BufferPartition *part) { return(eNOERROR); }
+void edubfm_clock_Final(Four type, BufferPartition *part) { }
+void edubfm_clock_Reset(Four type, BufferPartition *part) { }
+void edubfm_clock_Evict(Four type, BufferPartition *part, Four index) { }
+
+
+
+/*@================================
+ * edubfm_ListInit()
+ *================================*/
+/*
+ * Function: void edubfm_ListInit(PolicyList *, Four)
+ *
+ * Description:
+ *  Make the given lists empty.
+ */
+void edubfm_ListInit(
+    PolicyList          *lists,                 /* INOUT lists */
+    Four                nLists)                 /* IN # of lists */
+{
+    Four                i;
+
+    for (i = 0; i < nLists; i++) {
+        lists[i].head = lists[i].tail = NIL;
+        lists[i].count = 0;
+    }
+
+}  /* edubfm_ListInit */
+
+
+
+/*@================================
+ * edubfm_FreeListInit()
+ *================================*/
+/*
+ * Function: void edubfm_FreeListInit(PolicyList *, PolicyLink *, Four, Four, BufferPartition *)
+ *
+ * Description:
+ *  Make the lists 0..nLists-1 empty and put the buffers in use of the
+ *  partition in the list POLICY_FREELIST, the first buffer at its LRU end.
+ *  The buffers which EduBfM_ResizeBuffer() adds later are put in the list
+ *  by the evict function of the policy. The 'load' of every link is set
+ *  to the given list.
+ */
+void edubfm_FreeListInit(
+    PolicyList          *lists,                 /* INOUT lists */
+    PolicyLink          *links,                 /* INOUT links of the buffers */
+    Four                nLists,                 /* IN # of lists */
+    Four                load,                   /* IN list which a page/train read enters by default */
+    BufferPartition     *part)                  /* IN partition */
+{
+    Four                i;
+
+    edubfm_ListInit(lists, nLists);
+
+    for (i = 0; i < part->maxBufs; i++) {
+        links[i].prev = links[i].next = links[i].list = NIL;
+        links[i].load = load;
+    }
+
+    for (i = 0; i < part->nBufs; i++) edubfm_ListPush(lists, links, POLICY_FREELIST, i);
+
+}  /* edubfm_FreeListInit */
+
+
+
+/*@================================
+ * edubfm_ListPush()
+ *================================*/
+/*
+ * Function: void edubfm_ListPush(PolicyList *, PolicyLink *, Four, Four)
+ *
+ * Description:
+ *  Insert the element at the MRU end of the list 'listNo'.
+ *  The element must not be in any list.
+ */
+void edubfm_ListPush(
+    PolicyList          *lists,                 /* INOUT lists */
+    PolicyLink          *links,                 /* INOUT links of the elements */
+    Four                listNo,                 /* IN list number */
+    Four                i)                      /* IN element */
+{
+    PolicyList          *l = &lists[listNo];
+
+    links[i].list = listNo;
+    links[i].prev = NIL;
+    links[i].next = l->head;
+
+    if (l->head != NIL) links[l->head].prev = i;
+    else l->tail = i;
+
+    l->head = i;
+    l->count++;
+
+}  /* edubfm_ListPush */
+
+
+
+/*@================================
+ * edubfm_ListRemove()
+ *================================*/
+/*
+ * Function: void edubfm_ListRemove(PolicyList *, PolicyLink *, Four)
+ *
+ * Description:
+ *  Remove the element from the list containing it.
+ *  Nothing is done if the element is not in any list.
+ */
+void edubfm_ListRemove(
+    PolicyList          *lists,                 /* INOUT lists */
+    PolicyLink          *links,                 /* INOUT links of the elements */
+    Four                i)                      /* IN element */
+{
+    PolicyList          *l;
+
+    if (links[i].list == NIL) return;
+    l = &lists[links[i].list];
+
+    if (links[i].prev != NIL) links[links[i].prev].next = links[i].next;
+    else l->head = links[i].next;
+
+    if (links[i].next != NIL) links[links[i].next].prev = links[i].prev;
+    else l->tail = links[i].prev;
+
+    links[i].prev = links[i].next = links[i].list = NIL;
+    l->count--;
+
+}  /* edubfm_ListRemove */
+
+
+
+/*@================================
+ * edubfm_ListUnfixedLRU()
+ *================================*/
+/*
+ * Function: Four edubfm_ListUnfixedLRU(PolicyList *, PolicyLink *, Four, Four, BufferPartition *)
+ *
+ * Description:
+ *  Return the least recently used buffer of the list 'listNo' which is
+ *  not fixed. The elements of the list are offsets in the partition.
+ *
+ * Returns:
+ *  offset of the buffer in the partition (NIL : none)
+ */
+Four edubfm_ListUnfixedLRU(
+    PolicyList          *lists,                 /* IN lists */
+    PolicyLink          *links,                 /* IN links of the buffers */
+    Four                listNo,                 /* IN list number */
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part)                  /* IN partition */
+{
+    Four                i;
+
+    for (i = lists[listNo].tail; i != NIL; i = links[i].prev) {
+        BFM_STATS( part->stats.nVictimSteps++ );
+        if (BI_FIXED(type, part->firstBuf + i) == 0) return(i);
+    }
+
+    return(NIL);
+
+}  /* edubfm_ListUnfixedLRU */
+
+
+
+/*@================================
+ * edubfm_UnlistedUnfixed()
+ *================================*/
+/*
+ * Function: Four edubfm_UnlistedUnfixed(PolicyList *, PolicyLink *, Four, BufferPartition *)
+ *
+ * Description:
+ *  Return the unfixed buffer nearest to the LRU end of the list
+ *  POLICY_FREELIST, i.e. an empty buffer or a buffer filled by the storage
+ *  system itself. The buffer stays in the list until the page/train read
+ *  into it is reported to the policy, so that it is found again if the
+ *  read fails. The buffers taken away by EduBfM_ResizeBuffer() are dropped
+ *  from the list on the way.
+ *
+ * Returns:
+ *  offset of the buffer in the partition (NIL : none)
+ */
+Four edubfm_UnlistedUnfixed(
+    PolicyList          *lists,                 /* INOUT lists */
+    PolicyLink          *links,                 /* INOUT links of the buffers */
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part)                  /* IN partition */
+{
+    Four                i;
+    Four                prev;                   /* element toward the MRU end */
+
+    for (i = lists[POLICY_FREELIST].tail; i != NIL; i = prev) {
+        BFM_STATS( part->stats.nVictimSteps++ );
+        prev = links[i].prev;
+
+        if (i >= part->nBufs) edubfm_ListRemove(lists, links, i);
+        else if (BI_FIXED(type, part->firstBuf + i) == 0) return(i);
+    }
+
+    return(NIL);
+
+}  /* edubfm_UnlistedUnfixed */
+
+
+
+/*@================================
+ * edubfm_GhostInit()
+ *================================*/
+/*
+ * Function: Four edubfm_GhostInit(GhostDir *, Four)
+ *
+ * Description:
+ *  Allocate a ghost directory which can remember 'nEntries' hash keys.
+ *
+ * Returns:
+ *  error code
+ *    eMEMALLOCERR_EDUBFM - Memory allocation failed.
+ */
+Four edubfm_GhostInit(
+    GhostDir            *g,                     /* OUT ghost directory */
+    Four                nEntries)               /* IN # of entries */
+{
+    g->nEntries = MAX(nEntries, 1);
+    g->nBuckets = g->nEntries * 2 + 1;
+    g->entries = (GhostEntry *)malloc(sizeof(GhostEntry) * g->nEntries);
+    g->links = (PolicyLink *)malloc(sizeof(PolicyLink) * g->nEntries);
+    g->buckets = (Four *)malloc(sizeof(Four) * g->nBuckets);
+
+    if (g->entries == NULL || g->links == NULL || g->buckets == NULL) {
+        edubfm_GhostFinal(g);
+        ERR(eMEMALLOCERR_EDUBFM);
+    }
+
+    edubfm_GhostReset(g);
+
+    return(eNOERROR);
+
+}  /* edubfm_GhostInit */
+
+
+
+/*@================================
+ * edubfm_GhostFinal()
+ *================================*/
+/*
+ * Function: void edubfm_GhostFinal(GhostDir *)
+ *
+ * Description:
+ *  Free the memory of the ghost directory.
+ */
+void edubfm_GhostFinal(
+    GhostDir            *g)                     /* IN ghost directory */
+{
+    free(g->entries);
+    free(g->links);
+    free(g->buckets);
+    g->entries = NULL;
+    g->links = NULL;
+    g->buckets = NULL;
+
+}  /* edubfm_GhostFinal */
+
+
+
+/*@================================
+ * edubfm_GhostReset()
+ *================================*/
+/*
+ * Function: void edubfm_GhostReset(GhostDir *)
+ *
+ * Description:
+ *  Forget all hash keys; every entry is moved to the free list.
+ */
+void edubfm_GhostReset(
+    GhostDir            *g)                     /* INOUT ghost directory */
+{
+    Four                i;
+
+    edubfm_ListInit(g->lists, MAX_GHOST_LISTS + 1);
+
+    for (i = 0; i < g->nBuckets; i++) g->buckets[i] = NIL;
+
+    for (i = 0; i < g->nEntries; i++) {
+        g->links[i].list = NIL;
+        edubfm_ListPush(g->lists, g->links, GHOST_FREELIST, i);
+    }
+
+}  /* edubfm_GhostReset */
+
+
+
+/*@================================
+ * edubfm_GhostLookUp()
+ *================================*/
+/*
+ * Function: Four edubfm_GhostLookUp(GhostDir *, BfMHashKey *)
+ *
+ * Description:
+ *  Look up the given key in the ghost directory.
+ *
+ * Returns:
+ *  entry holding the key (NIL : The key isn't in the directory.)
+ */
+Four edubfm_GhostLookUp(
+    GhostDir            *g,                     /* IN ghost directory */
+    BfMHashKey          *key)                   /* IN hash key */
+{
+    Four                i;
+
+    for (i = g->buckets[GHOST_HASH(key, g->nBuckets)]; i != NIL; i = g->entries[i].hashNext)
+        if (EQUALKEY(&g->entries[i].key, key)) return(i);
+
+    return(NIL);
+
+}  /* edubfm_GhostLookUp */
+
+
+
+/*@================================
+ * edubfm_GhostInsert()
+ *================================*/
+/*
+ * Function: Four edubfm_GhostInsert(GhostDir *, BfMHashKey *, Four)
+ *
+ * Description:
+ *  Insert the key at the MRU end of the list 'listNo'. If there is no free
+ *  entry, the LRU entry of the list 'listNo' (or of another list if that
+ *  list is empty) is forgotten and reused.
+ *
+ * Returns:
+ *  entry holding the key
+ */
+Four edubfm_GhostInsert(
+    GhostDir            *g,                     /* INOUT ghost directory */
+    BfMHashKey          *key,                   /* IN hash key */
+    Four                listNo)                 /* IN list number (1..MAX_GHOST_LISTS) */
+{
+    Four                i;
+    Four                l;
+    Four                bucket;
+
+    i = g->lists[GHOST_FREELIST].tail;
+    if (i == NIL) {
+        i = g->lists[listNo].tail;
+        for (l = 1; i == NIL && l <= MAX_GHOST_LISTS; l++) i = g->lists[l].tail;
+        edubfm_GhostDelete(g, i);
+    }
+    edubfm_ListRemove(g->lists, g->links, i);
+
+    g->entries[i].key = *key;
+    bucket = GHOST_HASH(key, g->nBuckets);
+    g->entries[i].hashNext = g->buckets[bucket];
+    g->buckets[bucket] = i;
+
+    edubfm_ListPush(g->lists, g->links, listNo, i);
+
+    return(i);
+
+}  /* edubfm_GhostInsert */
+
+
+
+/*@================================
+ * edubfm_GhostDelete()
+ *================================*/
+/*
+ * Function: void edubfm_GhostDelete(GhostDir *, Four)
+ *
+ * Description:
+ *  Forget the key of the entry and move the entry to the free list.
+ */
+void edubfm_GhostDelete(
+    GhostDir            *g,                     /* INOUT ghost directory */
+    Four                i)                      /* IN entry */
+{
+    Four                *p;
+
+    for (p = &g->buckets[GHOST_HASH(&g->entries[i].key, g->nBuckets)]; *p != NIL; p = &g->entries[*p].hashNext)
+        if (*p == i) {
+            *p = g->entries[i].hashNext;
+            break;
+        }
+
+    edubfm_ListRemove(g->lists, g->links, i);
+    edubfm_ListPush(g->lists, g->links, GHOST_FREELIST, i);
+
+}  /* edubfm_GhostDelete */
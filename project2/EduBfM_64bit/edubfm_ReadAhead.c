@@ -0,0 +1,526 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_ReadAhead.c
+ *
+ * Description:
+ *  The read-ahead, which detects sequential or strided accesses of each
+ *  volume and reads the following pages/trains into the buffer pool by
+ *  a pool of I/O threads before they are fixed. The I/O threads also serve
+ *  the prefetch requests of EduBfM_Prefetch().
+ *  EduBfM_GetFrame() reports each fix to edubfm_ReadAheadNotify(), which
+ *  tracks the streams and queues the read-ahead requests. An I/O
+ *  thread allocates a buffer element for a request, inserts it into the
+ *  hash table marked READING and fixed, and reads the page/train after the
+ *  latch of the partition is released; a transaction fixing the page/train
+ *  meanwhile waits until the read completes (see edubfm_AsyncIO.c).
+ *  edubfm_raMutex protects the streams, the queue and the counters, and no
+ *  other latch is acquired while it is held.
+ *
+ * Exports:
+ *  Four edubfm_StartReadAhead(void)
+ *  Four edubfm_StopReadAhead(void)
+ *  void edubfm_ReadAheadNotify(TrainID *, Four, Boolean)
+ *  Boolean edubfm_ReadAheadQueue(TrainID *, Four, Four)
+ *  void edubfm_ReadAheadWasted(BfMHashKey *, Four)
+ *  Four edubfm_ReadFrames(TrainID *, Four, Four)
+ *  void edubfm_WaitReadAheadIdle(void)
+ */
+
+
+#include <stdlib.h> /* for abs */
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* counters of the read-ahead */
+EduBfM_ReadAheadStats   edubfm_raStats;
+pthread_mutex_t         edubfm_raMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* state of the read-ahead */
+static pthread_t        raThreads[MAX_IO_THREADS];
+static Four             raNThreads = 0;         /* # of I/O threads */
+static Boolean          raRunning = FALSE;
+static Boolean          raStop;                 /* TRUE if the threads are requested to stop */
+static pthread_cond_t   raQueueCond = PTHREAD_COND_INITIALIZER;    /* signaled when a request is queued */
+static pthread_cond_t   raDoneCond = PTHREAD_COND_INITIALIZER;     /* signaled when a request has been served */
+static ReadAheadStream  raStreams[READAHEAD_NSTREAMS];
+static Four             raNextStream;           /* stream to be reused next */
+static ReadAheadRequest raQueue[READAHEAD_QUEUE_SIZE];
+static Four             raHead, raCount;        /* first request and # of requests in the queue */
+static Four             raNBusy;                /* # of requests being served */
+
+
+/* internal function prototypes */
+static void *edubfm_ReadAheadMain(void *);
+static ReadAheadStream *edubfm_ra_FindStream(VolNo, Four);
+
+
+
+/*@================================
+ * edubfm_StartReadAhead()
+ *================================*/
+/*
+ * Function: Four edubfm_StartReadAhead(void)
+ *
+ * Description:
+ *  Start edubfm_cfgParams.nIOThreads I/O threads (one if it is 0).
+ *  The buffer pools must be partitioned.
+ *
+ * Returns:
+ *  error code
+ *    eMUTEXCREATEUNKNOWN_BFM - A thread cannot be created.
+ */
+Four edubfm_StartReadAhead(void)
+{
+    Four                i;
+
+    if (raRunning) return(eNOERROR);
+
+    for (i = 0; i < READAHEAD_NSTREAMS; i++) raStreams[i].volNo = NIL;
+    raNextStream = 0;
+    raHead = raCount = raNBusy = 0;
+    edubfm_raStats.nReadAheads = edubfm_raStats.nReadAheadHits = edubfm_raStats.nReadAheadWasted = 0;
+
+    raStop = FALSE;
+    for (raNThreads = 0; raNThreads < MIN(MAX(edubfm_cfgParams.nIOThreads, 1), MAX_IO_THREADS); raNThreads++) {
+        if (pthread_create(&raThreads[raNThreads], NULL, edubfm_ReadAheadMain, NULL) != 0) {
+            raRunning = TRUE;
+            edubfm_StopReadAhead();
+            ERR(eMUTEXCREATEUNKNOWN_BFM);
+        }
+    }
+
+    pthread_mutex_lock(&edubfm_raMutex);
+    raRunning = TRUE;
+    pthread_mutex_unlock(&edubfm_raMutex);
+
+    return(eNOERROR);
+
+}  /* edubfm_StartReadAhead */
+
+
+
+/*@================================
+ * edubfm_StopReadAhead()
+ *================================*/
+/*
+ * Function: Four edubfm_StopReadAhead(void)
+ *
+ * Description:
+ *  Stop the I/O threads after the reads in progress (if any) complete.
+ *  The pending requests are dropped.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_StopReadAhead(void)
+{
+    Four                i;
+
+    if (!raRunning) return(eNOERROR);
+
+    pthread_mutex_lock(&edubfm_raMutex);
+    raRunning = FALSE;
+    raStop = TRUE;
+    raCount = 0;
+    pthread_cond_broadcast(&raQueueCond);
+    pthread_mutex_unlock(&edubfm_raMutex);
+
+    for (i = 0; i < raNThreads; i++) pthread_join(raThreads[i], NULL);
+    raNThreads = 0;
+
+    return(eNOERROR);
+
+}  /* edubfm_StopReadAhead */
+
+
+
+/*@================================
+ * edubfm_ReadAheadNotify()
+ *================================*/
+/*
+ * Function: void edubfm_ReadAheadNotify(TrainID *, Four, Boolean)
+ *
+ * Description:
+ *  Report a fix of a page/train to the read-ahead. The stream of the
+ *  volume is updated, and if the accesses of the stream have had the same
+ *  stride READAHEAD_TRIGGER times, the pages/trains up to 'window' strides
+ *  ahead which have not been requested yet are queued.
+ *  If the page/train had been read ahead, the window of the stream is doubled
+ *  (up to edubfm_cfgParams.readAheadMaxWindow).
+ *  Fixing the same page/train again does not change the stream.
+ */
+void edubfm_ReadAheadNotify(
+    TrainID             *trainId,               /* IN page/train fixed */
+    Four                type,                   /* IN buffer type */
+    Boolean             prefetched)             /* IN TRUE if it had been read ahead */
+{
+    ReadAheadStream     *s;                     /* stream of the volume */
+    Four                delta;                  /* difference of the pageNos */
+    Four                ahead;                  /* # of pages/trains already requested ahead */
+    Four                k;
+    PageNo              pageNo;                 /* page/train to be read ahead */
+    ReadAheadRequest    *r;
+
+    if (!raRunning || (!prefetched && edubfm_cfgParams.readAheadMaxWindow <= 0)) return;
+
+    pthread_mutex_lock(&edubfm_raMutex);
+
+    if (!raRunning) {
+        pthread_mutex_unlock(&edubfm_raMutex);
+        return;
+    }
+
+    if (prefetched) edubfm_raStats.nReadAheadHits++;
+
+    // Read-ahead를 사용하지 않고 EduBfM_Prefetch()만 사용하는 경우
+    if (edubfm_cfgParams.readAheadMaxWindow <= 0) {
+        pthread_mutex_unlock(&edubfm_raMutex);
+        return;
+    }
+
+    // 해당 volume의 stream을 찾고, 없으면 가장 오래전에 생성된 stream을 재사용함
+    s = edubfm_ra_FindStream(trainId->volNo, type);
+    if (s == NULL) {
+        s = &raStreams[raNextStream];
+        raNextStream = (raNextStream + 1) % READAHEAD_NSTREAMS;
+
+        s->volNo = trainId->volNo;
+        s->type = type;
+        s->lastPage = trainId->pageNo;
+        s->stride = 0;
+        s->nSeq = 0;
+        s->window = MIN(READAHEAD_MIN_WINDOW, edubfm_cfgParams.readAheadMaxWindow);
+        s->raEnd = trainId->pageNo;
+    }
+
+    if (prefetched) s->window = MIN(s->window * 2, edubfm_cfgParams.readAheadMaxWindow);
+
+    delta = trainId->pageNo - s->lastPage;
+    if (delta == 0) {
+        pthread_mutex_unlock(&edubfm_raMutex);
+        return;
+    }
+
+    // 이전과 같은 stride이면 연속 횟수를 늘리고, 아니면 새 stride로 다시 시작함
+    if (delta == s->stride) s->nSeq++;
+    else {
+        s->stride = (abs(delta) <= READAHEAD_MAX_STRIDE * BI_BUFSIZE(type) && delta % BI_BUFSIZE(type) == 0) ? delta : 0;
+        s->nSeq = (s->stride != 0) ? 1 : 0;
+        s->raEnd = trainId->pageNo;
+    }
+    s->lastPage = trainId->pageNo;
+
+    // 이미 요청한 page/train들 다음부터 window 개의 stride 앞까지 read-ahead를 요청함
+    if (s->nSeq >= READAHEAD_TRIGGER) {
+        ahead = (s->raEnd - trainId->pageNo) / s->stride;
+        if (ahead < 0) ahead = 0;
+
+        for (k = ahead + 1; k <= s->window && raCount < READAHEAD_QUEUE_SIZE; k++) {
+            pageNo = trainId->pageNo + k * s->stride;
+            if (pageNo < 0) break;
+
+            r = &raQueue[(raHead + raCount) % READAHEAD_QUEUE_SIZE];
+            r->trainId.volNo = trainId->volNo;
+            r->trainId.pageNo = pageNo;
+            r->type = type;
+            raCount++;
+
+            s->raEnd = pageNo;
+        }
+
+        pthread_cond_broadcast(&raQueueCond);
+    }
+
+    pthread_mutex_unlock(&edubfm_raMutex);
+
+}  /* edubfm_ReadAheadNotify */
+
+
+
+/*@================================
+ * edubfm_ReadAheadQueue()
+ *================================*/
+/*
+ * Function: Boolean edubfm_ReadAheadQueue(TrainID *, Four, Four)
+ *
+ * Description:
+ *  Queue the requests to read the given pages/trains, which the I/O threads
+ *  serve in order. The requests which do not fit in the queue are dropped.
+ *
+ * Returns:
+ *  TRUE if the I/O threads are running, otherwise FALSE
+ */
+Boolean edubfm_ReadAheadQueue(
+    TrainID             *trainIds,              /* IN pages/trains to be read */
+    Four                count,                  /* IN # of pages/trains */
+    Four                type)                   /* IN buffer type */
+{
+    Four                i;
+    ReadAheadRequest    *r;
+
+    if (!raRunning) return(FALSE);
+
+    pthread_mutex_lock(&edubfm_raMutex);
+
+    if (!raRunning) {
+        pthread_mutex_unlock(&edubfm_raMutex);
+        return(FALSE);
+    }
+
+    for (i = 0; i < count && raCount < READAHEAD_QUEUE_SIZE; i++) {
+        r = &raQueue[(raHead + raCount) % READAHEAD_QUEUE_SIZE];
+        r->trainId = trainIds[i];
+        r->type = type;
+        raCount++;
+    }
+
+    pthread_cond_broadcast(&raQueueCond);
+    pthread_mutex_unlock(&edubfm_raMutex);
+
+    return(TRUE);
+
+}  /* edubfm_ReadAheadQueue */
+
+
+
+/*@================================
+ * edubfm_ReadAheadWasted()
+ *================================*/
+/*
+ * Function: void edubfm_ReadAheadWasted(BfMHashKey *, Four)
+ *
+ * Description:
+ *  Report that a page/train read ahead is replaced without being fixed.
+ *  The window of the stream of the volume is halved.
+ */
+void edubfm_ReadAheadWasted(
+    BfMHashKey          *key,                   /* IN page/train replaced */
+    Four                type)                   /* IN buffer type */
+{
+    ReadAheadStream     *s;                     /* stream of the volume */
+
+    pthread_mutex_lock(&edubfm_raMutex);
+
+    edubfm_raStats.nReadAheadWasted++;
+
+    s = edubfm_ra_FindStream(key->volNo, type);
+    if (s != NULL) s->window = MAX(s->window / 2, MIN(READAHEAD_MIN_WINDOW, edubfm_cfgParams.readAheadMaxWindow));
+
+    pthread_mutex_unlock(&edubfm_raMutex);
+
+}  /* edubfm_ReadAheadWasted */
+
+
+
+/*@================================
+ * edubfm_ReadFrames()
+ *================================*/
+/*
+ * Function: Four edubfm_ReadFrames(TrainID *, Four, Four)
+ *
+ * Description:
+ *  Read the given pages/trains into the buffer pool, unless they are
+ *  already there, and mark them PREFETCHED. Each buffer element is marked
+ *  READING and fixed while it is read without the latch of the partition.
+ *  If the asynchronous I/O is running, the reads of up to
+ *  READAHEAD_BATCH_SIZE pages/trains of the attached volumes are kept in
+ *  flight together; otherwise they are read one by one. A page/train for
+ *  which no buffer element can be allocated or whose read fails is skipped.
+ *  It is used by the I/O threads, and in the calling thread when none is running.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_ReadFrames(
+    TrainID             *trainIds,              /* IN pages/trains to be read */
+    Four                count,                  /* IN # of pages/trains */
+    Four                type)                   /* IN buffer type */
+{
+    Four                e;                      /* for error */
+    Four                i, k, n;
+    Four                nReqs;                  /* # of asynchronous reads */
+    Four                nLoaded;                /* # of pages/trains read */
+    BufferPartition     *part;                  /* partition of a page/train */
+    TrainID             *trainId;
+    Four                index[READAHEAD_BATCH_SIZE];    /* buffer element of each page/train (NIL : skipped) */
+    Four                ioError[READAHEAD_BATCH_SIZE];  /* error of the read of each page/train */
+    Four                reqOf[READAHEAD_BATCH_SIZE];    /* asynchronous read of each page/train (NIL : none) */
+    BfMIORequest        reqs[READAHEAD_BATCH_SIZE];     /* asynchronous reads */
+
+    for (i = 0; i < count; i += n) {
+        n = MIN(count - i, READAHEAD_BATCH_SIZE);
+
+        // bufferPool에 없는 page/train마다 buffer element를 할당 받아 READING으로 표시함
+        // (모든 buffer element가 fix 된 경우 등에는 해당 page/train을 건너뜀)
+        for (k = 0; k < n; k++) {
+            trainId = &trainIds[i + k];
+            part = edubfm_GetPartition((BfMHashKey *)trainId, type);
+            e = edubfm_LatchPartition(part);
+            if (e < 0) ERR(e);
+
+            index[k] = NIL;
+            if (edubfm_LookUp((BfMHashKey *)trainId, type) == NOTFOUND_IN_HTABLE) {
+                index[k] = edubfm_AllocTrain((BfMHashKey *)trainId, type);
+                if (index[k] < 0 || edubfm_BeginFrameRead(trainId, type, index[k]) < 0) index[k] = NIL;
+            }
+
+            e = edubfm_UnlatchPartition(part);
+            if (e < 0) ERR(e);
+        }
+
+        // Partition의 latch 없이 읽음 (비동기 I/O를 사용하는 경우, attach 된 volume의 page/train들은 한꺼번에 제출함)
+        for (nReqs = 0, k = 0; k < n; k++) {
+            reqOf[k] = NIL;
+            ioError[k] = eNOERROR;
+            if (index[k] == NIL) continue;
+
+            trainId = &trainIds[i + k];
+            if (!AIO_RUNNING() || edubfm_VolumeFd(trainId->volNo) == NIL)
+                ioError[k] = edubfm_ReadTrain(trainId, BI_BUFFER(type, index[k]), type);
+            else if (!edubfm_CompressedCacheRead(trainId, BI_BUFFER(type, index[k]), type)) {
+                BFM_TRACE(BFM_TRACE_READ, trainId, type);
+                BFM_CHECKPOINT_READ();
+                edubfm_PrepareIO(&reqs[nReqs], BFM_IO_READ, trainId, BI_BUFFER(type, index[k]), type);
+                reqOf[k] = nReqs++;
+            }
+        }
+
+        if (nReqs > 0) {
+            e = edubfm_SubmitIO(reqs, nReqs);
+            if (e >= 0) (void) edubfm_WaitIO(reqs, nReqs);
+            for (k = 0; k < n; k++)
+                if (reqOf[k] != NIL) ioError[k] = (e < 0) ? e : reqs[reqOf[k]].result;
+        }
+
+        // 읽은 page/train들을 PREFETCHED로 표시하고, 기다리는 transaction들을 깨움
+        for (nLoaded = 0, k = 0; k < n; k++) {
+            if (index[k] == NIL) continue;
+
+            trainId = &trainIds[i + k];
+            part = edubfm_GetPartition((BfMHashKey *)trainId, type);
+            e = edubfm_LatchPartition(part);
+            if (e < 0) ERR(e);
+
+            if (edubfm_EndFrameRead(trainId, type, part, index[k], ioError[k], PREFETCHED, FALSE)) nLoaded++;
+
+            e = edubfm_UnlatchPartition(part);
+            if (e < 0) ERR(e);
+        }
+
+        pthread_mutex_lock(&edubfm_raMutex);
+        edubfm_raStats.nReadAheads += nLoaded;
+        pthread_mutex_unlock(&edubfm_raMutex);
+    }
+
+    return(eNOERROR);
+
+}  /* edubfm_ReadFrames */
+
+
+
+/*@================================
+ * edubfm_WaitReadAheadIdle()
+ *================================*/
+/*
+ * Function: void edubfm_WaitReadAheadIdle(void)
+ *
+ * Description:
+ *  Wait until the I/O threads have served all queued requests.
+ *  It returns at once if no I/O thread is running.
+ */
+void edubfm_WaitReadAheadIdle(void)
+{
+    pthread_mutex_lock(&edubfm_raMutex);
+    while (raRunning && (raCount > 0 || raNBusy > 0)) pthread_cond_wait(&raDoneCond, &edubfm_raMutex);
+    pthread_mutex_unlock(&edubfm_raMutex);
+
+}  /* edubfm_WaitReadAheadIdle */
+
+
+
+/*
+ * Function: static void *edubfm_ReadAheadMain(void *)
+ *
+ * Description:
+ *  Main loop of an I/O thread, which serves the queued requests in order.
+ */
+static void *edubfm_ReadAheadMain(
+    void                *arg)                   /* IN not used */
+{
+    Four                e;                      /* for error */
+    ReadAheadRequest    r;                      /* request being served */
+
+    for (;;) {
+        pthread_mutex_lock(&edubfm_raMutex);
+        while (raCount == 0 && !raStop) pthread_cond_wait(&raQueueCond, &edubfm_raMutex);
+        if (raStop) {
+            pthread_mutex_unlock(&edubfm_raMutex);
+            break;
+        }
+        r = raQueue[raHead];
+        raHead = (raHead + 1) % READAHEAD_QUEUE_SIZE;
+        raCount--;
+        raNBusy++;
+        pthread_mutex_unlock(&edubfm_raMutex);
+
+        e = edubfm_ReadFrames(&r.trainId, 1, r.type);
+        if (e < 0) PRTERR(e);
+
+        pthread_mutex_lock(&edubfm_raMutex);
+        raNBusy--;
+        pthread_cond_broadcast(&raDoneCond);
+        pthread_mutex_unlock(&edubfm_raMutex);
+    }
+
+    return(NULL);
+
+}  /* edubfm_ReadAheadMain */
+
+
+
+/*
+ * Function: static ReadAheadStream *edubfm_ra_FindStream(VolNo, Four)
+ *
+ * Description:
+ *  Return the stream of the volume for the buffer type. edubfm_raMutex must be held.
+ *
+ * Returns:
+ *  pointer to the stream (NULL : not found)
+ */
+static ReadAheadStream *edubfm_ra_FindStream(
+    VolNo               volNo,                  /* IN volume number */
+    Four                type)                   /* IN buffer type */
+{
+    Four                i;
+
+    for (i = 0; i < READAHEAD_NSTREAMS; i++)
+        if (raStreams[i].volNo == volNo && raStreams[i].type == type) return(&raStreams[i]);
+
+    return(NULL);
+
+}  /* edubfm_ra_FindStream */
@@ -33,6 +33,7 @@
  */
 
 
+#include <unistd.h>
 #include "EduBfM_common.h"
 #include "RDsM.h"
 #include "RM.h"                 /* YKL05MAR97 */
@@ -55,9 +56,18 @@
  *  when RDsM_ReadTrain() is called, simply return it.  The function has
  *  no code for checking input parameters since this will be done RDsM,
  *  especially RDsM_ReadTrain().
+ *  If the volume is attached by EduBfM_AttachVolume(), the train is read
+ *  from its device directly, holding the I/O latch in the shared mode so
+ *  that the reads of several threads can overlap. If the asynchronous I/O
+ *  is running, the read is submitted to it instead, ordered only against
+ *  the writes of the same train in flight. The reads of a memory volume
+ *  are delayed by its latency and bandwidth.
+ *  If the train has been replaced into the compressed cache, it is
+ *  decompressed from there instead of being read from disk.
  *
  * Returns;
  *  error code
+ *    eVOLUMEIOERR_EDUBFM - Reading from the device of an attached volume failed.
  *    some errors caused by RDsM_ReadTrain()
  *
  * Side effects
@@ -69,6 +79,7 @@
  * 
  * 관련 함수:
  *  1. RDsM_ReadTrain()
+ *  2. edubfm_CompressedCacheRead() - compressed cache에 저장된 page/train의 압축을 풀어 읽음
  */
 Four edubfm_ReadTrain(
     TrainID *trainId,		/* IN which train? */
@@ -76,6 +87,10 @@ Four edubfm_ReadTrain(
     Four    type )		/* IN buffer type */
 {
     Four e;			/* for error */
+    Four fd;			/* file descriptor of the device */
+    ssize_t nBytes;		/* # of bytes to be read */
+    UEight  due;		/* time when the read of a memory volume completes */
+    BfMIORequest req;		/* asynchronous read */
 
 	/* Error check whether using not supported functionality by EduBfM */
 	if (RM_IS_ROLLBACK_REQUIRED()) ERR(eNOTSUPPORTED_EDUBFM);
@@ -83,7 +98,52 @@ Four edubfm_ReadTrain(
     /* Is the buffer type valid? */
     if(IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);	
 
+    // Compressed cache에 남아 있는 경우, disk로부터 읽지 않고 압축을 풀어 저장함
+    if (edubfm_CompressedCacheRead(trainId, aTrain, type)) return( eNOERROR );
+
+    BFM_TRACE(BFM_TRACE_READ, trainId, type);
+    BFM_CHECKPOINT_READ();
+
+    // Attach 된 volume인 경우, device로부터 직접 읽음
+    fd = edubfm_VolumeFd(trainId->volNo);
+
+    // 비동기 I/O를 사용하는 경우, I/O latch 없이 제출하고 완료될 때까지 기다림
+    if (fd != NIL && AIO_RUNNING()) {
+        edubfm_PrepareIO(&req, BFM_IO_READ, trainId, aTrain, type);
+
+        e = edubfm_SubmitIO(&req, 1);
+        if (e < 0) ERR(e);
+
+        e = edubfm_WaitIO(&req, 1);
+        if (e < 0) ERR(e);
+
+        return( eNOERROR );
+    }
+
+    if (fd != NIL) {
+        e = edubfm_LatchIOShared();
+        if (e < 0) ERR(e);
+
+        nBytes = PAGESIZE * BI_BUFSIZE(type);
+        due = edubfm_MemoryVolumeCharge(trainId->volNo, nBytes);
+        nBytes -= pread(fd, aTrain, nBytes, (off_t)trainId->pageNo * PAGESIZE);
+
+        edubfm_UnlatchIO();
+        if (nBytes != 0) ERR(eVOLUMEIOERR_EDUBFM);
+
+        // Memory volume인 경우, 주어진 지연 시간이 지날 때까지 기다림
+        edubfm_MemoryVolumeWait(due);
+
+        return( eNOERROR );
+    }
+
+    // RDsM은 reentrant 하지 않으므로, partition된 경우 I/O latch를 획득한 후 disk로부터 읽음
+    e = edubfm_LatchIO();
+    if (e < 0) ERR(e);
+
     e = RDsM_ReadTrain((PageID *)trainId, aTrain, BI_BUFSIZE(type));
+
+    edubfm_UnlatchIO();
     if (e < 0) ERR(e);
 
     return( eNOERROR );
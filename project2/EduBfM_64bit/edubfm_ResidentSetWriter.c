@@ -0,0 +1,147 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_ResidentSetWriter.c
+ *
+ * Description:
+ *  The resident set writer, a thread which saves the list of the
+ *  pages/trains in the buffer pools to edubfm_cfgParams.residentSetFile
+ *  every edubfm_cfgParams.residentSetInterval seconds, so that EduBfM can
+ *  start warm even after it was not finalized cleanly.
+ *
+ * Exports:
+ *  Four edubfm_StartResidentSetWriter(void)
+ *  Four edubfm_StopResidentSetWriter(void)
+ */
+
+
+#include <time.h>
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_Internal.h"
+
+
+/* state of the resident set writer */
+static pthread_t        rsWriterThread;
+static Boolean          rsWriterRunning = FALSE;
+static Boolean          rsWriterStop;           /* TRUE if the writer is requested to stop */
+static pthread_mutex_t  rsWriterMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   rsWriterCond = PTHREAD_COND_INITIALIZER;
+
+
+/* internal function prototypes */
+static void *edubfm_ResidentSetWriterMain(void *);
+
+
+
+/*@================================
+ * edubfm_StartResidentSetWriter()
+ *================================*/
+/*
+ * Function: Four edubfm_StartResidentSetWriter(void)
+ *
+ * Description:
+ *  Start the resident set writer. The buffer pools must be partitioned.
+ *
+ * Returns:
+ *  error code
+ *    eMUTEXCREATEUNKNOWN_BFM - The thread cannot be created.
+ */
+Four edubfm_StartResidentSetWriter(void)
+{
+    if (rsWriterRunning) return(eNOERROR);
+
+    rsWriterStop = FALSE;
+    if (pthread_create(&rsWriterThread, NULL, edubfm_ResidentSetWriterMain, NULL) != 0) ERR(eMUTEXCREATEUNKNOWN_BFM);
+    rsWriterRunning = TRUE;
+
+    return(eNOERROR);
+
+}  /* edubfm_StartResidentSetWriter */
+
+
+
+/*@================================
+ * edubfm_StopResidentSetWriter()
+ *================================*/
+/*
+ * Function: Four edubfm_StopResidentSetWriter(void)
+ *
+ * Description:
+ *  Stop the resident set writer and wait until it finishes the current save.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_StopResidentSetWriter(void)
+{
+    if (!rsWriterRunning) return(eNOERROR);
+
+    pthread_mutex_lock(&rsWriterMutex);
+    rsWriterStop = TRUE;
+    pthread_cond_signal(&rsWriterCond);
+    pthread_mutex_unlock(&rsWriterMutex);
+
+    pthread_join(rsWriterThread, NULL);
+    rsWriterRunning = FALSE;
+
+    return(eNOERROR);
+
+}  /* edubfm_StopResidentSetWriter */
+
+
+
+/*
+ * Function: static void *edubfm_ResidentSetWriterMain(void *)
+ *
+ * Description:
+ *  Main loop of the resident set writer. Every residentSetInterval sec,
+ *  the resident set file is rewritten.
+ */
+static void *edubfm_ResidentSetWriterMain(
+    void                *arg)                   /* IN not used */
+{
+    Four                e;                      /* for error */
+    struct timespec     ts;
+
+    for (;;) {
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec += edubfm_cfgParams.residentSetInterval;
+
+        pthread_mutex_lock(&rsWriterMutex);
+        if (!rsWriterStop) pthread_cond_timedwait(&rsWriterCond, &rsWriterMutex, &ts);
+        if (rsWriterStop) {
+            pthread_mutex_unlock(&rsWriterMutex);
+            break;
+        }
+        pthread_mutex_unlock(&rsWriterMutex);
+
+        e = EduBfM_SaveResidentSet(edubfm_cfgParams.residentSetFile);
+        if (e < 0) PRTERR(e);
+    }
+
+    return(NULL);
+
+}  /* edubfm_ResidentSetWriterMain */
@@ -0,0 +1,320 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_Stats.c
+ *
+ * Description:
+ *  Some functions are provided to collect the statistics returned by
+ *  EduBfM_GetStats(). They are called through BFM_STATS(), so they are
+ *  compiled only if EDUBFM_STATS is defined, and the counters of a
+ *  partition are updated under the latch of the partition.
+ *  Besides the counters of the partitions, the number of fixes of the
+ *  page/train held by each buffer element and the time it was fixed are
+ *  kept, to build the fix count and the pin time histograms. Reading the
+ *  clock costs more than the rest of a fix, so the pin time is sampled:
+ *  only one of BFM_STATS_PIN_SAMPLE fixes of a partition is timed.
+ *
+ * Exports:
+ *  void edubfm_StatsFix(Four, BufferPartition *, Four, Boolean)
+ *  void edubfm_StatsUnfix(Four, BufferPartition *, Four)
+ *  void edubfm_StatsEvict(Four, BufferPartition *, Four)
+ *  void edubfm_StatsDiscard(Four, Four)
+ *  void edubfm_StatsVictim(BufferPartition *, UEight)
+ *  void edubfm_StatsLookUp(Four, Four, UEight)
+ *  void edubfm_StatsOptimisticFix(Four, BufferPartition *, Four)
+ *  Boolean edubfm_StatsPinTimed(Four, Four)
+ */
+
+
+#include <time.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+#ifdef EDUBFM_STATS
+
+
+/* # of fixes of the page/train held by each buffer element since it was read */
+static UFour edubfm_fixCount[NUM_BUF_TYPES][BFM_STATS_MAX_NBUFS];
+
+/* time when the page/train held by each buffer element was fixed, if the fix is timed (unit: nsec, 0 : not timed) */
+static UEight edubfm_pinStart[NUM_BUF_TYPES][BFM_STATS_MAX_NBUFS];
+
+
+/* return the current time of the monotonic clock (unit: nsec) */
+static UEight edubfm_StatsNow(void)
+{
+    struct timespec     ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return( (UEight)ts.tv_sec * 1000000000ULL + ts.tv_nsec );
+
+}  /* edubfm_StatsNow */
+
+
+
+/*@================================
+ * edubfm_StatsFix()
+ *================================*/
+/*
+ * Function: void edubfm_StatsFix(Four, BufferPartition *, Four, Boolean)
+ *
+ * Description:
+ *  Count a fix of the page/train held by the buffer 'index', which has
+ *  just been fixed by EduBfM_GetTrain(). 'hit' is TRUE if it was found in
+ *  the buffer pool. The fix is also counted as remote if the partition is
+ *  placed on another NUMA node than the calling thread.
+ *  The caller must hold the latch of the partition.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_StatsFix(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part,                  /* IN partition of the buffer */
+    Four                index,                  /* IN index of the buffer */
+    Boolean             hit)                    /* IN TRUE if the page/train was in the buffer pool */
+{
+    part->stats.nFixes++;
+    if (hit) part->stats.nHits++;
+    else part->stats.nMisses++;
+
+    if (part->node != NIL && edubfm_ThreadNode() != part->node) part->stats.nRemoteFixes++;
+
+    if (index >= BFM_STATS_MAX_NBUFS) return;
+
+    // 새로 읽힌 page/train의 fix 횟수는 0부터 다시 셈
+    if (!hit) edubfm_fixCount[type][index] = 0;
+    edubfm_fixCount[type][index]++;
+
+    // 처음 fix 된 시각을 기록하여, unfix 될 때 fix 되어 있던 시간을 구함 (BFM_STATS_PIN_SAMPLE 번에 한 번만 기록함)
+    if (BI_FIXED(type, index) == 1 && part->stats.nFixes % BFM_STATS_PIN_SAMPLE == 0)
+        edubfm_pinStart[type][index] = edubfm_StatsNow();
+
+}  /* edubfm_StatsFix */
+
+
+
+/*@================================
+ * edubfm_StatsUnfix()
+ *================================*/
+/*
+ * Function: void edubfm_StatsUnfix(Four, BufferPartition *, Four)
+ *
+ * Description:
+ *  Record the pin time of the page/train held by the buffer 'index' if it
+ *  has just been unfixed by its last holder and the fix was timed.
+ *  The caller must hold the latch of the partition.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_StatsUnfix(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part,                  /* IN partition of the buffer */
+    Four                index)                  /* IN index of the buffer */
+{
+    UEight              usec;                   /* pin time */
+
+    if (index >= BFM_STATS_MAX_NBUFS || BI_FIXED(type, index) != 0 || edubfm_pinStart[type][index] == 0) return;
+
+    usec = (edubfm_StatsNow() - edubfm_pinStart[type][index]) / 1000;
+    part->stats.pinTimeHist[BFM_STATS_BUCKET(usec)]++;
+    edubfm_pinStart[type][index] = 0;
+
+}  /* edubfm_StatsUnfix */
+
+
+
+/*@================================
+ * edubfm_StatsEvict()
+ *================================*/
+/*
+ * Function: void edubfm_StatsEvict(Four, BufferPartition *, Four)
+ *
+ * Description:
+ *  Count the eviction of the page/train held by the buffer 'index' and
+ *  record how many times it was fixed while it stayed in the buffer pool.
+ *  The caller must hold the latch of the partition.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_StatsEvict(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part,                  /* IN partition of the buffer */
+    Four                index)                  /* IN index of the buffer */
+{
+    part->stats.nEvictions++;
+
+    if (index >= BFM_STATS_MAX_NBUFS) return;
+
+    part->stats.fixCountHist[BFM_STATS_BUCKET(edubfm_fixCount[type][index])]++;
+    edubfm_fixCount[type][index] = 0;
+
+}  /* edubfm_StatsEvict */
+
+
+
+/*@================================
+ * edubfm_StatsDiscard()
+ *================================*/
+/*
+ * Function: void edubfm_StatsDiscard(Four, Four)
+ *
+ * Description:
+ *  Forget the fix count and the fix time of the buffer 'index', whose page/train is
+ *  discarded by EduBfM_DiscardAll() without being evicted.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_StatsDiscard(
+    Four                type,                   /* IN buffer type */
+    Four                index)                  /* IN index of the buffer */
+{
+    if (index >= BFM_STATS_MAX_NBUFS) return;
+
+    edubfm_fixCount[type][index] = 0;
+    edubfm_pinStart[type][index] = 0;
+
+}  /* edubfm_StatsDiscard */
+
+
+
+/*@================================
+ * edubfm_StatsVictim()
+ *================================*/
+/*
+ * Function: void edubfm_StatsVictim(BufferPartition *, UEight)
+ *
+ * Description:
+ *  Record the number of buffer elements visited by the replacement policy
+ *  to select a victim of the partition. The policies add the visited
+ *  buffer elements to part->stats.nVictimSteps themselves.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_StatsVictim(
+    BufferPartition     *part,                  /* IN partition */
+    UEight              steps)                  /* IN # of buffer elements visited */
+{
+    part->stats.nVictimSearches++;
+    part->stats.maxVictimSteps = MAX(part->stats.maxVictimSteps, steps);
+    part->stats.victimStepsHist[BFM_STATS_BUCKET(steps)]++;
+
+}  /* edubfm_StatsVictim */
+
+
+
+/*@================================
+ * edubfm_StatsLookUp()
+ *================================*/
+/*
+ * Function: void edubfm_StatsLookUp(Four, Four, UEight)
+ *
+ * Description:
+ *  Record the number of hash chain entries compared by edubfm_LookUp()
+ *  to look up a key of the hash value 'hashValue'. The partition is found
+ *  from the hash value already computed by edubfm_LookUp(). The caller
+ *  must hold the latch of the partition.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_StatsLookUp(
+    Four                hashValue,              /* IN hash value of the key looked up */
+    Four                type,                   /* IN buffer type */
+    UEight              steps)                  /* IN # of hash chain entries compared */
+{
+    BufferPartition     *part;                  /* partition of the key */
+
+    part = IS_PARTITIONED(type) ? PI_PART(type, BFM_HASHPARTITION(hashValue, type)) : &partInfo[type].whole;
+
+    part->stats.nLookUps++;
+    part->stats.nChainSteps += steps;
+    part->stats.maxChainSteps = MAX(part->stats.maxChainSteps, steps);
+    part->stats.chainStepsHist[BFM_STATS_BUCKET(steps)]++;
+
+}  /* edubfm_StatsLookUp */
+
+
+
+/*@================================
+ * edubfm_StatsOptimisticFix()
+ *================================*/
+/*
+ * Function: void edubfm_StatsOptimisticFix(Four, BufferPartition *, Four)
+ *
+ * Description:
+ *  Count a fix of the page/train held by the buffer 'index', which has
+ *  just been fixed by edubfm_OptimisticFix() without the latch. The
+ *  counters are incremented atomically, and the fix is not timed.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_StatsOptimisticFix(
+    Four                type,                   /* IN buffer type */
+    BufferPartition     *part,                  /* IN partition of the buffer */
+    Four                index)                  /* IN index of the buffer */
+{
+    __atomic_add_fetch(&part->stats.nOptimisticFixes, 1, __ATOMIC_RELAXED);
+
+    if (part->node != NIL && edubfm_ThreadNode() != part->node)
+        __atomic_add_fetch(&part->stats.nRemoteFixes, 1, __ATOMIC_RELAXED);
+
+    if (index < BFM_STATS_MAX_NBUFS) __atomic_add_fetch(&edubfm_fixCount[type][index], 1, __ATOMIC_RELAXED);
+
+}  /* edubfm_StatsOptimisticFix */
+
+
+
+/*@================================
+ * edubfm_StatsPinTimed()
+ *================================*/
+/*
+ * Function: Boolean edubfm_StatsPinTimed(Four, Four)
+ *
+ * Description:
+ *  Check whether the fix of the page/train held by the buffer 'index' is
+ *  timed, so that EduBfM_FreeFrame() unfixes it under the latch and
+ *  edubfm_StatsUnfix() records its pin time.
+ *
+ * Returns:
+ *  TRUE if the fix is timed
+ */
+Boolean edubfm_StatsPinTimed(
+    Four                type,                   /* IN buffer type */
+    Four                index)                  /* IN index of the buffer */
+{
+    if (index >= BFM_STATS_MAX_NBUFS) return(FALSE);
+
+    return( __atomic_load_n(&edubfm_pinStart[type][index], __ATOMIC_RELAXED) != 0 );
+
+}  /* edubfm_StatsPinTimed */
+
+#endif /* EDUBFM_STATS */
@@ -0,0 +1,217 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_Trace.c
+ *
+ * Description:
+ *  Some functions are provided to trace the operations of EduBfM into a
+ *  binary file (edubfm_cfgParams.traceFile), from EduBfM_Init() to
+ *  EduBfM_Final(). Each fix (hit or miss), unfix, EduBfM_SetDirty(), read
+ *  and write of a page/train of the buffer pools is recorded as an
+ *  EduBfM_TraceRecord with its time, after an EduBfM_TraceHeader giving
+ *  the sizes of the buffer pools. The records are collected in a buffer
+ *  of TRACE_BUFFER_SIZE records, which is written when it is full, so that
+ *  an operation costs only a copy under the mutex of the trace; when
+ *  nothing is traced, it costs only the test of edubfm_traceOn.
+ *  The records of all threads are written in the order of their times.
+ *  The pages/trains of the mapped volumes and the variable-size trains are
+ *  not traced, since they do not use the buffer pools.
+ *  The "replay" benchmark reads such a file, and the "policy" benchmark
+ *  replays its fixes.
+ *
+ * Exports:
+ *  Four edubfm_StartTrace(char *)
+ *  Four edubfm_StopTrace(void)
+ *  void edubfm_Trace(Four, PageID *, Four)
+ */
+
+
+#include <string.h>
+#include <time.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* TRUE while the operations are traced */
+Boolean edubfm_traceOn = FALSE;
+
+/* trace file, buffer of the records not yet written, and the time when the trace was started (unit: nsec) */
+static FILE *traceFp = NULL;
+static EduBfM_TraceRecord traceBuf[TRACE_BUFFER_SIZE];
+static Four traceCount = 0;
+static UEight traceStart;
+static Boolean traceFailed;             /* TRUE if a write to the trace file failed */
+static pthread_mutex_t traceMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+/* return the current time of the monotonic clock (unit: nsec) */
+static UEight edubfm_TraceNow(void)
+{
+    struct timespec     ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return( (UEight)ts.tv_sec * 1000000000ULL + ts.tv_nsec );
+
+}  /* edubfm_TraceNow */
+
+
+
+/*@================================
+ * edubfm_StartTrace()
+ *================================*/
+/*
+ * Function: Four edubfm_StartTrace(char *)
+ *
+ * Description:
+ *  Create the trace file, write its header and start tracing.
+ *
+ * Returns:
+ *  error code
+ *    eFILEIOERR_EDUBFM - The file cannot be written.
+ *
+ * 설명:
+ *  Trace file을 만들고 header를 기록한 후, EduBfM의 연산들을 기록하기 시작함
+ */
+Four edubfm_StartTrace(
+    char                *fileName)              /* IN trace file */
+{
+    Four                type;                   /* buffer type */
+    EduBfM_TraceHeader  header;                 /* header of the trace file */
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BFM_TRACE_MAGIC, sizeof(header.magic));
+    header.pageSize = PAGESIZE;
+    header.nTypes = NUM_BUF_TYPES;
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        header.nBufs[type] = BI_NBUFS(type);
+        header.bufSize[type] = BI_BUFSIZE(type);
+    }
+
+    traceFp = fopen(fileName, "wb");
+    if (traceFp == NULL) ERR(eFILEIOERR_EDUBFM);
+
+    if (fwrite(&header, sizeof(header), 1, traceFp) != 1) {
+        fclose(traceFp);
+        traceFp = NULL;
+        ERR(eFILEIOERR_EDUBFM);
+    }
+
+    traceCount = 0;
+    traceFailed = FALSE;
+    traceStart = edubfm_TraceNow();
+    edubfm_traceOn = TRUE;
+
+    return(eNOERROR);
+
+}  /* edubfm_StartTrace */
+
+
+
+/*@================================
+ * edubfm_StopTrace()
+ *================================*/
+/*
+ * Function: Four edubfm_StopTrace(void)
+ *
+ * Description:
+ *  Stop tracing, and write the buffered records and close the trace file.
+ *  Nothing is done if EduBfM is not tracing.
+ *
+ * Returns:
+ *  error code
+ *    eFILEIOERR_EDUBFM - Some records could not be written.
+ */
+Four edubfm_StopTrace(void)
+{
+    Boolean             ok;
+
+    if (traceFp == NULL) return(eNOERROR);
+
+    pthread_mutex_lock(&traceMutex);
+
+    edubfm_traceOn = FALSE;
+
+    ok = !traceFailed && fwrite(traceBuf, sizeof(EduBfM_TraceRecord), traceCount, traceFp) == traceCount;
+    ok = (fclose(traceFp) == 0) && ok;
+    traceFp = NULL;
+    traceCount = 0;
+
+    pthread_mutex_unlock(&traceMutex);
+
+    if (!ok) ERR(eFILEIOERR_EDUBFM);
+
+    return(eNOERROR);
+
+}  /* edubfm_StopTrace */
+
+
+
+/*@================================
+ * edubfm_Trace()
+ *================================*/
+/*
+ * Function: void edubfm_Trace(Four, PageID *, Four)
+ *
+ * Description:
+ *  Record an operation on the page/train, called through BFM_TRACE().
+ *  The buffer of the records is written to the trace file when it is full.
+ *  If a write fails, the records are dropped from then on, and
+ *  edubfm_StopTrace() reports the failure.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_Trace(
+    Four                op,                     /* IN BFM_TRACE_XXX */
+    PageID              *trainId,               /* IN page/train */
+    Four                type)                   /* IN buffer type */
+{
+    EduBfM_TraceRecord  *r;                     /* record */
+
+    pthread_mutex_lock(&traceMutex);
+
+    // 그동안 trace가 끝난 경우에는 기록하지 않음
+    if (traceFp == NULL || traceFailed) {
+        pthread_mutex_unlock(&traceMutex);
+        return;
+    }
+
+    r = &traceBuf[traceCount++];
+    r->time = edubfm_TraceNow() - traceStart;
+    r->pageNo = trainId->pageNo;
+    r->volNo = trainId->volNo;
+    r->op = op;
+    r->type = type;
+
+    // Buffer가 가득 차면 trace file에 기록함
+    if (traceCount == TRACE_BUFFER_SIZE) {
+        if (fwrite(traceBuf, sizeof(EduBfM_TraceRecord), traceCount, traceFp) != traceCount) traceFailed = TRUE;
+        traceCount = 0;
+    }
+
+    pthread_mutex_unlock(&traceMutex);
+
+}  /* edubfm_Trace */